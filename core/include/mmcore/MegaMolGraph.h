@@ -9,6 +9,8 @@
 #include <functional>
 #include <list>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "FrontendResource.h"
@@ -59,6 +61,16 @@ public:
 
     bool CreateCall(std::string const& className, std::string const& from, std::string const& to);
 
+    // batched graph construction for large generated projects.
+    // failed requests are logged and skipped, the result is false if any request failed.
+    bool CreateModules(std::vector<ModuleInstantiationRequest_t> const& requests);
+
+    bool CreateCalls(std::vector<CallInstantiationRequest_t> const& requests);
+
+    // sets all parameters or none of them, then broadcasts the changes to graph subscribers once.
+    // expects pairs of parameter name and value.
+    bool SetParameters(std::vector<std::pair<std::string, std::string>> const& values);
+
     megamol::core::Module::ptr_type FindModule(std::string const& moduleName) const;
 
     megamol::core::Call::ptr_type FindCall(std::string const& from, std::string const& to) const;
@@ -107,6 +119,9 @@ private:
 
     [[nodiscard]] CallList_t::const_iterator find_call(std::string const& from, std::string const& to) const;
 
+    // calls are found by their slot names, which are compared case-insensitive
+    [[nodiscard]] static std::string call_key(std::string const& from, std::string const& to);
+
     // modules are named using the exact same string that gets requested,
     // i.e. we dont split namespaces like ::Project_1::Group_1::View3D_2_1 to extract the 'actual' modul name 'View3D_2_1'
     [[nodiscard]] bool add_module(ModuleInstantiationRequest_t const& request);
@@ -128,6 +143,10 @@ private:
     /** List of call that this graph owns */
     CallList_t call_list_;
 
+    // hashed lookup into module_list_ and call_list_, whose iterators stay valid until the element is erased
+    std::unordered_map<std::string, ModuleList_t::iterator> module_index_;
+    std::unordered_map<std::string, CallList_t::iterator> call_index_;
+
     megamol::frontend_resources::FrontendResourcesLookup provided_resources_lookup;
 
     // for each View in the MegaMol graph we create a EntryPoint
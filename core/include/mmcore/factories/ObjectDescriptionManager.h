@@ -9,9 +9,11 @@
 #include <algorithm>
 #include <cctype>
 #include <exception>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "mmcore/utility/String.h"
@@ -29,6 +31,7 @@ public:
     typedef std::vector<description_ptr_type> description_list_type;
     typedef typename description_list_type::iterator description_iterator_type;
     typedef typename description_list_type::const_iterator description_const_iterator_type;
+    typedef std::function<bool(const std::string&)> missing_handler_type;
 
     /** ctor */
     ObjectDescriptionManager();
@@ -74,6 +77,15 @@ public:
      */
     void Shutdown();
 
+    /**
+     * Sets a handler that is called by Find for class names that are not
+     * registered. The handler may register the description, e.g. by
+     * loading the plugin providing it.
+     *
+     * @param handler Answers true if Find should search again.
+     */
+    void SetMissingHandler(missing_handler_type handler);
+
     /**
      * Searches for an object description object with the given name.
      *
@@ -116,13 +128,19 @@ public:
 private:
     /** The registered object descriptions */
     description_list_type descriptions_;
+
+    /** The registered object descriptions by lower case class name */
+    std::unordered_map<std::string, description_ptr_type> index_;
+
+    /** Called for unknown class names */
+    missing_handler_type missing_handler_;
 };
 
 /*
  * ObjectDescriptionManager::ObjectDescriptionManager
  */
 template<class T>
-ObjectDescriptionManager<T>::ObjectDescriptionManager() : descriptions_() {}
+ObjectDescriptionManager<T>::ObjectDescriptionManager() : descriptions_(), index_(), missing_handler_() {}
 
 /*
  * ObjectDescriptionManager::~ObjectDescriptionManager
@@ -130,6 +148,7 @@ ObjectDescriptionManager<T>::ObjectDescriptionManager() : descriptions_() {}
 template<class T>
 ObjectDescriptionManager<T>::~ObjectDescriptionManager() {
     descriptions_.clear();
+    index_.clear();
 }
 
 /*
@@ -139,7 +158,7 @@ template<class T>
 void ObjectDescriptionManager<T>::Register(description_ptr_type objDesc) {
     if (!objDesc)
         throw std::runtime_error("No object description given!");
-    if (this->Find(objDesc->ClassName()) != nullptr) {
+    if (!index_.emplace(utility::string::ToLowerAsciiCopy(objDesc->ClassName()), objDesc).second) {
         throw std::invalid_argument("Class name of object description is already registered!");
     }
     descriptions_.push_back(objDesc);
@@ -151,6 +170,7 @@ void ObjectDescriptionManager<T>::Register(description_ptr_type objDesc) {
 template<class T>
 void ObjectDescriptionManager<T>::Unregister(const char* classname) {
     std::string name(classname);
+    index_.erase(utility::string::ToLowerAsciiCopy(name));
     descriptions_.erase(std::remove_if(descriptions_.begin(), descriptions_.end(),
                             [&name](const description_ptr_type& d) {
                                 return utility::string::EqualAsciiCaseInsensitive(name, d->ClassName());
@@ -172,6 +192,15 @@ unsigned int ObjectDescriptionManager<T>::Count() const {
 template<class T>
 void ObjectDescriptionManager<T>::Shutdown() {
     descriptions_.clear();
+    index_.clear();
+}
+
+/*
+ * ObjectDescriptionManager<T>::SetMissingHandler
+ */
+template<class T>
+void ObjectDescriptionManager<T>::SetMissingHandler(missing_handler_type handler) {
+    missing_handler_ = std::move(handler);
 }
 
 /*
@@ -180,12 +209,12 @@ void ObjectDescriptionManager<T>::Shutdown() {
 template<class T>
 typename ObjectDescriptionManager<T>::description_ptr_type ObjectDescriptionManager<T>::Find(
     const char* classname) const {
-    for (auto& desc : descriptions_) {
-        if (utility::string::EqualAsciiCaseInsensitive(std::string(classname), std::string(desc->ClassName()))) {
-            return desc;
-        }
+    const auto name = utility::string::ToLowerAsciiCopy(classname);
+    auto it = index_.find(name);
+    if (it == index_.end() && missing_handler_ && missing_handler_(classname)) {
+        it = index_.find(name);
     }
-    return nullptr;
+    return it != index_.end() ? it->second : nullptr;
 }
 
 /*
@@ -0,0 +1,117 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+namespace megamol::core::utility::sys {
+
+/**
+ * Process-wide task scheduler, parallel code should run its work here instead of starting threads of its own.
+ *
+ * Tasks are executed by the work-stealing workers of oneTBB, whose total number is limited to the configured thread
+ * count, which also applies to code using oneTBB directly. On machines with several NUMA nodes there is one arena per
+ * node with workers bound to that node: parallel loops are split into one contiguous part per node, and work started
+ * from a task stays on the node of that task.
+ *
+ * OpenMP regions inside tasks run with a single thread, and parallel loops started inside an OpenMP region run on the
+ * calling thread, so that the OpenMP team and the workers do not oversubscribe the cores.
+ */
+class TaskScheduler {
+public:
+    /** Tasks that are waited for together. */
+    class TaskGroup {
+    public:
+        TaskGroup();
+
+        /** Waits for all tasks. */
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        void Run(std::function<void()> task);
+
+        /**
+         * Waits for all tasks, the calling thread helps executing them. If a task throws, the remaining tasks are
+         * cancelled and the exception is rethrown here.
+         */
+        void Wait();
+
+        /**
+         * Number of tasks that have not finished yet. Once a task has thrown, the remaining tasks are cancelled and
+         * this is 0, Wait() then rethrows the exception.
+         */
+        std::size_t Pending() const {
+            return cancelled_ ? 0 : pending_.load();
+        }
+
+    private:
+        tbb::task_arena& arena_;
+        tbb::task_group group_;
+        std::atomic<std::size_t> pending_{0};
+        std::atomic<bool> cancelled_{false};
+    };
+
+    /**
+     * Sets up the scheduler, must be called before it is used for the first time.
+     *
+     * @param thread_count Number of threads including the calling ones, 0 uses all hardware threads.
+     * @param numa_aware Bind the workers to NUMA nodes if there are several.
+     */
+    static void Configure(std::size_t thread_count, bool numa_aware = true);
+
+    static TaskScheduler& Instance();
+
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /** Runs a task asynchronously. Exceptions thrown by the task are logged. */
+    void Enqueue(std::function<void()> task);
+
+    /**
+     * Calls body(chunk_begin, chunk_end) for chunks of [begin, end) in parallel and returns when all chunks are done.
+     *
+     * @param grain Minimum number of iterations per chunk.
+     */
+    void ParallelFor(std::size_t begin, std::size_t end, std::function<void(std::size_t, std::size_t)> const& body,
+        std::size_t grain = 1);
+
+    std::size_t GetThreadCount() const {
+        return thread_count_;
+    }
+
+    std::size_t GetNumaNodeCount() const {
+        return arenas_.size();
+    }
+
+private:
+    class Observer;
+
+    TaskScheduler(std::size_t thread_count, bool numa_aware);
+
+    /** Arena of the node the calling thread works on, or the next one in turn. */
+    tbb::task_arena& arena();
+
+    std::unique_ptr<tbb::global_control> thread_limit_;
+    std::vector<std::unique_ptr<tbb::task_arena>> arenas_;
+    std::vector<std::unique_ptr<Observer>> observers_;
+    std::atomic<std::size_t> next_arena_{0};
+    std::size_t thread_count_ = 0;
+};
+
+} // namespace megamol::core::utility::sys
@@ -12,6 +12,7 @@
 #include <numeric> // std::accumulate
 #include <string>
 #include <type_traits>
+#include <unordered_set>
 
 #include "ResourceRequest.h"
 #include "mmcore/AbstractSlot.h"
@@ -123,10 +124,16 @@ bool megamol::core::MegaMolGraph::RenameModule(std::string const& old, std::stri
         log_error("error. could not rename module. module is nullptr: " + oldId);
         return false;
     }
+    if (newId != oldId && find_module(newId) != module_list_.end()) {
+        log_error("error. could not rename module " + oldId + ". a module named " + newId + " already exists");
+        return false;
+    }
 
     log("rename module " + module_it->request.id + " to " + newId);
     module_it->request.id = newId;
     module_it->modulePtr->setName(newId.c_str());
+    module_index_.erase(oldId);
+    module_index_[newId] = module_it;
 
     const auto matches_old_prefix = [&](std::string const& call_slot) {
         auto res = call_slot.find(oldId);
@@ -139,13 +146,21 @@ bool megamol::core::MegaMolGraph::RenameModule(std::string const& old, std::stri
         log("rename call at slot " + old + " to " + name);
     };
 
-    for (auto& call : call_list_) {
-        if (matches_old_prefix(call.request.from)) {
+    for (auto call_it = call_list_.begin(); call_it != call_list_.end(); ++call_it) {
+        auto& call = *call_it;
+        const bool rename_from = matches_old_prefix(call.request.from);
+        const bool rename_to = matches_old_prefix(call.request.to);
+        if (!rename_from && !rename_to) {
+            continue;
+        }
+        call_index_.erase(call_key(call.request.from, call.request.to));
+        if (rename_from) {
             put_new_prefix(call.request.from);
         }
-        if (matches_old_prefix(call.request.to)) {
+        if (rename_to) {
             put_new_prefix(call.request.to);
         }
+        call_index_[call_key(call.request.from, call.request.to)] = call_it;
     }
 
     // dont know what we are supposed to do when entry point renaming fails... how can it fail?
@@ -176,6 +191,26 @@ bool megamol::core::MegaMolGraph::CreateCall(
     return add_call(CallInstantiationRequest{className, clean(from), clean(to)});
 }
 
+bool megamol::core::MegaMolGraph::CreateModules(std::vector<ModuleInstantiationRequest_t> const& requests) {
+    module_index_.reserve(module_index_.size() + requests.size());
+
+    bool all_ok = true;
+    for (auto const& request : requests) {
+        all_ok &= add_module(ModuleInstantiationRequest{request.className, clean(request.id)});
+    }
+    return all_ok;
+}
+
+bool megamol::core::MegaMolGraph::CreateCalls(std::vector<CallInstantiationRequest_t> const& requests) {
+    call_index_.reserve(call_index_.size() + requests.size());
+
+    bool all_ok = true;
+    for (auto const& request : requests) {
+        all_ok &= add_call(CallInstantiationRequest{request.className, clean(request.from), clean(request.to)});
+    }
+    return all_ok;
+}
+
 megamol::core::Module::ptr_type megamol::core::MegaMolGraph::FindModule(std::string const& module) const {
     auto moduleName = clean(module);
     auto module_it = find_module(moduleName);
@@ -228,7 +263,47 @@ bool megamol::core::MegaMolGraph::SetParameter(std::string const& paramName, std
     return true;
 }
 
+bool megamol::core::MegaMolGraph::SetParameters(std::vector<std::pair<std::string, std::string>> const& values) {
+    // resolve all parameters before changing any of them
+    std::vector<param::AbstractParam*> params;
+    params.reserve(values.size());
+    for (auto const& [name, value] : values) {
+        auto param_ptr = getParameterFromParamSlot(FindParameterSlot(name));
+        if (!param_ptr) {
+            log_error("error. could not set parameters, no parameter was changed");
+            return false;
+        }
+        params.push_back(param_ptr);
+    }
+
+    std::vector<std::string> old_values;
+    old_values.reserve(values.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        old_values.push_back(params[i]->ValueString());
+        if (!params[i]->ParseValue(values[i].second)) {
+            log_error("error. could not set parameter " + values[i].first + " to " + values[i].second +
+                      ", reverting the parameters set before");
+            for (size_t j = i; j-- > 0;) {
+                params[j]->ParseValue(old_values[j]);
+            }
+            return false;
+        }
+    }
+
+    // subscribers learn about all changes at once
+    return Broadcast_graph_subscribers_parameter_changes();
+}
+
 bool megamol::core::MegaMolGraph::Broadcast_graph_subscribers_parameter_changes() {
+    // a parameter may change several times between broadcasts, subscribers only need its current value once
+    const auto remove_duplicates = [](std::vector<core::param::AbstractParamSlot*>& queue) {
+        std::unordered_set<core::param::AbstractParamSlot*> seen;
+        queue.erase(std::remove_if(queue.begin(), queue.end(), [&](auto slot) { return !seen.insert(slot).second; }),
+            queue.end());
+    };
+    remove_duplicates(module_param_changes_queue);
+    remove_duplicates(module_param_presentation_changes_queue);
+
     for (auto& subscriber : graph_subscribers.subscribers) {
 
         for (auto changed_param_ptr : module_param_changes_queue) {
@@ -513,6 +588,8 @@ void megamol::core::MegaMolGraph::Clear() {
         delete_module(ModuleDeletionRequest_t{module.id});
     }
     module_list_.clear();
+    module_index_.clear();
+    call_index_.clear();
     graph_entry_points.clear();
     module_param_changes_queue.clear();
     module_param_presentation_changes_queue.clear();
@@ -524,47 +601,40 @@ void megamol::core::MegaMolGraph::Clear() {
 
 
 megamol::core::ModuleList_t::iterator megamol::core::MegaMolGraph::find_module(std::string const& name) {
-    auto it = std::find_if(this->module_list_.begin(), this->module_list_.end(),
-        [&name](megamol::core::ModuleInstance_t const& el) { return el.request.id == name; });
-
-    return it;
+    auto it = module_index_.find(name);
+    return it != module_index_.end() ? it->second : module_list_.end();
 }
 
 megamol::core::ModuleList_t::const_iterator megamol::core::MegaMolGraph::find_module(std::string const& name) const {
+    auto it = module_index_.find(name);
+    return it != module_index_.end() ? ModuleList_t::const_iterator(it->second) : module_list_.cend();
+}
 
-    auto it = std::find_if(this->module_list_.cbegin(), this->module_list_.cend(),
-        [&name](megamol::core::ModuleInstance_t const& el) { return el.request.id == name; });
-
-    return it;
+std::string megamol::core::MegaMolGraph::call_key(std::string const& from, std::string const& to) {
+    // Case-insensitive comparison in Module::FindSlot() during add_call
+    return utility::string::ToLowerAsciiCopy(from + "->" + to);
 }
 
 megamol::core::CallList_t::iterator megamol::core::MegaMolGraph::find_call(
     std::string const& from, std::string const& to) {
-    auto it =
-        std::find_if(this->call_list_.begin(), this->call_list_.end(), [&](megamol::core::CallInstance_t const& el) {
-            // Case-insensitive comparison in Module::FindSlot() during add_call
-            return utility::string::EqualAsciiCaseInsensitive(el.request.from, from) &&
-                   utility::string::EqualAsciiCaseInsensitive(el.request.to, to);
-        });
-
-    return it;
+    auto it = call_index_.find(call_key(from, to));
+    return it != call_index_.end() ? it->second : call_list_.end();
 }
 
 megamol::core::CallList_t::const_iterator megamol::core::MegaMolGraph::find_call(
     std::string const& from, std::string const& to) const {
-
-    auto it =
-        std::find_if(this->call_list_.cbegin(), this->call_list_.cend(), [&](megamol::core::CallInstance_t const& el) {
-            // Case-insensitive comparison in Module::FindSlot() during add_call
-            return utility::string::EqualAsciiCaseInsensitive(el.request.from, from) &&
-                   utility::string::EqualAsciiCaseInsensitive(el.request.to, to);
-        });
-
-    return it;
+    auto it = call_index_.find(call_key(from, to));
+    return it != call_index_.end() ? CallList_t::const_iterator(it->second) : call_list_.cend();
 }
 
 
 bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const& request) {
+    if (find_module(request.id) != module_list_.end()) {
+        log_error("error. could not create module " + request.className + ", a module named " + request.id +
+                  " already exists");
+        return false;
+    }
+
     factories::ModuleDescription::ptr module_description = this->ModuleProvider().Find(request.className.c_str());
     if (!module_description) {
         log_error("error. module factory could not find module class name: " + request.className);
@@ -601,6 +671,7 @@ bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const&
     }
 
     this->module_list_.push_front({module_ptr, request, false, module_resource_request, module_lifetime_dependencies});
+    module_index_[request.id] = module_list_.begin();
 
     module_ptr->setParent(this->dummy_namespace);
 
@@ -648,6 +719,7 @@ bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const&
     }
 
     if (!isCreateOk) {
+        module_index_.erase(request.id);
         this->module_list_.pop_front();
     }
 
@@ -765,6 +837,7 @@ bool megamol::core::MegaMolGraph::add_call(CallInstantiationRequest_t const& req
 
     log("create call: " + request.from + " -> " + request.to + " (" + std::string(call_description->ClassName()) + ")");
     this->call_list_.emplace_front(CallInstance_t{call, request});
+    call_index_[call_key(request.from, request.to)] = call_list_.begin();
 
     if (auto result = graph_subscribers.tell_all([&](auto& s) { return s.AddCall(this->call_list_.front()); });
         result.first == false) {
@@ -776,19 +849,6 @@ bool megamol::core::MegaMolGraph::add_call(CallInstantiationRequest_t const& req
     return true;
 }
 
-static std::list<megamol::core::CallList_t::iterator> find_all_of(
-    megamol::core::CallList_t list, std::function<bool(megamol::core::CallInstance_t const&)> const& func) {
-
-    std::list<megamol::core::CallList_t::iterator> result;
-
-    for (auto begin = list.begin(); begin != list.end(); begin++)
-        if (func(*begin))
-            result.push_back(begin);
-
-    return result;
-}
-
-
 bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& request) {
 
     auto module_it = find_module(request);
@@ -822,14 +882,17 @@ bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& r
     }
 
     // delete all outgoing/incoming calls
-    auto discard_calls = find_all_of(call_list_, [&](CallInstance_t const& call_info) {
-        return (call_info.request.from.find(request) != std::string::npos ||
-                call_info.request.to.find(request) != std::string::npos);
-    });
+    std::vector<CallDeletionRequest_t> discard_calls;
+    for (auto const& call_info : call_list_) {
+        if (call_info.request.from.find(request) != std::string::npos ||
+            call_info.request.to.find(request) != std::string::npos) {
+            discard_calls.push_back(CallDeletionRequest_t{call_info.request.from, call_info.request.to});
+        }
+    }
 
-    std::for_each(discard_calls.begin(), discard_calls.end(), [&](auto const& call_it) {
-        delete_call(CallDeletionRequest_t{call_it->request.from, call_it->request.to});
-    });
+    for (auto const& call : discard_calls) {
+        delete_call(call);
+    }
 
     if (module_it->isGraphEntryPoint) {
         if (auto result = graph_subscribers.tell_all([&](auto& s) { return s.DisableEntryPoint(*module_it); });
@@ -847,6 +910,7 @@ bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& r
     module_ptr->Release(module_it->lifetime_resources);
     log("release module: " + std::string(module_ptr->Name().PeekBuffer()));
 
+    module_index_.erase(module_it->request.id);
     this->module_list_.erase(module_it);
 
     return true;
@@ -883,30 +947,28 @@ bool megamol::core::MegaMolGraph::delete_call(CallDeletionRequest_t const& reque
     source->PerformCleanup();  // does nothing
     target->DisconnectCalls(); // does nothing
 
+    call_index_.erase(call_key(call_it->request.from, call_it->request.to));
     this->call_list_.erase(call_it);
 
     return true;
 }
 
-static const auto check_module_is_prefix = [](std::string const& request, auto const& module) {
-    const auto& module_name = module.request.id;
-    const auto substring = request.substr(0, module_name.size());
-    return (module_name == substring) &&         // module name is prefix of request
-           (request.size() == module_name.size() // module name matches whole request
-               || (request.size() >= module_name.size() + 2 &&
-                      request.substr(module_name.size(), 2) == "::")); // OR request has :: after module name
-};
-
-// find module where module name is prefix of request
+// find module where module name is prefix of request, i.e. matches the whole request or is followed by ::
+// the longest matching module name wins
 megamol::core::ModuleList_t::iterator megamol::core::MegaMolGraph::find_module_by_prefix(std::string const& request) {
-    return std::find_if(module_list_.begin(), module_list_.end(),
-        [&](auto const& module) { return check_module_is_prefix(request, module); });
+    auto prefix_end = request.size();
+    while (prefix_end != std::string::npos && prefix_end > 0) {
+        if (auto it = module_index_.find(request.substr(0, prefix_end)); it != module_index_.end()) {
+            return it->second;
+        }
+        prefix_end = request.rfind("::", prefix_end - 1);
+    }
+    return module_list_.end();
 }
 
 megamol::core::ModuleList_t::const_iterator megamol::core::MegaMolGraph::find_module_by_prefix(
     std::string const& request) const {
-    return std::find_if(module_list_.begin(), module_list_.end(),
-        [&](auto const& module) { return check_module_is_prefix(request, module); });
+    return const_cast<MegaMolGraph*>(this)->find_module_by_prefix(request);
 }
 
 void megamol::frontend_resources::MegaMolGraph_SubscriptionRegistry::subscribe(ModuleGraphSubscription subscriber) {
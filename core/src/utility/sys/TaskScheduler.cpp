@@ -0,0 +1,213 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "mmcore/utility/sys/TaskScheduler.h"
+
+#include <algorithm>
+#include <exception>
+
+#include <omp.h>
+#include <tbb/blocked_range.h>
+#include <tbb/info.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_observer.h>
+
+#include "mmcore/utility/log/Log.h"
+
+using megamol::core::utility::log::Log;
+
+namespace megamol::core::utility::sys {
+
+namespace {
+std::size_t configured_thread_count = 0;
+bool configured_numa_aware = true;
+std::atomic<bool> scheduler_created{false};
+
+// index of the arena the calling thread works in, -1 outside of the scheduler
+thread_local int current_node = -1;
+} // namespace
+
+class TaskScheduler::Observer : public tbb::task_scheduler_observer {
+public:
+    Observer(tbb::task_arena& arena, int node) : tbb::task_scheduler_observer(arena), node_(node) {
+        observe(true);
+    }
+
+    ~Observer() override {
+        observe(false);
+    }
+
+    void on_scheduler_entry(bool is_worker) override {
+        current_node = node_;
+        if (is_worker) {
+            // the cores are already busy with the other workers
+            omp_set_num_threads(1);
+        }
+    }
+
+    void on_scheduler_exit(bool) override {
+        current_node = -1;
+    }
+
+private:
+    int node_;
+};
+
+
+TaskScheduler::TaskGroup::TaskGroup() : arena_(TaskScheduler::Instance().arena()) {}
+
+TaskScheduler::TaskGroup::~TaskGroup() {
+    try {
+        Wait();
+    } catch (std::exception const& ex) {
+        Log::DefaultLog.WriteError("TaskScheduler: Task failed: %s", ex.what());
+    } catch (...) {
+        Log::DefaultLog.WriteError("TaskScheduler: Task failed with unknown exception");
+    }
+}
+
+void TaskScheduler::TaskGroup::Run(std::function<void()> task) {
+    ++pending_;
+    arena_.execute([&] {
+        group_.run([this, task = std::move(task)] {
+            try {
+                task();
+            } catch (...) {
+                // oneTBB cancels the tasks that have not started yet, they never finish
+                cancelled_ = true;
+                --pending_;
+                throw;
+            }
+            --pending_;
+        });
+    });
+}
+
+void TaskScheduler::TaskGroup::Wait() {
+    try {
+        arena_.execute([this] { group_.wait(); });
+    } catch (...) {
+        pending_ = 0;
+        cancelled_ = false;
+        throw;
+    }
+}
+
+
+void TaskScheduler::Configure(std::size_t thread_count, bool numa_aware) {
+    if (scheduler_created) {
+        Log::DefaultLog.WriteWarn("TaskScheduler: Already running, configuration is ignored");
+        return;
+    }
+    configured_thread_count = thread_count;
+    configured_numa_aware = numa_aware;
+}
+
+TaskScheduler& TaskScheduler::Instance() {
+    static TaskScheduler scheduler(configured_thread_count, configured_numa_aware);
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler(std::size_t thread_count, bool numa_aware) {
+    scheduler_created = true;
+    thread_count_ = thread_count > 0 ? thread_count : static_cast<std::size_t>(tbb::info::default_concurrency());
+    thread_limit_ = std::make_unique<tbb::global_control>(tbb::global_control::max_allowed_parallelism, thread_count_);
+
+    const auto nodes = numa_aware ? tbb::info::numa_nodes() : std::vector<tbb::numa_node_id>{};
+    if (nodes.size() > 1 && (thread_count == 0 || thread_count >= nodes.size())) {
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            // without a thread count, each node gets as many threads as it has cores
+            const int node_threads = thread_count == 0 ? tbb::task_arena::automatic
+                                                       : static_cast<int>(thread_count * (i + 1) / nodes.size() -
+                                                                          thread_count * i / nodes.size());
+            arenas_.push_back(std::make_unique<tbb::task_arena>(tbb::task_arena::constraints(nodes[i], node_threads)));
+        }
+    } else {
+        arenas_.push_back(std::make_unique<tbb::task_arena>(
+            thread_count == 0 ? tbb::task_arena::automatic : static_cast<int>(thread_count)));
+    }
+
+    for (std::size_t i = 0; i < arenas_.size(); ++i) {
+        arenas_[i]->initialize();
+        observers_.push_back(std::make_unique<Observer>(*arenas_[i], static_cast<int>(i)));
+    }
+
+    Log::DefaultLog.WriteInfo("TaskScheduler: %zu threads on %zu NUMA node(s)", thread_count_, arenas_.size());
+}
+
+TaskScheduler::~TaskScheduler() = default;
+
+void TaskScheduler::Enqueue(std::function<void()> task) {
+    arena().enqueue([task = std::move(task)] {
+        try {
+            task();
+        } catch (std::exception const& ex) {
+            Log::DefaultLog.WriteError("TaskScheduler: Task failed: %s", ex.what());
+        } catch (...) {
+            Log::DefaultLog.WriteError("TaskScheduler: Task failed with unknown exception");
+        }
+    });
+}
+
+void TaskScheduler::ParallelFor(std::size_t begin, std::size_t end,
+    std::function<void(std::size_t, std::size_t)> const& body, std::size_t grain) {
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t count = end - begin;
+
+    // the OpenMP team of the calling thread already occupies the cores
+    if (count <= grain || omp_in_parallel()) {
+        body(begin, end);
+        return;
+    }
+
+    const auto run_range = [&](std::size_t range_begin, std::size_t range_end) {
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(range_begin, range_end, grain),
+            [&](tbb::blocked_range<std::size_t> const& range) { body(range.begin(), range.end()); });
+    };
+
+    // nested loops stay on the node of the calling task
+    if (current_node >= 0 || arenas_.size() == 1) {
+        arena().execute([&] { run_range(begin, end); });
+        return;
+    }
+
+    // one contiguous part per node, so that neighbouring iterations share the memory of their node
+    const std::size_t parts = std::min(arenas_.size(), (count + grain - 1) / grain);
+    std::vector<tbb::task_group> groups(parts);
+    for (std::size_t i = 0; i < parts; ++i) {
+        const std::size_t part_begin = begin + count * i / parts;
+        const std::size_t part_end = begin + count * (i + 1) / parts;
+        arenas_[i]->execute([&, i, part_begin, part_end] {
+            groups[i].run([&run_range, part_begin, part_end] { run_range(part_begin, part_end); });
+        });
+    }
+
+    std::exception_ptr error;
+    for (std::size_t i = 0; i < parts; ++i) {
+        try {
+            arenas_[i]->execute([&groups, i] { groups[i].wait(); });
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+tbb::task_arena& TaskScheduler::arena() {
+    if (current_node >= 0 && static_cast<std::size_t>(current_node) < arenas_.size()) {
+        return *arenas_[current_node];
+    }
+    return *arenas_[next_arena_++ % arenas_.size()];
+}
+
+} // namespace megamol::core::utility::sys
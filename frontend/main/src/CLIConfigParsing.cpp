@@ -123,6 +123,13 @@ static std::string profile_log_option = "profiling-log";
 static std::string flush_frequency_option = "flush-frequency";
 static std::string profile_log_no_autostart_option = "pause-profiling";
 static std::string profile_log_include_events_option = "profiling-include-events";
+static std::string benchmark_option = "benchmark";
+static std::string benchmark_warmup_option = "benchmark-warmup";
+static std::string benchmark_frames_option = "benchmark-frames";
+static std::string benchmark_keyframes_option = "benchmark-keyframes";
+static std::string benchmark_view_option = "benchmark-view";
+static std::string lazy_plugins_option = "lazy-plugins";
+static std::string task_threads_option = "task-threads";
 static std::string param_option = "param";
 static std::string remote_head_option = "headnode";
 static std::string remote_render_option = "rendernode";
@@ -198,6 +205,42 @@ static void profile_log_include_events_handler(
     config.include_graph_events = parsed_options[option_name].as<bool>();
 }
 
+static void benchmark_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    config.benchmark_output_file = parsed_options[option_name].as<std::string>();
+}
+
+static void benchmark_warmup_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    config.benchmark_warmup_frames = parsed_options[option_name].as<uint32_t>();
+}
+
+static void benchmark_frames_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    config.benchmark_frames = parsed_options[option_name].as<uint32_t>();
+}
+
+static void benchmark_keyframes_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    files_exist({parsed_options[option_name].as<std::string>()}, "Keyframe file");
+    config.benchmark_camera_keyframes = parsed_options[option_name].as<std::string>();
+}
+
+static void benchmark_view_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    config.benchmark_view = parsed_options[option_name].as<std::string>();
+}
+
+static void lazy_plugins_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    config.plugin_manifest_file = parsed_options[option_name].as<std::string>();
+}
+
+static void task_threads_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    config.task_threads = parsed_options[option_name].as<uint32_t>();
+}
+
 static void remote_head_handler(
     std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
     config.remote_headnode = parsed_options[option_name].as<bool>();
@@ -581,6 +624,25 @@ std::vector<OptionsListEntry> cli_options_list =
 
 #endif
         ,
+        {benchmark_option,
+            "Run a benchmark, write frame time statistics to this JSON file and quit. "
+            "Combine with --nogl or --hidden for headless runs",
+            cxxopts::value<std::string>(), benchmark_handler},
+        {benchmark_warmup_option, "Number of frames rendered before the benchmark measures, default: 10",
+            cxxopts::value<uint32_t>(), benchmark_warmup_handler},
+        {benchmark_frames_option, "Number of frames the benchmark measures, default: 100", cxxopts::value<uint32_t>(),
+            benchmark_frames_handler},
+        {benchmark_keyframes_option, "Cinematic keyframe file, the camera follows its keyframes during the benchmark",
+            cxxopts::value<std::string>(), benchmark_keyframes_handler},
+        {benchmark_view_option, "View that follows the benchmark keyframes, default: first view entry point",
+            cxxopts::value<std::string>(), benchmark_view_handler},
+        {lazy_plugins_option,
+            "Load plugins when a project uses their classes, as listed in this manifest file. "
+            "The manifest is written if missing or outdated",
+            cxxopts::value<std::string>(), lazy_plugins_handler},
+        {task_threads_option,
+            "Number of threads of the task scheduler shared by all modules, default: all hardware threads",
+            cxxopts::value<uint32_t>(), task_threads_handler},
         {param_option, "Set MegaMol Graph parameter to value: --param param=value",
             cxxopts::value<std::vector<std::string>>(), param_handler},
         {remote_head_option, "Start HeadNode server and run Remote_Service test ", cxxopts::value<bool>(),
@@ -0,0 +1,202 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "PluginLoader.h"
+
+#include <chrono>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+#include "mmcore/factories/PluginRegister.h"
+#include "mmcore/utility/String.h"
+#include "mmcore/utility/buildinfo/BuildInfo.h"
+#include "mmcore/utility/log/Log.h"
+#include "vislib/Exception.h"
+
+using megamol::core::utility::log::Log;
+
+namespace megamol::frontend {
+
+PluginLoader::PluginLoader(frontend_resources::PluginsResource& plugins_resource)
+        : plugins_resource_(plugins_resource)
+        , loaded_(core::factories::PluginRegister::size(), false)
+        , instances_(core::factories::PluginRegister::size()) {}
+
+PluginLoader::~PluginLoader() {
+    plugins_resource_.all_module_descriptions.SetMissingHandler(nullptr);
+    plugins_resource_.all_call_descriptions.SetMissingHandler(nullptr);
+}
+
+void PluginLoader::LoadAll() {
+    all_loaded_ = true;
+    for (size_t i = 0; i < loaded_.size(); ++i) {
+        load(i);
+    }
+}
+
+void PluginLoader::LoadLazy(std::filesystem::path const& manifest_file) {
+    manifest_file_ = manifest_file;
+
+    if (!read_manifest()) {
+        Log::DefaultLog.WriteInfo("Plugin manifest \"%s\" is missing or outdated, loading all plugins",
+            manifest_file_.generic_u8string().c_str());
+        LoadAll();
+        write_manifest();
+        return;
+    }
+
+    plugins_resource_.all_module_descriptions.SetMissingHandler(
+        [&](std::string const& class_name) { return load_class(module_plugins_, class_name); });
+    plugins_resource_.all_call_descriptions.SetMissingHandler(
+        [&](std::string const& class_name) { return load_class(call_plugins_, class_name); });
+    Log::DefaultLog.WriteInfo("Plugins are loaded on demand, as listed in \"%s\"",
+        manifest_file_.generic_u8string().c_str());
+}
+
+bool PluginLoader::load(size_t index) {
+    if (loaded_[index]) {
+        return true;
+    }
+    loaded_[index] = true;
+
+    try {
+        const auto start = std::chrono::steady_clock::now();
+        auto new_plugin = core::factories::PluginRegister::get(index)->create();
+        plugins_resource_.plugins.push_back(new_plugin);
+        instances_[index] = new_plugin;
+
+        for (auto const& md : new_plugin->GetModuleDescriptionManager()) {
+            try {
+                plugins_resource_.all_module_descriptions.Register(md);
+            } catch (std::invalid_argument const&) {
+                Log::DefaultLog.WriteError(
+                    "Failed to load module description \"%s\": Naming conflict", md->ClassName());
+            }
+        }
+        for (auto const& cd : new_plugin->GetCallDescriptionManager()) {
+            try {
+                plugins_resource_.all_call_descriptions.Register(cd);
+            } catch (std::invalid_argument const&) {
+                Log::DefaultLog.WriteError("Failed to load call description \"%s\": Naming conflict", cd->ClassName());
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        plugins_resource_.load_times.push_back({new_plugin->GetObjectFactoryName(), start, end});
+
+        // report success
+        Log::DefaultLog.WriteInfo("Plugin \"%s\" loaded: %u Modules, %u Calls (%.3f ms)",
+            new_plugin->GetObjectFactoryName().c_str(), new_plugin->GetModuleDescriptionManager().Count(),
+            new_plugin->GetCallDescriptionManager().Count(),
+            std::chrono::duration<double, std::milli>(end - start).count());
+
+        if (!all_loaded_ && index < manifest_names_.size() &&
+            manifest_names_[index] != new_plugin->GetObjectFactoryName()) {
+            Log::DefaultLog.WriteWarn("Plugin manifest \"%s\" does not match the registered plugins, loading all",
+                manifest_file_.generic_u8string().c_str());
+            manifest_names_.clear();
+            LoadAll();
+            write_manifest();
+        }
+        return true;
+    } catch (vislib::Exception const& vex) {
+        Log::DefaultLog.WriteError("Unable to load Plugin: %s (%s, %d)", vex.GetMsgA(), vex.GetFile(), vex.GetLine());
+    } catch (std::exception const& ex) {
+        Log::DefaultLog.WriteError("Unable to load Plugin: %s", ex.what());
+    } catch (...) {
+        Log::DefaultLog.WriteError("Unable to load Plugin: unknown exception");
+    }
+    return false;
+}
+
+bool PluginLoader::load_class(
+    std::unordered_map<std::string, size_t> const& class_plugins, std::string const& class_name) {
+    if (all_loaded_) {
+        return false;
+    }
+    if (auto it = class_plugins.find(core::utility::string::ToLowerAsciiCopy(class_name)); it != class_plugins.end()) {
+        return load(it->second);
+    }
+
+    // unknown classes are either misspelled or the manifest is outdated, which only the plugins can tell
+    LoadAll();
+    if (plugins_resource_.all_module_descriptions.Find(class_name.c_str()) != nullptr ||
+        plugins_resource_.all_call_descriptions.Find(class_name.c_str()) != nullptr) {
+        Log::DefaultLog.WriteWarn(
+            "Plugin manifest \"%s\" lacks class \"%s\"", manifest_file_.generic_u8string().c_str(), class_name.c_str());
+        write_manifest();
+    }
+    return true;
+}
+
+bool PluginLoader::read_manifest() {
+    std::ifstream file(manifest_file_);
+    if (!file) {
+        return false;
+    }
+
+    try {
+        const auto manifest = nlohmann::json::parse(file);
+        const auto& plugins = manifest.at("plugins");
+        if (manifest.at("version").get<std::string>() != core::utility::buildinfo::MEGAMOL_GIT_HASH() ||
+            plugins.size() != loaded_.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            manifest_names_.push_back(plugins[i].at("name").get<std::string>());
+            for (auto const& name : plugins[i].at("modules")) {
+                module_plugins_.emplace(core::utility::string::ToLowerAsciiCopy(name.get<std::string>()), i);
+            }
+            for (auto const& name : plugins[i].at("calls")) {
+                call_plugins_.emplace(core::utility::string::ToLowerAsciiCopy(name.get<std::string>()), i);
+            }
+        }
+    } catch (nlohmann::json::exception const& ex) {
+        Log::DefaultLog.WriteWarn(
+            "Could not read plugin manifest \"%s\": %s", manifest_file_.generic_u8string().c_str(), ex.what());
+        manifest_names_.clear();
+        module_plugins_.clear();
+        call_plugins_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool PluginLoader::write_manifest() const {
+    // plugins are identified by their index in the register, which is fixed for a build
+    nlohmann::json plugins = nlohmann::json::array();
+    for (auto const& plugin : instances_) {
+        nlohmann::json entry;
+        entry["name"] = plugin ? plugin->GetObjectFactoryName() : "";
+        entry["modules"] = nlohmann::json::array();
+        entry["calls"] = nlohmann::json::array();
+        if (plugin) {
+            for (auto const& md : plugin->GetModuleDescriptionManager()) {
+                entry["modules"].push_back(md->ClassName());
+            }
+            for (auto const& cd : plugin->GetCallDescriptionManager()) {
+                entry["calls"].push_back(cd->ClassName());
+            }
+        }
+        plugins.push_back(entry);
+    }
+
+    nlohmann::json manifest;
+    manifest["version"] = core::utility::buildinfo::MEGAMOL_GIT_HASH();
+    manifest["plugins"] = plugins;
+
+    std::ofstream file(manifest_file_);
+    file << manifest.dump(2) << "\n";
+    if (!file) {
+        Log::DefaultLog.WriteWarn("Could not write plugin manifest \"%s\"", manifest_file_.generic_u8string().c_str());
+        return false;
+    }
+    Log::DefaultLog.WriteInfo("Wrote plugin manifest \"%s\"", manifest_file_.generic_u8string().c_str());
+    return true;
+}
+
+} // namespace megamol::frontend
@@ -0,0 +1,63 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PluginsResource.h"
+
+namespace megamol::frontend {
+
+/**
+ * Creates the plugins of the PluginRegister and registers their module and call descriptions in the PluginsResource.
+ *
+ * With lazy loading, a plugin is created when one of its classes is looked up for the first time. The classes of each
+ * plugin are taken from a manifest file. If the manifest is missing or was written by another build, all plugins are
+ * loaded and the manifest is written anew.
+ */
+class PluginLoader {
+public:
+    explicit PluginLoader(frontend_resources::PluginsResource& plugins_resource);
+    ~PluginLoader();
+
+    PluginLoader(const PluginLoader&) = delete;
+    PluginLoader& operator=(const PluginLoader&) = delete;
+
+    /** Loads all plugins that have not been loaded yet. */
+    void LoadAll();
+
+    /**
+     * Loads plugins on demand, as listed in the manifest file.
+     *
+     * @param manifest_file The manifest, it is (re)written if it does not match the registered plugins.
+     */
+    void LoadLazy(std::filesystem::path const& manifest_file);
+
+private:
+    bool load(size_t index);
+    bool load_class(std::unordered_map<std::string, size_t> const& class_plugins, std::string const& class_name);
+    bool read_manifest();
+    bool write_manifest() const;
+
+    frontend_resources::PluginsResource& plugins_resource_;
+    std::filesystem::path manifest_file_;
+
+    // set once all plugins are loaded, which makes the lookup handlers do nothing
+    bool all_loaded_ = false;
+    std::vector<bool> loaded_;
+    std::vector<core::factories::AbstractPluginInstance::ptr_type> instances_;
+    // plugin names by register index, as listed in the manifest
+    std::vector<std::string> manifest_names_;
+    // register index of the plugin providing a class, by lower case class name
+    std::unordered_map<std::string, size_t> module_plugins_;
+    std::unordered_map<std::string, size_t> call_plugins_;
+};
+
+} // namespace megamol::frontend
@@ -4,6 +4,7 @@
  * All rights reserved.
  */
 
+#include "Benchmark_Service.hpp"
 #include "CLIConfigParsing.h"
 #include "CUDA_Service.hpp"
 #include "Command_Service.hpp"
@@ -14,6 +15,7 @@
 #include "ImagePresentation_Service.hpp"
 #include "Lua_Service_Wrapper.hpp"
 #include "OpenGL_GLFW_Service.hpp"
+#include "PluginLoader.h"
 #include "PluginsResource.h"
 #include "Profiling_Service.hpp"
 #include "ProjectLoader_Service.hpp"
@@ -23,8 +25,8 @@
 #include "VR_Service.hpp"
 #include "mmcore/LuaAPI.h"
 #include "mmcore/MegaMolGraph.h"
-#include "mmcore/factories/PluginRegister.h"
 #include "mmcore/utility/log/Log.h"
+#include "mmcore/utility/sys/TaskScheduler.h"
 
 #ifdef MEGAMOL_USE_TRACY
 #include <tracy/Tracy.hpp>
@@ -48,8 +50,6 @@ static void log_error(std::string const& text) {
     Log::DefaultLog.WriteError(msg.c_str());
 }
 
-void loadPlugins(megamol::frontend_resources::PluginsResource& pluginsRes);
-
 int main(const int argc, const char** argv) {
 #ifdef MEGAMOL_USE_TRACY
     ZoneScoped;
@@ -69,6 +69,8 @@ int main(const int argc, const char** argv) {
     log(config.as_string());
     log(global_value_store.as_string());
 
+    megamol::core::utility::sys::TaskScheduler::Configure(config.task_threads);
+
     megamol::frontend::OpenGL_GLFW_Service gl_service;
     megamol::frontend::OpenGL_GLFW_Service::Config openglConfig;
     openglConfig.windowTitlePrefix = "MegaMol";
@@ -173,6 +175,16 @@ int main(const int argc, const char** argv) {
     profiling_config.autostart_profiling = config.autostart_profiling;
     profiling_config.include_graph_events = config.include_graph_events;
 
+    megamol::frontend::Benchmark_Service benchmark_service;
+    megamol::frontend::Benchmark_Service::Config benchmarkConfig;
+    benchmarkConfig.output_file = config.benchmark_output_file;
+    benchmarkConfig.warmup_frames = config.benchmark_warmup_frames;
+    benchmarkConfig.frames = config.benchmark_frames;
+    benchmarkConfig.camera_keyframes_file = config.benchmark_camera_keyframes;
+    benchmarkConfig.view = config.benchmark_view;
+    benchmarkConfig.project_files = config.project_files;
+    const bool with_benchmark = !config.benchmark_output_file.empty();
+
 #ifdef MM_CUDA_ENABLED
     megamol::frontend::CUDA_Service cuda_service;
     cuda_service.setPriority(24);
@@ -210,6 +222,10 @@ int main(const int argc, const char** argv) {
 
     services.add(profiling_service, &profiling_config);
 
+    if (with_benchmark) {
+        services.add(benchmark_service, &benchmarkConfig);
+    }
+
 #ifdef MM_CUDA_ENABLED
     services.add(cuda_service, nullptr);
 #endif
@@ -232,7 +248,12 @@ int main(const int argc, const char** argv) {
     }
 
     megamol::frontend_resources::PluginsResource pluginsRes;
-    loadPlugins(pluginsRes);
+    megamol::frontend::PluginLoader plugin_loader(pluginsRes);
+    if (config.plugin_manifest_file.empty()) {
+        plugin_loader.LoadAll();
+    } else {
+        plugin_loader.LoadLazy(config.plugin_manifest_file);
+    }
     services.getProvidedResources().push_back({"PluginsResource", pluginsRes});
 
     megamol::core::MegaMolGraph graph(pluginsRes.all_module_descriptions, pluginsRes.all_call_descriptions);
@@ -362,42 +383,3 @@ int main(const int argc, const char** argv) {
 
     return ret;
 }
-
-void loadPlugins(megamol::frontend_resources::PluginsResource& pluginsRes) {
-    for (auto const& pluginDesc : megamol::core::factories::PluginRegister::getAll()) {
-        try {
-            auto new_plugin = pluginDesc->create();
-            pluginsRes.plugins.push_back(new_plugin);
-
-            // report success
-            Log::DefaultLog.WriteInfo("Plugin \"%s\" loaded: %u Modules, %u Calls",
-                new_plugin->GetObjectFactoryName().c_str(), new_plugin->GetModuleDescriptionManager().Count(),
-                new_plugin->GetCallDescriptionManager().Count());
-
-            for (auto const& md : new_plugin->GetModuleDescriptionManager()) {
-                try {
-                    pluginsRes.all_module_descriptions.Register(md);
-                } catch (std::invalid_argument const&) {
-                    Log::DefaultLog.WriteError(
-                        "Failed to load module description \"%s\": Naming conflict", md->ClassName());
-                }
-            }
-            for (auto const& cd : new_plugin->GetCallDescriptionManager()) {
-                try {
-                    pluginsRes.all_call_descriptions.Register(cd);
-                } catch (std::invalid_argument const&) {
-                    Log::DefaultLog.WriteError(
-                        "Failed to load call description \"%s\": Naming conflict", cd->ClassName());
-                }
-            }
-
-        } catch (vislib::Exception const& vex) {
-            Log::DefaultLog.WriteError(
-                "Unable to load Plugin: %s (%s, &d)", vex.GetMsgA(), vex.GetFile(), vex.GetLine());
-        } catch (std::exception const& ex) {
-            Log::DefaultLog.WriteError("Unable to load Plugin: %s", ex.what());
-        } catch (...) {
-            Log::DefaultLog.WriteError("Unable to load Plugin: unknown exception");
-        }
-    }
-}
@@ -11,8 +11,10 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -49,6 +51,7 @@ public:
     using frame_type = uint32_t;
     using user_index_type = uint32_t;
     using time_point = std::chrono::steady_clock::time_point;
+    using pool_handle = uint32_t;
 
     enum class query_api { CPU, OPENGL }; // TODO: CUDA, OpenCL, Vulkan, whatnot
 
@@ -99,6 +102,8 @@ public:
         PerformanceManager::parent_type parent_type = parent_type::BUILTIN;
         time_point start, end, duration;
         int64_t global_index;
+        // changes whenever the comment of the timer changes
+        uint32_t comment_version = 0;
     };
 
     struct timer_region {
@@ -112,6 +117,16 @@ public:
     };
     using update_callback = std::function<void(const frame_info&)>;
 
+    struct memory_pool_info {
+        pool_handle handle = 0;
+        // full name of the owning module
+        std::string parent;
+        std::string name;
+        size_t current_bytes = 0;
+        size_t peak_bytes = 0;
+    };
+    using memory_callback = std::function<void(const memory_pool_info&)>;
+
     class Itimer {
         friend class PerformanceManager;
 
@@ -142,7 +157,10 @@ public:
         }
 
         void set_comment(std::string comment) {
-            conf.comment = comment;
+            if (conf.comment != comment) {
+                conf.comment = comment;
+                comment_version++;
+            }
         }
 
     protected:
@@ -157,6 +175,7 @@ public:
         //time_point last_start;
         std::vector<timer_region> regions;
         bool started = false;
+        uint32_t comment_version = 0;
         frame_type start_frame = std::numeric_limits<frame_type>::max();
         handle_type h = 0;
     };
@@ -236,11 +255,40 @@ public:
     void start_timer(handle_type h);
     void stop_timer(handle_type h);
 
+    // memory accounting: modules report the size of their caches and buffers into named pools.
+    // unlike the timers, these functions can be called from any thread.
+    pool_handle add_memory_pool(megamol::core::Module* m, std::string name);
+
+    void remove_memory_pool(pool_handle h);
+
+    void set_memory_usage(pool_handle h, size_t bytes);
+
+    std::vector<memory_pool_info> get_memory_pools() const;
+
+    // visits the pools whose usage changed since the last visit
+    void visit_changed_memory_pools(const memory_callback& cb);
+
+    // warns when the pools of a module together exceed the budget, 0 removes the budget
+    void set_memory_budget(const std::string& parent, size_t bytes);
+
+    size_t get_memory_budget(const std::string& parent) const;
+
 private:
     friend class frontend::Profiling_Service;
 
     handle_type add_timer(std::unique_ptr<Itimer> t);
 
+    struct memory_pool {
+        std::string parent;
+        std::string name;
+        size_t current = 0;
+        size_t peak = 0;
+        bool changed = true;
+    };
+
+    // expects memory_mutex to be held
+    void check_memory_budget(const std::string& parent);
+
     void startFrame(frame_type frame);
 
     void endFrame();
@@ -253,6 +301,12 @@ private:
     inline static int64_t current_global_index = 0;
     std::vector<update_callback> subscribers;
 
+    mutable std::mutex memory_mutex;
+    pool_handle next_pool = 0;
+    std::unordered_map<pool_handle, memory_pool> memory_pools;
+    std::unordered_map<std::string, size_t> memory_budgets;
+    std::unordered_set<std::string> over_budget;
+
 #ifdef MEGAMOL_USE_OPENGL
     handle_type whole_frame_gl;
 #endif
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <string>
 #include <vector>
 
 #include "mmcore/factories/AbstractPluginInstance.h"
@@ -15,8 +17,18 @@
 namespace megamol::frontend_resources {
 
 struct PluginsResource {
+    struct PluginLoadTime {
+        std::string name;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+    };
+
     std::vector<core::factories::AbstractPluginInstance::ptr_type> plugins;
 
+    // time spent creating each plugin and registering its classes, in order of loading.
+    // with lazy plugin loading, plugins are loaded while the program is running.
+    std::vector<PluginLoadTime> load_times;
+
     core::factories::CallDescriptionManager all_call_descriptions;
 
     core::factories::ModuleDescriptionManager all_module_descriptions;
@@ -82,6 +82,13 @@ struct RuntimeConfig {
     uint32_t flush_frequency = 1000;
     bool autostart_profiling = true;
     bool include_graph_events = false;
+    std::string benchmark_output_file;
+    uint32_t benchmark_warmup_frames = 10;
+    uint32_t benchmark_frames = 100;
+    std::string benchmark_camera_keyframes;
+    std::string benchmark_view;
+    std::string plugin_manifest_file; // plugins are loaded on demand if set
+    uint32_t task_threads = 0;        // 0: all hardware threads
 
     struct Tile {
         UintPair global_framebuffer_resolution; // e.g. whole powerwall resolution, needed for tiling
@@ -0,0 +1,298 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "Benchmark_Service.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+#include "mmcore/MegaMolGraph.h"
+#include "mmcore/utility/buildinfo/BuildInfo.h"
+#include "mmcore/utility/log/Log.h"
+#include "mmcore/view/AbstractViewInterface.h"
+#include "mmcore/view/CameraSerializer.h"
+
+static void log(std::string const& text) {
+    const std::string msg = "Benchmark_Service: " + text;
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo(msg.c_str());
+}
+
+static void log_error(std::string const& text) {
+    const std::string msg = "Benchmark_Service: " + text;
+    megamol::core::utility::log::Log::DefaultLog.WriteError(msg.c_str());
+}
+
+namespace megamol::frontend {
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double elapsed_cpu_ms(std::clock_t start, std::clock_t end) {
+    return 1000.0 * static_cast<double>(end - start) / CLOCKS_PER_SEC;
+}
+
+// nearest-rank percentile of sorted samples
+double percentile(std::vector<double> const& sorted, double p) {
+    const auto rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+nlohmann::json summarize(std::vector<double> samples) {
+    nlohmann::json stats;
+    stats["count"] = samples.size();
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (const auto s : samples) {
+        sum += s;
+    }
+    const auto mean = sum / static_cast<double>(samples.size());
+    double square_sum = 0.0;
+    for (const auto s : samples) {
+        square_sum += (s - mean) * (s - mean);
+    }
+
+    stats["min"] = samples.front();
+    stats["max"] = samples.back();
+    stats["mean"] = mean;
+    stats["stddev"] = std::sqrt(square_sum / static_cast<double>(samples.size()));
+    stats["p50"] = percentile(samples, 50.0);
+    stats["p90"] = percentile(samples, 90.0);
+    stats["p95"] = percentile(samples, 95.0);
+    stats["p99"] = percentile(samples, 99.0);
+    return stats;
+}
+
+} // namespace
+
+bool Benchmark_Service::init(void* configPtr) {
+    if (configPtr == nullptr) {
+        return false;
+    }
+    config = *static_cast<Config*>(configPtr);
+
+    _requestedResourcesNames = {frontend_resources::MegaMolGraph_Req_Name};
+#ifdef MEGAMOL_USE_PROFILING
+    _requestedResourcesNames.push_back(frontend_resources::PerformanceManager_Req_Name);
+#endif
+
+    if (!config.camera_keyframes_file.empty() && !load_camera_keyframes()) {
+        return false;
+    }
+
+    frame_wall_ms.reserve(config.frames);
+    frame_cpu_ms.reserve(config.frames);
+
+    log("measuring " + std::to_string(config.frames) + " frames after " + std::to_string(config.warmup_frames) +
+        " warmup frames");
+    return true;
+}
+
+void Benchmark_Service::close() {
+    if (current_state != state::DONE) {
+        log_error("shut down before the benchmark finished, no report written");
+    }
+}
+
+void Benchmark_Service::setRequestedResources(std::vector<FrontendResource> resources) {
+    _requestedResourcesReferences = resources;
+
+#ifdef MEGAMOL_USE_PROFILING
+    auto& perf_manager = const_cast<frontend_resources::PerformanceManager&>(
+        _requestedResourcesReferences[1].getResource<frontend_resources::PerformanceManager>());
+
+    perf_manager.subscribe_to_updates([&](const frontend_resources::PerformanceManager::frame_info& fi) {
+        if (current_state != state::MEASURING) {
+            return;
+        }
+
+        // a region can be entered several times per frame, we report the time per frame
+        std::vector<std::pair<size_t, double>> frame_regions;
+        for (auto const& e : fi.entries) {
+            auto it = region_by_handle.find(e.handle);
+            const auto parent = perf_manager.lookup_parent_pointer(e.handle);
+            if (it == region_by_handle.end() || regions[it->second].parent != parent) {
+                const auto name = perf_manager.lookup_parent(e.handle) + "::" + perf_manager.lookup_name(e.handle) +
+                                  " (" + frontend_resources::PerformanceManager::query_api_string(e.api) + ")";
+                auto [named, inserted] = region_by_name.emplace(name, regions.size());
+                if (inserted) {
+                    regions.push_back({name, parent});
+                }
+                it = region_by_handle.insert_or_assign(e.handle, named->second).first;
+            }
+
+            const auto ms = elapsed_ms(e.start, e.end);
+            auto region = std::find_if(frame_regions.begin(), frame_regions.end(),
+                [&](auto const& r) { return r.first == it->second; });
+            if (region == frame_regions.end()) {
+                frame_regions.emplace_back(it->second, ms);
+            } else {
+                region->second += ms;
+            }
+            ++regions[it->second].calls;
+        }
+        for (auto const& [index, ms] : frame_regions) {
+            regions[index].frame_ms.push_back(ms);
+        }
+    });
+#endif
+}
+
+void Benchmark_Service::updateProvidedResources() {
+    if (current_state == state::DONE) {
+        return;
+    }
+
+    if (current_state == state::WARMUP && frame >= config.warmup_frames) {
+        current_state = state::MEASURING;
+        measure_start = std::chrono::steady_clock::now();
+        measure_cpu_start = std::clock();
+        if (!camera_keyframes.empty()) {
+            view = find_view();
+        }
+    }
+
+    if (current_state == state::MEASURING && frame >= config.warmup_frames + config.frames) {
+        total_wall_ms = elapsed_ms(measure_start, std::chrono::steady_clock::now());
+        total_cpu_ms = elapsed_cpu_ms(measure_cpu_start, std::clock());
+        current_state = state::DONE;
+        if (write_report()) {
+            log("wrote report to " + config.output_file);
+        }
+        // the frame is not rendered, we shut down right after the digest
+        this->setShutdown();
+        return;
+    }
+
+    frame_start = std::chrono::steady_clock::now();
+    frame_cpu_start = std::clock();
+}
+
+void Benchmark_Service::digestChangedRequestedResources() {
+    if (current_state != state::MEASURING || view == nullptr) {
+        return;
+    }
+    // traverse the keyframes once during the measurement
+    const auto measured = frame - config.warmup_frames;
+    const auto keyframe = static_cast<size_t>(measured) * camera_keyframes.size() / std::max(config.frames, 1u);
+    view->SetCamera(camera_keyframes[std::min(keyframe, camera_keyframes.size() - 1)]);
+}
+
+void Benchmark_Service::resetProvidedResources() {
+    if (current_state == state::DONE) {
+        return;
+    }
+    if (current_state == state::MEASURING) {
+        frame_wall_ms.push_back(elapsed_ms(frame_start, std::chrono::steady_clock::now()));
+        frame_cpu_ms.push_back(elapsed_cpu_ms(frame_cpu_start, std::clock()));
+    }
+    ++frame;
+}
+
+bool Benchmark_Service::load_camera_keyframes() {
+    std::ifstream file(config.camera_keyframes_file);
+    if (!file) {
+        log_error("could not open keyframe file " + config.camera_keyframes_file);
+        return false;
+    }
+
+    try {
+        const auto json = nlohmann::json::parse(file);
+        const auto keyframes = json.at("keyframes");
+
+        // keyframes are stored with their animation time, which orders them along the path
+        std::vector<std::pair<float, core::view::Camera>> path;
+        core::view::CameraSerializer serializer;
+        for (auto const& kf : keyframes) {
+            core::view::Camera cam;
+            if (!serializer.deserialize(cam, kf.at("camera_state").dump())) {
+                log_error("invalid camera in keyframe file " + config.camera_keyframes_file);
+                return false;
+            }
+            path.emplace_back(kf.value("animation_time", 0.0f), cam);
+        }
+        std::stable_sort(path.begin(), path.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+
+        camera_keyframes.clear();
+        for (auto const& [time, cam] : path) {
+            camera_keyframes.push_back(cam);
+        }
+    } catch (nlohmann::json::exception const& e) {
+        log_error("could not read keyframe file " + config.camera_keyframes_file + ": " + e.what());
+        return false;
+    }
+
+    if (camera_keyframes.empty()) {
+        log_error("keyframe file " + config.camera_keyframes_file + " contains no keyframes");
+        return false;
+    }
+    log("camera follows " + std::to_string(camera_keyframes.size()) + " keyframes");
+    return true;
+}
+
+std::shared_ptr<core::view::AbstractViewInterface> Benchmark_Service::find_view() const {
+    auto const& graph = _requestedResourcesReferences[0].getResource<core::MegaMolGraph>();
+
+    if (!config.view.empty()) {
+        auto view = std::dynamic_pointer_cast<core::view::AbstractViewInterface>(graph.FindModule(config.view));
+        if (!view) {
+            log_error(config.view + " is not a view, the camera path is ignored");
+        }
+        return view;
+    }
+
+    for (auto const& module : graph.ListModules()) {
+        if (module.isGraphEntryPoint) {
+            if (auto view = std::dynamic_pointer_cast<core::view::AbstractViewInterface>(module.modulePtr)) {
+                return view;
+            }
+        }
+    }
+    log_error("found no view entry point, the camera path is ignored");
+    return nullptr;
+}
+
+bool Benchmark_Service::write_report() const {
+    nlohmann::json report;
+    report["version"] = core::utility::buildinfo::MEGAMOL_GIT_HASH();
+    report["project_files"] = config.project_files;
+    report["warmup_frames"] = config.warmup_frames;
+    report["frames"] = frame_wall_ms.size();
+    report["camera_keyframes"] = config.camera_keyframes_file;
+    report["wall_time_ms"] = total_wall_ms;
+    report["cpu_time_ms"] = total_cpu_ms;
+    report["frame_wall_ms"] = summarize(frame_wall_ms);
+    report["frame_cpu_ms"] = summarize(frame_cpu_ms);
+
+    auto& region_report = report["regions"];
+    region_report = nlohmann::json::object();
+#ifdef MEGAMOL_USE_PROFILING
+    for (auto const& region : regions) {
+        auto stats = summarize(region.frame_ms);
+        stats["calls"] = region.calls;
+        region_report[region.name] = stats;
+    }
+#endif
+
+    std::ofstream file(config.output_file);
+    if (!file) {
+        log_error("could not write report to " + config.output_file);
+        return false;
+    }
+    file << report.dump(2) << "\n";
+    return static_cast<bool>(file);
+}
+
+} // namespace megamol::frontend
@@ -0,0 +1,117 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AbstractFrontendService.hpp"
+#include "mmcore/view/Camera.h"
+
+#ifdef MEGAMOL_USE_PROFILING
+#include "PerformanceManager.h"
+#endif
+
+namespace megamol::core::view {
+class AbstractViewInterface;
+}
+
+namespace megamol::frontend {
+
+/**
+ * Runs the loaded project for a fixed number of frames and writes frame time statistics to a JSON report.
+ *
+ * After a number of warmup frames, the service measures the wall and CPU time of each frame. When built with
+ * profiling, it also collects the time spent in every timed region (calls, user regions) per frame. The camera of a
+ * view can follow the keyframes of a cinematic keyframe file during the measurement. MegaMol shuts down as soon as the
+ * report has been written. Reports can be compared with utils/profiling/compare_benchmark.py.
+ */
+class Benchmark_Service final : public AbstractFrontendService {
+public:
+    struct Config {
+        std::string output_file;
+        uint32_t warmup_frames = 10;
+        uint32_t frames = 100;
+        // cinematic keyframe file, the measured frames traverse its keyframes once
+        std::string camera_keyframes_file;
+        // view that follows the keyframes, the first view entry point if empty
+        std::string view;
+        std::vector<std::string> project_files;
+    };
+
+    std::string serviceName() const override {
+        return "Benchmark_Service";
+    }
+
+    bool init(void* configPtr) override;
+    void close() override;
+
+    std::vector<FrontendResource>& getProvidedResources() override {
+        return _providedResourceReferences;
+    }
+    const std::vector<std::string> getRequestedResourceNames() const override {
+        return _requestedResourcesNames;
+    }
+    void setRequestedResources(std::vector<FrontendResource> resources) override;
+
+    void updateProvidedResources() override;
+    void digestChangedRequestedResources() override;
+    void resetProvidedResources() override;
+
+    void preGraphRender() override {}
+    void postGraphRender() override {}
+
+private:
+    enum class state { WARMUP, MEASURING, DONE };
+
+    struct region_samples {
+        std::string name;
+        void* parent = nullptr;
+        // time spent in the region per measured frame, in milliseconds
+        std::vector<double> frame_ms;
+        uint64_t calls = 0;
+    };
+
+    bool load_camera_keyframes();
+    std::shared_ptr<core::view::AbstractViewInterface> find_view() const;
+    bool write_report() const;
+
+    Config config;
+    state current_state = state::WARMUP;
+    uint32_t frame = 0;
+
+    std::chrono::steady_clock::time_point frame_start;
+    std::clock_t frame_cpu_start = 0;
+    std::chrono::steady_clock::time_point measure_start;
+    std::clock_t measure_cpu_start = 0;
+    double total_wall_ms = 0.0;
+    double total_cpu_ms = 0.0;
+
+    std::vector<double> frame_wall_ms;
+    std::vector<double> frame_cpu_ms;
+
+    std::vector<core::view::Camera> camera_keyframes;
+    std::shared_ptr<core::view::AbstractViewInterface> view;
+
+#ifdef MEGAMOL_USE_PROFILING
+    // handles of deleted timers are reused, thus regions are identified by name and only cached by handle
+    std::unordered_map<frontend_resources::PerformanceManager::handle_type, size_t> region_by_handle;
+    std::unordered_map<std::string, size_t> region_by_name;
+    std::vector<region_samples> regions;
+#endif
+
+    std::vector<FrontendResource> _providedResourceReferences;
+    std::vector<std::string> _requestedResourcesNames;
+    std::vector<FrontendResource> _requestedResourcesReferences;
+};
+
+} // namespace megamol::frontend
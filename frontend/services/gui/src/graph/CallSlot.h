@@ -44,6 +44,9 @@ public:
         std::string name;
         std::string description;
         std::vector<size_t> compatible_call_idxs;
+        // Names of the accepted calls (callees: per registered function), for calls registered later on
+        std::vector<std::string> call_names;
+        std::vector<std::string> function_names;
         CallSlotType type;
         megamol::core::AbstractCallSlotPresentation::Necessity necessity;
     };
@@ -94,6 +97,9 @@ public:
     void SetInterfaceSlotPtr(InterfaceSlotPtr_t interfaceslot_ptr) {
         this->gui_interfaceslot_ptr = interfaceslot_ptr;
     }
+    void SetCompatibleCallIdxs(const std::vector<size_t>& idxs) {
+        this->compatible_call_idxs = idxs;
+    }
 
 private:
     // VARIABLES --------------------------------------------------------------
@@ -102,7 +108,7 @@ private:
     const std::string name;
     const std::string description;
     // Storing only indices of compatible calls for faster comparison.
-    const std::vector<size_t> compatible_call_idxs;
+    std::vector<size_t> compatible_call_idxs;
     const CallSlotType type;
     megamol::core::AbstractCallSlotPresentation::Necessity necessity;
 
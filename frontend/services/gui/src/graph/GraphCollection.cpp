@@ -124,15 +124,12 @@ megamol::gui::GraphPtr_t megamol::gui::GraphCollection::GetRunningGraph() {
 
 bool megamol::gui::GraphCollection::load_call_stock(const megamol::frontend_resources::PluginsResource& pluginsRes) {
 
-    // Load only once
-    if (!this->calls_stock.empty()) {
+    // Load only plugins that have not been read yet, plugins may be loaded on demand
+    if (this->calls_stock_plugins == pluginsRes.plugins.size()) {
         return true;
-        // megamol::core::utility::log::Log::DefaultLog.WriteWarn("[GUI] Call stock already exists. Deleting exiting
-        // stock and recreating new one. [%s, %s, line %d]\n", __FILE__, __FUNCTION__, __LINE__);
     }
 
     bool retval = true;
-    this->calls_stock.clear();
 
     try {
         std::string plugin_name;
@@ -140,11 +137,12 @@ bool megamol::gui::GraphCollection::load_call_stock(const megamol::frontend_reso
 
         // CALLS ------------------------------------------------------------------
         /// ! Get calls before getting modules for having calls in place for setting compatible call indices of slots!
-        if (this->calls_stock.empty()) {
+        if (this->calls_stock_plugins < pluginsRes.plugins.size()) {
 
             // Get plugin calls (get prior to core calls for being  able to find duplicates in core instance call desc.
             // manager)
-            for (auto& plugin : pluginsRes.plugins) {
+            for (auto i = this->calls_stock_plugins; i < pluginsRes.plugins.size(); ++i) {
+                auto& plugin = pluginsRes.plugins[i];
                 plugin_name = plugin->GetObjectFactoryName();
                 for (auto& c_desc : plugin->GetCallDescriptionManager()) {
                     Call::StockCall call;
@@ -153,6 +151,10 @@ bool megamol::gui::GraphCollection::load_call_stock(const megamol::frontend_reso
                     }
                 }
             }
+            this->calls_stock_plugins = pluginsRes.plugins.size();
+
+            // Slots that have been read before may accept some of the new calls
+            this->update_compatible_call_idxs();
         }
 
         auto delta_time =
@@ -187,15 +189,12 @@ bool megamol::gui::GraphCollection::load_module_stock(const megamol::frontend_re
         return false;
     }
 
-    // Load only once
-    if (!this->modules_stock.empty()) {
+    // Load only plugins that have not been read yet, plugins may be loaded on demand
+    if (this->modules_stock_plugins == pluginsRes.plugins.size()) {
         return true;
-        // megamol::core::utility::log::Log::DefaultLog.WriteWarn("[GUI] Module stock already exists. Deleting exiting
-        // stock and recreating new one. [%s, %s, line %d]\n", __FILE__, __FUNCTION__, __LINE__);
     }
 
     bool retval = true;
-    this->modules_stock.clear();
 
     try {
         std::string plugin_name;
@@ -204,11 +203,12 @@ bool megamol::gui::GraphCollection::load_module_stock(const megamol::frontend_re
         auto module_load_time = std::chrono::system_clock::now();
 #endif // GUI_VERBOSE
         // MODULES ----------------------------------------------------------------
-        if (this->modules_stock.empty()) {
+        if (this->modules_stock_plugins < pluginsRes.plugins.size()) {
 
             // Get plugin modules (get prior to core modules for being  able to find duplicates in core instance module
             // desc. manager)
-            for (auto& plugin : pluginsRes.plugins) {
+            for (auto i = this->modules_stock_plugins; i < pluginsRes.plugins.size(); ++i) {
+                auto& plugin = pluginsRes.plugins[i];
                 plugin_name = plugin->GetObjectFactoryName();
                 for (auto& m_desc : plugin->GetModuleDescriptionManager()) {
                     Module::StockModule mod;
@@ -226,6 +226,7 @@ bool megamol::gui::GraphCollection::load_module_stock(const megamol::frontend_re
 #endif // GUI_VERBOSE
                 }
             }
+            this->modules_stock_plugins = pluginsRes.plugins.size();
 
             // Sorting module by alphabetically ascending class names.
             std::sort(this->modules_stock.begin(), this->modules_stock.end(),
@@ -268,6 +269,8 @@ void megamol::gui::GraphCollection::SetLuaFunc(lua_func_type* func) {
 bool megamol::gui::GraphCollection::InitializeGraphSynchronisation(
     const megamol::frontend_resources::PluginsResource& pluginsRes) {
 
+    this->plugins_resource = &pluginsRes;
+
     // Load all known calls from core instance ONCE
     if (!this->load_call_stock(pluginsRes)) {
         megamol::core::utility::log::Log::DefaultLog.WriteError(
@@ -1030,7 +1033,10 @@ bool megamol::gui::GraphCollection::get_module_stock_data(Module::StockModule& o
             CallSlot::StockCallSlot csd;
             csd.name = std::string(caller_slot->Name().PeekBuffer());
             csd.description = std::string(caller_slot->Description().PeekBuffer());
-            csd.compatible_call_idxs = this->get_compatible_caller_idxs(caller_slot.get());
+            for (SIZE_T i = 0; i < caller_slot->GetCompCallCount(); ++i) {
+                csd.call_names.emplace_back(caller_slot->GetCompCallClassName(i));
+            }
+            csd.compatible_call_idxs = this->get_compatible_caller_idxs(csd.call_names);
             csd.type = CallSlotType::CALLER;
             csd.necessity = caller_slot->GetNecessity();
 
@@ -1042,7 +1048,11 @@ bool megamol::gui::GraphCollection::get_module_stock_data(Module::StockModule& o
             CallSlot::StockCallSlot csd;
             csd.name = std::string(callee_slot->Name().PeekBuffer());
             csd.description = std::string(callee_slot->Description().PeekBuffer());
-            csd.compatible_call_idxs = this->get_compatible_callee_idxs(callee_slot.get());
+            for (SIZE_T i = 0; i < callee_slot->GetCallbackCount(); ++i) {
+                csd.call_names.emplace_back(callee_slot->GetCallbackCallName(i));
+                csd.function_names.emplace_back(callee_slot->GetCallbackFuncName(i));
+            }
+            csd.compatible_call_idxs = this->get_compatible_callee_idxs(csd.call_names, csd.function_names);
             csd.type = CallSlotType::CALLEE;
             csd.necessity = callee_slot->GetNecessity();
 
@@ -1191,19 +1201,24 @@ bool megamol::gui::GraphCollection::project_separate_name_and_namespace(
 std::vector<size_t> megamol::gui::GraphCollection::get_compatible_callee_idxs(
     const megamol::core::CalleeSlot* callee_slot) {
 
-    std::vector<size_t> retval;
-    retval.clear();
     if (callee_slot == nullptr)
-        return retval;
+        return std::vector<size_t>();
 
     SIZE_T callbackCount = callee_slot->GetCallbackCount();
     std::vector<std::string> callNames, funcNames;
-    std::set<std::string> uniqueCallNames, completeCallNames;
     for (SIZE_T i = 0; i < callbackCount; ++i) {
-        uniqueCallNames.insert(callee_slot->GetCallbackCallName(i));
         callNames.emplace_back(callee_slot->GetCallbackCallName(i));
         funcNames.emplace_back(callee_slot->GetCallbackFuncName(i));
     }
+    return this->get_compatible_callee_idxs(callNames, funcNames);
+}
+
+
+std::vector<size_t> megamol::gui::GraphCollection::get_compatible_callee_idxs(
+    const std::vector<std::string>& callNames, const std::vector<std::string>& funcNames) {
+
+    std::vector<size_t> retval;
+    std::set<std::string> uniqueCallNames(callNames.begin(), callNames.end()), completeCallNames;
     size_t ll = callNames.size();
     assert(ll == funcNames.size());
     for (auto& callName : uniqueCallNames) {
@@ -1255,14 +1270,23 @@ std::vector<size_t> megamol::gui::GraphCollection::get_compatible_callee_idxs(
 std::vector<size_t> megamol::gui::GraphCollection::get_compatible_caller_idxs(
     const megamol::core::CallerSlot* caller_slot) {
 
-    std::vector<size_t> retval;
-    retval.clear();
     if (caller_slot == nullptr)
-        return retval;
+        return std::vector<size_t>();
 
     SIZE_T callCount = caller_slot->GetCompCallCount();
+    std::vector<std::string> callNames;
     for (SIZE_T i = 0; i < callCount; ++i) {
-        std::string comp_call_class_name = std::string(caller_slot->GetCompCallClassName(i));
+        callNames.emplace_back(caller_slot->GetCompCallClassName(i));
+    }
+    return this->get_compatible_caller_idxs(callNames);
+}
+
+
+std::vector<size_t> megamol::gui::GraphCollection::get_compatible_caller_idxs(
+    const std::vector<std::string>& callNames) {
+
+    std::vector<size_t> retval;
+    for (auto& comp_call_class_name : callNames) {
         size_t calls_cnt = this->calls_stock.size();
         for (size_t idx = 0; idx < calls_cnt; ++idx) {
             // Case-Insensitive call slot comparison
@@ -1276,6 +1300,42 @@ std::vector<size_t> megamol::gui::GraphCollection::get_compatible_caller_idxs(
 }
 
 
+void megamol::gui::GraphCollection::update_compatible_call_idxs() {
+
+    for (auto& mod : this->modules_stock) {
+        for (auto& callslot : mod.callslots[CallSlotType::CALLER]) {
+            callslot.compatible_call_idxs = this->get_compatible_caller_idxs(callslot.call_names);
+        }
+        for (auto& callslot : mod.callslots[CallSlotType::CALLEE]) {
+            callslot.compatible_call_idxs =
+                this->get_compatible_callee_idxs(callslot.call_names, callslot.function_names);
+        }
+    }
+
+    // Call slots of modules in the graphs have been created from the stock or the core instance, their classes are
+    // in the stock then
+    for (auto& graph_ptr : this->graphs) {
+        for (auto& module_ptr : graph_ptr->Modules()) {
+            auto mod_it = std::find_if(this->modules_stock.begin(), this->modules_stock.end(),
+                [&](const Module::StockModule& mod) { return mod.class_name == module_ptr->ClassName(); });
+            if (mod_it == this->modules_stock.end()) {
+                continue;
+            }
+            for (auto& callslot_map : module_ptr->CallSlots()) {
+                for (auto& callslot_ptr : callslot_map.second) {
+                    for (auto& stock_callslot : mod_it->callslots[callslot_map.first]) {
+                        if (stock_callslot.name == callslot_ptr->Name()) {
+                            callslot_ptr->SetCompatibleCallIdxs(stock_callslot.compatible_call_idxs);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+
 std::string megamol::gui::GraphCollection::get_state(ImGuiID graph_id, const std::string& filename) {
 
     nlohmann::json state_json;
@@ -1465,6 +1525,12 @@ bool megamol::gui::GraphCollection::NotifyRunningGraph_AddModule(core::ModuleIns
         return false;
     }
 
+    // The module may come from a plugin that has been loaded on demand, its slots need the calls of that plugin
+    if (this->plugins_resource != nullptr) {
+        this->load_call_stock(*this->plugins_resource);
+        this->load_module_stock(*this->plugins_resource);
+    }
+
     if (auto graph_ptr = this->GetRunningGraph()) {
 
         std::string full_name(module_inst.request.id);
@@ -1690,6 +1756,12 @@ bool megamol::gui::GraphCollection::NotifyRunningGraph_AddCall(core::CallInstanc
         return false;
     }
 
+    // The call may come from a plugin that has been loaded on demand
+    if (this->plugins_resource != nullptr) {
+        this->load_call_stock(*this->plugins_resource);
+        this->load_module_stock(*this->plugins_resource);
+    }
+
     if (auto graph_ptr = this->GetRunningGraph()) {
 
         if (graph_ptr->CallExists(call_inst.request.className, call_inst.request.from, call_inst.request.to)) {
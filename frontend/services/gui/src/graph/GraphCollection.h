@@ -107,6 +107,10 @@ private:
     GraphPtrVector_t graphs;
     ModuleStockVector_t modules_stock;
     CallStockVector_t calls_stock;
+    // number of plugins read into the stocks
+    size_t modules_stock_plugins = 0;
+    size_t calls_stock_plugins = 0;
+    const megamol::frontend_resources::PluginsResource* plugins_resource = nullptr;
     unsigned int graph_name_uid;
 
     FileBrowserWidget gui_file_browser;
@@ -140,7 +144,13 @@ private:
     }
 
     std::vector<size_t> get_compatible_callee_idxs(const megamol::core::CalleeSlot* callee_slot);
+    std::vector<size_t> get_compatible_callee_idxs(
+        const std::vector<std::string>& call_names, const std::vector<std::string>& function_names);
     std::vector<size_t> get_compatible_caller_idxs(const megamol::core::CallerSlot* caller_slot);
+    std::vector<size_t> get_compatible_caller_idxs(const std::vector<std::string>& call_names);
+
+    /** Adds calls that have been registered after the call slots have been read to their compatible calls. */
+    void update_compatible_call_idxs();
 
     bool load_state_from_file(const std::string& filename, ImGuiID graph_id);
 
@@ -10,6 +10,12 @@
 
 #include "mmcore/utility/log/Log.h"
 
+namespace {
+// the worker polls with a timeout to notice when it has to stop
+constexpr auto poll_timeout = std::chrono::milliseconds(100);
+const std::string wake_address = "inproc://lua-remote-answers";
+} // namespace
+
 megamol::frontend::LuaRemoteConnectionsBroker::LuaRemoteConnectionsBroker(
     const std::string& broker_address, int max_retries) {
     using megamol::core::utility::log::Log;
@@ -20,7 +26,12 @@ megamol::frontend::LuaRemoteConnectionsBroker::LuaRemoteConnectionsBroker(
 
     zmq::socket_t socket(zmq_context_, zmq::socket_type::router);
     socket.set(zmq::sockopt::linger, 0);
-    socket.set(zmq::sockopt::rcvtimeo, 100); // message receive time out 100ms
+
+    zmq::socket_t wake_receiver(zmq_context_, zmq::socket_type::pull);
+    wake_receiver.bind(wake_address);
+    wake_sender_ = zmq::socket_t(zmq_context_, zmq::socket_type::push);
+    wake_sender_.set(zmq::sockopt::linger, 0);
+    wake_sender_.connect(wake_address);
 
     // retry to start broker socket on next port until max_retries reached
     int retry = 0;
@@ -30,7 +41,8 @@ megamol::frontend::LuaRemoteConnectionsBroker::LuaRemoteConnectionsBroker(
         try {
             socket.bind(address);
             Log::DefaultLog.WriteInfo("LRH Server socket opened on \"%s\"", address.c_str());
-            worker_ = std::thread(&LuaRemoteConnectionsBroker::worker, this, std::move(socket));
+            worker_ =
+                std::thread(&LuaRemoteConnectionsBroker::worker, this, std::move(socket), std::move(wake_receiver));
             return;
         } catch (zmq::error_t& ex) {
             if (ex.num() != EADDRINUSE) {
@@ -46,51 +58,75 @@ megamol::frontend::LuaRemoteConnectionsBroker::LuaRemoteConnectionsBroker(
 
 megamol::frontend::LuaRemoteConnectionsBroker::~LuaRemoteConnectionsBroker() {
     stop_ = true;
-    worker_.join();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    wake_sender_.close();
 }
 
-void megamol::frontend::LuaRemoteConnectionsBroker::worker(zmq::socket_t&& socket) {
+void megamol::frontend::LuaRemoteConnectionsBroker::SendAnswer(uint64_t id, std::string answer) {
+    answer_queue_.push(LuaAnswer{id, std::move(answer)});
+    // the content does not matter, the worker only needs to wake up. if the pipe is full, the worker is awake anyway
+    wake_sender_.send(zmq::message_t(), zmq::send_flags::dontwait);
+}
+
+void megamol::frontend::LuaRemoteConnectionsBroker::worker(zmq::socket_t&& socket, zmq::socket_t&& wake_receiver) {
     using megamol::core::utility::log::Log;
 
+    zmq::pollitem_t items[] = {
+        {socket.handle(), 0, ZMQ_POLLIN, 0},
+        {wake_receiver.handle(), 0, ZMQ_POLLIN, 0},
+    };
+
     while (!stop_) {
+        zmq::poll(items, 2, poll_timeout);
+
         // Receive
         zmq::multipart_t request_msg;
         while (request_msg.recv(socket, ZMQ_DONTWAIT)) {
-            LuaResponse response;
-
-            // With router socket there should be always 3 messages, but do extra safety check.
-            response.client_id = (request_msg.size() >= 1) ? request_msg[0].to_string() : "";
-            std::string request_str = (request_msg.size() >= 3) ? request_msg[2].to_string() : "";
-
-            std::promise<std::string> promise;
-            response.future = promise.get_future();
+            // With router socket there should be always at least 3 messages: client id, delimiter and script.
+            // Pipelining clients put their request id between delimiter and script, we answer with the same envelope.
+            std::vector<std::string> envelope;
+            std::string request_str;
+            if (request_msg.size() >= 3) {
+                request_str = request_msg.back().to_string();
+                for (size_t i = 0; i + 1 < request_msg.size(); ++i) {
+                    envelope.push_back(request_msg[i].to_string());
+                }
+            } else {
+                envelope = {(request_msg.size() >= 1) ? request_msg[0].to_string() : "", ""};
+            }
+            request_msg.clear();
 
-            response_queue_.emplace_back(std::move(response));
-            request_queue_.push(LuaRequest{request_str, std::move(promise)});
+            const auto id = next_request_id_++;
+            pending_envelopes_.emplace(id, std::move(envelope));
+            request_queue_.push(LuaRequest{id, std::move(request_str)});
         }
 
         // Send
-        auto it = response_queue_.begin();
-        while (it != response_queue_.end()) {
-            if (it->future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
+        zmq::message_t wake_msg;
+        while (wake_receiver.recv(wake_msg, zmq::recv_flags::dontwait)) {}
+
+        auto answers = answer_queue_.pop_queue();
+        while (!answers.empty()) {
+            auto& answer = answers.front();
+            auto it = pending_envelopes_.find(answer.id);
+            if (it != pending_envelopes_.end()) {
                 zmq::multipart_t response_msg;
-                response_msg.addstr(it->client_id);    // Client
-                response_msg.addmem(nullptr, 0);       // Separator
-                response_msg.addstr(it->future.get()); // Message for REQ socket
+                for (auto const& frame : it->second) {
+                    response_msg.addstr(frame); // Client, separator, request id of pipelining clients
+                }
+                response_msg.addstr(std::move(answer.answer)); // Message for REQ socket
 
                 response_msg.send(socket);
-
-                it = response_queue_.erase(it);
-            } else {
-                it++;
+                pending_envelopes_.erase(it);
             }
+            answers.pop();
         }
-
-        // Reduce CPU load
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
     }
 
     try {
+        wake_receiver.close();
         socket.close();
     } catch (...) {
         Log::DefaultLog.WriteInfo("LRH Server socket close threw exception");
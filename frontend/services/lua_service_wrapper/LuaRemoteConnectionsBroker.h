@@ -6,10 +6,13 @@
 
 #pragma once
 
-#include <future>
-#include <list>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <zmq.hpp>
 
@@ -17,11 +20,19 @@
 
 namespace megamol::frontend {
 
+/**
+ * Receives Lua requests from remote clients on a ZMQ router socket and sends back the answers.
+ *
+ * REQ clients send the script as a single frame and wait for the answer. DEALER clients may pipeline requests: they
+ * send an empty delimiter frame, a request id frame of their choice and the script, and get back the delimiter, the
+ * request id and the answer. Answers are sent as soon as they are available, in execution order.
+ */
 class LuaRemoteConnectionsBroker {
 public:
     struct LuaRequest {
+        // identifies the request when answering it
+        uint64_t id = 0;
         std::string request;
-        std::promise<std::string> answer_promise;
     };
 
     bool RequestQueueEmpty() const {
@@ -32,22 +43,31 @@ public:
         return request_queue_.pop_queue();
     }
 
+    /** Sends the answer of a request back to its client. Must be called from one thread only. */
+    void SendAnswer(uint64_t id, std::string answer);
+
     explicit LuaRemoteConnectionsBroker(std::string const& broker_address, int max_retries = 0);
     ~LuaRemoteConnectionsBroker();
 
 private:
-    void worker(zmq::socket_t&& socket);
+    void worker(zmq::socket_t&& socket, zmq::socket_t&& wake_receiver);
 
-    struct LuaResponse {
-        std::string client_id;
-        std::future<std::string> future;
+    struct LuaAnswer {
+        uint64_t id = 0;
+        std::string answer;
     };
 
     zmq::context_t zmq_context_;
+    // wakes the worker when answers are ready
+    zmq::socket_t wake_sender_;
     std::thread worker_;
     std::atomic<bool> stop_{false};
     frontend_resources::threadsafe_queue<LuaRequest> request_queue_;
-    std::list<LuaResponse> response_queue_;
+    frontend_resources::threadsafe_queue<LuaAnswer> answer_queue_;
+
+    // worker thread state: the frames preceding the script of each pending request, i.e. the address to answer to
+    std::unordered_map<uint64_t, std::vector<std::string>> pending_envelopes_;
+    uint64_t next_request_id_ = 0;
 };
 
 } // namespace megamol::frontend
@@ -6,6 +6,9 @@
 
 #include "Lua_Service_Wrapper.hpp"
 
+#include <cctype>
+#include <chrono>
+
 #include "CommandRegistry.h"
 #include "FrameStatistics.h"
 #include "GUIState.h"
@@ -29,6 +32,9 @@ static void log(std::string text) {
     log(text.c_str());
 }
 
+// time the main loop spends on remote requests per frame, as long as more requests arrive
+static constexpr auto remote_requests_frame_budget = std::chrono::milliseconds(20);
+
 static std::shared_ptr<bool> open_version_notification = std::make_shared<bool>(true);
 static const std::string version_mismatch_title = "Version Check";
 static const std::string version_mismatch_notification = "Warning: MegaMol version does not match version in project!";
@@ -186,24 +192,120 @@ void Lua_Service_Wrapper::updateProvidedResources() {
     bool need_to_shutdown = false; // e.g. mmQuit should set this to true
 
     // fetch Lua requests from ZMQ queue, execute, and give back result
-    if (m_network_host != nullptr && !m_network_host->RequestQueueEmpty()) {
-        auto lua_requests = std::move(m_network_host->GetRequestQueue());
+    execute_remote_requests();
+
+    // LuaAPI sets shutdown request of this service via direct callback
+    // -> see Lua_Service_Wrapper::setRequestedResources()
+    //if (need_to_shutdown)
+    //    this->setShutdown();
+}
+
+// matches requests consisting of a single mmSetParamValue("name", "value") call with plain string literals
+static bool parse_set_param_request(std::string const& request, std::pair<std::string, std::string>& param_value) {
+    static const std::string function_name = "mmSetParamValue";
+    size_t pos = 0;
+    const auto skip_space = [&]() {
+        while (pos < request.size() && std::isspace(static_cast<unsigned char>(request[pos]))) {
+            ++pos;
+        }
+    };
+    const auto expect = [&](char c) {
+        skip_space();
+        return pos < request.size() && request[pos++] == c;
+    };
+    // escape sequences are left to Lua
+    const auto string_literal = [&](std::string& str) {
+        skip_space();
+        if (pos >= request.size() || (request[pos] != '"' && request[pos] != '\'')) {
+            return false;
+        }
+        const auto quote = request[pos++];
+        const auto end = request.find_first_of(std::string{quote, '\\', '\n'}, pos);
+        if (end == std::string::npos || request[end] != quote) {
+            return false;
+        }
+        str = request.substr(pos, end - pos);
+        pos = end + 1;
+        return true;
+    };
+
+    skip_space();
+    if (request.compare(pos, function_name.size(), function_name) != 0) {
+        return false;
+    }
+    pos += function_name.size();
+    if (!expect('(') || !string_literal(param_value.first) || !expect(',') || !string_literal(param_value.second) ||
+        !expect(')')) {
+        return false;
+    }
+    skip_space();
+    if (pos < request.size() && request[pos] == ';') {
+        ++pos;
+        skip_space();
+    }
+    return pos == request.size();
+}
+
+void Lua_Service_Wrapper::execute_remote_requests() {
+    if (m_network_host == nullptr) {
+        return;
+    }
+
+    auto& graph = const_cast<megamol::core::MegaMolGraph&>(
+        m_requestedResourceReferences[5].getResource<megamol::core::MegaMolGraph>());
+
+    // pipelining clients keep the queue filled, we keep executing until the frame budget is used up
+    const auto deadline = std::chrono::steady_clock::now() + remote_requests_frame_budget;
+
+    while (!m_network_host->RequestQueueEmpty()) {
+        auto lua_requests = m_network_host->GetRequestQueue();
         std::string result;
+        std::vector<LuaRemoteConnectionsBroker::LuaRequest> param_requests;
+        std::vector<std::pair<std::string, std::string>> param_values;
+
+        // consecutive parameter changes skip the Lua interpreter and are applied as one batch
+        const auto flush_param_requests = [&]() {
+            if (param_values.empty()) {
+                return;
+            }
+            if (graph.SetParameters(param_values)) {
+                for (auto const& request : param_requests) {
+                    m_network_host->SendAnswer(request.id, "");
+                }
+            } else {
+                // no parameter was changed, let Lua report the errors of the individual requests
+                for (auto const& request : param_requests) {
+                    luaAPI.RunString(request.request, result);
+                    m_network_host->SendAnswer(request.id, std::move(result));
+                    result.clear();
+                }
+            }
+            param_requests.clear();
+            param_values.clear();
+        };
+
         while (!lua_requests.empty()) {
             auto& request = lua_requests.front();
 
-            luaAPI.RunString(request.request, result);
-            request.answer_promise.set_value(result);
+            std::pair<std::string, std::string> param_value;
+            if (parse_set_param_request(request.request, param_value)) {
+                param_values.push_back(std::move(param_value));
+                param_requests.push_back(std::move(request));
+            } else {
+                flush_param_requests();
+                luaAPI.RunString(request.request, result);
+                m_network_host->SendAnswer(request.id, std::move(result));
+                result.clear();
+            }
 
             lua_requests.pop();
-            result.clear();
         }
-    }
+        flush_param_requests();
 
-    // LuaAPI sets shutdown request of this service via direct callback
-    // -> see Lua_Service_Wrapper::setRequestedResources()
-    //if (need_to_shutdown)
-    //    this->setShutdown();
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
 }
 
 void Lua_Service_Wrapper::digestChangedRequestedResources() {
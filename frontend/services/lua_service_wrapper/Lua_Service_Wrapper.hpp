@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <list>
+
 #include "AbstractFrontendService.hpp"
 #include "CommonTypes.h"
 #include "LuaCallbacksCollection.h"
@@ -94,6 +96,9 @@ private:
     std::function<void(std::string const&)> m_setScriptPath_resource;
     std::function<void(megamol::frontend_resources::LuaCallbacksCollection const&)> m_registerLuaCallbacks_resource;
 
+    // executes the requests of remote clients, answers are sent back as soon as they are available
+    void execute_remote_requests();
+
     void fill_frontend_resources_callbacks(void* callbacks_collection_ptr);
     void fill_graph_manipulation_callbacks(void* callbacks_collection_ptr);
 };
@@ -6,7 +6,9 @@
 
 #include "PerformanceManager.h"
 
+#include <algorithm>
 #include <array>
+#include <tuple>
 
 #include "mmcore/Call.h"
 #include "mmcore/Module.h"
@@ -260,6 +262,105 @@ void PerformanceManager::stop_timer(handle_type h) {
     timers[h]->end();
 }
 
+PerformanceManager::pool_handle PerformanceManager::add_memory_pool(megamol::core::Module* m, std::string name) {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    memory_pool pool;
+    pool.parent = m != nullptr ? m->FullName().PeekBuffer() : "BuiltIn";
+    pool.name = std::move(name);
+    const auto h = next_pool++;
+    memory_pools.emplace(h, std::move(pool));
+    return h;
+}
+
+void PerformanceManager::remove_memory_pool(pool_handle h) {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    const auto it = memory_pools.find(h);
+    if (it != memory_pools.end()) {
+        const auto parent = it->second.parent;
+        memory_pools.erase(it);
+        check_memory_budget(parent);
+    }
+}
+
+void PerformanceManager::set_memory_usage(pool_handle h, size_t bytes) {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    const auto it = memory_pools.find(h);
+    if (it == memory_pools.end()) {
+        core::utility::log::Log::DefaultLog.WriteError("PerformanceManager: cannot find memory pool %u", h);
+        return;
+    }
+    auto& pool = it->second;
+    if (pool.current != bytes) {
+        pool.current = bytes;
+        pool.peak = std::max(pool.peak, bytes);
+        pool.changed = true;
+        check_memory_budget(pool.parent);
+    }
+}
+
+std::vector<PerformanceManager::memory_pool_info> PerformanceManager::get_memory_pools() const {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::vector<memory_pool_info> pools;
+    pools.reserve(memory_pools.size());
+    for (const auto& [h, pool] : memory_pools) {
+        pools.push_back({h, pool.parent, pool.name, pool.current, pool.peak});
+    }
+    std::sort(pools.begin(), pools.end(), [](const memory_pool_info& a, const memory_pool_info& b) {
+        return std::tie(a.parent, a.name) < std::tie(b.parent, b.name);
+    });
+    return pools;
+}
+
+void PerformanceManager::visit_changed_memory_pools(const memory_callback& cb) {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    for (auto& [h, pool] : memory_pools) {
+        if (pool.changed) {
+            pool.changed = false;
+            cb({h, pool.parent, pool.name, pool.current, pool.peak});
+        }
+    }
+}
+
+void PerformanceManager::set_memory_budget(const std::string& parent, size_t bytes) {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    if (bytes == 0) {
+        memory_budgets.erase(parent);
+    } else {
+        memory_budgets[parent] = bytes;
+    }
+    over_budget.erase(parent);
+    check_memory_budget(parent);
+}
+
+size_t PerformanceManager::get_memory_budget(const std::string& parent) const {
+    std::lock_guard<std::mutex> lock(memory_mutex);
+    const auto it = memory_budgets.find(parent);
+    return it != memory_budgets.end() ? it->second : 0;
+}
+
+void PerformanceManager::check_memory_budget(const std::string& parent) {
+    const auto budget = memory_budgets.find(parent);
+    if (budget == memory_budgets.end()) {
+        return;
+    }
+    size_t total = 0;
+    for (const auto& [h, pool] : memory_pools) {
+        if (pool.parent == parent) {
+            total += pool.current;
+        }
+    }
+    // warn once when the budget is exceeded, and again after having been within budget
+    if (total > budget->second) {
+        if (over_budget.insert(parent).second) {
+            core::utility::log::Log::DefaultLog.WriteWarn(
+                "PerformanceManager: %s uses %zu bytes, exceeding its memory budget of %zu bytes", parent.c_str(),
+                total, budget->second);
+        }
+    } else {
+        over_budget.erase(parent);
+    }
+}
+
 PerformanceManager::handle_type PerformanceManager::add_timer(std::unique_ptr<Itimer> t) {
     handle_type my_handle = 0;
     if (!handle_holes.empty()) {
@@ -319,6 +420,7 @@ void PerformanceManager::endFrame() {
         e.handle = timer->get_handle();
         e.user_index = tconf.user_index;
         e.parent_type = tconf.parent_type;
+        e.comment_version = timer->comment_version;
 
         for (uint32_t region = 0; region < timer->get_region_count(); ++region) {
             e.frame_index = region;
@@ -14,6 +14,10 @@
 #include "mmcore/view/AbstractViewInterface.h"
 #include "mmcore/view/CameraSerializer.h"
 
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
 #ifdef MEGAMOL_USE_TRACY
 #include <tracy/Tracy.hpp>
 #endif
@@ -32,21 +36,9 @@ bool Profiling_Service::init(void* configPtr) {
     profiling_logging.active = conf->autostart_profiling;
     include_graph_events = conf->include_graph_events;
 
-    const auto unit_name = "ns";
-    using timer_ratio = std::nano;
-    //const auto unit_name = "us";
-    //using timer_ratio = std::micro;
-    //const auto unit_name = "ms";
-    //using timer_ratio = std::milli;
-
-    if (conf != nullptr && !conf->log_file.empty()) {
-        if (!log_file.is_open()) {
-            log_file = std::ofstream(conf->log_file, std::ofstream::trunc);
-            flush_frequency = conf->flush_frequency;
-        }
-        // header
-        log_buffer << "frame;type;parent;name;comment;global_index;frame_index;api;start (" << unit_name << ");end ("
-                   << unit_name << ");duration (" << unit_name << ")" << std::endl;
+    // The log is written by a background thread; the render thread only stores binary records.
+    // A log file ending in .json is written in the Chrome trace format instead of CSV.
+    if (conf != nullptr && !conf->log_file.empty() && trace_recorder.open(conf->log_file, conf->flush_frequency)) {
         _perf_man.subscribe_to_updates([&](const frontend_resources::PerformanceManager::frame_info& fi) {
             if (!profiling_logging.active) {
                 return;
@@ -55,49 +47,117 @@ bool Profiling_Service::init(void* configPtr) {
             if (frame > 0) {
                 auto& _frame_stats =
                     _requestedResourcesReferences[4].getResource<frontend_resources::FrameStatistics>();
-                log_buffer << (frame - 1) << ";MegaMol;MegaMol;FrameTime;;0;0;CPU;;;"
-                           << _frame_stats.last_rendered_frame_time_milliseconds << std::endl;
+                TraceRecorder::event frame_time;
+                frame_time.type = TraceRecorder::event::kind::FRAME_TIME;
+                frame_time.frame = frame - 1;
+                const auto now = std::chrono::steady_clock::now().time_since_epoch();
+                frame_time.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+                frame_time.value = _frame_stats.last_rendered_frame_time_milliseconds;
+                trace_recorder.record(frame_time);
             }
             for (auto& e : fi.entries) {
-                auto conf = _perf_man.lookup_config(e.handle);
-                auto name = conf.name;
-                auto parent = _perf_man.lookup_parent(e.handle);
-                auto comment = conf.comment;
-
-                const auto the_start = std::chrono::duration<double, timer_ratio>(e.start.time_since_epoch()).count();
-                const auto the_end = std::chrono::duration<double, timer_ratio>(e.end.time_since_epoch()).count();
-                const auto the_duration =
-                    std::chrono::duration<double, timer_ratio>(e.duration.time_since_epoch()).count();
-
-                log_buffer << frame << ";" << frontend_resources::PerformanceManager::parent_type_string(e.parent_type)
-                           << ";" << parent << ";" << name << ";" << comment << ";" << e.global_index << ";"
-                           << e.frame_index << ";"
-                           << megamol::frontend_resources::PerformanceManager::query_api_string(e.api) << ";"
-                           << std::to_string(the_start) << ";" << std::to_string(the_end) << ";"
-                           << std::to_string(the_duration) << std::endl;
-            }
-            if (frame % flush_frequency == flush_frequency - 1) {
-                log_file << log_buffer.rdbuf();
-                log_buffer.str(std::string());
-                log_buffer.clear();
+                TraceRecorder::event te;
+                te.track = trace_track(e);
+                te.frame = frame;
+                te.frame_index = e.frame_index;
+                te.global_index = e.global_index;
+                te.start_ns =
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(e.start.time_since_epoch()).count();
+                te.end_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(e.end.time_since_epoch()).count();
+                trace_recorder.record(te);
             }
+            record_memory_pools(frame);
+            record_plugin_loads(frame);
         });
     }
 #endif
 
     _requestedResourcesNames = {"RegisterLuaCallbacks", frontend_resources::MegaMolGraph_Req_Name, "RenderNextFrame",
-        frontend_resources::MegaMolGraph_SubscriptionRegistry_Req_Name, frontend_resources::FrameStatistics_Req_Name};
+        frontend_resources::MegaMolGraph_SubscriptionRegistry_Req_Name, frontend_resources::FrameStatistics_Req_Name,
+        "PluginsResource"};
 
     return true;
 }
 
 void Profiling_Service::log_graph_event(
     std::string const& parent, std::string const& name, std::string const& comment) {
-    if (this->include_graph_events) {
+    if (this->include_graph_events && trace_recorder.is_open()) {
         const auto frames_rendered = static_cast<int64_t>(
             _requestedResourcesReferences[4].getResource<frontend_resources::FrameStatistics>().rendered_frames_count);
-        log_buffer << frames_rendered - 1 << ";Graph;" << parent << ";" << name << ";" << comment
-                   << ";0;0;GraphEvent;;;" << std::endl;
+        trace_recorder.record_graph_event(static_cast<uint32_t>(frames_rendered - 1), parent, name, comment);
+    }
+}
+
+uint32_t Profiling_Service::trace_track(frontend_resources::PerformanceManager::timer_entry const& e) {
+    if (trace_tracks.size() <= e.handle) {
+        trace_tracks.resize(e.handle + 1, {0, 0});
+    }
+    auto& [track, version] = trace_tracks[e.handle];
+
+    // describe the timer once, and again whenever its comment changes
+    if (track == 0 || version != e.comment_version) {
+        const auto conf = _perf_man.lookup_config(e.handle);
+        TraceRecorder::track_info info;
+        info.type = frontend_resources::PerformanceManager::parent_type_string(e.parent_type);
+        info.parent = _perf_man.lookup_parent(e.handle);
+        info.name = conf.name;
+        info.comment = conf.comment;
+        info.api = frontend_resources::PerformanceManager::query_api_string(e.api);
+        track = trace_recorder.add_track(std::move(info));
+        version = e.comment_version;
+    }
+    return track;
+}
+
+void Profiling_Service::record_memory_pools(uint32_t frame) {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    _perf_man.visit_changed_memory_pools([&](frontend_resources::PerformanceManager::memory_pool_info const& pool) {
+        auto& track = memory_tracks[pool.handle];
+        if (track == 0) {
+            TraceRecorder::track_info info;
+            info.type = "Memory";
+            info.parent = pool.parent;
+            info.name = pool.name;
+            info.api = "Memory";
+            track = trace_recorder.add_track(std::move(info));
+        }
+        TraceRecorder::event e;
+        e.type = TraceRecorder::event::kind::MEMORY;
+        e.track = track;
+        e.frame = frame;
+        e.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        e.value = static_cast<double>(pool.current_bytes);
+        trace_recorder.record(e);
+    });
+}
+
+void Profiling_Service::record_plugin_loads(uint32_t frame) {
+    // plugins are loaded at startup and, when loaded on demand, while the graph is built
+    auto const& load_times =
+        _requestedResourcesReferences[5].getResource<frontend_resources::PluginsResource>().load_times;
+    for (; recorded_plugin_loads < load_times.size(); ++recorded_plugin_loads) {
+        auto const& load = load_times[recorded_plugin_loads];
+        TraceRecorder::track_info info;
+        info.type = "Plugin";
+        info.parent = "MegaMol";
+        info.name = load.name;
+        info.comment = "PluginLoad";
+        info.api = "CPU";
+        TraceRecorder::event e;
+        e.track = trace_recorder.add_track(std::move(info));
+        e.frame = frame;
+        e.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(load.start.time_since_epoch()).count();
+        e.end_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(load.end.time_since_epoch()).count();
+        trace_recorder.record(e);
+    }
+}
+
+void Profiling_Service::forget_trace_tracks(frontend_resources::PerformanceManager::handle_vector const& handles) {
+    // handles are reused for new timers
+    for (auto h : handles) {
+        if (h < trace_tracks.size()) {
+            trace_tracks[h] = {0, 0};
+        }
     }
 }
 
@@ -127,8 +187,10 @@ void Profiling_Service::setRequestedResources(std::vector<FrontendResource> reso
     profiling_manager_subscription.DeleteCall = [&](core::CallInstance_t const& call_inst) {
         auto the_call = call_inst.callPtr.get();
         _perf_man.remove_timers(the_call->cpu_queries);
+        forget_trace_tracks(the_call->cpu_queries);
         if (the_call->GetCapabilities().OpenGLRequired()) {
             _perf_man.remove_timers(the_call->gl_queries);
+            forget_trace_tracks(the_call->gl_queries);
         }
 
         log_graph_event("", call_inst.callPtr->GetDescriptiveText(), "DeleteCall");
@@ -177,11 +239,8 @@ void Profiling_Service::setRequestedResources(std::vector<FrontendResource> reso
 
 void Profiling_Service::close() {
 #ifdef MEGAMOL_USE_PROFILING
-    if (log_file.is_open()) {
-        // flush rest of log
-        log_file << log_buffer.rdbuf();
-        log_file.close();
-    }
+    // writes the rest of the log
+    trace_recorder.close();
 #endif
 #ifdef MEGAMOL_USE_NVPERF
     nvperf.Reset();
@@ -294,6 +353,26 @@ void Profiling_Service::fill_lua_callbacks() {
         }});
 
 
+#ifdef MEGAMOL_USE_PROFILING
+    callbacks.add<frontend_resources::LuaCallbacksCollection::StringResult>("mmGetMemoryUsage", "()",
+        {[&]() -> frontend_resources::LuaCallbacksCollection::StringResult {
+            std::stringstream sstr;
+            sstr << "module;pool;current (bytes);peak (bytes);budget (bytes)\n";
+            for (auto const& pool : _perf_man.get_memory_pools()) {
+                sstr << pool.parent << ";" << pool.name << ";" << pool.current_bytes << ";" << pool.peak_bytes << ";"
+                     << _perf_man.get_memory_budget(pool.parent) << "\n";
+            }
+            return frontend_resources::LuaCallbacksCollection::StringResult{sstr.str()};
+        }});
+
+    callbacks.add<frontend_resources::LuaCallbacksCollection::VoidResult, std::string, int>("mmSetMemoryBudget",
+        "(string module, int megabytes)",
+        {[&](std::string module, int megabytes) -> frontend_resources::LuaCallbacksCollection::VoidResult {
+            _perf_man.set_memory_budget(module, static_cast<size_t>(std::max(megabytes, 0)) * 1024 * 1024);
+            return frontend_resources::LuaCallbacksCollection::VoidResult{};
+        }});
+#endif
+
 #ifdef MEGAMOL_USE_NVPERF
     callbacks.add<frontend_resources::LuaCallbacksCollection::VoidResult, std::string>("mmNVPerfInit",
         "(string outpath)", {[&](std::string const& outpath) -> frontend_resources::LuaCallbacksCollection::VoidResult {
@@ -6,12 +6,15 @@
 
 #pragma once
 
-#include <fstream>
-#include <sstream>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 #include "AbstractFrontendService.hpp"
 #include "FrameStatistics.h"
 #include "PerformanceManager.h"
+#include "PluginsResource.h"
+#include "TraceRecorder.hpp"
 
 #ifdef MEGAMOL_USE_NVPERF
 #include <NvPerfReportGeneratorOpenGL.h>
@@ -51,15 +54,23 @@ public:
 private:
     void fill_lua_callbacks();
     void log_graph_event(std::string const& parent, std::string const& name, std::string const& comment);
+    uint32_t trace_track(frontend_resources::PerformanceManager::timer_entry const& e);
+    void forget_trace_tracks(frontend_resources::PerformanceManager::handle_vector const& handles);
+    void record_memory_pools(uint32_t frame);
+    void record_plugin_loads(uint32_t frame);
 
     std::vector<FrontendResource> _providedResourceReferences;
     std::vector<std::string> _requestedResourcesNames;
     std::vector<FrontendResource> _requestedResourcesReferences;
 
     frontend_resources::PerformanceManager _perf_man;
-    uint32_t flush_frequency = 0;
-    std::ofstream log_file;
-    std::stringstream log_buffer;
+    TraceRecorder trace_recorder;
+    // track id and comment version per timer handle, track id 0 if the timer has not been described yet
+    std::vector<std::pair<uint32_t, uint32_t>> trace_tracks;
+    // track id per memory pool
+    std::unordered_map<frontend_resources::PerformanceManager::pool_handle, uint32_t> memory_tracks;
+    // number of plugin loads written to the log
+    size_t recorded_plugin_loads = 0;
     bool include_graph_events = false;
     frontend_resources::ProfilingLoggingStatus profiling_logging;
 
@@ -0,0 +1,287 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "TraceRecorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+#include "mmcore/utility/log/Log.h"
+
+namespace megamol::frontend {
+
+TraceRecorder::~TraceRecorder() {
+    close();
+}
+
+bool TraceRecorder::open(std::string const& path, uint32_t flush_frequency, size_t capacity) {
+    if (is_open()) {
+        return false;
+    }
+
+    file = std::ofstream(path, std::ofstream::trunc);
+    if (!file.is_open()) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "TraceRecorder: cannot open %s for writing", path.c_str());
+        return false;
+    }
+
+    const auto json_ext = std::string(".json");
+    out_format = path.size() >= json_ext.size() && path.compare(path.size() - json_ext.size(), json_ext.size(),
+                                                        json_ext) == 0
+                     ? format::CHROME_JSON
+                     : format::CSV;
+    this->flush_frequency = std::max<uint32_t>(flush_frequency, 1);
+
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    ring.assign(size, event{});
+    ring_mask = size - 1;
+    write_pos = 0;
+    read_pos = 0;
+    dropped = 0;
+    first_record = true;
+    tracks.assign(1, track_info{});
+
+    write_header();
+
+    running = true;
+    writer = std::thread([this]() { writer_loop(); });
+    return true;
+}
+
+void TraceRecorder::close() {
+    if (!is_open()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        running = false;
+    }
+    wake.notify_one();
+    writer.join();
+
+    // the writer has stopped, so the remaining events can be drained from here
+    drain();
+    write_footer();
+    file.close();
+
+    if (dropped > 0) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "TraceRecorder: dropped %llu events because the buffer was full",
+            static_cast<unsigned long long>(dropped.load()));
+    }
+}
+
+uint32_t TraceRecorder::add_track(track_info info) {
+    const auto id = next_track++;
+
+    message m;
+    m.is_track = true;
+    m.id = id;
+    m.info = std::move(info);
+
+    std::lock_guard<std::mutex> lock(message_mutex);
+    messages.push_back(std::move(m));
+    return id;
+}
+
+bool TraceRecorder::record(event const& e) {
+    const auto w = write_pos.load(std::memory_order_relaxed);
+    if (w - read_pos.load(std::memory_order_acquire) > ring_mask) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ring[w & ring_mask] = e;
+    write_pos.store(w + 1, std::memory_order_release);
+    return true;
+}
+
+void TraceRecorder::record_graph_event(uint32_t frame, std::string parent, std::string name, std::string comment) {
+    message m;
+    m.is_track = false;
+    m.frame = frame;
+    m.time_ns = now_ns();
+    m.info.parent = std::move(parent);
+    m.info.name = std::move(name);
+    m.info.comment = std::move(comment);
+
+    std::lock_guard<std::mutex> lock(message_mutex);
+    messages.push_back(std::move(m));
+}
+
+void TraceRecorder::writer_loop() {
+    while (running) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait_for(lock, std::chrono::milliseconds(10), [this]() { return !running; });
+        }
+        drain();
+    }
+}
+
+void TraceRecorder::drain() {
+    // Events are published after the tracks they reference. Taking the snapshot of the ring before fetching the
+    // messages thus guarantees that all tracks of the drained events are known.
+    const auto end = write_pos.load(std::memory_order_acquire);
+    {
+        std::lock_guard<std::mutex> lock(message_mutex);
+        std::swap(messages, pending_messages);
+    }
+    for (auto& m : pending_messages) {
+        if (m.is_track) {
+            if (tracks.size() <= m.id) {
+                tracks.resize(m.id + 1);
+            }
+            tracks[m.id] = std::move(m.info);
+        } else {
+            write_graph_event(m);
+        }
+    }
+    pending_messages.clear();
+
+    auto pos = read_pos.load(std::memory_order_relaxed);
+    for (; pos != end; ++pos) {
+        const auto& e = ring[pos & ring_mask];
+        write_event(e);
+
+        if (e.frame >= last_flushed_frame + flush_frequency) {
+            file.flush();
+            last_flushed_frame = e.frame;
+        }
+    }
+    read_pos.store(pos, std::memory_order_release);
+}
+
+void TraceRecorder::write_header() {
+    if (out_format == format::CSV) {
+        const auto unit_name = "ns";
+        file << "frame;type;parent;name;comment;global_index;frame_index;api;start (" << unit_name << ");end ("
+             << unit_name << ");duration (" << unit_name << ")\n";
+    } else {
+        file << "[\n";
+        // name the lanes of the timer APIs
+        begin_json_record();
+        file << R"({"name":"thread_name","ph":"M","pid":1,"tid":1,"args":{"name":"CPU"}})";
+        begin_json_record();
+        file << R"({"name":"thread_name","ph":"M","pid":1,"tid":2,"args":{"name":"OpenGL"}})";
+        begin_json_record();
+        file << R"({"name":"thread_name","ph":"M","pid":1,"tid":3,"args":{"name":"Graph"}})";
+    }
+}
+
+void TraceRecorder::write_footer() {
+    if (out_format == format::CHROME_JSON) {
+        file << "\n]\n";
+    }
+}
+
+void TraceRecorder::begin_json_record() {
+    if (!first_record) {
+        file << ",\n";
+    }
+    first_record = false;
+}
+
+void TraceRecorder::write_event(event const& e) {
+    static const track_info unknown{"unknown", "unknown", "unknown", "", "unknown"};
+    const auto& t = e.track < tracks.size() ? tracks[e.track] : unknown;
+
+    char times[96];
+    if (out_format == format::CSV) {
+        if (e.type == event::kind::FRAME_TIME) {
+            file << e.frame << ";MegaMol;MegaMol;FrameTime;;0;0;CPU;;;" << e.value << "\n";
+            return;
+        }
+        if (e.type == event::kind::MEMORY) {
+            file << e.frame << ";Memory;" << t.parent << ";" << t.name << ";;0;0;Memory;;;"
+                 << static_cast<uint64_t>(e.value) << "\n";
+            return;
+        }
+        // same formatting as std::to_string(double)
+        std::snprintf(times, sizeof(times), "%f;%f;%f", static_cast<double>(e.start_ns),
+            static_cast<double>(e.end_ns), static_cast<double>(e.end_ns - e.start_ns));
+        file << e.frame << ";" << t.type << ";" << t.parent << ";" << t.name << ";" << t.comment << ";"
+             << e.global_index << ";" << e.frame_index << ";" << t.api << ";" << times << "\n";
+    } else {
+        begin_json_record();
+        if (e.type == event::kind::FRAME_TIME) {
+            std::snprintf(times, sizeof(times), "%.3f", static_cast<double>(e.start_ns) / 1000.0);
+            file << R"({"name":"FrameTime","ph":"C","pid":1,"tid":1,"ts":)" << times << R"(,"args":{"ms":)" << e.value
+                 << "}}";
+            return;
+        }
+        if (e.type == event::kind::MEMORY) {
+            std::snprintf(times, sizeof(times), "%.3f", static_cast<double>(e.start_ns) / 1000.0);
+            file << R"({"name":")" << escape_json(t.parent + "::" + t.name) << R"(","cat":"Memory","ph":"C","pid":1,)"
+                 << R"("tid":1,"ts":)" << times << R"(,"args":{"bytes":)" << static_cast<uint64_t>(e.value) << "}}";
+            return;
+        }
+        std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f", static_cast<double>(e.start_ns) / 1000.0,
+            static_cast<double>(e.end_ns - e.start_ns) / 1000.0);
+        file << R"({"name":")" << escape_json(t.parent + "::" + t.name) << R"(","cat":")" << escape_json(t.type)
+             << R"(","ph":"X","pid":1,"tid":)" << (t.api == "CPU" ? 1 : 2) << "," << times << R"(,"args":{"frame":)"
+             << e.frame << R"(,"frame_index":)" << e.frame_index << R"(,"global_index":)" << e.global_index
+             << R"(,"comment":")" << escape_json(t.comment) << R"("}})";
+    }
+}
+
+void TraceRecorder::write_graph_event(message const& m) {
+    if (out_format == format::CSV) {
+        file << m.frame << ";Graph;" << m.info.parent << ";" << m.info.name << ";" << m.info.comment
+             << ";0;0;GraphEvent;;;\n";
+    } else {
+        char time[32];
+        std::snprintf(time, sizeof(time), "%.3f", static_cast<double>(m.time_ns) / 1000.0);
+        begin_json_record();
+        file << R"({"name":")" << escape_json(m.info.comment) << R"(","cat":"Graph","ph":"i","s":"g","pid":1,)"
+             << R"("tid":3,"ts":)" << time << R"(,"args":{"frame":)" << m.frame << R"(,"parent":")"
+             << escape_json(m.info.parent) << R"(","name":")" << escape_json(m.info.name) << R"("}})";
+    }
+}
+
+std::string TraceRecorder::escape_json(std::string const& str) {
+    std::string result;
+    result.reserve(str.size());
+    for (const char c : str) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                result += code;
+            } else {
+                result += c;
+            }
+        }
+    }
+    return result;
+}
+
+int64_t TraceRecorder::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace megamol::frontend
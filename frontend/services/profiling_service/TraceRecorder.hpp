@@ -0,0 +1,135 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace megamol::frontend {
+
+/**
+ * Writes profiling events to a file without formatting them on the recording thread.
+ *
+ * Events are fixed-size binary records that are pushed into a lock-free single-producer ring buffer. A background
+ * thread drains the buffer and writes either the CSV log or, for files ending in ".json", the Chrome trace event
+ * format, which can be opened in chrome://tracing and Perfetto. The strings describing a timer are sent only once
+ * per track, through a separate, rarely used queue.
+ *
+ * All record methods must be called from the same thread.
+ */
+class TraceRecorder {
+public:
+    enum class format { CSV, CHROME_JSON };
+
+    /** Description of a timer, referenced by the events through its track id */
+    struct track_info {
+        std::string type;
+        std::string parent;
+        std::string name;
+        std::string comment;
+        std::string api;
+    };
+
+    struct event {
+        enum class kind : uint32_t { TIMER, FRAME_TIME, MEMORY };
+
+        kind type = kind::TIMER;
+        uint32_t track = 0;
+        uint32_t frame = 0;
+        uint32_t frame_index = 0;
+        int64_t global_index = 0;
+        int64_t start_ns = 0;
+        int64_t end_ns = 0;
+        double value = 0.0;
+    };
+
+    TraceRecorder() = default;
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * Opens the output file and starts the writer thread.
+     *
+     * @param path            The output file; the format is chosen by its extension.
+     * @param flush_frequency Flush the file every that many frames.
+     * @param capacity        The number of events the ring buffer holds, rounded up to a power of two.
+     */
+    bool open(std::string const& path, uint32_t flush_frequency, size_t capacity = size_t(1) << 16);
+
+    /** Writes all pending events, stops the writer thread and closes the file. */
+    void close();
+
+    bool is_open() const {
+        return writer.joinable();
+    }
+
+    /** Registers a timer description and answers its track id, which is never 0. */
+    uint32_t add_track(track_info info);
+
+    /** Records an event without blocking. Answers false and counts the event as dropped if the buffer is full. */
+    bool record(event const& e);
+
+    /** Records an instantaneous event of the module graph. */
+    void record_graph_event(uint32_t frame, std::string parent, std::string name, std::string comment);
+
+private:
+    /** Rare messages carrying strings: track descriptions and graph events */
+    struct message {
+        bool is_track = true;
+        uint32_t id = 0;
+        uint32_t frame = 0;
+        int64_t time_ns = 0;
+        track_info info;
+    };
+
+    void writer_loop();
+    void drain();
+
+    void write_header();
+    void write_footer();
+    void write_event(event const& e);
+    void write_graph_event(message const& m);
+    void begin_json_record();
+
+    static std::string escape_json(std::string const& str);
+    static int64_t now_ns();
+
+    // ring buffer, written by the recording thread and read by the writer thread
+    std::vector<event> ring;
+    size_t ring_mask = 0;
+    std::atomic<uint64_t> write_pos{0};
+    std::atomic<uint64_t> read_pos{0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::mutex message_mutex;
+    std::vector<message> messages;
+    uint32_t next_track = 1;
+
+    std::thread writer;
+    std::atomic_bool running{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+
+    // writer thread state
+    format out_format = format::CSV;
+    std::ofstream file;
+    uint32_t flush_frequency = 1;
+    uint32_t last_flushed_frame = 0;
+    bool first_record = true;
+    std::vector<track_info> tracks;
+    std::vector<message> pending_messages;
+};
+
+} // namespace megamol::frontend
@@ -195,6 +195,10 @@ public:
         return &(_point_data[idx * static_cast<std::size_t>(DIM)]);
     }
 
+    std::array<T, DIM> const& get_weights() const {
+        return _weights;
+    }
+
     void normalize_data() {
         std::array<T, DIM> mins;
         std::array<T, DIM> divs;
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -489,4 +495,228 @@ inline cluster_result_t GROWING_with_similarity_and_score(std::shared_ptr<kd_tre
 }
 
 
+namespace detail {
+
+/**
+ * Finds the root of 'x' in a concurrently modified union-find forest. Path halving is done with CAS, a failed CAS
+ * only means another thread already shortened the path.
+ */
+inline index_t uf_find(std::vector<std::atomic<index_t>>& parent, index_t x) {
+    while (true) {
+        auto p = parent[x].load(std::memory_order_relaxed);
+        auto const gp = parent[p].load(std::memory_order_relaxed);
+        if (p == gp) {
+            return p;
+        }
+        parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        x = gp;
+    }
+}
+
+/**
+ * Merges the sets of 'a' and 'b' lock-free. The larger root is always linked below the smaller one, so the final root
+ * of each set is its smallest index independent of the merge order.
+ */
+inline void uf_unite(std::vector<std::atomic<index_t>>& parent, index_t a, index_t b) {
+    while (true) {
+        a = uf_find(parent, a);
+        b = uf_find(parent, b);
+        if (a == b) {
+            return;
+        }
+        if (a > b) {
+            std::swap(a, b);
+        }
+        auto expected = b;
+        if (parent[b].compare_exchange_strong(expected, a, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * Parallel DBSCAN on a uniform grid.
+ *
+ * The points are sorted into cells whose extent in each dimension equals the search radius in the weighted metric of
+ * the point cloud, so all neighbours of a point lie in the 3^DIM surrounding cells (dimensions with zero weight do not
+ * restrict the distance and are not subdivided). Core points are marked in parallel, core points within the radius
+ * are merged with a lock-free union-find, and border points join the cluster with the smallest root among their core
+ * neighbours.
+ *
+ * The result matches the serial DBSCAN up to the assignment of border points reachable from several clusters:
+ * 'eps' is the squared search radius as well, noise is marked with cluster_type::NOISE and the clusters are numbered
+ * from NOISE + 1 in the order of their first point.
+ *
+ * @param data   The point cloud.
+ * @param eps    The squared search radius.
+ * @param minPts The minimum number of points (including the point itself) within the radius of a core point.
+ *
+ * @return The cluster id per point.
+ */
+template<typename T, int DIM>
+inline cluster_result_t DBSCAN_parallel(genericPointcloud<T, DIM> const& data, T eps, index_t minPts) {
+    using cell_t = std::array<int32_t, DIM>;
+    auto const num_points = data.kdtree_get_point_count();
+    cluster_result_t clusters(num_points, static_cast<cluster_type_ut>(cluster_type::NOISE));
+    if (num_points == 0) {
+        return clusters;
+    }
+    auto const num_points_s = static_cast<int64_t>(num_points);
+    eps = std::max(eps, std::numeric_limits<T>::min());
+
+    // grid setup
+    auto const& weights = data.get_weights();
+    std::array<T, DIM> inv_size;
+    std::array<T, DIM> origin;
+    for (int d = 0; d < DIM; ++d) {
+        inv_size[d] = weights[d] > static_cast<T>(0) ? std::sqrt(weights[d] / eps) : static_cast<T>(0);
+        origin[d] = data.get_position(0)[d];
+    }
+    for (std::size_t idx = 1; idx < num_points; ++idx) {
+        for (int d = 0; d < DIM; ++d) {
+            origin[d] = std::min(origin[d], data.get_position(idx)[d]);
+        }
+    }
+
+    // sort the points by cell
+    std::vector<std::pair<cell_t, index_t>> point_cells(num_points);
+#pragma omp parallel for
+    for (int64_t idx = 0; idx < num_points_s; ++idx) {
+        auto const pos = data.get_position(idx);
+        for (int d = 0; d < DIM; ++d) {
+            point_cells[idx].first[d] = static_cast<int32_t>(std::floor((pos[d] - origin[d]) * inv_size[d]));
+        }
+        point_cells[idx].second = static_cast<index_t>(idx);
+    }
+    std::sort(point_cells.begin(), point_cells.end());
+
+    std::vector<cell_t> cell_keys;
+    std::vector<index_t> cell_start;
+    std::vector<index_t> sorted_idx(num_points);
+    for (std::size_t i = 0; i < num_points; ++i) {
+        if (i == 0 || point_cells[i].first != point_cells[i - 1].first) {
+            cell_keys.push_back(point_cells[i].first);
+            cell_start.push_back(i);
+        }
+        sorted_idx[i] = point_cells[i].second;
+    }
+    cell_start.push_back(num_points);
+    point_cells.clear();
+    point_cells.shrink_to_fit();
+    auto const num_cells = static_cast<int64_t>(cell_keys.size());
+
+    // the non-empty neighbour cells of each cell (including the cell itself)
+    std::vector<std::vector<index_t>> cell_neighbours(num_cells);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int64_t c = 0; c < num_cells; ++c) {
+        int num_offsets = 1;
+        for (int d = 0; d < DIM; ++d) {
+            num_offsets *= (inv_size[d] > static_cast<T>(0)) ? 3 : 1;
+        }
+        for (int o = 0; o < num_offsets; ++o) {
+            cell_t key = cell_keys[c];
+            int rest = o;
+            for (int d = 0; d < DIM; ++d) {
+                if (inv_size[d] > static_cast<T>(0)) {
+                    key[d] += rest % 3 - 1;
+                    rest /= 3;
+                }
+            }
+            auto const it = std::lower_bound(cell_keys.cbegin(), cell_keys.cend(), key);
+            if (it != cell_keys.cend() && *it == key) {
+                cell_neighbours[c].push_back(static_cast<index_t>(it - cell_keys.cbegin()));
+            }
+        }
+    }
+
+    // calls 'func' for all points within the search radius of the point 'idx' in cell 'c' until it returns false
+    auto for_each_neighbour = [&](int64_t c, index_t idx, auto&& func) {
+        auto const query = data.get_position(idx);
+        for (auto const nc : cell_neighbours[c]) {
+            for (auto i = cell_start[nc]; i < cell_start[nc + 1]; ++i) {
+                auto const other = sorted_idx[i];
+                if (data.kdtree_distance(query, other, DIM) <= eps) {
+                    if (!func(other)) {
+                        return;
+                    }
+                }
+            }
+        }
+    };
+
+    // core point detection
+    std::vector<char> core(num_points, 0);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int64_t c = 0; c < num_cells; ++c) {
+        for (auto i = cell_start[c]; i < cell_start[c + 1]; ++i) {
+            auto const idx = sorted_idx[i];
+            index_t count = 0;
+            for_each_neighbour(c, idx, [&count, minPts](index_t) { return ++count < minPts; });
+            core[idx] = count >= minPts ? 1 : 0;
+        }
+    }
+
+    // merge core points within the search radius
+    std::vector<std::atomic<index_t>> parent(num_points);
+#pragma omp parallel for
+    for (int64_t idx = 0; idx < num_points_s; ++idx) {
+        parent[idx].store(static_cast<index_t>(idx), std::memory_order_relaxed);
+    }
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int64_t c = 0; c < num_cells; ++c) {
+        for (auto i = cell_start[c]; i < cell_start[c + 1]; ++i) {
+            auto const idx = sorted_idx[i];
+            if (core[idx] == 0) {
+                continue;
+            }
+            for_each_neighbour(c, idx, [&](index_t other) {
+                if (other > idx && core[other] != 0) {
+                    detail::uf_unite(parent, idx, other);
+                }
+                return true;
+            });
+        }
+    }
+
+    // roots of all points, border points take the smallest root of their core neighbours
+    auto const no_root = std::numeric_limits<index_t>::max();
+    std::vector<index_t> root(num_points, no_root);
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int64_t c = 0; c < num_cells; ++c) {
+        for (auto i = cell_start[c]; i < cell_start[c + 1]; ++i) {
+            auto const idx = sorted_idx[i];
+            if (core[idx] != 0) {
+                root[idx] = detail::uf_find(parent, idx);
+            } else {
+                index_t best = no_root;
+                for_each_neighbour(c, idx, [&](index_t other) {
+                    if (core[other] != 0) {
+                        best = std::min(best, detail::uf_find(parent, other));
+                    }
+                    return true;
+                });
+                root[idx] = best;
+            }
+        }
+    }
+
+    // number the clusters in the order of their first point
+    std::vector<index_t> root_label(num_points, 0);
+    index_t cluster_idx = static_cast<cluster_type_ut>(cluster_type::NOISE);
+    for (std::size_t idx = 0; idx < num_points; ++idx) {
+        if (root[idx] == no_root) {
+            continue;
+        }
+        auto& label = root_label[root[idx]];
+        if (label == 0) {
+            label = ++cluster_idx;
+        }
+        clusters[idx] = label;
+    }
+
+    return clusters;
+}
+
 } // namespace megamol::datatools::clustering
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <list>
+#include <unordered_map>
+
 #include "mmcore/param/ParamSlot.h"
 
 #include "datatools/AbstractParticleManipulator.h"
@@ -29,6 +32,16 @@ protected:
     bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
 
 private:
+    /** Cluster ids as colour index per particle list of one frame */
+    using frame_result_t = std::vector<std::vector<float>>;
+
+    frame_result_t computeClusters(geocalls::MultiParticleDataCall& data) const;
+
+    void clearCache() {
+        _result_cache.clear();
+        _result_order.clear();
+    }
+
     bool isDirty() {
         return _eps_slot.IsDirty() || _minpts_slot.IsDirty() || _icol_weight.IsDirty();
     }
@@ -45,11 +58,13 @@ private:
 
     core::param::ParamSlot _icol_weight;
 
-    std::vector<std::shared_ptr<genericPointcloud<float, 4>>> _points;
+    core::param::ParamSlot _cache_frames_slot;
 
-    std::vector<std::shared_ptr<kd_tree_t<float, 4>>> _kd_trees;
+    /** Clustering results of recently visited frames */
+    std::unordered_map<unsigned int, frame_result_t> _result_cache;
 
-    std::vector<std::vector<float>> _ret_cols;
+    /** Frame ids of '_result_cache' from most to least recently used */
+    std::list<unsigned int> _result_order;
 
     unsigned int _frame_id = std::numeric_limits<unsigned int>::max();
 
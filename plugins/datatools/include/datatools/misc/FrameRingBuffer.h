@@ -0,0 +1,86 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace megamol::datatools::misc {
+
+/**
+ * Fixed-size history of per-frame data. Inserting into a full buffer overwrites the oldest frame, which keeps the
+ * storage of the slots (and thus their allocations) for reuse.
+ */
+template<class T>
+class FrameRingBuffer {
+public:
+    /**
+     * Ctor.
+     *
+     * @param capacity The number of frames to keep, at least one.
+     */
+    explicit FrameRingBuffer(size_t capacity) : slots_(std::max<size_t>(capacity, 1)) {}
+
+    /**
+     * Answer the data of a frame.
+     *
+     * @param frame The frame ID.
+     *
+     * @return The data or nullptr if the frame is not in the buffer.
+     */
+    T* Find(unsigned int frame) {
+        auto const it = std::find_if(
+            slots_.begin(), slots_.end(), [frame](Slot const& s) { return s.valid && s.frame == frame; });
+        return it == slots_.end() ? nullptr : &it->data;
+    }
+
+    /**
+     * Answer a slot for a frame, replacing an existing entry of that frame or otherwise the oldest entry. The
+     * returned data still holds the content of the replaced frame and is to be overwritten by the caller.
+     *
+     * @param frame The frame ID.
+     *
+     * @return The data of the slot.
+     */
+    T& Insert(unsigned int frame) {
+        auto it = std::find_if(
+            slots_.begin(), slots_.end(), [frame](Slot const& s) { return s.valid && s.frame == frame; });
+        if (it == slots_.end()) {
+            it = slots_.begin() + next_;
+            next_ = (next_ + 1) % slots_.size();
+        }
+        it->frame = frame;
+        it->valid = true;
+        return it->data;
+    }
+
+    /**
+     * Marks all frames as invalid. The storage of the slots is kept.
+     */
+    void Clear() {
+        for (auto& s : slots_) {
+            s.valid = false;
+        }
+        next_ = 0;
+    }
+
+private:
+    struct Slot {
+        unsigned int frame = std::numeric_limits<unsigned int>::max();
+        bool valid = false;
+        T data;
+    };
+
+    std::vector<Slot> slots_;
+
+    /** The slot to be overwritten next */
+    size_t next_ = 0;
+};
+
+} // namespace megamol::datatools::misc
@@ -0,0 +1,99 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <omp.h>
+
+namespace megamol::datatools::misc {
+
+/**
+ * Stable parallel LSD radix sort of the keys and values in [begin, end) by the key.
+ *
+ * Each thread histograms a contiguous chunk, the scatter keeps the chunk order, which makes every pass stable. Passes
+ * in which all keys share the same digit are skipped.
+ *
+ * @param keys     The keys, sorted in place.
+ * @param values   The values, permuted along with the keys.
+ * @param begin    The first element to sort.
+ * @param end      One past the last element to sort.
+ * @param key_bits The number of low bits of the keys that are significant.
+ */
+template<class Value>
+void radix_sort(std::vector<uint64_t>& keys, std::vector<Value>& values, size_t begin, size_t end, int key_bits = 64) {
+    constexpr int digit_bits = 8;
+    constexpr size_t num_digits = size_t(1) << digit_bits;
+    auto const count = end - begin;
+    if (count < 2) {
+        return;
+    }
+    auto const num_chunks = static_cast<int64_t>(std::max(1, omp_get_max_threads()));
+    auto const chunk_size = (count + num_chunks - 1) / num_chunks;
+
+    std::vector<uint64_t> tmp_keys(count);
+    std::vector<Value> tmp_values(count);
+    std::vector<size_t> histograms(num_chunks * num_digits);
+
+    uint64_t* src_keys = keys.data() + begin;
+    Value* src_values = values.data() + begin;
+    uint64_t* dst_keys = tmp_keys.data();
+    Value* dst_values = tmp_values.data();
+
+    for (int shift = 0; shift < key_bits; shift += digit_bits) {
+        std::fill(histograms.begin(), histograms.end(), 0);
+#pragma omp parallel for schedule(static, 1)
+        for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+            auto const hist = histograms.data() + chunk * num_digits;
+            auto const chunk_end = std::min(count, (chunk + 1) * chunk_size);
+            for (size_t idx = chunk * chunk_size; idx < chunk_end; ++idx) {
+                ++hist[(src_keys[idx] >> shift) & (num_digits - 1)];
+            }
+        }
+
+        // exclusive prefix sum over (digit, chunk), which keeps the sort stable; a pass where all keys share the
+        // digit does not change the order and is skipped
+        size_t offset = 0;
+        bool trivial = false;
+        for (size_t digit = 0; digit < num_digits; ++digit) {
+            size_t digit_count = 0;
+            for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+                auto& h = histograms[chunk * num_digits + digit];
+                auto const c = h;
+                h = offset;
+                offset += c;
+                digit_count += c;
+            }
+            trivial = trivial || digit_count == count;
+        }
+        if (trivial) {
+            continue;
+        }
+
+#pragma omp parallel for schedule(static, 1)
+        for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+            auto const hist = histograms.data() + chunk * num_digits;
+            auto const chunk_end = std::min(count, (chunk + 1) * chunk_size);
+            for (size_t idx = chunk * chunk_size; idx < chunk_end; ++idx) {
+                auto const dst = hist[(src_keys[idx] >> shift) & (num_digits - 1)]++;
+                dst_keys[dst] = src_keys[idx];
+                dst_values[dst] = src_values[idx];
+            }
+        }
+        std::swap(src_keys, dst_keys);
+        std::swap(src_values, dst_values);
+    }
+
+    if (src_keys != keys.data() + begin) {
+        std::copy(src_keys, src_keys + count, keys.begin() + begin);
+        std::copy(src_values, src_values + count, values.begin() + begin);
+    }
+}
+
+} // namespace megamol::datatools::misc
@@ -0,0 +1,278 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <omp.h>
+
+#include "vislib/math/Cuboid.h"
+
+namespace megamol::datatools::misc {
+
+/**
+ * Neighbour lists with a skin distance (Verlet lists) for particles that move little between frames.
+ *
+ * Each particle stores all particles within 'cutoff + skin' at the time the lists were built. As long as no particle
+ * moved more than half of the skin since then, the lists still contain every pair closer than 'cutoff', thus queries
+ * only have to filter the candidates by their current distance. The lists are rebuilt with a uniform cell grid.
+ * Periodic boundaries use the minimum image convention.
+ */
+class VerletList {
+public:
+    /**
+     * Prepares the lists for the current positions. The lists are rebuilt if the particle count, the box, the periodic
+     * axes, the cutoff or the skin changed, or if any particle moved more than half of the skin since the last build.
+     *
+     * @param positions The positions stored as triples (xyzxyz...). Particle indices must refer to the same particles
+     *                  as in the previous call for the lists to be reused.
+     * @param cutoff    The largest distance that will be queried.
+     * @param skin      The additional distance stored in the lists.
+     * @param box       The simulation box.
+     * @param periodic  Whether each axis is periodic.
+     *
+     * @return 'true' if the lists have been rebuilt.
+     */
+    bool Update(std::vector<float> const& positions, float cutoff, float skin, vislib::math::Cuboid<float> const& box,
+        std::array<bool, 3> const& periodic) {
+        auto const count = positions.size() / 3;
+        bool const same_setup = count == reference_.size() / 3 && cutoff == cutoff_ && skin == skin_ &&
+                                periodic == periodic_ && box == box_ && !offsets_.empty();
+        cutoff_ = cutoff;
+        skin_ = skin;
+        box_ = box;
+        periodic_ = periodic;
+        extent_ = {box.Width(), box.Height(), box.Depth()};
+
+        if (same_setup && maxDisplacementSquared(positions) <= 0.25f * skin * skin) {
+            return false;
+        }
+        build(positions);
+        ++rebuild_count_;
+        return true;
+    }
+
+    /**
+     * Calls 'func(j, dist_sq)' for each particle 'j' other than 'idx' within 'radius' of particle 'idx'.
+     *
+     * @param idx       The query particle.
+     * @param positions The current positions, as passed to the last Update.
+     * @param radius    The query radius, must not exceed the cutoff.
+     * @param func      The callback.
+     */
+    template<class Func>
+    void ForEachNeighbour(size_t idx, std::vector<float> const& positions, float radius, Func func) const {
+        auto const r_sq = radius * radius;
+        auto const p = &positions[idx * 3];
+        for (auto n = offsets_[idx]; n < offsets_[idx + 1]; ++n) {
+            auto const j = neighbours_[n];
+            auto const d_sq = DistanceSquared(p, &positions[static_cast<size_t>(j) * 3]);
+            if (d_sq < r_sq) {
+                func(static_cast<size_t>(j), d_sq);
+            }
+        }
+    }
+
+    /**
+     * Answer the squared distance of two positions under the minimum image convention.
+     */
+    float DistanceSquared(float const* a, float const* b) const {
+        float d_sq = 0.0f;
+        for (int c = 0; c < 3; ++c) {
+            auto const d = delta(a[c], b[c], c);
+            d_sq += d * d;
+        }
+        return d_sq;
+    }
+
+    /** Answer the cutoff of the current lists */
+    float Cutoff() const {
+        return cutoff_;
+    }
+
+    /** Answer how often the lists have been rebuilt */
+    size_t RebuildCount() const {
+        return rebuild_count_;
+    }
+
+    /** Drops the lists, the next Update rebuilds them */
+    void Clear() {
+        reference_.clear();
+        offsets_.clear();
+        neighbours_.clear();
+    }
+
+private:
+    float delta(float a, float b, int axis) const {
+        auto d = b - a;
+        if (periodic_[axis] && extent_[axis] > 0.0f) {
+            d -= extent_[axis] * std::floor(d / extent_[axis] + 0.5f);
+        }
+        return d;
+    }
+
+    float maxDisplacementSquared(std::vector<float> const& positions) const {
+        auto const count = static_cast<int64_t>(positions.size() / 3);
+        std::vector<float> thread_max(omp_get_max_threads(), 0.0f);
+#pragma omp parallel for
+        for (int64_t i = 0; i < count; ++i) {
+            auto& m = thread_max[omp_get_thread_num()];
+            m = std::max(m, DistanceSquared(&reference_[i * 3], &positions[i * 3]));
+        }
+        return *std::max_element(thread_max.begin(), thread_max.end());
+    }
+
+    int cellCoord(float pos, int axis) const {
+        auto const rel = pos - origin(axis);
+        auto c = static_cast<int>(std::floor(rel / cell_size_[axis]));
+        if (periodic_[axis]) {
+            c %= resolution_[axis];
+            if (c < 0) {
+                c += resolution_[axis];
+            }
+        } else {
+            c = std::clamp(c, 0, resolution_[axis] - 1);
+        }
+        return c;
+    }
+
+    float origin(int axis) const {
+        return axis == 0 ? box_.Left() : (axis == 1 ? box_.Bottom() : box_.Back());
+    }
+
+    void build(std::vector<float> const& positions) {
+        reference_ = positions;
+        auto const count = positions.size() / 3;
+        auto const list_radius = cutoff_ + skin_;
+        auto const list_radius_sq = list_radius * list_radius;
+
+        // cells are at least as large as the list radius, thus only the 27 surrounding cells need to be visited. The
+        // number of cells is bounded relative to the number of particles to keep the grid compact.
+        auto const max_cells = std::max(64.0, 2.0 * static_cast<double>(count));
+        auto size = std::max(list_radius, 1e-6f);
+        while (true) {
+            double cells = 1.0;
+            for (int a = 0; a < 3; ++a) {
+                cells *= std::max(1.0, std::floor(static_cast<double>(extent_[a]) / size));
+            }
+            if (cells <= max_cells)
+                break;
+            size *= 1.25f;
+        }
+        for (int a = 0; a < 3; ++a) {
+            resolution_[a] = std::max(1, static_cast<int>(std::floor(extent_[a] / size)));
+            cell_size_[a] = extent_[a] > 0.0f ? extent_[a] / static_cast<float>(resolution_[a]) : 1.0f;
+        }
+        auto const num_cells = static_cast<size_t>(resolution_[0]) * resolution_[1] * resolution_[2];
+
+        // counting sort of the particles by cell
+        std::vector<uint32_t> cell_of(count);
+#pragma omp parallel for
+        for (int64_t i = 0; i < static_cast<int64_t>(count); ++i) {
+            auto const p = &positions[i * 3];
+            cell_of[i] = static_cast<uint32_t>(
+                cellCoord(p[0], 0) + resolution_[0] * (cellCoord(p[1], 1) + resolution_[1] * cellCoord(p[2], 2)));
+        }
+        std::vector<size_t> cell_start(num_cells + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            ++cell_start[cell_of[i] + 1];
+        }
+        for (size_t c = 0; c < num_cells; ++c) {
+            cell_start[c + 1] += cell_start[c];
+        }
+        std::vector<uint32_t> sorted(count);
+        {
+            std::vector<size_t> fill(cell_start.begin(), cell_start.end() - 1);
+            for (size_t i = 0; i < count; ++i) {
+                sorted[fill[cell_of[i]]++] = static_cast<uint32_t>(i);
+            }
+        }
+
+        // the neighbour cells along each axis, wrapped around periodic boundaries and without duplicates for grids
+        // with fewer than three cells
+        auto const neighbour_coords = [this](int c, int axis) {
+            std::vector<int> coords;
+            for (int o = -1; o <= 1; ++o) {
+                auto n = c + o;
+                if (periodic_[axis]) {
+                    n = (n + resolution_[axis]) % resolution_[axis];
+                } else if (n < 0 || n >= resolution_[axis]) {
+                    continue;
+                }
+                if (std::find(coords.begin(), coords.end(), n) == coords.end()) {
+                    coords.push_back(n);
+                }
+            }
+            return coords;
+        };
+
+        offsets_.assign(count + 1, 0);
+        std::vector<std::vector<uint32_t>> thread_neighbours(omp_get_max_threads());
+#pragma omp parallel
+        {
+            // static scheduling hands out contiguous particle ranges in thread order, so the per-thread lists can
+            // simply be concatenated afterwards
+            auto& local = thread_neighbours[omp_get_thread_num()];
+#pragma omp for schedule(static)
+            for (int64_t i = 0; i < static_cast<int64_t>(count); ++i) {
+                auto const p = &positions[i * 3];
+                auto const cell = cell_of[i];
+                auto const cx = static_cast<int>(cell % resolution_[0]);
+                auto const cy = static_cast<int>((cell / resolution_[0]) % resolution_[1]);
+                auto const cz = static_cast<int>(cell / (resolution_[0] * resolution_[1]));
+                auto const before = local.size();
+                for (auto const z : neighbour_coords(cz, 2)) {
+                    for (auto const y : neighbour_coords(cy, 1)) {
+                        for (auto const x : neighbour_coords(cx, 0)) {
+                            auto const n = x + resolution_[0] * (y + resolution_[1] * z);
+                            for (auto s = cell_start[n]; s < cell_start[n + 1]; ++s) {
+                                auto const j = sorted[s];
+                                if (static_cast<int64_t>(j) != i &&
+                                    DistanceSquared(p, &positions[static_cast<size_t>(j) * 3]) < list_radius_sq) {
+                                    local.push_back(j);
+                                }
+                            }
+                        }
+                    }
+                }
+                offsets_[i + 1] = local.size() - before;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            offsets_[i + 1] += offsets_[i];
+        }
+        neighbours_.resize(offsets_[count]);
+        size_t pos = 0;
+        for (auto& local : thread_neighbours) {
+            std::copy(local.begin(), local.end(), neighbours_.begin() + pos);
+            pos += local.size();
+        }
+    }
+
+    /** The positions at the time of the last build */
+    std::vector<float> reference_;
+    /** Start of the list of each particle in 'neighbours_' (count + 1 entries) */
+    std::vector<size_t> offsets_;
+    /** The concatenated neighbour lists */
+    std::vector<uint32_t> neighbours_;
+
+    float cutoff_ = 0.0f;
+    float skin_ = 0.0f;
+    vislib::math::Cuboid<float> box_;
+    std::array<float, 3> extent_ = {0.0f, 0.0f, 0.0f};
+    std::array<bool, 3> periodic_ = {false, false, false};
+    std::array<int, 3> resolution_ = {1, 1, 1};
+    std::array<float, 3> cell_size_ = {1.0f, 1.0f, 1.0f};
+
+    size_t rebuild_count_ = 0;
+};
+
+} // namespace megamol::datatools::misc
@@ -0,0 +1,509 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "MMPLDArena.h"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <omp.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mmcore/utility/log/Log.h"
+
+namespace megamol::datatools {
+
+namespace {
+
+/** A memory-mapped file */
+class MappedStorage : public MMPLDStorage {
+public:
+    ~MappedStorage() override {
+        if (data_ != nullptr) {
+#ifdef _WIN32
+            UnmapViewOfFile(data_);
+#else
+            munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+        }
+    }
+
+    /**
+     * Maps a whole file read-only.
+     *
+     * @return The mapping or nullptr on failure.
+     */
+    static std::shared_ptr<MappedStorage> Map(std::filesystem::path const& path) {
+        auto ret = std::shared_ptr<MappedStorage>(new MappedStorage());
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return nullptr;
+        }
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            return nullptr;
+        }
+        // the view keeps the file mapped after the handles are closed
+        ret->data_ = static_cast<uint8_t const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (ret->data_ == nullptr) {
+            return nullptr;
+        }
+        ret->size_ = static_cast<size_t>(size.QuadPart);
+#else
+        int const fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return nullptr;
+        }
+        void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            return nullptr;
+        }
+        madvise(ptr, static_cast<size_t>(st.st_size), MADV_WILLNEED);
+        ret->data_ = static_cast<uint8_t const*>(ptr);
+        ret->size_ = static_cast<size_t>(st.st_size);
+#endif
+        return ret;
+    }
+
+    uint8_t const* Data() const override {
+        return data_;
+    }
+
+    size_t Size() const override {
+        return size_;
+    }
+
+    bool IsMapped() const override {
+        return true;
+    }
+
+private:
+    MappedStorage() = default;
+
+    uint8_t const* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/** A heap block holding the frames of several files back to back */
+class HeapStorage : public MMPLDStorage {
+public:
+    explicit HeapStorage(size_t size) : data_(new uint8_t[size]), size_(size) {}
+
+    uint8_t const* Data() const override {
+        return data_.get();
+    }
+
+    uint8_t* Data() {
+        return data_.get();
+    }
+
+    size_t Size() const override {
+        return size_;
+    }
+
+    bool IsMapped() const override {
+        return false;
+    }
+
+private:
+    std::unique_ptr<uint8_t[]> data_;
+    size_t size_;
+};
+
+/** Frames shared between all modules of the process */
+struct Registry {
+    using Key = std::pair<std::filesystem::path, std::filesystem::file_time_type>;
+
+    std::mutex mutex;
+    std::map<Key, std::weak_ptr<MMPLDFrame const>> frames;
+
+    static Registry& Instance() {
+        static Registry registry;
+        return registry;
+    }
+};
+
+/** Bookkeeping of a file that is not registered yet */
+struct PendingFile {
+    size_t index;
+    std::filesystem::path path;
+    std::filesystem::file_time_type mtime;
+    uint16_t version = 0;
+    vislib::math::Cuboid<float> bbox;
+    uint64_t frame_begin = 0;
+    uint64_t frame_size = 0;
+    size_t arena_offset = 0;
+    std::shared_ptr<MMPLDFrame> frame;
+    std::string error;
+};
+
+/**
+ * Reads the file header and the position of the first frame.
+ */
+bool readHeader(PendingFile& file) {
+    std::ifstream in(file.path, std::ios::binary);
+    if (!in.is_open()) {
+        file.error = "cannot open file";
+        return false;
+    }
+    char magic[6];
+    uint16_t version = 0;
+    uint32_t frame_count = 0;
+    float box[6];
+    float clip_box[6];
+    uint64_t frame_offsets[2];
+    in.read(magic, 6);
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&frame_count), sizeof(frame_count));
+    in.read(reinterpret_cast<char*>(box), sizeof(box));
+    in.read(reinterpret_cast<char*>(clip_box), sizeof(clip_box));
+    in.read(reinterpret_cast<char*>(frame_offsets), sizeof(frame_offsets));
+    if (!in.good()) {
+        file.error = "file header truncated";
+        return false;
+    }
+    if (std::memcmp(magic, "MMPLD", 6) != 0) {
+        file.error = "file header id wrong";
+        return false;
+    }
+    if (version < 100 || version > 103) {
+        file.error = "file header version wrong";
+        return false;
+    }
+    if (frame_count == 0 || frame_offsets[1] <= frame_offsets[0]) {
+        file.error = "file does not contain any frame";
+        return false;
+    }
+    file.version = version;
+    file.bbox.Set(box[0], box[1], box[2], box[3], box[4], box[5]);
+    file.frame_begin = frame_offsets[0];
+    file.frame_size = frame_offsets[1] - frame_offsets[0];
+    return true;
+}
+
+/**
+ * Parses the particle lists of a frame without copying the particle data.
+ */
+bool parseFrame(uint8_t const* data, size_t size, uint16_t version, MMPLDFrame& frame, std::string& error) {
+    using SSP = geocalls::SimpleSphericalParticles;
+    size_t p = 0;
+    auto const fits = [&](size_t n) { return p + n <= size; };
+    auto const read = [&](auto& value) {
+        std::memcpy(&value, data + p, sizeof(value));
+        p += sizeof(value);
+    };
+
+    if (version >= 102) {
+        p += sizeof(float); // time stamp
+    }
+    uint32_t list_count = 0;
+    if (!fits(sizeof(list_count))) {
+        error = "frame truncated";
+        return false;
+    }
+    read(list_count);
+
+    frame.lists.resize(list_count);
+    for (auto& list : frame.lists) {
+        uint8_t vert_type = 0;
+        uint8_t col_type = 0;
+        if (!fits(2)) {
+            error = "frame truncated";
+            return false;
+        }
+        read(vert_type);
+        read(col_type);
+
+        size_t col_size = 0;
+        switch (vert_type) {
+        case 1:
+            list.vert_type = SSP::VERTDATA_FLOAT_XYZ;
+            list.vert_size = 12;
+            break;
+        case 2:
+            list.vert_type = SSP::VERTDATA_FLOAT_XYZR;
+            list.vert_size = 16;
+            break;
+        case 3:
+            list.vert_type = SSP::VERTDATA_SHORT_XYZ;
+            list.vert_size = 6;
+            break;
+        case 4:
+            list.vert_type = SSP::VERTDATA_DOUBLE_XYZ;
+            list.vert_size = 24;
+            break;
+        default:
+            list.vert_type = SSP::VERTDATA_NONE;
+            list.vert_size = 0;
+            break;
+        }
+        switch (vert_type != 0 ? col_type : 0) {
+        case 1:
+            list.col_type = SSP::COLDATA_UINT8_RGB;
+            col_size = 3;
+            break;
+        case 2:
+            list.col_type = SSP::COLDATA_UINT8_RGBA;
+            col_size = 4;
+            break;
+        case 3:
+            list.col_type = SSP::COLDATA_FLOAT_I;
+            col_size = 4;
+            break;
+        case 4:
+            list.col_type = SSP::COLDATA_FLOAT_RGB;
+            col_size = 12;
+            break;
+        case 5:
+            list.col_type = SSP::COLDATA_FLOAT_RGBA;
+            col_size = 16;
+            break;
+        case 6:
+            list.col_type = SSP::COLDATA_USHORT_RGBA;
+            col_size = 8;
+            break;
+        case 7:
+            list.col_type = SSP::COLDATA_DOUBLE_I;
+            col_size = 8;
+            break;
+        default:
+            list.col_type = SSP::COLDATA_NONE;
+            col_size = 0;
+            break;
+        }
+        list.stride = list.vert_size + col_size;
+
+        list.global_radius = 0.05f;
+        if (vert_type == 1 || vert_type == 3 || vert_type == 4) {
+            if (!fits(sizeof(float))) {
+                error = "frame truncated";
+                return false;
+            }
+            read(list.global_radius);
+        }
+        list.global_color[0] = list.global_color[1] = list.global_color[2] = 192;
+        list.global_color[3] = 255;
+        list.intensity_range[0] = 0.0f;
+        list.intensity_range[1] = 1.0f;
+        if (col_type == 0) {
+            if (!fits(4)) {
+                error = "frame truncated";
+                return false;
+            }
+            read(list.global_color);
+        } else if (col_type == 3 || col_type == 7) {
+            if (!fits(2 * sizeof(float))) {
+                error = "frame truncated";
+                return false;
+            }
+            read(list.intensity_range);
+        }
+
+        if (!fits(sizeof(list.count))) {
+            error = "frame truncated";
+            return false;
+        }
+        read(list.count);
+
+        list.has_bbox = version >= 103;
+        if (list.has_bbox) {
+            float box[6];
+            if (!fits(sizeof(box))) {
+                error = "frame truncated";
+                return false;
+            }
+            read(box);
+            list.bbox.Set(box[0], box[1], box[2], box[3], box[4], box[5]);
+        } else {
+            list.bbox = frame.bbox;
+        }
+
+        auto const list_size = static_cast<size_t>(list.count) * list.stride;
+        if (!fits(list_size)) {
+            error = "particle data truncated";
+            return false;
+        }
+        list.data = data + p;
+        p += list_size;
+
+        if (version == 101) {
+            // cluster infos are not forwarded, skip them
+            uint32_t num_clusters = 0;
+            uint64_t plain_size = 0;
+            if (!fits(sizeof(num_clusters) + sizeof(plain_size))) {
+                error = "cluster infos truncated";
+                return false;
+            }
+            read(num_clusters);
+            read(plain_size);
+            if (!fits(plain_size)) {
+                error = "cluster infos truncated";
+                return false;
+            }
+            p += plain_size;
+        }
+    }
+
+    frame.byte_size = size;
+    return true;
+}
+
+} // namespace
+
+
+std::vector<MMPLDArena::FramePtr> MMPLDArena::Load(std::vector<std::filesystem::path> const& paths, bool use_mmap) {
+    using megamol::core::utility::log::Log;
+
+    std::vector<FramePtr> ret(paths.size());
+    std::vector<PendingFile> pending;
+
+    // answer registered frames of unchanged files and collect the files that have to be read
+    {
+        auto& registry = Registry::Instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            std::error_code ec;
+            auto path = std::filesystem::canonical(paths[i], ec);
+            auto const mtime = ec ? std::filesystem::file_time_type() : std::filesystem::last_write_time(path, ec);
+            if (ec) {
+                Log::DefaultLog.WriteError("[MMPLDArena] Cannot access \"%s\": %s", paths[i].string().c_str(),
+                    ec.message().c_str());
+                continue;
+            }
+            auto const it = registry.frames.find(Registry::Key(path, mtime));
+            if (it != registry.frames.end()) {
+                ret[i] = it->second.lock();
+                if (ret[i] != nullptr) {
+                    continue;
+                }
+            }
+            PendingFile file;
+            file.index = i;
+            file.path = std::move(path);
+            file.mtime = mtime;
+            pending.push_back(std::move(file));
+        }
+    }
+
+    auto const pending_count = static_cast<int64_t>(pending.size());
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t i = 0; i < pending_count; ++i) {
+        readHeader(pending[i]);
+    }
+
+    // all frames read from disk go into one arena
+    std::shared_ptr<HeapStorage> arena;
+    if (!use_mmap) {
+        size_t arena_size = 0;
+        for (auto& file : pending) {
+            if (file.error.empty()) {
+                file.arena_offset = arena_size;
+                arena_size += file.frame_size;
+            }
+        }
+        if (arena_size > 0) {
+            arena = std::make_shared<HeapStorage>(arena_size);
+        }
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t i = 0; i < pending_count; ++i) {
+        auto& file = pending[i];
+        if (!file.error.empty()) {
+            continue;
+        }
+
+        uint8_t const* frame_data = nullptr;
+        std::shared_ptr<MMPLDStorage const> storage;
+        if (use_mmap) {
+            auto mapping = MappedStorage::Map(file.path);
+            if (mapping == nullptr) {
+                file.error = "cannot map file";
+                continue;
+            }
+            if (file.frame_begin + file.frame_size > mapping->Size()) {
+                file.error = "frame exceeds the file";
+                continue;
+            }
+            frame_data = mapping->Data() + file.frame_begin;
+            storage = std::move(mapping);
+        } else {
+            std::ifstream in(file.path, std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(file.frame_begin));
+            in.read(reinterpret_cast<char*>(arena->Data() + file.arena_offset),
+                static_cast<std::streamsize>(file.frame_size));
+            if (!in.good()) {
+                file.error = "cannot read frame";
+                continue;
+            }
+            frame_data = arena->Data() + file.arena_offset;
+            storage = arena;
+        }
+
+        auto frame = std::make_shared<MMPLDFrame>();
+        frame->path = file.path;
+        frame->mtime = file.mtime;
+        frame->bbox = file.bbox;
+        frame->storage = std::move(storage);
+        if (!parseFrame(frame_data, file.frame_size, file.version, *frame, file.error)) {
+            continue;
+        }
+        file.frame = std::move(frame);
+    }
+
+    {
+        auto& registry = Registry::Instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        // drop entries of frames that are no longer used by anyone
+        for (auto it = registry.frames.begin(); it != registry.frames.end();) {
+            if (it->second.expired()) {
+                it = registry.frames.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto& file : pending) {
+            if (file.frame == nullptr) {
+                Log::DefaultLog.WriteError(
+                    "[MMPLDArena] Cannot load \"%s\": %s", file.path.string().c_str(), file.error.c_str());
+                continue;
+            }
+            registry.frames[Registry::Key(file.path, file.mtime)] = file.frame;
+            ret[file.index] = std::move(file.frame);
+        }
+    }
+
+    return ret;
+}
+
+} // namespace megamol::datatools
@@ -0,0 +1,98 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "geometry_calls/SimpleSphericalParticles.h"
+#include "vislib/math/Cuboid.h"
+
+namespace megamol::datatools {
+
+/**
+ * Read-only memory holding loaded MMPLD data, either a memory-mapped file or a heap block shared by several frames.
+ */
+class MMPLDStorage {
+public:
+    virtual ~MMPLDStorage() = default;
+
+    /** Answer the first byte of the storage */
+    virtual uint8_t const* Data() const = 0;
+
+    /** Answer the size of the storage in bytes */
+    virtual size_t Size() const = 0;
+
+    /** Answer whether the storage is a memory-mapped file */
+    virtual bool IsMapped() const = 0;
+};
+
+/**
+ * The first frame of an MMPLD file. The particle lists point into the storage, which is kept alive by the frame.
+ * Frames are immutable and may be shared between any number of modules.
+ */
+struct MMPLDFrame {
+    /** A particle list of the frame */
+    struct List {
+        geocalls::SimpleSphericalParticles::VertexDataType vert_type;
+        geocalls::SimpleSphericalParticles::ColourDataType col_type;
+        uint64_t count;
+        /** Size of the vertex data of one particle, the colour data follows directly */
+        size_t vert_size;
+        /** Size of one particle including vertex and colour data */
+        size_t stride;
+        float global_radius;
+        uint8_t global_color[4];
+        float intensity_range[2];
+        /** Whether the file stores a bounding box per list (version 103 and up) */
+        bool has_bbox;
+        vislib::math::Cuboid<float> bbox;
+        /** The interleaved particle data */
+        uint8_t const* data;
+    };
+
+    /** The canonical path of the file */
+    std::filesystem::path path;
+    /** The modification time of the file when it was loaded */
+    std::filesystem::file_time_type mtime;
+    /** The bounding box from the file header */
+    vislib::math::Cuboid<float> bbox;
+    /** The particle lists of the frame */
+    std::vector<List> lists;
+    /** Size of the frame data in bytes */
+    size_t byte_size = 0;
+    /** The memory the lists point into */
+    std::shared_ptr<MMPLDStorage const> storage;
+};
+
+/**
+ * Loads the first frame of many MMPLD files in parallel and shares them process-wide.
+ *
+ * Files are either memory-mapped or read into one heap arena per call of Load. Loaded frames are registered by
+ * canonical path and modification time. As long as any module holds a frame, loading the same unchanged file again
+ * answers the registered frame instead of reading the file a second time.
+ */
+class MMPLDArena {
+public:
+    using FramePtr = std::shared_ptr<MMPLDFrame const>;
+
+    /**
+     * Loads the first frame of each file.
+     *
+     * @param paths    The MMPLD files.
+     * @param use_mmap Memory-map the files instead of reading them into a heap arena.
+     *
+     * @return The frames in the order of 'paths'. Files that cannot be loaded yield nullptr.
+     */
+    static std::vector<FramePtr> Load(std::vector<std::filesystem::path> const& paths, bool use_mmap);
+
+    MMPLDArena() = delete;
+};
+
+} // namespace megamol::datatools
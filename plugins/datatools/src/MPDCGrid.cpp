@@ -1,5 +1,10 @@
 #include "MPDCGrid.h"
 
+#include <algorithm>
+
+#include <omp.h>
+
+#include "datatools/misc/RadixSort.h"
 #include "mmcore/param/IntParam.h"
 
 
@@ -47,61 +52,31 @@ bool megamol::datatools::MPDCGrid::getDataCallback(core::Call& c) {
     if (inData == nullptr)
         return false;
 
-    if (data_in_hash_ != inData->DataHash() || out_frame_id_ != inData->FrameID()) {
-        data_in_hash_ = inData->DataHash();
-        out_frame_id_ = inData->FrameID();
-
-        if (!(*inData)(0))
-            return false;
-
-        auto const plc = inData->GetParticleListCount();
-        auto const cbbox = inData->AccessBoundingBoxes().ObjectSpaceClipBox();
-
-        data_.resize(plc);
-        output_.clear();
-
-        for (size_t plidx = 0; plidx < plc; ++plidx) {
-            auto const& particles = inData->AccessParticles(plidx);
-
-            auto const parStore = particles.GetParticleStore();
-            auto const xAcc = parStore.GetXAcc();
-            auto const yAcc = parStore.GetYAcc();
-            auto const zAcc = parStore.GetZAcc();
-            auto const crAcc = parStore.GetCRAcc();
-            auto const cgAcc = parStore.GetCGAcc();
-            auto const cbAcc = parStore.GetCBAcc();
-            auto const caAcc = parStore.GetCAAcc();
-
-            auto const pcount = particles.GetCount();
-
-            data_[plidx].resize(pcount);
-
-            for (size_t pidx = 0; pidx < pcount; ++pidx) {
-                data_[plidx][pidx] = {{xAcc->Get_f(pidx), yAcc->Get_f(pidx), zAcc->Get_f(pidx)}, crAcc->Get_u8(pidx),
-                    cgAcc->Get_u8(pidx), cbAcc->Get_u8(pidx), caAcc->Get_u8(pidx)};
-            }
-
-            auto const maxSize = max_size_slot_.Param<core::param::IntParam>()->Value();
-            auto grid = gridify(data_[plidx],
-                {{cbbox.Left(), cbbox.Bottom(), cbbox.Back()}, {cbbox.Right(), cbbox.Top(), cbbox.Front()}}, maxSize, 0,
-                pcount);
+    bool const input_changed = data_in_hash_ != inData->DataHash() || out_frame_id_ != inData->FrameID();
+    if (input_changed || max_size_slot_.IsDirty()) {
+        if (input_changed) {
+            data_in_hash_ = inData->DataHash();
+            out_frame_id_ = inData->FrameID();
 
-            auto ssps = separate(data_[plidx], grid, particles.GetGlobalRadius());
+            if (!(*inData)(0))
+                return false;
 
-            ssps.erase(
-                std::remove_if(ssps.begin(), ssps.end(), [](auto const& a) { return a.GetCount() == 0; }), ssps.end());
-
-            output_.insert(output_.end(), ssps.cbegin(), ssps.cend());
+            sortParticles(*inData);
         }
 
-        outData->SetParticleListCount(output_.size());
-        for (size_t plidx = 0; plidx < output_.size(); ++plidx) {
-            outData->AccessParticles(plidx) = output_[plidx];
-        }
+        // a new brick size only requires new cuts through the already sorted particles
+        auto const maxSize = static_cast<size_t>(max_size_slot_.Param<core::param::IntParam>()->Value());
+        max_size_slot_.ResetDirty();
+        cutBricks(maxSize);
 
         ++data_out_hash_;
     }
 
+    outData->SetParticleListCount(output_.size());
+    for (size_t plidx = 0; plidx < output_.size(); ++plidx) {
+        outData->AccessParticles(plidx) = output_[plidx];
+    }
+
     outData->SetDataHash(data_out_hash_);
     outData->SetFrameID(inData->FrameID());
 
@@ -134,48 +109,158 @@ bool megamol::datatools::MPDCGrid::getExtentCallback(core::Call& c) {
 }
 
 
-std::vector<megamol::datatools::MPDCGrid::BrickLet> megamol::datatools::MPDCGrid::gridify(
-    std::vector<megamol::datatools::MPDCGrid::Particle>& particles, Box const& bbox, size_t maxSize, size_t begin,
-    size_t end) {
-    auto const pcount = end - begin;
+void megamol::datatools::MPDCGrid::sortParticles(geocalls::MultiParticleDataCall& inData) {
+    auto const plc = inData.GetParticleListCount();
 
-    std::vector<BrickLet> ret;
-    ret.reserve((pcount / maxSize) + 1);
+    lists_.resize(plc);
+    size_t total = 0;
+    for (unsigned int plidx = 0; plidx < plc; ++plidx) {
+        auto const& particles = inData.AccessParticles(plidx);
+        lists_[plidx] = {total, total + particles.GetCount(), particles.GetGlobalRadius()};
+        total += particles.GetCount();
+    }
 
-    if (pcount <= maxSize) {
-        ret.push_back({begin, end, bbox});
-        return ret;
-    } else {
-        auto const bspan = bbox.span();
-        auto const dim = arg_max(bspan);
+    std::vector<Particle> unsorted(total);
+    keys_.resize(total);
+    data_.resize(total);
+    std::vector<size_t> order(total);
+
+    for (unsigned int plidx = 0; plidx < plc; ++plidx) {
+        auto const& particles = inData.AccessParticles(plidx);
+        auto const begin = lists_[plidx].begin;
+        auto const pcount = static_cast<int64_t>(lists_[plidx].end - begin);
+        if (pcount == 0) {
+            continue;
+        }
 
-        auto const splitPos = bbox.calc_center()[dim];
+        auto const data = unsorted.data() + begin;
+        particles.DispatchTyped([data, pcount](auto const& xAcc, auto const& yAcc, auto const& zAcc,
+                                    auto const& /*rAcc*/, auto const& crAcc, auto const& cgAcc, auto const& cbAcc,
+                                    auto const& caAcc) {
+#pragma omp parallel for
+            for (int64_t pidx = 0; pidx < pcount; ++pidx) {
+                data[pidx] = {{xAcc.template Get<float>(pidx), yAcc.template Get<float>(pidx),
+                                  zAcc.template Get<float>(pidx)},
+                    crAcc.template Get<unsigned char>(pidx), cgAcc.template Get<unsigned char>(pidx),
+                    cbAcc.template Get<unsigned char>(pidx), caAcc.template Get<unsigned char>(pidx)};
+            }
+        });
+
+        // Morton keys relative to the tight bounds of the list
+        auto const bounds = computeBounds(unsorted, begin, begin + pcount);
+        auto const span = bounds.span();
+        float scale[3];
+        for (int d = 0; d < 3; ++d) {
+            scale[d] = span[d] > 0.0f ? static_cast<float>(morton_resolution - 1) / span[d] : 0.0f;
+        }
+#pragma omp parallel for
+        for (int64_t pidx = 0; pidx < pcount; ++pidx) {
+            auto const& pos = data[pidx].pos;
+            uint64_t key = 0;
+            for (int d = 0; d < 3; ++d) {
+                auto const q = static_cast<uint64_t>(std::clamp((pos[d] - bounds.lower[d]) * scale[d], 0.0f,
+                    static_cast<float>(morton_resolution - 1)));
+                key |= spread_bits(q) << d;
+            }
+            keys_[begin + pidx] = key;
+            order[begin + pidx] = begin + pidx;
+        }
 
-        /*for (size_t pidx = 0; pidx < pcount; ++pidx) {
-        }*/
-        auto it = std::partition(particles.begin() + begin, particles.begin() + end,
-            [dim, splitPos](auto const& a) { return a.pos[dim] < splitPos; });
-        auto mid = std::distance(particles.begin(), it);
+        misc::radix_sort(keys_, order, begin, begin + pcount, 3 * morton_bits);
+    }
 
-        auto lbounds = bbox;
-        lbounds.upper[dim] = splitPos;
-        auto rbounds = bbox;
-        rbounds.lower[dim] = splitPos;
+#pragma omp parallel for
+    for (int64_t idx = 0; idx < static_cast<int64_t>(total); ++idx) {
+        data_[idx] = unsorted[order[idx]];
+    }
+}
 
-        auto left = gridify(particles, lbounds, maxSize, begin, mid);
-        auto right = gridify(particles, rbounds, maxSize, mid, end);
 
-        ret.insert(ret.end(), left.cbegin(), left.cend());
-        ret.insert(ret.end(), right.cbegin(), right.cend());
+void megamol::datatools::MPDCGrid::cutBricks(size_t maxSize) {
+    std::vector<std::vector<BrickLet>> list_bricks(lists_.size());
+    for (size_t plidx = 0; plidx < lists_.size(); ++plidx) {
+        if (lists_[plidx].begin != lists_[plidx].end) {
+            splitBrick(lists_[plidx].begin, lists_[plidx].end, 0, std::max<size_t>(maxSize, 1), list_bricks[plidx]);
+        }
     }
 
-    return ret;
+    bricks_.clear();
+    std::vector<float> radii;
+    for (size_t plidx = 0; plidx < lists_.size(); ++plidx) {
+        bricks_.insert(bricks_.end(), list_bricks[plidx].cbegin(), list_bricks[plidx].cend());
+        radii.insert(radii.end(), list_bricks[plidx].size(), lists_[plidx].radius);
+    }
+
+    // tight bounds of each brick for culling
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t bidx = 0; bidx < static_cast<int64_t>(bricks_.size()); ++bidx) {
+        bricks_[bidx].bounds = computeBounds(data_, bricks_[bidx].begin, bricks_[bidx].end);
+    }
+
+    output_ = separate(data_, bricks_, radii);
+}
+
+
+void megamol::datatools::MPDCGrid::splitBrick(
+    size_t begin, size_t end, int level, size_t maxSize, std::vector<BrickLet>& bricks) const {
+    if (end - begin <= maxSize || level == morton_bits) {
+        bricks.push_back({begin, end, {}});
+        return;
+    }
+
+    // the keys of the range share their top 'level' octree digits, the next digit selects the child octant
+    auto const shift = 3 * (morton_bits - level - 1);
+    size_t children[9];
+    children[0] = begin;
+    for (uint64_t octant = 0; octant < 8; ++octant) {
+        children[octant + 1] = std::partition_point(keys_.cbegin() + children[octant], keys_.cbegin() + end,
+                                   [shift, octant](uint64_t key) { return ((key >> shift) & 7) <= octant; }) -
+                               keys_.cbegin();
+    }
+
+    // consecutive octants are adjacent on the Morton curve, thus small siblings are merged into one brick
+    size_t run_begin = begin;
+    for (int octant = 0; octant < 8; ++octant) {
+        auto const child_begin = children[octant];
+        auto const child_end = children[octant + 1];
+        if (child_end - child_begin > maxSize) {
+            if (run_begin != child_begin) {
+                bricks.push_back({run_begin, child_begin, {}});
+            }
+            splitBrick(child_begin, child_end, level + 1, maxSize, bricks);
+            run_begin = child_end;
+        } else if (child_end - run_begin > maxSize) {
+            bricks.push_back({run_begin, child_begin, {}});
+            run_begin = child_begin;
+        }
+    }
+    if (run_begin != end) {
+        bricks.push_back({run_begin, end, {}});
+    }
+}
+
+
+megamol::datatools::MPDCGrid::Box megamol::datatools::MPDCGrid::computeBounds(
+    std::vector<Particle> const& particles, size_t begin, size_t end) {
+    Box bounds;
+    bounds.lower.Set(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max());
+    bounds.upper.Set(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::lowest());
+    for (size_t pidx = begin; pidx < end; ++pidx) {
+        auto const& pos = particles[pidx].pos;
+        for (int d = 0; d < 3; ++d) {
+            bounds.lower[d] = std::min(bounds.lower[d], pos[d]);
+            bounds.upper[d] = std::max(bounds.upper[d], pos[d]);
+        }
+    }
+    return bounds;
 }
 
 
 std::vector<megamol::geocalls::SimpleSphericalParticles> megamol::datatools::MPDCGrid::separate(
     std::vector<megamol::datatools::MPDCGrid::Particle> const& particles,
-    std::vector<megamol::datatools::MPDCGrid::BrickLet> const& bricks, float radius) {
+    std::vector<megamol::datatools::MPDCGrid::BrickLet> const& bricks, std::vector<float> const& radii) {
     std::vector<geocalls::SimpleSphericalParticles> ret(bricks.size());
     auto vert_base = reinterpret_cast<char const*>(particles.data());
     auto col_base = vert_base + sizeof(vislib::math::Point<float, 3>);
@@ -188,7 +273,10 @@ std::vector<megamol::geocalls::SimpleSphericalParticles> megamol::datatools::MPD
             vert_base + brick.begin * particle_size, particle_size);
         ssp.SetColourData(geocalls::SimpleSphericalParticles::COLDATA_UINT8_RGBA,
             col_base + brick.begin * particle_size, particle_size);
-        ssp.SetGlobalRadius(radius);
+        ssp.SetGlobalRadius(radii[i]);
+        ssp.SetBBox(vislib::math::Cuboid<float>(brick.bounds.lower[0] - radii[i], brick.bounds.lower[1] - radii[i],
+            brick.bounds.lower[2] - radii[i], brick.bounds.upper[0] + radii[i], brick.bounds.upper[1] + radii[i],
+            brick.bounds.upper[2] + radii[i]));
         ++i;
     }
     return ret;
@@ -38,6 +38,12 @@ public:
         Box bounds;
     };
 
+    /** Range of an input list within the sorted particle buffer */
+    struct ListRange {
+        size_t begin, end;
+        float radius;
+    };
+
     /**
      * Answer the name of this module.
      *
@@ -79,11 +85,36 @@ private:
 
     bool getExtentCallback(core::Call& c);
 
-    std::vector<BrickLet> gridify(
-        std::vector<Particle>& particles, Box const& bbox, size_t maxSize, size_t begin, size_t end);
+    /** Copies all lists into one buffer and sorts each list along the Morton curve of its bounds */
+    void sortParticles(geocalls::MultiParticleDataCall& inData);
+
+    /** Cuts the sorted lists into bricks of at most 'maxSize' particles and builds the output lists */
+    void cutBricks(size_t maxSize);
 
-    std::vector<geocalls::SimpleSphericalParticles> separate(
-        std::vector<Particle> const& particles, std::vector<BrickLet> const& bricks, float radius);
+    /** Recursively splits the range [begin, end) at octree cells of the given level, merging small siblings */
+    void splitBrick(size_t begin, size_t end, int level, size_t maxSize, std::vector<BrickLet>& bricks) const;
+
+    static Box computeBounds(std::vector<Particle> const& particles, size_t begin, size_t end);
+
+    /** Spreads the lower 21 bits of 'v' to every third bit */
+    static uint64_t spread_bits(uint64_t v) {
+        v &= 0x1fffff;
+        v = (v | v << 32) & 0x1f00000000ffff;
+        v = (v | v << 16) & 0x1f0000ff0000ff;
+        v = (v | v << 8) & 0x100f00f00f00f00f;
+        v = (v | v << 4) & 0x10c30c30c30c30c3;
+        v = (v | v << 2) & 0x1249249249249249;
+        return v;
+    }
+
+    static std::vector<geocalls::SimpleSphericalParticles> separate(
+        std::vector<Particle> const& particles, std::vector<BrickLet> const& bricks, std::vector<float> const& radii);
+
+    /** Number of octree levels encoded in the Morton keys */
+    static constexpr int morton_bits = 21;
+
+    /** Number of quantization steps per dimension */
+    static constexpr uint64_t morton_resolution = uint64_t(1) << morton_bits;
 
     core::CalleeSlot data_out_slot_;
 
@@ -97,7 +128,15 @@ private:
 
     int out_frame_id_;
 
-    std::vector<std::vector<Particle>> data_;
+    /** All particles, each list sorted along its Morton curve */
+    std::vector<Particle> data_;
+
+    /** Morton keys of 'data_' */
+    std::vector<uint64_t> keys_;
+
+    std::vector<ListRange> lists_;
+
+    std::vector<BrickLet> bricks_;
 
     std::vector<geocalls::SimpleSphericalParticles> output_;
 }; // class MPDCGrid
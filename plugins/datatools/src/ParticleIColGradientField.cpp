@@ -7,13 +7,17 @@
 #include "ParticleIColGradientField.h"
 #include "datatools/MultiParticleDataAdaptor.h"
 
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
-#include "vislib/math/ShallowPoint.h"
-#include "vislib/math/Vector.h"
+#include "mmcore/utility/log/Log.h"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <nanoflann.hpp>
+#include <omp.h>
 #include <utility>
 
 using namespace megamol;
@@ -25,12 +29,20 @@ using namespace megamol;
 datatools::ParticleIColGradientField::ParticleIColGradientField()
         : AbstractParticleManipulator("outData", "indata")
         , radiusSlot("radius", "The neighbourhood radius size")
+        , methodSlot("method", "The gradient estimation method")
         , datahash(0)
         , time(0)
         , newColors() {
 
     this->radiusSlot.SetParameter(new core::param::FloatParam(0.05f, 0.000001f));
     this->MakeSlotAvailable(&this->radiusSlot);
+
+    auto* method = new core::param::EnumParam(METHOD_NEIGHBOUR_AVERAGE);
+    method->SetTypePair(METHOD_NEIGHBOUR_AVERAGE, "Neighbour Average");
+    method->SetTypePair(METHOD_LEAST_SQUARES, "Least Squares");
+    method->SetTypePair(METHOD_GRID, "Grid (fast)");
+    this->methodSlot.SetParameter(method);
+    this->MakeSlotAvailable(&this->methodSlot);
 }
 
 
@@ -53,8 +65,9 @@ bool datatools::ParticleIColGradientField::manipulateData(
     inData.SetUnlocker(nullptr, false); // keep original data locked
                                         // original data will be unlocked through outData
 
-    if (this->radiusSlot.IsDirty()) {
+    if (this->radiusSlot.IsDirty() || this->methodSlot.IsDirty()) {
         this->radiusSlot.ResetDirty();
+        this->methodSlot.ResetDirty();
         this->datahash = 0;
     }
     if ((this->datahash == 0) || (this->datahash != outData.DataHash()) || (this->time != outData.FrameID())) {
@@ -73,11 +86,14 @@ bool datatools::ParticleIColGradientField::manipulateData(
 namespace {
 
 /**
- * Utility class forming a data adapter for nanoflann
+ * Utility class forming a data adapter for nanoflann on the gathered particle positions
  */
-class DataAdapter : public datatools::MultiParticleDataAdaptor {
+class DataAdapter {
 public:
-    DataAdapter(geocalls::MultiParticleDataCall& dat) : datatools::MultiParticleDataAdaptor(dat) {
+    DataAdapter(const std::vector<float>& pos, const float* bboxMin, const float* bboxMax)
+            : pos(pos)
+            , bboxMin(bboxMin)
+            , bboxMax(bboxMax) {
         // intentionally empty
     }
     ~DataAdapter() {
@@ -85,14 +101,14 @@ public:
     }
     // Must return the number of data points
     inline size_t kdtree_get_point_count() const {
-        return get_count();
+        return pos.size() / 3;
     }
 
     typedef float coord_t;
 
     // Returns the distance between the vector "p1[0:size-1]" and the data point with index "idx_p2" stored in the class:
     inline coord_t kdtree_distance(const coord_t* p1, const size_t idx_p2, size_t /*size*/) const {
-        float const* p2 = get_position(idx_p2);
+        float const* p2 = &pos[idx_p2 * 3];
         const coord_t d0 = p1[0] - p2[0];
         const coord_t d1 = p1[1] - p2[1];
         const coord_t d2 = p1[2] - p2[2];
@@ -104,7 +120,7 @@ public:
     //  "if/else's" are actually solved at compile time.
     inline coord_t kdtree_get_pt(const size_t idx, int dim) const {
         assert((dim >= 0) && (dim < 3));
-        return get_position(idx)[dim];
+        return pos[idx * 3 + dim];
     }
 
     // Optional bounding-box computation: return false to default to a standard bbox computation loop.
@@ -112,79 +128,326 @@ public:
     //   Look at bb.size() to find out the expected dimensionality (e.g. 2 or 3 for point clouds)
     template<class BBOX>
     bool kdtree_get_bbox(BBOX& bb) const {
-        //return false;
-
         assert(bb.size() == 3);
-        const auto& cbox = data.GetBoundingBoxes().ObjectSpaceClipBox();
-        bb[0].low = cbox.Left();
-        bb[0].high = cbox.Right();
-        bb[1].low = cbox.Bottom();
-        bb[1].high = cbox.Top();
-        bb[2].low = cbox.Back();
-        bb[2].high = cbox.Front();
+        for (int d = 0; d < 3; ++d) {
+            bb[d].low = bboxMin[d];
+            bb[d].high = bboxMax[d];
+        }
         return true;
     }
-};
-} // namespace
 
-void datatools::ParticleIColGradientField::compute_colors(geocalls::MultiParticleDataCall& dat) {
-    DataAdapter data(dat);
-
-    this->newColors.resize(data.kdtree_get_point_count() /* * 3*/);
-    float rad = this->radiusSlot.Param<core::param::FloatParam>()->Value();
-
-    // construct a kd-tree index:
-    typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, DataAdapter>, DataAdapter,
-        3 /* dim */, std::size_t>
-        my_kd_tree_t;
-
-    my_kd_tree_t index(3 /*dim*/, data, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-    index.buildIndex();
+private:
+    const std::vector<float>& pos;
+    const float* bboxMin;
+    const float* bboxMax;
+};
 
-    double maxLen = 0.0;
+/**
+ * Particles sorted into a regular grid (counting sort), so that the particles of each cell are contiguous in 'order'
+ */
+struct SpatialBins {
+    float origin[3];
+    float cellSize;
+    int res[3];
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> order;
+
+    inline size_t cellCount() const {
+        return static_cast<size_t>(res[0]) * res[1] * res[2];
+    }
 
-    std::vector<nanoflann::ResultItem<size_t, float>> res;
-    res.reserve(100);
+    inline int cellCoord(float p, int d) const {
+        return std::clamp(static_cast<int>((p - origin[d]) / cellSize), 0, res[d] - 1);
+    }
 
-    //#pragma omp parallel for
-    for (int part_i = 0; part_i < static_cast<int>(data.kdtree_get_point_count()); ++part_i) {
-        // compute gradient vector for point i
+    inline size_t cellIndex(int x, int y, int z) const {
+        return static_cast<size_t>(x) + (static_cast<size_t>(y) + static_cast<size_t>(z) * res[1]) * res[0];
+    }
+};
 
-        vislib::math::ShallowPoint<const float, 3> query_pos(data.get_position(part_i));
-        const float* query_col = data.get_color(part_i);
+/**
+ * Sorts the particles into cells of at least 'cellSize'. The cell size is increased until the grid has at most
+ * 'maxCells' cells to bound the memory footprint.
+ */
+void binParticles(const std::vector<float>& pos, const float* bboxMin, const float* bboxMax, float cellSize,
+    size_t maxCells, SpatialBins& bins) {
+    const size_t cnt = pos.size() / 3;
+    cellSize = std::max(cellSize, std::numeric_limits<float>::epsilon());
+    while (true) {
+        double cells = 1.0;
+        for (int d = 0; d < 3; ++d) {
+            cells *= std::floor((bboxMax[d] - bboxMin[d]) / cellSize) + 1.0;
+        }
+        if (cells <= static_cast<double>(maxCells))
+            break;
+        cellSize *= 1.25f;
+    }
+    bins.cellSize = cellSize;
+    for (int d = 0; d < 3; ++d) {
+        bins.origin[d] = bboxMin[d];
+        bins.res[d] = static_cast<int>(std::floor((bboxMax[d] - bboxMin[d]) / cellSize)) + 1;
+    }
 
-        res.clear();
-        index.radiusSearch(query_pos.PeekCoordinates(), rad, res, nanoflann::SearchParameters(0.01f, false));
+    std::vector<uint32_t> cellOf(cnt);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(cnt); ++i) {
+        const float* p = &pos[i * 3];
+        cellOf[i] = static_cast<uint32_t>(
+            bins.cellIndex(bins.cellCoord(p[0], 0), bins.cellCoord(p[1], 1), bins.cellCoord(p[2], 2)));
+    }
 
-        vislib::math::Vector<double, 3> gradient;
+    bins.cellStart.assign(bins.cellCount() + 1, 0);
+    for (size_t i = 0; i < cnt; ++i) {
+        bins.cellStart[cellOf[i] + 1]++;
+    }
+    for (size_t c = 0; c < bins.cellCount(); ++c) {
+        bins.cellStart[c + 1] += bins.cellStart[c];
+    }
+    std::vector<uint32_t> fill(bins.cellStart.begin(), bins.cellStart.end() - 1);
+    bins.order.resize(cnt);
+    for (size_t i = 0; i < cnt; ++i) {
+        bins.order[fill[cellOf[i]]++] = static_cast<uint32_t>(i);
+    }
+}
 
-        for (auto const& p : res) {
-            vislib::math::Vector<double, 3> dir(
-                vislib::math::ShallowPoint<float, 3>(const_cast<float*>(data.get_position(p.first))) - query_pos);
-            dir.Normalise();
-            double colDiff = static_cast<double>(*data.get_color(p.first)) - static_cast<double>(*query_col);
-            //double weight = static_cast<double>(rad - p.second) / static_cast<double>(rad);
+/**
+ * Solves the 3x3 normal equations of the least squares gradient fit. 'a' holds the symmetric matrix as
+ * (xx, xy, xz, yy, yz, zz). A small Tikhonov regularisation keeps degenerate neighbourhoods (e.g. planar ones) stable.
+ */
+inline void solveNormalEquations(const double* a, const double* b, double* g) {
+    const double lambda = 1.0e-6 * (a[0] + a[3] + a[5]) + std::numeric_limits<double>::min();
+    const double m00 = a[0] + lambda, m01 = a[1], m02 = a[2];
+    const double m11 = a[3] + lambda, m12 = a[4];
+    const double m22 = a[5] + lambda;
+    const double c00 = m11 * m22 - m12 * m12;
+    const double c01 = m02 * m12 - m01 * m22;
+    const double c02 = m01 * m12 - m02 * m11;
+    const double det = m00 * c00 + m01 * c01 + m02 * c02;
+    if (std::abs(det) < std::numeric_limits<double>::min()) {
+        g[0] = g[1] = g[2] = 0.0;
+        return;
+    }
+    const double c11 = m00 * m22 - m02 * m02;
+    const double c12 = m01 * m02 - m00 * m12;
+    const double c22 = m00 * m11 - m01 * m01;
+    g[0] = (c00 * b[0] + c01 * b[1] + c02 * b[2]) / det;
+    g[1] = (c01 * b[0] + c11 * b[1] + c12 * b[2]) / det;
+    g[2] = (c02 * b[0] + c12 * b[1] + c22 * b[2]) / det;
+}
 
-            dir *= colDiff;
-            //dir *= weight;
+} // namespace
 
-            gradient += dir;
+void datatools::ParticleIColGradientField::compute_colors(geocalls::MultiParticleDataCall& dat) {
+    using megamol::core::utility::log::Log;
+    using clock = std::chrono::high_resolution_clock;
+    const auto startTime = clock::now();
+
+    const float rad = this->radiusSlot.Param<core::param::FloatParam>()->Value();
+    const int method = this->methodSlot.Param<core::param::EnumParam>()->Value();
+
+    // gather positions and colours into contiguous arrays, all stages below only work on these
+    MultiParticleDataAdaptor adaptor(dat);
+    const size_t cnt = adaptor.get_count();
+    this->newColors.resize(cnt);
+    this->maxColor = 0.0f;
+    if (cnt == 0) {
+        return;
+    }
+    if (cnt > static_cast<size_t>(std::numeric_limits<uint32_t>::max())) {
+        Log::DefaultLog.WriteError("ParticleIColGradientField: too many particles (%zu)", cnt);
+        this->newColors.clear();
+        return;
+    }
+    std::vector<float> pos(cnt * 3);
+    std::vector<float> col(cnt);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(cnt); ++i) {
+        const float* p = adaptor.get_position(i);
+        const float* c = adaptor.get_color(i);
+        pos[i * 3 + 0] = p[0];
+        pos[i * 3 + 1] = p[1];
+        pos[i * 3 + 2] = p[2];
+        col[i] = (c != nullptr) ? *c : 0.0f;
+    }
+    float bboxMin[3] = {pos[0], pos[1], pos[2]};
+    float bboxMax[3] = {pos[0], pos[1], pos[2]};
+    for (size_t i = 1; i < cnt; ++i) {
+        for (int d = 0; d < 3; ++d) {
+            bboxMin[d] = std::min(bboxMin[d], pos[i * 3 + d]);
+            bboxMax[d] = std::max(bboxMax[d], pos[i * 3 + d]);
+        }
+    }
+    const auto gatherTime = clock::now();
+
+    // per-thread maxima, combined at the end
+    std::vector<double> threadMax(omp_get_max_threads(), 0.0);
+
+    if (method == METHOD_GRID) {
+        // cheap approximation: average colour per cell and central differences between neighbouring cells
+        SpatialBins bins;
+        binParticles(pos, bboxMin, bboxMax, rad, std::min<size_t>(std::max<size_t>(cnt, 64), size_t(1) << 24), bins);
+        const auto indexTime = clock::now();
+
+        const int64_t cellCnt = static_cast<int64_t>(bins.cellCount());
+        std::vector<float> cellCol(cellCnt);
+#pragma omp parallel for
+        for (int64_t c = 0; c < cellCnt; ++c) {
+            double sum = 0.0;
+            for (uint32_t i = bins.cellStart[c]; i < bins.cellStart[c + 1]; ++i) {
+                sum += col[bins.order[i]];
+            }
+            const uint32_t n = bins.cellStart[c + 1] - bins.cellStart[c];
+            cellCol[c] = (n > 0) ? static_cast<float>(sum / n) : std::numeric_limits<float>::quiet_NaN();
         }
 
-        gradient /= static_cast<double>(res.size());
-        double len = gradient.Length();
-        if (len > maxLen)
-            maxLen = len;
-
-        newColors[part_i] = static_cast<float>(len);
+#pragma omp parallel for schedule(dynamic, 64)
+        for (int64_t c = 0; c < cellCnt; ++c) {
+            if (bins.cellStart[c] == bins.cellStart[c + 1])
+                continue;
+            const int xyz[3] = {static_cast<int>(c % bins.res[0]), static_cast<int>((c / bins.res[0]) % bins.res[1]),
+                static_cast<int>(c / (static_cast<int64_t>(bins.res[0]) * bins.res[1]))};
+            double gradient[3] = {0.0, 0.0, 0.0};
+            for (int d = 0; d < 3; ++d) {
+                int lo[3] = {xyz[0], xyz[1], xyz[2]};
+                int hi[3] = {xyz[0], xyz[1], xyz[2]};
+                lo[d] = std::max(xyz[d] - 1, 0);
+                hi[d] = std::min(xyz[d] + 1, bins.res[d] - 1);
+                float cLo = cellCol[bins.cellIndex(lo[0], lo[1], lo[2])];
+                float cHi = cellCol[bins.cellIndex(hi[0], hi[1], hi[2])];
+                // fall back to one-sided differences next to empty cells
+                if (std::isnan(cLo)) {
+                    cLo = cellCol[c];
+                    lo[d] = xyz[d];
+                }
+                if (std::isnan(cHi)) {
+                    cHi = cellCol[c];
+                    hi[d] = xyz[d];
+                }
+                if (hi[d] > lo[d]) {
+                    gradient[d] = (cHi - cLo) / (static_cast<double>(hi[d] - lo[d]) * bins.cellSize);
+                }
+            }
+            const double len =
+                std::sqrt(gradient[0] * gradient[0] + gradient[1] * gradient[1] + gradient[2] * gradient[2]);
+            for (uint32_t i = bins.cellStart[c]; i < bins.cellStart[c + 1]; ++i) {
+                this->newColors[bins.order[i]] = static_cast<float>(len);
+            }
+            auto& tm = threadMax[omp_get_thread_num()];
+            tm = std::max(tm, len);
+        }
+        const auto gradientTime = clock::now();
+
+        Log::DefaultLog.WriteInfo("ParticleIColGradientField: %zu particles, gather %.1f ms, grid %.1f ms, gradients "
+                                  "%.1f ms",
+            cnt, std::chrono::duration<double, std::milli>(gatherTime - startTime).count(),
+            std::chrono::duration<double, std::milli>(indexTime - gatherTime).count(),
+            std::chrono::duration<double, std::milli>(gradientTime - indexTime).count());
+
+    } else {
+        DataAdapter data(pos, bboxMin, bboxMax);
+
+        // construct a kd-tree index:
+        typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, DataAdapter>, DataAdapter,
+            3 /* dim */, std::size_t>
+            my_kd_tree_t;
+
+        my_kd_tree_t index(3 /*dim*/, data, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
+        index.buildIndex();
+
+        // the queries are processed in spatial blocks, so that the queries of one thread touch the same tree nodes
+        SpatialBins blocks;
+        binParticles(pos, bboxMin, bboxMax, 4.0f * rad, std::max<size_t>(cnt / 256, 64), blocks);
+        const auto indexTime = clock::now();
+
+        const int64_t blockCnt = static_cast<int64_t>(blocks.cellCount());
+        // the squared radius, as the L2_Simple_Adaptor works on squared distances
+        const float searchRad = rad * rad;
+
+#pragma omp parallel
+        {
+            std::vector<nanoflann::ResultItem<size_t, float>> res;
+            res.reserve(100);
+            // neighbour offsets in struct-of-arrays layout for the least squares accumulation
+            std::vector<float> dx, dy, dz, dc;
+            auto& tm = threadMax[omp_get_thread_num()];
+
+#pragma omp for schedule(dynamic)
+            for (int64_t b = 0; b < blockCnt; ++b) {
+                for (uint32_t o = blocks.cellStart[b]; o < blocks.cellStart[b + 1]; ++o) {
+                    const size_t part_i = blocks.order[o];
+                    const float* query_pos = &pos[part_i * 3];
+                    const float query_col = col[part_i];
+
+                    res.clear();
+                    index.radiusSearch(query_pos, searchRad, res, nanoflann::SearchParameters(0.01f, false));
+
+                    double gradient[3] = {0.0, 0.0, 0.0};
+                    if (method == METHOD_LEAST_SQUARES) {
+                        const size_t n = res.size();
+                        dx.resize(n);
+                        dy.resize(n);
+                        dz.resize(n);
+                        dc.resize(n);
+                        for (size_t k = 0; k < n; ++k) {
+                            const float* p = &pos[res[k].first * 3];
+                            dx[k] = p[0] - query_pos[0];
+                            dy[k] = p[1] - query_pos[1];
+                            dz[k] = p[2] - query_pos[2];
+                            dc[k] = col[res[k].first] - query_col;
+                        }
+                        // independent sums over contiguous arrays, which the compiler vectorises
+                        float sxx = 0.0f, sxy = 0.0f, sxz = 0.0f, syy = 0.0f, syz = 0.0f, szz = 0.0f;
+                        float sxc = 0.0f, syc = 0.0f, szc = 0.0f;
+                        for (size_t k = 0; k < n; ++k) {
+                            sxx += dx[k] * dx[k];
+                            sxy += dx[k] * dy[k];
+                            sxz += dx[k] * dz[k];
+                            syy += dy[k] * dy[k];
+                            syz += dy[k] * dz[k];
+                            szz += dz[k] * dz[k];
+                            sxc += dx[k] * dc[k];
+                            syc += dy[k] * dc[k];
+                            szc += dz[k] * dc[k];
+                        }
+                        const double a[6] = {sxx, sxy, sxz, syy, syz, szz};
+                        const double rhs[3] = {sxc, syc, szc};
+                        solveNormalEquations(a, rhs, gradient);
+
+                    } else {
+                        for (auto const& p : res) {
+                            const float* pp = &pos[p.first * 3];
+                            double dir[3] = {static_cast<double>(pp[0] - query_pos[0]),
+                                static_cast<double>(pp[1] - query_pos[1]), static_cast<double>(pp[2] - query_pos[2])};
+                            const double dirLen = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+                            if (dirLen == 0.0)
+                                continue;
+                            const double colDiff = static_cast<double>(col[p.first]) - static_cast<double>(query_col);
+                            for (int d = 0; d < 3; ++d) {
+                                gradient[d] += dir[d] / dirLen * colDiff;
+                            }
+                        }
+                        for (int d = 0; d < 3; ++d) {
+                            gradient[d] /= static_cast<double>(res.size());
+                        }
+                    }
+
+                    const double len =
+                        std::sqrt(gradient[0] * gradient[0] + gradient[1] * gradient[1] + gradient[2] * gradient[2]);
+                    tm = std::max(tm, len);
+                    this->newColors[part_i] = static_cast<float>(len);
+                }
+            }
+        }
+        const auto gradientTime = clock::now();
 
-        //newColors[part_i * 3 + 0] = static_cast<float>(gradient[0]);
-        //newColors[part_i * 3 + 1] = static_cast<float>(gradient[1]);
-        //newColors[part_i * 3 + 2] = static_cast<float>(gradient[2]);
+        Log::DefaultLog.WriteInfo("ParticleIColGradientField: %zu particles, gather %.1f ms, index %.1f ms, gradients "
+                                  "%.1f ms",
+            cnt, std::chrono::duration<double, std::milli>(gatherTime - startTime).count(),
+            std::chrono::duration<double, std::milli>(indexTime - gatherTime).count(),
+            std::chrono::duration<double, std::milli>(gradientTime - indexTime).count());
     }
 
-    maxColor = static_cast<float>(maxLen);
-    //printf("%f\n", maxLen);
+    this->maxColor = static_cast<float>(*std::max_element(threadMax.begin(), threadMax.end()));
 }
 
 
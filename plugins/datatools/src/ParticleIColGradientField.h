@@ -55,10 +55,21 @@ protected:
     bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
 
 private:
+    /** The available gradient estimation methods */
+    enum Method : int {
+        /** mean of the colour differences along the directions to all neighbours (kd-tree) */
+        METHOD_NEIGHBOUR_AVERAGE = 0,
+        /** least squares fit of a linear colour function to all neighbours (kd-tree) */
+        METHOD_LEAST_SQUARES = 1,
+        /** central differences of the mean colours of grid cells of the radius size */
+        METHOD_GRID = 2
+    };
+
     void compute_colors(geocalls::MultiParticleDataCall& dat);
     void set_colors(geocalls::MultiParticleDataCall& dat);
 
     core::param::ParamSlot radiusSlot;
+    core::param::ParamSlot methodSlot;
     size_t datahash;
     unsigned int time;
     std::vector<float> newColors;
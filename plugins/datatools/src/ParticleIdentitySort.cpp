@@ -1,8 +1,21 @@
 #include "ParticleIdentitySort.h"
+
+#include <algorithm>
+#include <cstring>
 #include <numeric>
 
+#include <omp.h>
+
+#include "datatools/misc/RadixSort.h"
+#include "mmcore/param/BoolParam.h"
 
-megamol::datatools::ParticleIdentitySort::ParticleIdentitySort() : AbstractParticleManipulator("outData", "indata") {}
+
+megamol::datatools::ParticleIdentitySort::ParticleIdentitySort()
+        : AbstractParticleManipulator("outData", "indata")
+        , soaSlot("SoA", "Store positions, colours and identities in separate arrays instead of interleaved") {
+    soaSlot << new core::param::BoolParam(false);
+    MakeSlotAvailable(&soaSlot);
+}
 
 
 megamol::datatools::ParticleIdentitySort::~ParticleIdentitySort() {
@@ -20,84 +33,166 @@ bool megamol::datatools::ParticleIdentitySort::manipulateData(
                                         // original data will be unlocked through outData
 
     auto const plc = outData.GetParticleListCount();
-    this->data_.clear();
-    for (unsigned int i = 0; i < plc; ++i) {
-        auto& p = outData.AccessParticles(i);
-
-        if (p.GetIDDataType() == geocalls::SimpleSphericalParticles::IDDATA_NONE) {
-            megamol::core::utility::log::Log::DefaultLog.WriteWarn(
-                "ParticleIdentitySort: Particlelist %d has no indentity array\n", i);
-            continue;
-        }
-
-        this->data_.emplace_back();
-        auto& dlist = this->data_.back();
 
-        auto vs = p.GetVertexDataStride();
-        auto cs = p.GetColourDataStride();
-        auto is = p.GetIDDataStride();
-
-        auto avs = vs;
-        auto acs = cs;
-        auto ais = is;
-
-        auto const vp = reinterpret_cast<char const* const>(p.GetVertexData());
-        auto const cp = reinterpret_cast<char const* const>(p.GetColourData());
-        auto const ip = reinterpret_cast<char const* const>(p.GetIDData());
-
-        auto ts = vs;
-
-        bool const sep = (vs == 0) || (cs == 0) || (is == 0);
+    if (frame_id_ != inData.FrameID() || in_data_hash_ != inData.DataHash() || soaSlot.IsDirty() ||
+        lists_.size() != plc) {
+        soaSlot.ResetDirty();
+        auto const soa = soaSlot.Param<core::param::BoolParam>()->Value();
+        lists_.resize(plc);
+        for (unsigned int i = 0; i < plc; ++i) {
+            auto const& p = outData.AccessParticles(i);
+
+            if (p.GetIDDataType() == geocalls::SimpleSphericalParticles::IDDATA_NONE) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "ParticleIdentitySort: Particlelist %d has no indentity array\n", i);
+                lists_[i] = SortedList();
+                continue;
+            }
 
-        if (sep) {
-            vs = geocalls::SimpleSphericalParticles::VertexDataSize[p.GetVertexDataType()];
-            cs = geocalls::SimpleSphericalParticles::ColorDataSize[p.GetColourDataType()];
-            is = geocalls::SimpleSphericalParticles::IDDataSize[p.GetIDDataType()];
+            sortList(p, lists_[i], soa);
+        }
 
-            ts = vs + cs + is;
+        frame_id_ = inData.FrameID();
+        in_data_hash_ = inData.DataHash();
+        ++out_data_hash_;
+    }
 
-            // sep = true;
+    for (unsigned int i = 0; i < plc; ++i) {
+        auto& p = outData.AccessParticles(i);
+        auto const& list = lists_[i];
+        if (p.GetIDDataType() == geocalls::SimpleSphericalParticles::IDDATA_NONE || list.vert_ptr == nullptr) {
+            continue;
         }
+        p.SetVertexData(p.GetVertexDataType(), list.vert_ptr, list.vert_stride);
+        p.SetColourData(p.GetColourDataType(), list.col_ptr, list.col_stride);
+        p.SetIDData(p.GetIDDataType(), list.id_ptr, list.id_stride);
+    }
 
-        auto const cnt = p.GetCount();
+    outData.SetDataHash(out_data_hash_);
 
-        std::vector<size_t> keys(cnt);
-        std::iota(keys.begin(), keys.end(), 0);
+    return true;
+}
 
-        auto const& iAcc = p.GetParticleStore().GetIDAcc();
 
-        std::sort(keys.begin(), keys.end(),
-            [&iAcc](auto const& a, auto const& b) -> bool { return iAcc->Get_u64(a) < iAcc->Get_u64(b); });
+bool megamol::datatools::ParticleIdentitySort::isSorted(
+    std::vector<uint64_t> const& ids, std::vector<size_t> const& permutation) {
+    auto const cnt = static_cast<int64_t>(permutation.size());
+    bool sorted = true;
+#pragma omp parallel for reduction(&& : sorted)
+    for (int64_t pidx = 1; pidx < cnt; ++pidx) {
+        sorted = sorted && ids[permutation[pidx - 1]] <= ids[permutation[pidx]];
+    }
+    return sorted;
+}
 
-        dlist.resize(cnt * ts);
 
-        auto const basePtr = dlist.data();
+void megamol::datatools::ParticleIdentitySort::sortList(
+    geocalls::SimpleSphericalParticles const& p, SortedList& list, bool soa) {
+    auto const cnt = p.GetCount();
+
+    auto const vs = geocalls::SimpleSphericalParticles::VertexDataSize[p.GetVertexDataType()];
+    auto const cs = geocalls::SimpleSphericalParticles::ColorDataSize[p.GetColourDataType()];
+    auto const is = geocalls::SimpleSphericalParticles::IDDataSize[p.GetIDDataType()];
+
+    // a stride of zero denotes tightly packed data
+    auto const avs = p.GetVertexDataStride() == 0 ? vs : p.GetVertexDataStride();
+    auto const acs = p.GetColourDataStride() == 0 ? cs : p.GetColourDataStride();
+    auto const ais = p.GetIDDataStride() == 0 ? is : p.GetIDDataStride();
+
+    auto const vp = reinterpret_cast<char const*>(p.GetVertexData());
+    auto const cp = reinterpret_cast<char const*>(p.GetColourData());
+    auto const ip = reinterpret_cast<char const*>(p.GetIDData());
+
+    std::vector<uint64_t> ids(cnt);
+    p.GetParticleStore().GetIDAcc()->Gather_u64(0, cnt, ids.data(), 1);
+
+    // the identities of consecutive frames are usually ordered the same way, in which case the permutation of the
+    // last frame is reused and the sort skipped
+    bool const reused = list.permutation.size() == cnt && isSorted(ids, list.permutation);
+    if (!reused) {
+        int key_bits = 32;
+        if (p.GetIDDataType() == geocalls::SimpleSphericalParticles::IDDATA_UINT64) {
+            std::vector<uint64_t> thread_max(omp_get_max_threads(), 0);
+#pragma omp parallel for
+            for (int64_t pidx = 0; pidx < static_cast<int64_t>(cnt); ++pidx) {
+                auto& m = thread_max[omp_get_thread_num()];
+                m = std::max(m, ids[pidx]);
+            }
+            auto const max_id = *std::max_element(thread_max.begin(), thread_max.end());
+            key_bits = 0;
+            while (key_bits < 64 && (max_id >> key_bits) != 0) {
+                ++key_bits;
+            }
+        }
+        list.permutation.resize(cnt);
+        std::iota(list.permutation.begin(), list.permutation.end(), 0);
+        misc::radix_sort(ids, list.permutation, 0, cnt, key_bits);
+    }
 
-        if (sep) {
-            for (size_t pidx = 0; pidx < cnt; ++pidx) {
-                auto const sidx = keys[pidx];
+    auto const& perm = list.permutation;
+
+    if (soa) {
+        list.data.clear();
+        list.data.shrink_to_fit();
+        list.vertices.resize(cnt * vs);
+        list.colours.resize(cnt * cs);
+        list.ids.resize(cnt * is);
+        auto const vdst = list.vertices.data();
+        auto const cdst = list.colours.data();
+        auto const idst = list.ids.data();
+#pragma omp parallel for
+        for (int64_t pidx = 0; pidx < static_cast<int64_t>(cnt); ++pidx) {
+            auto const sidx = perm[pidx];
+            memcpy(vdst + vs * pidx, vp + sidx * avs, vs);
+            memcpy(cdst + cs * pidx, cp + sidx * acs, cs);
+            memcpy(idst + is * pidx, ip + sidx * ais, is);
+        }
+        list.vert_ptr = vdst;
+        list.col_ptr = cdst;
+        list.id_ptr = idst;
+        list.vert_stride = vs;
+        list.col_stride = cs;
+        list.id_stride = is;
+    } else {
+        list.vertices.clear();
+        list.vertices.shrink_to_fit();
+        list.colours.clear();
+        list.colours.shrink_to_fit();
+        list.ids.clear();
+        list.ids.shrink_to_fit();
+
+        // colour and identity stored inside the vertex record allow copying whole records
+        auto const in_record = [vp, avs](char const* ptr, size_t stride, size_t size) {
+            return stride == avs && (size == 0 || (ptr >= vp && ptr + size <= vp + avs));
+        };
+        bool const interleaved = cnt > 0 && in_record(cp, acs, cs) && in_record(ip, ais, is);
+
+        auto const ts = interleaved ? avs : vs + cs + is;
+        list.data.resize(cnt * ts);
+        auto const basePtr = list.data.data();
+
+        if (interleaved) {
+#pragma omp parallel for
+            for (int64_t pidx = 0; pidx < static_cast<int64_t>(cnt); ++pidx) {
+                memcpy(basePtr + ts * pidx, vp + perm[pidx] * ts, ts);
+            }
+            list.vert_ptr = basePtr;
+            list.col_ptr = cs == 0 ? basePtr : basePtr + (cp - vp);
+            list.id_ptr = basePtr + (ip - vp);
+        } else {
+#pragma omp parallel for
+            for (int64_t pidx = 0; pidx < static_cast<int64_t>(cnt); ++pidx) {
+                auto const sidx = perm[pidx];
                 memcpy(basePtr + ts * pidx, vp + sidx * avs, vs);
                 memcpy(basePtr + ts * pidx + vs, cp + sidx * acs, cs);
                 memcpy(basePtr + ts * pidx + vs + cs, ip + sidx * ais, is);
-
-                /*auto const didx = iAcc->Get_u64(pidx);
-                memcpy(basePtr + ts * didx, vp, vs);
-                memcpy(basePtr + ts * didx + vs, cp, cs);
-                memcpy(basePtr + ts * didx + vs + cs, ip, is);*/
-            }
-        } else {
-            for (size_t pidx = 0; pidx < cnt; ++pidx) {
-                auto const sidx = keys[pidx];
-                memcpy(basePtr + ts * pidx, vp + sidx * ts, ts);
-
-                /*auto const didx = iAcc->Get_u64(pidx);
-                memcpy(basePtr + ts * didx, vp, ts);*/
             }
+            list.vert_ptr = basePtr;
+            list.col_ptr = basePtr + vs;
+            list.id_ptr = basePtr + vs + cs;
         }
-
-        p.SetVertexData(p.GetVertexDataType(), basePtr, ts);
-        p.SetColourData(p.GetColourDataType(), basePtr + vs, ts);
-        p.SetIDData(p.GetIDDataType(), basePtr + vs + cs, ts);
+        list.vert_stride = static_cast<unsigned int>(ts);
+        list.col_stride = static_cast<unsigned int>(ts);
+        list.id_stride = static_cast<unsigned int>(ts);
     }
-    return true;
 }
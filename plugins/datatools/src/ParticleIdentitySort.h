@@ -1,6 +1,11 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include "datatools/AbstractParticleManipulator.h"
+#include "mmcore/param/ParamSlot.h"
 
 namespace megamol::datatools {
 
@@ -41,7 +46,45 @@ protected:
     bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
 
 private:
-    std::vector<std::vector<char>> data_;
+    /** The sorted copy of one particle list */
+    struct SortedList {
+        /** Source index of each output particle, reused as long as it still orders the identities */
+        std::vector<size_t> permutation;
+        /** Interleaved output (vertex, colour, identity) */
+        std::vector<char> data;
+        /** Separate output arrays */
+        std::vector<char> vertices;
+        std::vector<char> colours;
+        std::vector<char> ids;
+        /** Output layout */
+        char const* vert_ptr = nullptr;
+        char const* col_ptr = nullptr;
+        char const* id_ptr = nullptr;
+        unsigned int vert_stride = 0;
+        unsigned int col_stride = 0;
+        unsigned int id_stride = 0;
+    };
+
+    /**
+     * Answers whether the permutation still orders the identities, i.e. whether it can be reused.
+     */
+    static bool isSorted(std::vector<uint64_t> const& ids, std::vector<size_t> const& permutation);
+
+    /**
+     * Sorts the particle list and stores the sorted copy in 'list'.
+     */
+    void sortList(geocalls::SimpleSphericalParticles const& p, SortedList& list, bool soa);
+
+    /** Stores the particles in separate arrays instead of one interleaved array */
+    core::param::ParamSlot soaSlot;
+
+    std::vector<SortedList> lists_;
+
+    unsigned int frame_id_ = std::numeric_limits<unsigned int>::max();
+
+    size_t in_data_hash_ = std::numeric_limits<size_t>::max();
+
+    size_t out_data_hash_ = 0;
 };
 
 } // namespace megamol::datatools
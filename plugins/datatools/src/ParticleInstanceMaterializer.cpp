@@ -0,0 +1,206 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "ParticleInstanceMaterializer.h"
+
+#include <cstring>
+
+using namespace megamol;
+
+
+namespace {
+
+/**
+ * Copies 'count' attributes of 'size' bytes from 'src' with the given stride tightly packed into 'dst' and replicates
+ * them 'instances' times.
+ */
+void replicate(
+    char const* src, size_t stride, size_t size, uint64_t count, size_t instances, std::vector<char>& dst) {
+    dst.resize(count * size * instances);
+    if (size == 0 || count == 0 || instances == 0) {
+        return;
+    }
+    if (stride == size) {
+        memcpy(dst.data(), src, count * size);
+    } else {
+#pragma omp parallel for
+        for (int64_t j = 0; j < static_cast<int64_t>(count); ++j) {
+            memcpy(dst.data() + j * size, src + j * stride, size);
+        }
+    }
+    auto const inst_bytes = count * size;
+#pragma omp parallel for
+    for (int64_t inst = 1; inst < static_cast<int64_t>(instances); ++inst) {
+        memcpy(dst.data() + inst * inst_bytes, dst.data(), inst_bytes);
+    }
+}
+
+} // namespace
+
+
+datatools::ParticleInstanceMaterializer::ParticleInstanceMaterializer()
+        : AbstractParticleManipulator("outData", "indata") {}
+
+
+datatools::ParticleInstanceMaterializer::~ParticleInstanceMaterializer() {
+    this->Release();
+}
+
+
+void datatools::ParticleInstanceMaterializer::Materialize(
+    geocalls::MultiParticleDataCall& call, std::vector<MaterializedList>& lists) {
+    using geocalls::SimpleSphericalParticles;
+
+    auto const transforms = call.GetInstanceTransforms();
+    if (transforms == nullptr) {
+        lists.clear();
+        return;
+    }
+    auto const instances = transforms->size();
+
+    unsigned int const plc = call.GetParticleListCount();
+    lists.resize(plc);
+    for (unsigned int i = 0; i < plc; ++i) {
+        auto const& p = call.AccessParticles(i);
+        auto& list = lists[i];
+        auto const count = p.GetCount();
+        list.count = count * instances;
+
+        if (p.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_NONE) {
+            list.vertices.clear();
+        } else {
+            auto const& s = p.GetParticleStore();
+            bool const has_radius = p.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR;
+            size_t const comps = has_radius ? 4 : 3;
+            list.vertices.resize(list.count * comps);
+            auto const base = list.vertices.data();
+
+            // the first instance slot holds the untransformed positions while the others are derived from it, thus
+            // it is transformed last
+            s.GetXAcc()->Gather_f(0, count, base + 0, comps);
+            s.GetYAcc()->Gather_f(0, count, base + 1, comps);
+            s.GetZAcc()->Gather_f(0, count, base + 2, comps);
+            if (has_radius) {
+                s.GetRAcc()->Gather_f(0, count, base + 3, comps);
+            }
+            for (size_t inst = instances; inst-- > 0;) {
+                auto const& t = (*transforms)[inst];
+                auto const dst = base + inst * count * comps;
+#pragma omp parallel for
+                for (int64_t j = 0; j < static_cast<int64_t>(count); ++j) {
+                    auto const out = dst + j * comps;
+                    t.Apply(base + j * comps, out);
+                    if (has_radius) {
+                        out[3] = base[j * comps + 3];
+                    }
+                }
+            }
+        }
+
+        auto const effective_stride = [](unsigned int stride, unsigned int size) {
+            return stride == 0 ? size : stride;
+        };
+
+        auto const cs = SimpleSphericalParticles::ColorDataSize[p.GetColourDataType()];
+        replicate(static_cast<char const*>(p.GetColourData()), effective_stride(p.GetColourDataStride(), cs), cs, count,
+            instances, list.colours);
+
+        auto const ds = SimpleSphericalParticles::DirDataSize[p.GetDirDataType()];
+        replicate(static_cast<char const*>(p.GetDirData()), effective_stride(p.GetDirDataStride(), ds), ds, count,
+            instances, list.directions);
+
+        auto const is = SimpleSphericalParticles::IDDataSize[p.GetIDDataType()];
+        replicate(static_cast<char const*>(p.GetIDData()), effective_stride(p.GetIDDataStride(), is), is, count,
+            instances, list.ids);
+    }
+
+    Apply(call, lists);
+}
+
+
+void datatools::ParticleInstanceMaterializer::Apply(
+    geocalls::MultiParticleDataCall& call, std::vector<MaterializedList> const& lists) {
+    using geocalls::SimpleSphericalParticles;
+
+    auto const transforms = call.GetInstanceTransforms();
+    if (transforms == nullptr) {
+        return;
+    }
+
+    unsigned int const plc = call.GetParticleListCount();
+    for (unsigned int i = 0; i < plc && i < lists.size(); ++i) {
+        auto& p = call.AccessParticles(i);
+        auto const& list = lists[i];
+        if (p.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_NONE) {
+            continue;
+        }
+
+        auto bbox = p.GetBBox();
+        if (!bbox.IsEmpty()) {
+            vislib::math::Cuboid<float> inst_bbox;
+            bool first = true;
+            for (auto const& t : *transforms) {
+                for (int c = 0; c < 8; ++c) {
+                    float const corner[3] = {c & 1 ? bbox.Right() : bbox.Left(), c & 2 ? bbox.Top() : bbox.Bottom(),
+                        c & 4 ? bbox.Front() : bbox.Back()};
+                    float pos[3];
+                    t.Apply(corner, pos);
+                    if (first) {
+                        inst_bbox.Set(pos[0], pos[1], pos[2], pos[0], pos[1], pos[2]);
+                        first = false;
+                    } else {
+                        inst_bbox.GrowToPoint(pos[0], pos[1], pos[2]);
+                    }
+                }
+            }
+            bbox = inst_bbox;
+        }
+
+        auto const col_type = p.GetColourDataType();
+        auto const dir_type = p.GetDirDataType();
+        auto const id_type = p.GetIDDataType();
+        bool const has_radius = p.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR;
+
+        p.SetCount(list.count);
+        p.SetVertexData(has_radius ? SimpleSphericalParticles::VERTDATA_FLOAT_XYZR
+                                   : SimpleSphericalParticles::VERTDATA_FLOAT_XYZ,
+            list.vertices.data());
+        p.SetColourData(col_type, col_type == SimpleSphericalParticles::COLDATA_NONE ? nullptr : list.colours.data());
+        p.SetDirData(dir_type, dir_type == SimpleSphericalParticles::DIRDATA_NONE ? nullptr : list.directions.data());
+        p.SetIDData(id_type, id_type == SimpleSphericalParticles::IDDATA_NONE ? nullptr : list.ids.data());
+        p.SetBBox(bbox);
+    }
+
+    call.SetInstanceTransforms(nullptr);
+}
+
+
+bool datatools::ParticleInstanceMaterializer::manipulateData(
+    geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
+
+    outData = inData;                   // also transfers the unlocker to 'outData'
+    inData.SetUnlocker(nullptr, false); // keep original data locked
+                                        // original data will be unlocked through outData
+
+    if (outData.GetInstanceTransforms() == nullptr) {
+        // nothing to materialize, pass the data through
+        return true;
+    }
+
+    if (frame_id_ != inData.FrameID() || in_data_hash_ != inData.DataHash() || inData.DataHash() == 0) {
+        Materialize(outData, lists_);
+
+        frame_id_ = inData.FrameID();
+        in_data_hash_ = inData.DataHash();
+        ++out_data_hash_;
+    } else {
+        Apply(outData, lists_);
+    }
+
+    outData.SetDataHash(out_data_hash_);
+
+    return true;
+}
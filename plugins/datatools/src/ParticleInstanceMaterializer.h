@@ -0,0 +1,85 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "datatools/AbstractParticleManipulator.h"
+
+namespace megamol::datatools {
+
+/**
+ * Module replicating the particles of all instance transformations of a MultiParticleDataCall into plain particle
+ * lists, for consumers that cannot handle instances.
+ */
+class ParticleInstanceMaterializer : public AbstractParticleManipulator {
+public:
+    static const char* ClassName() {
+        return "ParticleInstanceMaterializer";
+    }
+    static const char* Description() {
+        return "copies the particles of every instance transformation into plain particle lists";
+    }
+    static bool IsAvailable() {
+        return true;
+    }
+
+    /** The replicated data of one particle list */
+    struct MaterializedList {
+        /** Number of particles of all instances */
+        uint64_t count = 0;
+        std::vector<float> vertices;
+        std::vector<char> colours;
+        std::vector<char> directions;
+        std::vector<char> ids;
+    };
+
+    /**
+     * Replicates the particles of all instances of 'call' into 'lists' and points the particle lists of 'call' to
+     * them. Positions are transformed to float XYZ (or XYZR with per-particle radius), all other attributes keep their
+     * type. Afterwards, 'call' holds no instance transformations.
+     *
+     * @param call  The call to materialize.
+     * @param lists Receives the replicated data. Must outlive the use of 'call'.
+     */
+    static void Materialize(geocalls::MultiParticleDataCall& call, std::vector<MaterializedList>& lists);
+
+    /**
+     * Points the particle lists of 'call' to data replicated earlier and removes the instance transformations.
+     *
+     * @param call  The call, holding the same data and transformations 'lists' has been materialized from.
+     * @param lists The replicated data.
+     */
+    static void Apply(geocalls::MultiParticleDataCall& call, std::vector<MaterializedList> const& lists);
+
+    ParticleInstanceMaterializer();
+    ~ParticleInstanceMaterializer() override;
+
+protected:
+    /**
+     * Manipulates the particle data
+     *
+     * @param outData The call receiving the manipulated data
+     * @param inData The call holding the original data
+     *
+     * @return True on success
+     */
+    bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
+
+private:
+    std::vector<MaterializedList> lists_;
+
+    unsigned int frame_id_ = std::numeric_limits<unsigned int>::max();
+
+    size_t in_data_hash_ = std::numeric_limits<size_t>::max();
+
+    size_t out_data_hash_ = 0;
+};
+
+} // namespace megamol::datatools
@@ -7,8 +7,11 @@
 
 #include "ParticleInstantiator.h"
 
+#include <algorithm>
+
 #include <glm/glm.hpp>
 
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/ButtonParam.h"
 #include "mmcore/param/Vector3fParam.h"
 
@@ -20,7 +23,9 @@ datatools::ParticleInstantiator::ParticleInstantiator()
         , numInstancesParam("instances", "number of dataset replications in X, Y, Z direction")
         , instanceOffsetParam("instOffset", "offset per instance in X, Y, Z")
         , setFromClipboxParam("fromClipbox", "set offsets based on size of clipbox")
-        , setFromBoundingboxParam("fromBBox", "set offsets based on size of bounding box") {
+        , setFromBoundingboxParam("fromBBox", "set offsets based on size of bounding box")
+        , materializeParam("materialize", "copy the particles of all instances, switch off for consumers that "
+                                          "support instancing (OSPRay sphere, PKD and AOV geometries)") {
 
     this->numInstancesParam << new core::param::Vector3fParam(
         vislib::math::Vector<float, 3>(1.0f, 1.0f, 1.0f), vislib::math::Vector<float, 3>(1.0f, 1.0f, 1.0f));
@@ -34,6 +39,9 @@ datatools::ParticleInstantiator::ParticleInstantiator()
 
     this->setFromBoundingboxParam << new core::param::ButtonParam();
     this->MakeSlotAvailable(&this->setFromBoundingboxParam);
+
+    this->materializeParam << new core::param::BoolParam(true);
+    this->MakeSlotAvailable(&this->materializeParam);
 }
 
 datatools::ParticleInstantiator::~ParticleInstantiator() {
@@ -42,7 +50,8 @@ datatools::ParticleInstantiator::~ParticleInstantiator() {
 
 bool datatools::ParticleInstantiator::InterfaceIsDirty() {
     return this->numInstancesParam.IsDirty() || this->instanceOffsetParam.IsDirty() ||
-           this->setFromBoundingboxParam.IsDirty() || this->setFromClipboxParam.IsDirty();
+           this->setFromBoundingboxParam.IsDirty() || this->setFromClipboxParam.IsDirty() ||
+           this->materializeParam.IsDirty();
 }
 
 void datatools::ParticleInstantiator::InterfaceResetDirty() {
@@ -50,6 +59,7 @@ void datatools::ParticleInstantiator::InterfaceResetDirty() {
     this->instanceOffsetParam.ResetDirty();
     this->setFromBoundingboxParam.ResetDirty();
     this->setFromClipboxParam.ResetDirty();
+    this->materializeParam.ResetDirty();
 }
 
 bool datatools::ParticleInstantiator::manipulateData(
@@ -69,145 +79,54 @@ bool datatools::ParticleInstantiator::manipulateData(
             vislib::math::Vector<float, 3>(inData.AccessBoundingBoxes().ObjectSpaceBBox().GetSize().PeekDimension()));
     }
 
-    unsigned int plc = inData.GetParticleListCount();
     auto ni_temp = this->numInstancesParam.Param<core::param::Vector3fParam>()->Value();
     glm::ivec3 numInstances =
         glm::ivec3(static_cast<int>(ni_temp.X()), static_cast<int>(ni_temp.Y()), static_cast<int>(ni_temp.Z()));
     auto io_temp = this->instanceOffsetParam.Param<core::param::Vector3fParam>()->Value();
     glm::vec3 instOffsets = glm::vec3(io_temp.X(), io_temp.Y(), io_temp.Z());
-    int numTotalInstances = numInstances.x * numInstances.y * numInstances.z;
-
-    if (InterfaceIsDirty() || (in_hash != inData.DataHash()) || (inData.DataHash() == 0) ||
-        (in_frameID != inData.FrameID())) {
-        // Update data
-        in_hash = inData.DataHash();
-        in_frameID = inData.FrameID();
-        InterfaceResetDirty();
-        my_hash++;
-
-        vertData.resize(plc);
-        colData.resize(plc);
-        dirData.resize(plc);
-        has_global_radius.resize(plc);
-        for (auto i = 0; i < plc; ++i) {
-            // first copy everything into a defined format
-            // XYZR, RGBA, VXVYVZ, no IDs (might waste space for radii, but we are wasting space here bigtime anyway)
-            const auto& p = inData.AccessParticles(i);
-            const auto& s = p.GetParticleStore();
-            int vert_components = 3;
-            has_global_radius[i] = true;
-
-            if (p.GetVertexDataType() == geocalls::SimpleSphericalParticles::VERTDATA_FLOAT_XYZR) {
-                vert_components = 4;
-                has_global_radius[i] = false;
-            }
-
-            vertData[i].resize(p.GetCount() * vert_components * numTotalInstances);
-            if (p.GetColourDataType() == geocalls::SimpleSphericalParticles::COLDATA_NONE) {
-                colData[i].resize(0);
-            } else {
-                colData[i].resize(p.GetCount() * 4 * numTotalInstances);
-            }
-            if (p.GetDirDataType() == geocalls::SimpleSphericalParticles::DIRDATA_NONE) {
-                dirData[i].resize(0);
-            } else {
-                dirData[i].resize(p.GetCount() * 3 * numTotalInstances);
-            }
-
-            const auto& xacc = s.GetXAcc();
-            const auto& yacc = s.GetYAcc();
-            const auto& zacc = s.GetZAcc();
-            const auto& racc = s.GetRAcc();
-            const auto& cracc = s.GetCRAcc();
-            const auto& cgacc = s.GetCGAcc();
-            const auto& cbacc = s.GetCBAcc();
-            const auto& caacc = s.GetCAAcc();
-
-            if (p.GetColourDataType() != geocalls::SimpleSphericalParticles::COLDATA_NONE) {
-                for (uint64_t j = 0; j < p.GetCount(); ++j) {
-                    colData[i][j * 4 + 0] = cracc->Get_f(j) * 255;
-                    colData[i][j * 4 + 1] = cgacc->Get_f(j) * 255;
-                    colData[i][j * 4 + 2] = cbacc->Get_f(j) * 255;
-                    colData[i][j * 4 + 3] = caacc->Get_f(j) * 255;
-                }
-            }
-
-            if (p.GetDirDataType() != geocalls::SimpleSphericalParticles::DIRDATA_NONE) {
-                const auto& dxacc = s.GetDXAcc();
-                const auto& dyacc = s.GetDYAcc();
-                const auto& dzacc = s.GetDZAcc();
-
-                for (uint64_t j = 0; j < p.GetCount(); ++j) {
-                    dirData[i][j * 3 + 0] = dxacc->Get_f(j);
-                    dirData[i][j * 3 + 1] = dyacc->Get_f(j);
-                    dirData[i][j * 3 + 2] = dzacc->Get_f(j);
-                }
-            }
-
-            // then make copies of that data
-            for (auto instX = 0; instX < numInstances.x; instX++) {
-                for (auto instY = 0; instY < numInstances.y; instY++) {
-                    for (auto instZ = 0; instZ < numInstances.z; instZ++) {
-                        const auto instSize = p.GetCount() * vert_components;
-                        const auto offset = (instSize * instX) + (instSize * numInstances.x * instY) +
-                                            (instSize * numInstances.x * numInstances.y * instZ);
-                        for (uint64_t j = 0; j < p.GetCount(); ++j) {
-                            vertData[i][offset + j * vert_components + 0] =
-                                xacc->Get_f(j) + instOffsets.x * static_cast<float>(instX);
-                            vertData[i][offset + j * vert_components + 1] =
-                                yacc->Get_f(j) + instOffsets.y * static_cast<float>(instY);
-                            vertData[i][offset + j * vert_components + 2] =
-                                zacc->Get_f(j) + instOffsets.z * static_cast<float>(instZ);
-                            if (!has_global_radius[i]) {
-                                vertData[i][offset + j * vert_components + 3] = racc->Get_f(j);
-                            }
-                        }
-                        if (instX + instY + instZ > 0) {
-                            if (p.GetColourDataType() != geocalls::SimpleSphericalParticles::COLDATA_NONE) {
-                                const auto colInstSize = p.GetCount() * 4;
-                                const auto coloffset = (colInstSize * instX) + (colInstSize * numInstances.x * instY) +
-                                                       (colInstSize * numInstances.x * numInstances.y * instZ);
-                                memcpy(&colData[i][coloffset], &colData[i][0], colInstSize * sizeof(uint8_t));
-                            }
-
-                            if (p.GetDirDataType() != geocalls::SimpleSphericalParticles::DIRDATA_NONE) {
-                                const auto dirInstSize = p.GetCount() * 3;
-                                const auto diroffset = (dirInstSize * instX) + (dirInstSize * numInstances.x * instY) +
-                                                       (dirInstSize * numInstances.x * numInstances.y * instZ);
-                                memcpy(&dirData[i][diroffset], &dirData[i][0], dirInstSize * sizeof(float));
-                            }
-                        }
+    bool const materialize = this->materializeParam.Param<core::param::BoolParam>()->Value();
+
+    bool const data_changed = (in_hash != inData.DataHash()) || (inData.DataHash() == 0) ||
+                              (in_frameID != inData.FrameID());
+    bool const interface_changed = InterfaceIsDirty() || this->transforms == nullptr;
+
+    if (interface_changed || data_changed) {
+        // the instances only depend on the parameters and the instances of the input, the particle data is never
+        // copied. Instances of the input are replicated for each grid cell.
+        auto const upstream = inData.GetInstanceTransforms();
+        auto const base = upstream != nullptr ? *upstream : std::vector<geocalls::InstanceTransform>(1);
+        auto inst = std::make_shared<std::vector<geocalls::InstanceTransform>>();
+        inst->reserve(static_cast<size_t>(std::max(numInstances.x * numInstances.y * numInstances.z, 0)) * base.size());
+        for (auto instZ = 0; instZ < numInstances.z; instZ++) {
+            for (auto instY = 0; instY < numInstances.y; instY++) {
+                for (auto instX = 0; instX < numInstances.x; instX++) {
+                    for (auto const& b : base) {
+                        auto& t = inst->emplace_back(b);
+                        t.matrix[9] += instOffsets.x * static_cast<float>(instX);
+                        t.matrix[10] += instOffsets.y * static_cast<float>(instY);
+                        t.matrix[11] += instOffsets.z * static_cast<float>(instZ);
                     }
                 }
             }
         }
+        this->transforms = std::move(inst);
+        InterfaceResetDirty();
     }
 
-    for (auto i = 0; i < plc; ++i) {
-        const auto& p = inData.AccessParticles(i);
-        outData.AccessParticles(i).SetCount(p.GetCount() * numTotalInstances);
-        if (has_global_radius[i]) {
-            outData.AccessParticles(i).SetVertexData(
-                geocalls::SimpleSphericalParticles::VERTDATA_FLOAT_XYZ, vertData[i].data(), 0);
-            outData.AccessParticles(i).SetGlobalRadius(p.GetGlobalRadius());
-        } else {
-            outData.AccessParticles(i).SetVertexData(
-                geocalls::SimpleSphericalParticles::VERTDATA_FLOAT_XYZR, vertData[i].data(), 0);
-        }
-        if (p.GetColourDataType() == geocalls::SimpleSphericalParticles::COLDATA_NONE) {
-            outData.AccessParticles(i).SetGlobalColour(
-                p.GetGlobalColour()[0], p.GetGlobalColour()[1], p.GetGlobalColour()[2], p.GetGlobalColour()[3]);
-            outData.AccessParticles(i).SetColourData(geocalls::SimpleSphericalParticles::COLDATA_NONE, nullptr, 0);
-        } else {
-            outData.AccessParticles(i).SetColourData(
-                geocalls::SimpleSphericalParticles::COLDATA_UINT8_RGBA, colData[i].data(), 0);
-        }
-        if (p.GetDirData() != nullptr) {
-            outData.AccessParticles(i).SetDirData(
-                geocalls::SimpleSphericalParticles::DIRDATA_FLOAT_XYZ, dirData[i].data(), 0);
+    outData.SetInstanceTransforms(this->transforms);
+
+    if (interface_changed || data_changed) {
+        in_hash = inData.DataHash();
+        in_frameID = inData.FrameID();
+        my_hash++;
+
+        if (materialize) {
+            ParticleInstanceMaterializer::Materialize(outData, this->materialized);
         } else {
-            outData.AccessParticles(i).SetDirData(geocalls::SimpleSphericalParticles::DIRDATA_NONE, nullptr, 0);
+            this->materialized.clear();
         }
+    } else if (materialize) {
+        ParticleInstanceMaterializer::Apply(outData, this->materialized);
     }
     outData.SetDataHash(my_hash);
 
@@ -7,13 +7,20 @@
 
 #pragma once
 
+#include <memory>
+
+#include "ParticleInstanceMaterializer.h"
 #include "datatools/AbstractParticleManipulator.h"
 #include "mmcore/param/ParamSlot.h"
 
 namespace megamol::datatools {
 
 /**
- * Module overriding global colors of multi particle lists
+ * Module instantiating the particle data on a regular xyz grid.
+ *
+ * By default, the particles of all instances are materialized into plain particle lists. Without materialization, the
+ * module only emits one instance transformation per grid cell and passes the particle data through unchanged, which
+ * only consumers supporting instance transformations (the OSPRay sphere, PKD and AOV geometries) can render.
  */
 class ParticleInstantiator : public AbstractParticleManipulator {
 public:
@@ -55,13 +62,13 @@ private:
     megamol::core::param::ParamSlot setFromClipboxParam;
     megamol::core::param::ParamSlot setFromBoundingboxParam;
 
+    megamol::core::param::ParamSlot materializeParam;
+
     SIZE_T in_hash = -1;
     unsigned int in_frameID = -1;
     SIZE_T my_hash = 0;
-    std::vector<std::vector<float>> vertData;
-    std::vector<std::vector<uint8_t>> colData;
-    std::vector<std::vector<float>> dirData;
-    std::vector<bool> has_global_radius;
+    std::shared_ptr<std::vector<geocalls::InstanceTransform>> transforms;
+    std::vector<ParticleInstanceMaterializer::MaterializedList> materialized;
 };
 
 } // namespace megamol::datatools
@@ -16,6 +16,7 @@
 #include <cassert>
 #include <cfenv>
 #include <cfloat>
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <omp.h>
@@ -48,6 +49,8 @@ datatools::ParticleThermodyn::ParticleThermodyn()
         , fluidDensitySlot("phase01::fluid density", "Density of the fluid")
         , tcSlot("phase02::Tc", "Critical temperature")
         , rhocSlot("phase02::RhoC", "Critical density")
+        , skinSlot("skin", "additional distance of the neighbour lists relative to the search distance. Larger values "
+                           "rebuild the lists less often while particles move, but test more candidates")
         , datahash(0)
         , lastTime(-1)
         , newColors()
@@ -122,6 +125,9 @@ datatools::ParticleThermodyn::ParticleThermodyn()
     this->rhocSlot.SetParameter(new core::param::FloatParam(0.3211f));
     this->MakeSlotAvailable(&this->rhocSlot);
 
+    this->skinSlot.SetParameter(new core::param::FloatParam(0.2f, 0.0f));
+    this->MakeSlotAvailable(&this->skinSlot);
+
     this->outDataSlot.SetCallback(
         geocalls::MultiParticleDataCall::ClassName(), "GetData", &ParticleThermodyn::getDataCallback);
     this->outDataSlot.SetCallback(
@@ -268,12 +274,16 @@ bool datatools::ParticleThermodyn::assertData(
         assert(allpartcnt == totalParts);
         this->myPts = std::make_shared<simplePointcloud>(in, allParts);
 
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "ParticleThermodyn: building acceleration structure for frame %u...", out->FrameID());
-        particleTree = std::make_shared<my_kd_tree_t>(
-            3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-        particleTree->buildIndex();
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: done.");
+        this->positions.resize(totalParts * 3);
+#pragma omp parallel for
+        for (INT64 i = 0; i < static_cast<INT64>(totalParts); ++i) {
+            const float* pos = this->myPts->get_position(i);
+            this->positions[i * 3 + 0] = pos[0];
+            this->positions[i * 3 + 1] = pos[1];
+            this->positions[i * 3 + 2] = pos[2];
+        }
+        // the tree is only needed for neighbour count searches the Verlet lists cannot answer
+        this->particleTree.reset();
 
         this->datahash = in->DataHash();
         this->lastTime = time;
@@ -292,6 +302,56 @@ bool datatools::ParticleThermodyn::assertData(
         // bbox.EnforcePositiveSize(); // paranoia
         auto bbox_cntr = bbox.CalcCenter();
 
+        const bool remove_self = this->removeSelfSlot.Param<megamol::core::param::BoolParam>()->Value();
+        const float eps = sqrt(std::numeric_limits<float>::epsilon());
+        const INT64 numParts = static_cast<INT64>(this->positions.size() / 3);
+
+        // the search distance of the neighbour count search is estimated from the mean density, such that a sphere
+        // of that size holds the requested number of neighbours on average
+        float cutoff = sqrt(theSquaredRadius + eps);
+        if (theSearchType == searchTypeEnum::NUM_NEIGHBORS) {
+            const float volume = bbox.Volume();
+            const float density = volume > 0.0f ? static_cast<float>(numParts) / volume : 0.0f;
+            cutoff = density > 0.0f ? 1.5f * knnGrowth * std::cbrt(3.0f * theNumber / (4.0f * 3.14159265f * density))
+                                    : 0.0f;
+        }
+        const float skin = this->skinSlot.Param<core::param::FloatParam>()->Value() * cutoff;
+        if (verletList.Update(positions, cutoff, skin, bbox, {cycl_x, cycl_y, cycl_z})) {
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "ParticleThermodyn: rebuilt neighbour lists for frame %u (cutoff %f, skin %f)", out->FrameID(), cutoff,
+                skin);
+        }
+
+        // particles with fewer candidates than requested neighbours fall back to the tree
+        auto const listCandidates = [&](INT64 idx) {
+            size_t cnt = remove_self ? 0 : 1;
+            verletList.ForEachNeighbour(idx, positions, cutoff, [&cnt](size_t, float) { ++cnt; });
+            return cnt;
+        };
+        if (theSearchType == searchTypeEnum::NUM_NEIGHBORS) {
+            INT64 fallbacks = 0;
+#pragma omp parallel for reduction(+ : fallbacks)
+            for (INT64 i = 0; i < numParts; ++i) {
+                if (listCandidates(i) < static_cast<size_t>(theNumber)) {
+                    ++fallbacks;
+                }
+            }
+            if (fallbacks > 0 && particleTree == nullptr) {
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                    "ParticleThermodyn: building acceleration structure for frame %u...", out->FrameID());
+                particleTree = std::make_shared<my_kd_tree_t>(
+                    3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
+                particleTree->buildIndex();
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: done.");
+            }
+            if (fallbacks * 100 > numParts) {
+                knnGrowth *= 1.25f;
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                    "ParticleThermodyn: %lld particles lack neighbours in the lists, enlarging the search distance",
+                    static_cast<long long>(fallbacks));
+            }
+        }
+
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
             "ParticleThermodyn: calculating thermodynamics for frame %u...", out->FrameID());
         vislib::sys::ConsoleProgressBar cpb;
@@ -306,8 +366,6 @@ bool datatools::ParticleThermodyn::assertData(
         auto const inv_search_volume = 1.0f / search_volume;*/
         auto const phase_krit = 0.5f * theFluidDensity;
 
-        const bool remove_self = this->removeSelfSlot.Param<megamol::core::param::BoolParam>()->Value();
-
         auto const T_c = tcSlot.Param<core::param::FloatParam>()->Value();
         auto const rho_c = rhocSlot.Param<core::param::FloatParam>()->Value();
 
@@ -324,7 +382,6 @@ bool datatools::ParticleThermodyn::assertData(
             std::vector<float> metricMin(num_thr, FLT_MAX);
             std::vector<float> metricMax(num_thr, 0.0f);
 
-            float eps = sqrt(std::numeric_limits<float>::epsilon());
             bool findExtremes = this->findExtremesSlot.Param<megamol::core::param::BoolParam>()->Value();
             float extremeVal = this->extremeValueSlot.Param<megamol::core::param::FloatParam>()->Value();
 
@@ -333,14 +390,12 @@ bool datatools::ParticleThermodyn::assertData(
             {
                 float theVertex[3];
                 std::vector<nanoflann::ResultItem<size_t, float>> ret_matches;
-                std::vector<nanoflann::ResultItem<size_t, float>> ret_localMatches;
                 std::vector<size_t> ret_index(theNumber);
                 std::vector<float> out_dist_sqr(theNumber);
                 nanoflann::KNNResultSet<float> resultSet(theNumber);
                 nanoflann::SearchParameters params;
                 params.sorted = false;
                 ret_matches.reserve(100);
-                ret_localMatches.reserve(100);
                 int threadIdx = omp_get_thread_num();
 
                 INT64 part_cnt = pl.GetCount();
@@ -352,39 +407,34 @@ bool datatools::ParticleThermodyn::assertData(
                     const float* vertexBase = this->myPts->get_position(myIndex);
                     // const float *velocityBase = this->myPts->get_velocity(myIndex);
 
-                    for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
-                        for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
-                            for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
-
-                                theVertex[0] = vertexBase[0];
-                                theVertex[1] = vertexBase[1];
-                                theVertex[2] = vertexBase[2];
-                                if (x_s > 0)
-                                    theVertex[0] =
-                                        theVertex[0] + ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
-                                if (y_s > 0)
-                                    theVertex[1] = theVertex[1] +
-                                                   ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height());
-                                if (z_s > 0)
-                                    theVertex[2] =
-                                        theVertex[2] + ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
-
-                                if (theSearchType == searchTypeEnum::RADIUS) {
-                                    // the documentation says the parameter radius for L2 is squared
-                                    // caution: the criterion is < radius, not <= !!!!
-                                    particleTree->radiusSearch(
-                                        theVertex, theSquaredRadius + eps, ret_localMatches, params);
-                                    if (remove_self) {
-                                        ret_localMatches.erase(
-                                            std::remove_if(ret_localMatches.begin(), ret_localMatches.end(),
-                                                [&](decltype(ret_localMatches)::value_type& elem) {
-                                                    return elem.first == myIndex;
-                                                }),
-                                            ret_localMatches.end());
-                                    }
-                                    ret_matches.insert(
-                                        ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
-                                } else {
+                    // caution: the criterion is < radius, not <= !!!!
+                    if (!remove_self) {
+                        ret_matches.push_back(nanoflann::ResultItem<size_t, float>(myIndex, 0.0f));
+                    }
+                    verletList.ForEachNeighbour(myIndex, positions, cutoff, [&ret_matches](size_t idx, float dist_sq) {
+                        ret_matches.push_back(nanoflann::ResultItem<size_t, float>(idx, dist_sq));
+                    });
+
+                    if (theSearchType == searchTypeEnum::NUM_NEIGHBORS &&
+                        ret_matches.size() < static_cast<size_t>(theNumber)) {
+                        ret_matches.clear();
+                        for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
+                            for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
+                                for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
+
+                                    theVertex[0] = vertexBase[0];
+                                    theVertex[1] = vertexBase[1];
+                                    theVertex[2] = vertexBase[2];
+                                    if (x_s > 0)
+                                        theVertex[0] = theVertex[0] +
+                                                       ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
+                                    if (y_s > 0)
+                                        theVertex[1] = theVertex[1] + ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height()
+                                                                                                      : bbox.Height());
+                                    if (z_s > 0)
+                                        theVertex[2] = theVertex[2] +
+                                                       ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
+
                                     resultSet.init(ret_index.data(), out_dist_sqr.data());
                                     particleTree->findNeighbors(resultSet, theVertex, params);
                                     for (size_t i = 0; i < resultSet.size(); ++i) {
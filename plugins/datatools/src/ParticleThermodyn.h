@@ -8,6 +8,7 @@
 #pragma once
 
 #include "datatools/PointcloudHelpers.h"
+#include "datatools/misc/VerletList.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
@@ -113,6 +114,7 @@ private:
     core::param::ParamSlot fluidDensitySlot;
     core::param::ParamSlot tcSlot;
     core::param::ParamSlot rhocSlot;
+    core::param::ParamSlot skinSlot;
 
     size_t datahash;
     size_t myHash = 0;
@@ -127,9 +129,19 @@ private:
         3 /* dim */, std::size_t>
         my_kd_tree_t;
 
+    /** Only built if a neighbour search cannot be answered from the Verlet lists */
     std::shared_ptr<my_kd_tree_t> particleTree;
     std::shared_ptr<simplePointcloud> myPts;
 
+    /** The positions of all processed particles (xyzxyz...), indexed like 'myPts' */
+    std::vector<float> positions;
+
+    /** Neighbour lists, kept across frames as long as the particles move less than half the skin */
+    misc::VerletList verletList;
+
+    /** Enlarges the estimated search distance for neighbour counts if too many particles fall back to the tree */
+    float knnGrowth = 1.0f;
+
     /** The slot providing access to the manipulated data */
     megamol::core::CalleeSlot outDataSlot;
 
@@ -71,10 +71,10 @@ datatools::ParticleVelocities::ParticleVelocities()
         , dtSlot("dt", "time difference between two sequential time steps")
         , outDataSlot("outData", "Provides one frame less than the source, but with velocities")
         , inDataSlot("inData", "Takes the particle data, sorted, with constant particle numbers over all frames")
-        , cachedVertexData()
         , cachedNumLists(0)
         , cachedTime(-1)
         , cachedDirData()
+        , history(4)
         , datahash(0)
         , time(0) {
 
@@ -109,6 +109,73 @@ datatools::ParticleVelocities::~ParticleVelocities() {
 }
 
 
+bool datatools::ParticleVelocities::fetchFrame(geocalls::MultiParticleDataCall* in, unsigned int frame) {
+    in->SetFrameID(frame, true);
+    do {
+        if (!(*in)(1)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "ParticleVelocities: could not get frame extents (%u)", frame);
+            return false;
+        }
+        if (!(*in)(0)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "ParticleVelocities: could not get frame (%u)", frame);
+            return false;
+        }
+    } while (in->FrameID() != frame); // did we get correct frame?
+    return true;
+}
+
+
+void datatools::ParticleVelocities::gatherPositions(geocalls::MultiParticleDataCall& in, FramePositions& positions) {
+    using geocalls::MultiParticleDataCall;
+
+    auto const plc = in.GetParticleListCount();
+    positions.lists.resize(plc);
+    positions.types.resize(plc);
+    for (unsigned int i = 0; i < plc; ++i) {
+        auto const& parts = in.AccessParticles(i);
+        auto& pos = positions.lists[i];
+        positions.types[i] = parts.GetVertexDataType();
+        if (positions.types[i] == MultiParticleDataCall::Particles::VertexDataType::VERTDATA_NONE) {
+            pos.clear();
+            continue;
+        }
+        auto const count = parts.GetCount();
+        pos.resize(count * 3);
+        auto const& store = parts.GetParticleStore();
+        store.GetXAcc()->Gather_f(0, count, pos.data() + 0, 3);
+        store.GetYAcc()->Gather_f(0, count, pos.data() + 1, 3);
+        store.GetZAcc()->Gather_f(0, count, pos.data() + 2, 3);
+    }
+}
+
+
+void datatools::ParticleVelocities::computeVelocities(
+    FramePositions const& prev, FramePositions const& cur, vislib::math::Cuboid<float> const& bbox) {
+    bool const cycleX = this->cyclXSlot.Param<core::param::BoolParam>()->Value();
+    bool const cycleY = this->cyclYSlot.Param<core::param::BoolParam>()->Value();
+    bool const cycleZ = this->cyclZSlot.Param<core::param::BoolParam>()->Value();
+    float const theDt = this->dtSlot.Param<core::param::FloatParam>()->Value();
+
+    this->cachedDirData.resize(cachedNumLists);
+    for (auto i = 0; i < cachedNumLists; i++) {
+        auto& dir = this->cachedDirData[i];
+        auto const& prevPos = prev.lists[i];
+        auto const& curPos = cur.lists[i];
+        dir.resize(curPos.size());
+#pragma omp parallel for
+        for (int64_t p = 0; p < static_cast<int64_t>(curPos.size() / 3); p++) {
+            auto const diff = getDifference(&prevPos[p * 3], &curPos[p * 3], cycleX, cycleY, cycleZ, bbox.Width(),
+                bbox.Height(), bbox.Depth());
+            dir[p * 3 + 0] = diff[0] / theDt;
+            dir[p * 3 + 1] = diff[1] / theDt;
+            dir[p * 3 + 2] = diff[2] / theDt;
+        }
+    }
+}
+
+
 bool datatools::ParticleVelocities::assertData(
     geocalls::MultiParticleDataCall* in, geocalls::MultiParticleDataCall* outMPDC) {
 
@@ -119,148 +186,95 @@ bool datatools::ParticleVelocities::assertData(
         out = outMPDC;
     unsigned int time = out->FrameID() + 1; // we do not give out the original frame 0 because it has no previous frame
 
-    if (this->cachedTime != time - 1 || this->datahash != in->DataHash()) {
-        for (auto i = 0; i < cachedNumLists; i++) {
-            if (cachedVertexDataType[i] != MultiParticleDataCall::Particles::VertexDataType::VERTDATA_NONE)
-                delete this->cachedVertexData[i];
-            delete this->cachedDirData[i];
-            this->cachedListLength[i] = 0;
-        }
-        //cachedVertexData.resize(0);
-        this->cachedTime = -1;
-        this->cachedNumLists = 0;
-        // load previous Frame
-        in->SetFrameID(time - 1, true);
-        //if (!(*in)(1)) {
-        //    megamol::core::utility::log::Log::DefaultLog.WriteError("ParticleVelocities: could not get previous frame extents (%u)", time - 1);
-        //    return false;
-        //}
-        do {
-            if (!(*in)(0)) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(
-                    "ParticleVelocities: could not get previous frame (%u)", time - 1);
-                return false;
-            }
-        } while (in->FrameID() != time - 1); // did we get correct frame?
-        cachedVertexData.resize(in->GetParticleListCount(), nullptr);
-        cachedVertexDataType.resize(in->GetParticleListCount());
-        cachedGlobalRadius.resize(in->GetParticleListCount(), 0.0f);
-        cachedDirData.resize(in->GetParticleListCount());
-        cachedStride.resize(in->GetParticleListCount());
-        cachedListLength.resize(in->GetParticleListCount());
-        for (unsigned int i = 0; i < in->GetParticleListCount(); i++) {
-            size_t stride = in->AccessParticles(i).GetVertexDataStride();
-            this->cachedVertexDataType[i] = in->AccessParticles(i).GetVertexDataType();
-            cachedGlobalRadius[i] = in->AccessParticles(i).GetGlobalRadius();
-            if (stride == 0) {
-                switch (this->cachedVertexDataType[i]) {
-                case MultiParticleDataCall::Particles::VertexDataType::VERTDATA_NONE:
-                    continue;
-                case MultiParticleDataCall::Particles::VertexDataType::VERTDATA_FLOAT_XYZ:
-                    stride = 12;
-                    break;
-                case MultiParticleDataCall::Particles::VertexDataType::VERTDATA_FLOAT_XYZR:
-                    stride = 16;
-                    break;
-                case MultiParticleDataCall::Particles::VertexDataType::VERTDATA_SHORT_XYZ:
-                    megamol::core::utility::log::Log::DefaultLog.WriteError(
-                        "ParticleVelocities: cannot process short position vertices");
-                    this->cachedVertexDataType[i] = MultiParticleDataCall::Particles::VertexDataType::VERTDATA_NONE;
-                    continue;
-                default:
-                    megamol::core::utility::log::Log::DefaultLog.WriteError(
-                        "ParticleVelocities: cannot process unknown position type");
-                    this->cachedVertexDataType[i] = MultiParticleDataCall::Particles::VertexDataType::VERTDATA_NONE;
-                    continue;
-                }
-            }
-            this->cachedStride[i] = stride;
-            this->cachedListLength[i] = in->AccessParticles(i).GetCount();
-            size_t thesize = this->cachedListLength[i] * stride;
-            this->cachedVertexData[i] = new char[thesize];
-            memcpy(this->cachedVertexData[i], in->AccessParticles(i).GetVertexData(), thesize);
-        }
-        // TODO: what am I actually doing here
-        //in->SetUnlocker(nullptr, false);
-        in->Unlock();
-        this->cachedTime = time - 1;
-        this->cachedNumLists = in->GetParticleListCount();
+    // the current frame is always fetched, since the output references its positions and colours
+    if (!this->fetchFrame(in, time)) {
+        return false;
+    }
+    if (this->datahash != in->DataHash()) {
+        this->history.Clear();
+    }
 
-        in->SetFrameID(time, true);
-        do {
-            if (!(*in)(1)) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(
-                    "ParticleVelocities: could not get current frame extents (%u)", time - 1);
+    if (this->history.Find(time) == nullptr || this->history.Find(time - 1) == nullptr) {
+        // load previous frame, unless it has been the current frame of an earlier request
+        if (this->history.Find(time - 1) == nullptr) {
+            in->Unlock();
+            if (!this->fetchFrame(in, time - 1)) {
                 return false;
             }
-            if (!(*in)(0)) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(
-                    "ParticleVelocities: could not get current frame (%u)", time - 1);
+            gatherPositions(*in, this->history.Insert(time - 1));
+            // TODO: what am I actually doing here
+            //in->SetUnlocker(nullptr, false);
+            in->Unlock();
+            if (!this->fetchFrame(in, time)) {
                 return false;
             }
-        } while (in->FrameID() != time); // did we get correct frame?
-        if (cachedNumLists != in->GetParticleListCount()) {
+        }
+        auto const* prev = this->history.Find(time - 1);
+
+        if (prev->lists.size() != in->GetParticleListCount()) {
             megamol::core::utility::log::Log::DefaultLog.WriteError("ParticleVelocities: inconsistent number of lists"
                                                                     "between frames %u (%u) and %u (%u)",
-                time - 1, cachedNumLists, time, in->GetParticleListCount());
+                time - 1, static_cast<unsigned int>(prev->lists.size()), time, in->GetParticleListCount());
             return false;
         }
-        this->dtSlot.ForceSetDirty();
-    }
-    if (this->cyclXSlot.IsDirty() || this->cyclYSlot.IsDirty() || this->cyclZSlot.IsDirty() || this->dtSlot.IsDirty()) {
-        bool cycleX = this->cyclXSlot.Param<core::param::BoolParam>()->Value();
-        bool cycleY = this->cyclYSlot.Param<core::param::BoolParam>()->Value();
-        bool cycleZ = this->cyclZSlot.Param<core::param::BoolParam>()->Value();
-        float theDt = this->dtSlot.Param<core::param::FloatParam>()->Value();
-
-        float *cachedPtr, *currentPtr;
-        vislib::math::Vector<float, 3> diff;
+        gatherPositions(*in, this->currentPositions);
+
+        this->cachedNumLists = in->GetParticleListCount();
         for (auto i = 0; i < cachedNumLists; i++) {
-            if (cachedVertexDataType[i] != in->AccessParticles(i).GetVertexDataType()) {
+            auto const& parts = in->AccessParticles(i);
+            if (prev->types[i] != parts.GetVertexDataType()) {
                 megamol::core::utility::log::Log::DefaultLog.WriteError(
                     "ParticleVelocities: inconsistent vertex data type"
                     "between frames %u (%u) and %u (%u)in list %u",
-                    time - 1, static_cast<uint32_t>(cachedVertexDataType[i]), time,
-                    static_cast<uint32_t>(in->AccessParticles(i).GetVertexDataType()), i);
+                    time - 1, static_cast<uint32_t>(prev->types[i]), time,
+                    static_cast<uint32_t>(parts.GetVertexDataType()), i);
                 return false;
             }
-            if (cachedListLength[i] != in->AccessParticles(i).GetCount()) {
+            if (prev->lists[i].size() != this->currentPositions.lists[i].size()) {
                 megamol::core::utility::log::Log::DefaultLog.WriteError("ParticleVelocities: inconsistent list length"
                                                                         "between frames %u (%u) and %u (%u)in list %u",
-                    time - 1, cachedListLength[i], time, in->AccessParticles(i).GetCount(), i);
+                    time - 1, static_cast<unsigned int>(prev->lists[i].size() / 3), time,
+                    static_cast<unsigned int>(parts.GetCount()), i);
                 return false;
             }
-
-            auto& bbox = in->GetBoundingBoxes().ObjectSpaceBBox();
-            this->cachedDirData[i] = new float[cachedListLength[i] * 3];
-            for (auto p = 0; p < this->cachedListLength[i]; p++) {
-                cachedPtr =
-                    reinterpret_cast<float*>(static_cast<char*>(this->cachedVertexData[i]) + p * this->cachedStride[i]);
-                currentPtr = reinterpret_cast<float*>(
-                    static_cast<char*>(const_cast<void*>(in->AccessParticles(i).GetVertexData())) +
-                    p * this->cachedStride[i]);
-                diff = getDifference(
-                    cachedPtr, currentPtr, cycleX, cycleY, cycleZ, bbox.Width(), bbox.Height(), bbox.Depth());
-                this->cachedDirData[i][p * 3 + 0] = diff[0] / theDt;
-                this->cachedDirData[i][p * 3 + 1] = diff[1] / theDt;
-                this->cachedDirData[i][p * 3 + 2] = diff[2] / theDt;
-            }
         }
-        // TODO: what am I actually doing here
-        //in->SetUnlocker(nullptr, false);
-        //in->Unlock();
+
+        this->computeVelocities(*prev, this->currentPositions, in->GetBoundingBoxes().ObjectSpaceBBox());
+
+        // the current frame is the previous frame of the next request during playback
+        std::swap(this->history.Insert(time), this->currentPositions);
+        this->cachedTime = time;
+        this->cyclXSlot.ResetDirty();
+        this->cyclYSlot.ResetDirty();
+        this->cyclZSlot.ResetDirty();
+        this->dtSlot.ResetDirty();
+    } else if (this->cachedTime != time || this->cyclXSlot.IsDirty() || this->cyclYSlot.IsDirty() ||
+               this->cyclZSlot.IsDirty() || this->dtSlot.IsDirty()) {
+        // both frames are known, only the velocities need to be recomputed
+        this->computeVelocities(*this->history.Find(time - 1), *this->history.Find(time),
+            in->GetBoundingBoxes().ObjectSpaceBBox());
+        this->cachedTime = time;
+        this->cyclXSlot.ResetDirty();
+        this->cyclYSlot.ResetDirty();
+        this->cyclZSlot.ResetDirty();
+        this->dtSlot.ResetDirty();
     }
     if (outMPDC != nullptr) {
         outMPDC->SetParticleListCount(cachedNumLists);
         for (auto i = 0; i < cachedNumLists; i++) {
-            outMPDC->AccessParticles(i).SetCount(this->cachedListLength[i]);
-            outMPDC->AccessParticles(i).SetGlobalRadius(this->cachedGlobalRadius[i]);
-            outMPDC->AccessParticles(i).SetVertexData(this->cachedVertexDataType[i],
-                in->AccessParticles(i).GetVertexData(), in->AccessParticles(i).GetVertexDataStride());
-            outMPDC->AccessParticles(i).SetColourData(in->AccessParticles(i).GetColourDataType(),
-                in->AccessParticles(i).GetColourData(), in->AccessParticles(i).GetColourDataStride());
-            outMPDC->AccessParticles(i).SetDirData(
-                geocalls::MultiParticleDataCall::Particles::DIRDATA_FLOAT_XYZ, cachedDirData[i], 0);
+            auto const& parts = in->AccessParticles(i);
+            outMPDC->AccessParticles(i).SetCount(parts.GetCount());
+            outMPDC->AccessParticles(i).SetGlobalRadius(parts.GetGlobalRadius());
+            outMPDC->AccessParticles(i).SetVertexData(
+                parts.GetVertexDataType(), parts.GetVertexData(), parts.GetVertexDataStride());
+            outMPDC->AccessParticles(i).SetColourData(
+                parts.GetColourDataType(), parts.GetColourData(), parts.GetColourDataStride());
+            if (parts.GetVertexDataType() == MultiParticleDataCall::Particles::VertexDataType::VERTDATA_NONE) {
+                outMPDC->AccessParticles(i).SetDirData(MultiParticleDataCall::Particles::DIRDATA_NONE, nullptr, 0);
+            } else {
+                outMPDC->AccessParticles(i).SetDirData(
+                    MultiParticleDataCall::Particles::DIRDATA_FLOAT_XYZ, cachedDirData[i].data(), 0);
+            }
         }
     }
     this->datahash = in->DataHash();
@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include "datatools/misc/FrameRingBuffer.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
+#include "vislib/math/Cuboid.h"
 #include "vislib/math/Vector.h"
 #include <map>
 #include <vector>
@@ -77,8 +79,24 @@ private:
      */
     bool getExtentCallback(megamol::core::Call& c);
 
+    /** The positions of one frame, stored as triples (xyzxyz...) per list */
+    struct FramePositions {
+        std::vector<std::vector<float>> lists;
+        std::vector<geocalls::MultiParticleDataCall::Particles::VertexDataType> types;
+    };
+
     bool assertData(geocalls::MultiParticleDataCall* in, geocalls::MultiParticleDataCall* outMPDC);
 
+    /** Requests extents and data of a frame until the source delivers it */
+    bool fetchFrame(geocalls::MultiParticleDataCall* in, unsigned int frame);
+
+    /** Copies the positions of all lists of the fetched frame */
+    static void gatherPositions(geocalls::MultiParticleDataCall& in, FramePositions& positions);
+
+    /** Computes the velocities of all lists from frame i-1 to frame i */
+    void computeVelocities(
+        FramePositions const& prev, FramePositions const& cur, vislib::math::Cuboid<float> const& bbox);
+
     core::param::ParamSlot cyclXSlot;
     core::param::ParamSlot cyclYSlot;
     core::param::ParamSlot cyclZSlot;
@@ -87,14 +105,18 @@ private:
     unsigned int time;
 
     int cachedNumLists;
+    /** The frame of the source the velocities have been computed for */
     unsigned int cachedTime;
-    std::vector<float> cachedGlobalRadius;
-    std::vector<size_t> cachedListLength;
-    std::vector<size_t> cachedStride;
-    std::vector<geocalls::MultiParticleDataCall::Particles::VertexDataType> cachedVertexDataType;
-    std::vector<void*> cachedVertexData;
-    std::vector<float*> cachedDirData;
+    std::vector<std::vector<float>> cachedDirData;
+
+    /**
+     * The positions of the most recent source frames. During playback, the current frame becomes the previous frame
+     * of the next request, so every frame is fetched and copied only once.
+     */
+    misc::FrameRingBuffer<FramePositions> history;
 
+    /** Scratch storage for the positions of the current frame */
+    FramePositions currentPositions;
 
     /** The slot providing access to the manipulated data */
     megamol::core::CalleeSlot outDataSlot;
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <omp.h>
 
+#include "geometry_calls/VolumeKernels.h"
 #include "geometry_calls/VolumetricDataCall.h"
 
 using namespace megamol;
@@ -118,12 +119,10 @@ bool datatools::ParticleVisibilityFromVolume::manipulateData(
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("Computing Visibility from Volume...");
 
     const VolumetricDataCall::Metadata* volMeta = inVol->GetMetadata();
-    const auto theVol = inVol->GetData();
 
-    if (!volMeta->GridType == VolumetricDataCall::GridType::CARTESIAN ||
-        !volMeta->GridType == VolumetricDataCall::GridType::RECTILINEAR) {
+    if (volMeta->GridType != VolumetricDataCall::GridType::CARTESIAN) {
         megamol::core::utility::log::Log::DefaultLog.WriteError(
-            "ParticleVisibilityFromVolume: input Volume has to be cartesian or rectilinear!");
+            "ParticleVisibilityFromVolume: input Volume has to be cartesian!");
         return false;
     }
 
@@ -132,20 +131,16 @@ bool datatools::ParticleVisibilityFromVolume::manipulateData(
     this->minSlot.Param<core::param::FloatParam>()->SetValue(volMeta->MinValues[channel]);
     this->maxSlot.Param<core::param::FloatParam>()->SetValue(volMeta->MaxValues[channel]);
 
-    bool volumeIsNotBBoxAligned = false;
+    size_t numOutside = 0;
 
     //bool cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
     //bool cycl_y = this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value();
     //bool cycl_z = this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value();
 
-    typedef const float (VolumetricDataCall::*getter)(const uint32_t, const uint32_t, const uint32_t, const uint32_t)
-        const;
-    getter getFun;
-    if (absolute) {
-        getFun = &VolumetricDataCall::GetAbsoluteVoxelValue;
-    } else {
-        getFun = &VolumetricDataCall::GetRelativeVoxelValue;
-    }
+    // relative values map [min, max] of the channel to [0, 1], which commutes with the interpolation
+    const float valOffset = absolute ? 0.0f : static_cast<float>(volMeta->MinValues[channel]);
+    const float valRange = static_cast<float>(volMeta->MaxValues[channel] - volMeta->MinValues[channel]);
+    const float valScale = absolute ? 1.0f : (valRange != 0.0f ? 1.0f / valRange : 0.0f);
 
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleVisibilityFromVolume: starting filtering");
     const auto startTime = std::chrono::high_resolution_clock::now();
@@ -168,8 +163,6 @@ bool datatools::ParticleVisibilityFromVolume::manipulateData(
         const MultiParticleDataCall::Particles::VertexDataType vdt = p.GetVertexDataType();
         const auto vdsize = MultiParticleDataCall::Particles::VertexDataSize[vdt];
 
-        UINT64 cntLeft = 0;
-
         const uint8_t* commonBasePointer = nullptr;
         const uint8_t* vertexBasePointer = nullptr;
         const uint8_t* colorBasePointer = nullptr;
@@ -179,134 +172,129 @@ bool datatools::ParticleVisibilityFromVolume::manipulateData(
         vertexBasePointer = reinterpret_cast<const uint8_t*>(p.GetVertexData());
         colorBasePointer = reinterpret_cast<const uint8_t*>(p.GetColourData());
 
-        if (cdsize == 0 || vdsize + cdsize == vdstride) {
-            // data is interleaved
-            commonBasePointer = vertexBasePointer < colorBasePointer ? vertexBasePointer : colorBasePointer;
-            colorIsFirst = vertexBasePointer > colorBasePointer;
+        // a stride of zero denotes tightly packed data
+        const unsigned int avdstride = vdstride == 0 ? vdsize : vdstride;
+        const unsigned int acdstride = cdstride == 0 ? cdsize : cdstride;
+        // bytes copied per interleaved record, from the first to the last byte of the attributes in use
+        unsigned int recordSize = vdsize;
+        if (cdsize == 0) {
             isInterleaved = true;
-            vdstride = vdsize + cdsize;
-            theVertexData[i].resize(cnt * vdstride);
-        } else {
-            theVertexData[i].resize(cnt * vdsize);
-            theColorData[i].resize(cnt * cdsize);
+            commonBasePointer = vertexBasePointer;
+        } else if (acdstride == avdstride) {
+            // the data is interleaved if the colour lies within the first vertex record, or vice versa
+            const ptrdiff_t colorOffset = colorBasePointer - vertexBasePointer;
+            if (colorOffset >= 0 && colorOffset < static_cast<ptrdiff_t>(avdstride)) {
+                isInterleaved = true;
+                commonBasePointer = vertexBasePointer;
+                recordSize = std::max<unsigned int>(vdsize, static_cast<unsigned int>(colorOffset) + cdsize);
+            } else if (colorOffset < 0 && -colorOffset < static_cast<ptrdiff_t>(acdstride)) {
+                isInterleaved = true;
+                colorIsFirst = true;
+                commonBasePointer = colorBasePointer;
+                recordSize = std::max<unsigned int>(cdsize, static_cast<unsigned int>(-colorOffset) + vdsize);
+            }
+        }
+        if (isInterleaved) {
+            vdstride = avdstride;
         }
 
-#ifdef _OPENMP
-        const auto numThreads = omp_get_num_threads();
-#endif
-
+        // sample the volume at all particles, in Morton order of their voxels for cache locality
         auto const& parStore = p.GetParticleStore();
-        auto const& xAcc = parStore.GetXAcc();
-        auto const& yAcc = parStore.GetYAcc();
-        auto const& zAcc = parStore.GetZAcc();
-
-// todo: is this OK?
-#pragma omp parallel for
-        for (INT64 j = 0; j < cnt; ++j) {
-            const auto x = xAcc->Get_f(j);
-            const auto y = yAcc->Get_f(j);
-            const auto z = zAcc->Get_f(j);
-
-            // relative coordinates in volume
-            const auto rx = (x - volMeta->Origin[0]) / volMeta->SliceDists[0][0];
-            const auto ry = (y - volMeta->Origin[1]) / volMeta->SliceDists[1][0];
-            const auto rz = (z - volMeta->Origin[2]) / volMeta->SliceDists[2][0];
-
-            const int quantX = static_cast<int>(rx);
-            const int quantY = static_cast<int>(ry);
-            const int quantZ = static_cast<int>(rz);
-            int quantX2 = quantX;
-            int quantY2 = quantY;
-            int quantZ2 = quantZ;
-            const float diffX = rx - quantX;
-            const float diffY = ry - quantY;
-            const float diffZ = rz - quantZ;
-
-            if (quantX >= 0 || quantX < static_cast<int>(volMeta->Resolution[0]) || quantY >= 0 ||
-                quantY < static_cast<int>(volMeta->Resolution[1]) || quantZ >= 0 ||
-                quantZ < static_cast<int>(volMeta->Resolution[2])) {
-                // OK actually
-            } else {
-                volumeIsNotBBoxAligned = true;
-                continue;
-            }
+        this->positions.resize(cnt * 3);
+        parStore.GetXAcc()->Gather_f(0, cnt, this->positions.data() + 0, 3);
+        parStore.GetYAcc()->Gather_f(0, cnt, this->positions.data() + 1, 3);
+        parStore.GetZAcc()->Gather_f(0, cnt, this->positions.data() + 2, 3);
+        geocalls::volume_kernels::Grid grid;
+        grid.Set(*volMeta);
+        geocalls::volume_kernels::MortonOrder(this->positions.data(), cnt, grid, this->order);
+        this->samples.resize(cnt);
+        size_t listOutside = 0;
+        if (!geocalls::volume_kernels::SampleTrilinear(*inVol, channel, this->positions.data(), this->order.data(),
+                cnt, this->samples.data(), listOutside)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "ParticleVisibilityFromVolume: unsupported scalar type of the volume!");
+            return false;
+        }
+        numOutside += listOutside;
 
-            // warning: we fake CBC here which has no relevance since at the right border,
-            // the right neighbor influence should be pulled to 0 anyway
-            quantX2 = std::max<size_t>(0, std::min<size_t>(volMeta->Resolution[0] - 1, quantX + 1));
-            quantY2 = std::max<size_t>(0, std::min<size_t>(volMeta->Resolution[1] - 1, quantY + 1));
-            quantZ2 = std::max<size_t>(0, std::min<size_t>(volMeta->Resolution[2] - 1, quantZ + 1));
-
-            const float c000 = ((inVol)->*(getFun))(quantX, quantY, quantZ, channel);
-            const float c100 = ((inVol)->*(getFun))(quantX2, quantY, quantZ, channel);
-            const float c010 = ((inVol)->*(getFun))(quantX, quantY2, quantZ, channel);
-            const float c110 = ((inVol)->*(getFun))(quantX2, quantY2, quantZ, channel);
-            const float c001 = ((inVol)->*(getFun))(quantX, quantY, quantZ2, channel);
-            const float c101 = ((inVol)->*(getFun))(quantX2, quantY, quantZ2, channel);
-            const float c011 = ((inVol)->*(getFun))(quantX, quantY2, quantZ2, channel);
-            const float c111 = ((inVol)->*(getFun))(quantX2, quantY2, quantZ2, channel);
-
-            float volVal = (1.0f - diffX) * (1.0f - diffY) * (1.0f - diffZ) * c000 +
-                           diffX * (1.0f - diffY) * (1.0f - diffZ) * c100 +
-                           (1.0f - diffX) * diffY * (1.0f - diffZ) * c010 + diffX * diffY * (1.0f - diffZ) * c110 +
-                           (1.0f - diffX) * (1.0f - diffY) * diffZ * c001 + diffX * (1.0f - diffY) * diffZ * c101 +
-                           (1.0f - diffX) * diffY * diffZ * c011 + diffX * diffY * diffZ * c111;
-
-            bool isOK = false;
+        // the kept particles are compacted in their original order. The offsets are a prefix sum over the kept
+        // flags, computed per block of particles and shifted by the sums of the preceding blocks.
+        const auto isKept = [&](UINT64 j) {
+            const float volVal = (this->samples[j] - valOffset) * valScale;
             switch (op) {
             case 0:
                 // smaller
-                isOK = volVal < theVal;
-                break;
+                return volVal < theVal;
             case 1:
                 // larger
-                isOK = volVal > theVal;
-                break;
+                return volVal > theVal;
             case 2:
                 // equal
-                isOK = std::abs(volVal - theVal) < epsilon;
-                break;
+                return std::abs(volVal - theVal) < epsilon;
             }
-
-            if (isOK) {
-#ifdef _OPENMP
-                const UINT64 localIdx = cntLeft + omp_get_thread_num();
-#else
-                const UINT64 localIdx = cntLeft;
-#endif
-                if (isInterleaved) {
-                    memcpy(theVertexData[i].data() + vdstride * localIdx, commonBasePointer + vdstride * j, vdstride);
-                } else {
-                    memcpy(theVertexData[i].data() + vdsize * localIdx, vertexBasePointer + vdstride * j, vdsize);
-                    memcpy(theColorData[i].data() + cdsize * localIdx, colorBasePointer + cdstride * j, cdsize);
-                }
-#pragma omp atomic
-                cntLeft++;
+            return false;
+        };
+        const INT64 numBlocks = std::max<INT64>(std::min<INT64>(omp_get_max_threads(), cnt / 4096), 1);
+        std::vector<UINT64> blockOffsets(numBlocks + 1, 0);
+        this->offsets.resize(cnt + 1);
+        this->offsets[0] = 0;
+#pragma omp parallel for
+        for (INT64 b = 0; b < numBlocks; ++b) {
+            UINT64 kept = 0;
+            for (UINT64 j = cnt * b / numBlocks; j < cnt * (b + 1) / numBlocks; ++j) {
+                kept += isKept(j) ? 1 : 0;
+                this->offsets[j + 1] = kept;
             }
+            blockOffsets[b + 1] = kept;
+        }
+        for (INT64 b = 0; b < numBlocks; ++b) {
+            blockOffsets[b + 1] += blockOffsets[b];
         }
+#pragma omp parallel for
+        for (INT64 b = 1; b < numBlocks; ++b) {
+            for (UINT64 j = cnt * b / numBlocks; j < cnt * (b + 1) / numBlocks; ++j) {
+                this->offsets[j + 1] += blockOffsets[b];
+            }
+        }
+        const UINT64 cntLeft = this->offsets[cnt];
 
-        auto& outp = outData.AccessParticles(i);
-        outp.SetCount(cntLeft);
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "ParticleVisibilityFromVolume: list %d: %lu / %lu particles left", i, cntLeft, cnt);
         if (isInterleaved) {
             theVertexData[i].resize(cntLeft * vdstride);
-            //theColorData[i].resize(cntLeft * cdsize);
         } else {
             theVertexData[i].resize(cntLeft * vdsize);
             theColorData[i].resize(cntLeft * cdsize);
         }
+
+#pragma omp parallel for
+        for (INT64 j = 0; j < static_cast<INT64>(cnt); ++j) {
+            if (this->offsets[j + 1] == this->offsets[j]) {
+                continue;
+            }
+            const UINT64 localIdx = this->offsets[j];
+            if (isInterleaved) {
+                memcpy(theVertexData[i].data() + vdstride * localIdx, commonBasePointer + vdstride * j, recordSize);
+            } else {
+                memcpy(theVertexData[i].data() + vdsize * localIdx, vertexBasePointer + avdstride * j, vdsize);
+                memcpy(theColorData[i].data() + cdsize * localIdx, colorBasePointer + acdstride * j, cdsize);
+            }
+        }
+
+        auto& outp = outData.AccessParticles(i);
+        outp.SetCount(cntLeft);
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+            "ParticleVisibilityFromVolume: list %d: %lu / %lu particles left", i, cntLeft, cnt);
         auto col = p.GetGlobalColour();
         outp.SetGlobalColour(col[0], col[1], col[2], col[3]);
         outp.SetGlobalRadius(p.GetGlobalRadius());
         outp.SetGlobalType(p.GetGlobalType());
         if (isInterleaved) {
             if (colorIsFirst) {
-                outp.SetColourData(cdt, theVertexData[i].data(), cdstride);
+                outp.SetColourData(cdt, theVertexData[i].data(), vdstride);
                 outp.SetVertexData(vdt, theVertexData[i].data() + (vertexBasePointer - colorBasePointer), vdstride);
             } else {
                 outp.SetVertexData(vdt, theVertexData[i].data(), vdstride);
-                outp.SetColourData(cdt, theVertexData[i].data() + (colorBasePointer - vertexBasePointer), cdstride);
+                outp.SetColourData(cdt,
+                    cdsize != 0 ? theVertexData[i].data() + (colorBasePointer - vertexBasePointer) : nullptr, vdstride);
             }
         } else {
             outp.SetVertexData(vdt, theVertexData[i].data(), vdsize);
@@ -320,9 +308,10 @@ bool datatools::ParticleVisibilityFromVolume::manipulateData(
         "ParticleVisibilityFromVolume took %f ms.", diffMillis.count());
 
 
-    if (volumeIsNotBBoxAligned) {
+    if (numOutside > 0) {
         megamol::core::utility::log::Log::DefaultLog.WriteWarn(
-            "ParticleVisibilityFromVolume: Volume does not cover all of the domain!");
+            "ParticleVisibilityFromVolume: Volume does not cover all of the domain (%zu particles outside)!",
+            numOutside);
     }
 
     this->lastTime = inData.FrameID();
@@ -84,6 +84,12 @@ private:
     std::vector<std::vector<uint8_t>> theVertexData;
     std::vector<std::vector<uint8_t>> theColorData;
 
+    /** scratch storage for sampling: positions (xyzxyz...), sampling order, sampled values and output offsets */
+    std::vector<float> positions;
+    std::vector<uint32_t> order;
+    std::vector<float> samples;
+    std::vector<uint64_t> offsets;
+
     /** for change tracking: last frameID we pulled */
     unsigned int lastTime = -1;
 
@@ -37,6 +37,11 @@ using namespace megamol;
  * datatools::ParticlesToDensity::create
  */
 bool datatools::ParticlesToDensity::create() {
+#ifdef MEGAMOL_USE_PROFILING
+    perf_manager_ = const_cast<frontend_resources::PerformanceManager*>(
+        &frontend_resources.get<frontend_resources::PerformanceManager>());
+    volume_pool_ = perf_manager_->add_memory_pool(this, "volumes");
+#endif
     return true;
 }
 
@@ -45,6 +50,9 @@ bool datatools::ParticlesToDensity::create() {
  * datatools::ParticlesToDensity::release
  */
 void datatools::ParticlesToDensity::release() {
+#ifdef MEGAMOL_USE_PROFILING
+    perf_manager_->remove_memory_pool(volume_pool_);
+#endif
     delete[] this->metadata.MinValues;
     delete[] this->metadata.MaxValues;
     delete[] this->metadata.SliceDists[0];
@@ -235,6 +243,16 @@ bool datatools::ParticlesToDensity::getDataCallback(megamol::core::Call& c) {
                 modifyBBox(inMpdc);
             if (!this->createVolumeCPU(inMpdc))
                 return false;
+#ifdef MEGAMOL_USE_PROFILING
+            size_t bytes = 0;
+            for (auto const& v : this->vol) {
+                bytes += v.capacity() * sizeof(float);
+            }
+            bytes += (this->directions.capacity() + this->colors.capacity() + this->densities.capacity() +
+                         this->grid.capacity() + this->infoData.capacity()) *
+                     sizeof(float);
+            perf_manager_->set_memory_usage(volume_pool_, bytes);
+#endif
             this->time = inMpdc->FrameID();
             this->in_datahash = inMpdc->DataHash();
             ++this->datahash;
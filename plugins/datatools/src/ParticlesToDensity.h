@@ -22,6 +22,10 @@
 #include <limits>
 #include <vector>
 
+#ifdef MEGAMOL_USE_PROFILING
+#include "PerformanceManager.h"
+#endif
+
 namespace megamol::datatools {
 
 /**
@@ -46,6 +50,13 @@ public:
         return true;
     }
 
+#ifdef MEGAMOL_USE_PROFILING
+    static void requested_lifetime_resources(frontend_resources::ResourceRequest& req) {
+        Module::requested_lifetime_resources(req);
+        req.require<frontend_resources::PerformanceManager>();
+    }
+#endif
+
     /** Ctor */
     ParticlesToDensity();
 
@@ -142,6 +153,11 @@ private:
     megamol::core::CallerSlot inDataSlot;
 
     geocalls::VolumetricDataCall::Metadata metadata;
+
+#ifdef MEGAMOL_USE_PROFILING
+    frontend_resources::PerformanceManager* perf_manager_ = nullptr;
+    frontend_resources::PerformanceManager::pool_handle volume_pool_ = 0;
+#endif
 };
 
 } // namespace megamol::datatools
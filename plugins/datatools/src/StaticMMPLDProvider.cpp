@@ -1,13 +1,19 @@
 #include "StaticMMPLDProvider.h"
 
+#include <algorithm>
+#include <chrono>
+
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/StringParam.h"
+#include "mmcore/utility/log/Log.h"
 #include "vislib/StringConverter.h"
 #include "vislib/StringTokeniser.h"
 
 
 megamol::datatools::StaticMMPLDProvider::StaticMMPLDProvider()
         : outDataSlot("outData", "Output")
-        , filenamesSlot("filenames", "Set of filenames separated with ';'") {
+        , filenamesSlot("filenames", "Set of filenames separated with ';'")
+        , memoryMappingSlot("memoryMapping", "Maps the files into memory instead of reading them") {
     outDataSlot.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
         geocalls::MultiParticleDataCall::FunctionName(0), &StaticMMPLDProvider::getDataCallback);
     outDataSlot.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
@@ -16,6 +22,9 @@ megamol::datatools::StaticMMPLDProvider::StaticMMPLDProvider()
 
     filenamesSlot << new core::param::StringParam("");
     MakeSlotAvailable(&filenamesSlot);
+
+    memoryMappingSlot << new core::param::BoolParam(true);
+    MakeSlotAvailable(&memoryMappingSlot);
 }
 
 
@@ -33,73 +42,81 @@ void megamol::datatools::StaticMMPLDProvider::release() {}
 
 
 bool megamol::datatools::StaticMMPLDProvider::assertData(geocalls::MultiParticleDataCall& outCall) {
-    if (filenamesSlot.IsDirty()) {
+    if (filenamesSlot.IsDirty() || memoryMappingSlot.IsDirty()) {
+        filenamesSlot.ResetDirty();
+        memoryMappingSlot.ResetDirty();
 
         auto const filenames = vislib::TString(filenamesSlot.Param<core::param::StringParam>()->Value().c_str());
 
         vislib::Array<vislib::TString> filenamesArray = vislib::TStringTokeniser::Split(filenames, _T(";"), true);
 
-        unsigned int list_count = 0;
-
-        output_frames.clear();
-        output_frames.reserve(filenamesArray.Count());
-
+        std::vector<std::filesystem::path> paths;
+        paths.reserve(filenamesArray.Count());
         for (unsigned int fidx = 0; fidx < filenamesArray.Count(); ++fidx) {
-            auto mmpld_file = mmpld::mmpld(std::string(T2A(filenamesArray[fidx])));
-
-            output_frames.push_back(mmpld_file.ReadFrame(0));
+            paths.emplace_back(std::string(T2A(filenamesArray[fidx])));
+        }
 
-            list_count += output_frames.back().data.size();
+        auto const start = std::chrono::high_resolution_clock::now();
+        output_frames = MMPLDArena::Load(paths, memoryMappingSlot.Param<core::param::BoolParam>()->Value());
+        auto const end = std::chrono::high_resolution_clock::now();
 
-            auto box = mmpld_file.GetBBox();
-            auto tmp_box = vislib::math::Cuboid<float>(box[0], box[1], box[2], box[3], box[4], box[5]);
+        // files that could not be loaded are skipped
+        output_frames.erase(std::remove(output_frames.begin(), output_frames.end(), nullptr), output_frames.end());
 
+        list_count = 0;
+        size_t byte_count = 0;
+        for (size_t fidx = 0; fidx < output_frames.size(); ++fidx) {
+            auto const& frame = *output_frames[fidx];
+            list_count += static_cast<unsigned int>(frame.lists.size());
+            byte_count += frame.byte_size;
             if (fidx == 0) {
-                gbbox = tmp_box;
+                gbbox = frame.bbox;
             } else {
-                gbbox.Union(tmp_box);
+                gbbox.Union(frame.bbox);
             }
         }
 
-        outCall.SetParticleListCount(list_count);
-        auto counter = 0u;
-        for (auto const& frame : output_frames) {
-            for (auto idx = 0u; idx < frame.data.size(); ++idx) {
-                auto& particles = outCall.AccessParticles(counter);
-                auto const& entry = frame.data[idx];
-
-                particles.SetCount(entry.list_header.particle_count);
-                vislib::math::Cuboid<float> bbox(entry.list_header.lbox[0], entry.list_header.lbox[1],
-                    entry.list_header.lbox[2], entry.list_header.lbox[3], entry.list_header.lbox[4],
-                    entry.list_header.lbox[5]);
-                particles.SetBBox(bbox);
-                particles.SetVertexData(
-                    static_cast<geocalls::SimpleSphericalParticles::VertexDataType>(entry.list_header.vert_type),
-                    entry.data.data() + entry.vertex_offset, entry.vertex_stride + entry.color_stride);
-                particles.SetColourData(ColorTypeTranslator(entry.list_header.col_type),
-                    entry.data.data() + entry.color_offset, entry.vertex_stride + entry.color_stride);
-                particles.SetGlobalRadius(entry.list_header.global_radius);
-                particles.SetGlobalColour(entry.list_header.global_color[0], entry.list_header.global_color[1],
-                    entry.list_header.global_color[2], entry.list_header.global_color[3]);
-                particles.SetColourMapIndexValues(
-                    entry.list_header.intensity_range[0], entry.list_header.intensity_range[1]);
-
-                ++counter;
-            }
-        }
+        core::utility::log::Log::DefaultLog.WriteInfo(
+            "[StaticMMPLDProvider] Loaded %zu of %zu files (%.1f MiB) in %.1f ms", output_frames.size(), paths.size(),
+            static_cast<double>(byte_count) / (1024.0 * 1024.0),
+            std::chrono::duration<double, std::milli>(end - start).count());
 
-        outCall.AccessBoundingBoxes().SetObjectSpaceBBox(gbbox);
-        outCall.AccessBoundingBoxes().SetObjectSpaceClipBox(gbbox);
-        outCall.AccessBoundingBoxes().MakeScaledWorld(1.0f);
+        ++hash;
+    }
 
-        outCall.SetFrameCount(1);
-        outCall.SetDataHash(++hash);
+    if (output_frames.empty()) {
+        return false;
+    }
 
-        filenamesSlot.ResetDirty();
+    // the frames are immutable and shared, so every call just references them
+    outCall.SetParticleListCount(list_count);
+    auto counter = 0u;
+    for (auto const& frame : output_frames) {
+        for (auto const& entry : frame->lists) {
+            auto& particles = outCall.AccessParticles(counter);
+
+            particles.SetCount(entry.count);
+            particles.SetBBox(entry.bbox);
+            particles.SetVertexData(entry.vert_type, entry.data, static_cast<unsigned int>(entry.stride));
+            particles.SetColourData(
+                entry.col_type, entry.data + entry.vert_size, static_cast<unsigned int>(entry.stride));
+            particles.SetGlobalRadius(entry.global_radius);
+            particles.SetGlobalColour(
+                entry.global_color[0], entry.global_color[1], entry.global_color[2], entry.global_color[3]);
+            particles.SetColourMapIndexValues(entry.intensity_range[0], entry.intensity_range[1]);
+
+            ++counter;
+        }
     }
 
+    outCall.AccessBoundingBoxes().SetObjectSpaceBBox(gbbox);
+    outCall.AccessBoundingBoxes().SetObjectSpaceClipBox(gbbox);
+    outCall.AccessBoundingBoxes().MakeScaledWorld(1.0f);
 
-    return !output_frames.empty();
+    outCall.SetFrameCount(1);
+    outCall.SetDataHash(hash);
+
+    return true;
 }
 
 
@@ -1,7 +1,6 @@
 #pragma once
 
-#include <mmpld.h>
-
+#include "MMPLDArena.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/Module.h"
@@ -28,7 +27,7 @@ public:
      * @return A human readable description of this module.
      */
     static const char* Description() {
-        return "Reads a set of static MMPLDs";
+        return "Reads the first frame of a set of MMPLDs in parallel and shares the data with other providers";
     }
 
     /**
@@ -53,28 +52,9 @@ protected:
 
     core::param::ParamSlot filenamesSlot;
 
-private:
-    static geocalls::SimpleSphericalParticles::ColourDataType ColorTypeTranslator(mmpld::color_type ct) {
-        switch (ct) {
-        case mmpld::color_type::UINT8_RGB:
-            return geocalls::SimpleSphericalParticles::COLDATA_UINT8_RGB;
-        case mmpld::color_type::UINT8_RGBA:
-            return geocalls::SimpleSphericalParticles::COLDATA_UINT8_RGBA;
-        case mmpld::color_type::FLOAT_RGB:
-            return geocalls::SimpleSphericalParticles::COLDATA_FLOAT_RGB;
-        case mmpld::color_type::FLOAT_RGBA:
-            return geocalls::SimpleSphericalParticles::COLDATA_FLOAT_RGBA;
-        case mmpld::color_type::FLOAT_I:
-            return geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I;
-        case mmpld::color_type::DOUBLE_I:
-            return geocalls::SimpleSphericalParticles::COLDATA_DOUBLE_I;
-        case mmpld::color_type::SHORT_RGBA:
-            return geocalls::SimpleSphericalParticles::COLDATA_USHORT_RGBA;
-        }
-
-        return geocalls::SimpleSphericalParticles::COLDATA_NONE;
-    }
+    core::param::ParamSlot memoryMappingSlot;
 
+private:
     bool assertData(geocalls::MultiParticleDataCall& outCall);
 
     bool getDataCallback(core::Call& c);
@@ -83,7 +63,10 @@ private:
 
     core::CalleeSlot outDataSlot;
 
-    std::vector<mmpld::frame_t> output_frames;
+    /** The loaded frames, shared with all other providers reading the same files */
+    std::vector<MMPLDArena::FramePtr> output_frames;
+
+    unsigned int list_count = 0;
 
     vislib::math::Cuboid<float> gbbox;
 
@@ -1,5 +1,7 @@
 #include "datatools/clustering/ParticleIColClustering.h"
 
+#include <chrono>
+
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 
@@ -8,7 +10,8 @@ megamol::datatools::clustering::ParticleIColClustering::ParticleIColClustering()
         : AbstractParticleManipulator("outData", "inData")
         , _eps_slot("eps", "")
         , _minpts_slot("minpts", "")
-        , _icol_weight("icol weight", "") {
+        , _icol_weight("icol weight", "")
+        , _cache_frames_slot("cacheFrames", "Number of frames whose clustering is kept for revisiting") {
     _eps_slot << new core::param::FloatParam(0.1f, 0.0f, 1.0f);
     MakeSlotAvailable(&_eps_slot);
 
@@ -17,6 +20,9 @@ megamol::datatools::clustering::ParticleIColClustering::ParticleIColClustering()
 
     _icol_weight << new core::param::FloatParam(0.5f, 0.0f, 1.0f);
     MakeSlotAvailable(&_icol_weight);
+
+    _cache_frames_slot << new core::param::IntParam(8, 1);
+    MakeSlotAvailable(&_cache_frames_slot);
 }
 
 
@@ -27,89 +33,130 @@ megamol::datatools::clustering::ParticleIColClustering::~ParticleIColClustering(
 
 bool megamol::datatools::clustering::ParticleIColClustering::manipulateData(
     geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
-    if (_frame_id != inData.FrameID() || _in_data_hash != inData.DataHash() || isDirty()) {
+    if (_in_data_hash != inData.DataHash() || isDirty()) {
+        // results of other frames are only valid for the same data and parameters
+        clearCache();
+    }
+
+    if (_frame_id != inData.FrameID() || _in_data_hash != inData.DataHash() || isDirty() ||
+        _cache_frames_slot.IsDirty()) {
         outData = inData;
 
-        auto const pl_count = outData.GetParticleListCount();
+        auto const frame_id = inData.FrameID();
+        auto it = _result_cache.find(frame_id);
+        if (it == _result_cache.end()) {
+            it = _result_cache.emplace(frame_id, computeClusters(outData)).first;
+            _result_order.push_front(frame_id);
+        } else {
+            _result_order.remove(frame_id);
+            _result_order.push_front(frame_id);
+        }
 
-        auto const p_bbox = outData.AccessBoundingBoxes().ObjectSpaceBBox();
+        auto const& result = it->second;
+        auto const pl_count = outData.GetParticleListCount();
+        for (std::remove_const_t<decltype(pl_count)> pl_idx = 0; pl_idx < pl_count; ++pl_idx) {
+            auto const& cols = result[pl_idx];
+            if (cols.empty()) {
+                continue;
+            }
+            auto& parts = outData.AccessParticles(pl_idx);
+            parts.SetColourData(geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I, cols.data());
+            auto const minmax = std::minmax_element(cols.cbegin(), cols.cend());
+            parts.SetColourMapIndexValues(*minmax.first, *minmax.second);
+        }
 
-        auto const eps = _eps_slot.Param<core::param::FloatParam>()->Value();
-        auto const minpts = static_cast<index_t>(_minpts_slot.Param<core::param::IntParam>()->Value());
-        auto const icol_weight = _icol_weight.Param<core::param::FloatParam>()->Value();
+        // the current frame is the most recent one and thus never evicted
+        auto const max_frames =
+            static_cast<std::size_t>(std::max(1, _cache_frames_slot.Param<core::param::IntParam>()->Value()));
+        while (_result_order.size() > max_frames) {
+            _result_cache.erase(_result_order.back());
+            _result_order.pop_back();
+        }
 
-        std::array<float, 4> weights = {(1.0f - icol_weight), (1.0f - icol_weight), (1.0f - icol_weight), icol_weight};
+        _frame_id = frame_id;
+        _in_data_hash = inData.DataHash();
+        resetDirty();
+        _cache_frames_slot.ResetDirty();
+        ++_out_data_hash;
+    }
 
-        _points.resize(pl_count);
-        _kd_trees.resize(pl_count);
-        _ret_cols.resize(pl_count);
+    outData.SetDataHash(_out_data_hash);
+    outData.SetUnlocker(inData.GetUnlocker());
+    inData.SetUnlocker(nullptr, false);
 
-        for (std::remove_const_t<decltype(pl_count)> pl_idx = 0; pl_idx < pl_count; ++pl_idx) {
-            auto& parts = outData.AccessParticles(pl_idx);
+    return true;
+}
 
-            if (parts.GetVertexDataType() == geocalls::SimpleSphericalParticles::VERTDATA_NONE ||
-                (parts.GetColourDataType() != geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I &&
-                    parts.GetColourDataType() != geocalls::SimpleSphericalParticles::COLDATA_DOUBLE_I)) {
-                continue;
-            }
 
-            auto const p_count = parts.GetCount();
+megamol::datatools::clustering::ParticleIColClustering::frame_result_t
+megamol::datatools::clustering::ParticleIColClustering::computeClusters(
+    geocalls::MultiParticleDataCall& data) const {
+    auto const pl_count = data.GetParticleListCount();
 
-            if (_frame_id != inData.FrameID() || _in_data_hash != inData.DataHash()) {
-                // rebuild search structure
+    auto const p_bbox = data.AccessBoundingBoxes().ObjectSpaceBBox();
 
-                std::vector<float> cur_points(p_count * 4);
+    auto const eps = _eps_slot.Param<core::param::FloatParam>()->Value();
+    auto const minpts = static_cast<index_t>(_minpts_slot.Param<core::param::IntParam>()->Value());
+    auto const icol_weight = _icol_weight.Param<core::param::FloatParam>()->Value();
 
-                auto const xAcc = parts.GetParticleStore().GetXAcc();
-                auto const yAcc = parts.GetParticleStore().GetYAcc();
-                auto const zAcc = parts.GetParticleStore().GetZAcc();
-                auto const iAcc = parts.GetParticleStore().GetCRAcc();
+    std::array<float, 4> weights = {(1.0f - icol_weight), (1.0f - icol_weight), (1.0f - icol_weight), icol_weight};
 
-                for (std::remove_const_t<decltype(p_count)> pidx = 0; pidx < p_count; ++pidx) {
-                    cur_points[pidx * 4 + 0] = xAcc->Get_f(pidx);
-                    cur_points[pidx * 4 + 1] = yAcc->Get_f(pidx);
-                    cur_points[pidx * 4 + 2] = zAcc->Get_f(pidx);
-                    cur_points[pidx * 4 + 3] = iAcc->Get_f(pidx);
-                }
+    frame_result_t result(pl_count);
 
-                std::array<float, 8> bbox = {p_bbox.GetLeft(), p_bbox.GetRight(), p_bbox.GetBottom(), p_bbox.GetTop(),
-                    p_bbox.GetBack(), p_bbox.GetFront(), parts.GetMinColourIndexValue(),
-                    parts.GetMaxColourIndexValue()};
+    for (std::remove_const_t<decltype(pl_count)> pl_idx = 0; pl_idx < pl_count; ++pl_idx) {
+        auto& parts = data.AccessParticles(pl_idx);
 
-                _points[pl_idx] = std::make_shared<genericPointcloud<float, 4>>(cur_points, bbox, weights);
-                _points[pl_idx]->normalize_data();
+        if (parts.GetVertexDataType() == geocalls::SimpleSphericalParticles::VERTDATA_NONE ||
+            (parts.GetColourDataType() != geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I &&
+                parts.GetColourDataType() != geocalls::SimpleSphericalParticles::COLDATA_DOUBLE_I)) {
+            continue;
+        }
 
-                _kd_trees[pl_idx] = std::make_shared<kd_tree_t<float, 4>>(
-                    4, *_points[pl_idx], nanoflann::KDTreeSingleIndexAdaptorParams());
-                _kd_trees[pl_idx]->buildIndex();
-            }
+        auto const p_count = parts.GetCount();
+        if (p_count == 0) {
+            continue;
+        }
 
-            auto const cluster_res = DBSCAN(_kd_trees[pl_idx], eps * eps, minpts);
+        auto const start = std::chrono::high_resolution_clock::now();
 
-            _ret_cols[pl_idx].resize(p_count);
-            std::transform(cluster_res.cbegin(), cluster_res.cend(), _ret_cols[pl_idx].begin(),
-                [](auto const val) { return static_cast<float>(val); });
+        std::vector<float> cur_points(p_count * 4);
 
-            parts.SetColourData(geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I, _ret_cols[pl_idx].data());
-            auto const minmax = std::minmax_element(_ret_cols[pl_idx].cbegin(), _ret_cols[pl_idx].cend());
-            parts.SetColourMapIndexValues(*minmax.first, *minmax.second);
+        auto const xAcc = parts.GetParticleStore().GetXAcc();
+        auto const yAcc = parts.GetParticleStore().GetYAcc();
+        auto const zAcc = parts.GetParticleStore().GetZAcc();
+        auto const iAcc = parts.GetParticleStore().GetCRAcc();
 
-            auto const num_clusters = static_cast<index_t>(*minmax.second) - 1;
-            core::utility::log::Log::DefaultLog.WriteInfo(
-                "[ParticleIColClustering]: Number of clusters in list idx %d = %d", pl_idx, num_clusters);
-            core::utility::log::Log::DefaultLog.WriteInfo(
-                "[ParticleIColClustering]: Min idx %f; Max idx %f", *minmax.first, *minmax.second);
+#pragma omp parallel for
+        for (int64_t pidx = 0; pidx < static_cast<int64_t>(p_count); ++pidx) {
+            cur_points[pidx * 4 + 0] = xAcc->Get_f(pidx);
+            cur_points[pidx * 4 + 1] = yAcc->Get_f(pidx);
+            cur_points[pidx * 4 + 2] = zAcc->Get_f(pidx);
+            cur_points[pidx * 4 + 3] = iAcc->Get_f(pidx);
         }
 
-        _frame_id = inData.FrameID();
-        _in_data_hash = inData.DataHash();
-        resetDirty();
-        ++_out_data_hash;
-    }
+        std::array<float, 8> bbox = {p_bbox.GetLeft(), p_bbox.GetRight(), p_bbox.GetBottom(), p_bbox.GetTop(),
+            p_bbox.GetBack(), p_bbox.GetFront(), parts.GetMinColourIndexValue(), parts.GetMaxColourIndexValue()};
 
-    outData.SetDataHash(_out_data_hash);
-    outData.SetUnlocker(inData.GetUnlocker());
-    inData.SetUnlocker(nullptr, false);
+        genericPointcloud<float, 4> points(cur_points, bbox, weights);
+        points.normalize_data();
 
-    return true;
+        auto const cluster_res = DBSCAN_parallel(points, eps * eps, minpts);
+
+        auto& cols = result[pl_idx];
+        cols.resize(p_count);
+        std::transform(cluster_res.cbegin(), cluster_res.cend(), cols.begin(),
+            [](auto const val) { return static_cast<float>(val); });
+
+        auto const duration =
+            std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start);
+        auto const minmax = std::minmax_element(cols.cbegin(), cols.cend());
+        auto const num_clusters = static_cast<index_t>(*minmax.second) - 1;
+        core::utility::log::Log::DefaultLog.WriteInfo(
+            "[ParticleIColClustering]: Number of clusters in list idx %u = %zu (%.2f ms)", pl_idx, num_clusters,
+            duration.count());
+        core::utility::log::Log::DefaultLog.WriteInfo(
+            "[ParticleIColClustering]: Min idx %f; Max idx %f", *minmax.first, *minmax.second);
+    }
+
+    return result;
 }
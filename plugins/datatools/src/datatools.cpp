@@ -45,6 +45,7 @@
 #include "ParticleIColFilter.h"
 #include "ParticleIColGradientField.h"
 #include "ParticleIdentitySort.h"
+#include "ParticleInstanceMaterializer.h"
 #include "ParticleInstantiator.h"
 #include "ParticleListFilter.h"
 #include "ParticleListSelector.h"
@@ -175,6 +176,7 @@ public:
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::io::CPERAWDataSource>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::LocalBoundingBoxExtractor>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticleInstantiator>();
+        this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticleInstanceMaterializer>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::MPDCGrid>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::table::TableSplit>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::CSVWriter>();
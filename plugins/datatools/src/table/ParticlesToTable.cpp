@@ -1,5 +1,7 @@
 #include "ParticlesToTable.h"
 
+#include <omp.h>
+
 #define GLM_FORCE_SWIZZLE
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -89,34 +91,53 @@ bool ParticlesToTable::assertMPDC(geocalls::MultiParticleDataCall* in, table::Ta
                 column_infos.back().SetType(table::TableDataCall::ColumnType::QUANTITATIVE);
             }
 
-            auto store_and_compute_extents = [&](uint32_t idx, uint32_t col, float val) {
-                if (val < minimums[col]) {
-                    minimums[col] = val;
-                }
-                if (val > maximums[col]) {
-                    maximums[col] = val;
-                }
-                everything[column_names.size() * idx + col] = val;
-            };
+            auto const num_columns = column_names.size();
+            auto const row_stride = num_columns * sizeof(float);
+            everything.resize(num_columns * total_particles);
 
-            everything.resize(column_names.size() * total_particles);
-            uint32_t particle_idx = 0;
+            // one bulk gather per column and block of particles instead of one virtual call per value
+            constexpr int64_t block_size = 4096;
+            size_t list_offset = 0;
             for (auto l = 0; l < in->GetParticleListCount(); ++l) {
-                auto pl = in->AccessParticles(l);
+                auto const& pl = in->AccessParticles(l);
                 const auto& store = pl.GetParticleStore();
-                for (auto idx = 0; idx < pl.GetCount(); ++idx) {
-                    store_and_compute_extents(particle_idx, 0, store.GetXAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 1, store.GetYAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 2, store.GetZAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 3, store.GetRAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 4, store.GetCRAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 5, store.GetCGAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 6, store.GetCBAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 7, store.GetCRAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 8, store.GetDXAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 9, store.GetDYAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 10, store.GetDZAcc()->Get_f(idx));
-                    particle_idx++;
+                std::array<geocalls::Accessor const*, 11> const accessors = {store.GetXAcc().get(),
+                    store.GetYAcc().get(), store.GetZAcc().get(), store.GetRAcc().get(), store.GetCRAcc().get(),
+                    store.GetCGAcc().get(), store.GetCBAcc().get(), store.GetCRAcc().get(), store.GetDXAcc().get(),
+                    store.GetDYAcc().get(), store.GetDZAcc().get()};
+                auto const count = static_cast<int64_t>(pl.GetCount());
+                auto const base = everything.data() + num_columns * list_offset;
+                auto const num_blocks = (count + block_size - 1) / block_size;
+#pragma omp parallel for
+                for (int64_t b = 0; b < num_blocks; ++b) {
+                    auto const begin = b * block_size;
+                    auto const n = std::min(block_size, count - begin);
+                    for (size_t col = 0; col < num_columns; ++col) {
+                        accessors[col]->Gather_f(begin, n, base + num_columns * begin + col, row_stride);
+                    }
+                }
+                list_offset += count;
+            }
+
+            std::vector<std::array<float, 11>> thread_minimums(omp_get_max_threads(), minimums);
+            std::vector<std::array<float, 11>> thread_maximums(omp_get_max_threads(), maximums);
+#pragma omp parallel
+            {
+                auto& local_min = thread_minimums[omp_get_thread_num()];
+                auto& local_max = thread_maximums[omp_get_thread_num()];
+#pragma omp for
+                for (int64_t idx = 0; idx < static_cast<int64_t>(total_particles); ++idx) {
+                    auto const row = everything.data() + num_columns * idx;
+                    for (size_t col = 0; col < num_columns; ++col) {
+                        local_min[col] = std::min(local_min[col], row[col]);
+                        local_max[col] = std::max(local_max[col], row[col]);
+                    }
+                }
+            }
+            for (size_t t = 0; t < thread_minimums.size(); ++t) {
+                for (size_t col = 0; col < num_columns; ++col) {
+                    minimums[col] = std::min(minimums[col], thread_minimums[t][col]);
+                    maximums[col] = std::max(maximums[col], thread_maximums[t][col]);
                 }
             }
 
@@ -27,6 +27,26 @@ T const* access(char const* ptr, size_t idx, size_t stride) {
 }
 
 
+/**
+ * Writes 'get(idx)' for all idx in [begin, begin + count) to 'out'.
+ *
+ * @param out_stride Distance between two written values in bytes, 0 for tightly packed output.
+ */
+template<class R, class Getter>
+void gather_into(size_t begin, size_t count, R* out, size_t out_stride, Getter const& get) {
+    if (out_stride == 0 || out_stride == sizeof(R)) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = get(begin + i);
+        }
+    } else {
+        auto const base = reinterpret_cast<char*>(out);
+        for (size_t i = 0; i < count; ++i) {
+            *reinterpret_cast<R*>(base + i * out_stride) = get(begin + i);
+        }
+    }
+}
+
+
 /**
  * Interface for accessor classes.
  */
@@ -43,6 +63,28 @@ public:
     virtual unsigned int Get_u32(size_t idx) const = 0;
     virtual unsigned short Get_u16(size_t idx) const = 0;
     virtual unsigned char Get_u8(size_t idx) const = 0;
+
+    /**
+     * Bulk variants of the getters, which write the elements [begin, begin + count) to 'out'. 'out_stride' is the
+     * distance between two written values in bytes, 0 for tightly packed output. The implementations override these
+     * with inlined loops, so only one virtual call per batch is needed.
+     */
+    virtual void Gather_f(size_t begin, size_t count, float* out, size_t out_stride) const {
+        gather_into(begin, count, out, out_stride, [this](size_t idx) { return Get_f(idx); });
+    }
+
+    virtual void Gather_d(size_t begin, size_t count, double* out, size_t out_stride) const {
+        gather_into(begin, count, out, out_stride, [this](size_t idx) { return Get_d(idx); });
+    }
+
+    virtual void Gather_u64(size_t begin, size_t count, uint64_t* out, size_t out_stride) const {
+        gather_into(begin, count, out, out_stride, [this](size_t idx) { return Get_u64(idx); });
+    }
+
+    virtual void Gather_u8(size_t begin, size_t count, unsigned char* out, size_t out_stride) const {
+        gather_into(begin, count, out, out_stride, [this](size_t idx) { return Get_u8(idx); });
+    }
+
     virtual ~Accessor() = default;
 };
 
@@ -109,6 +151,22 @@ public:
         return Get<unsigned char>(idx);
     }
 
+    void Gather_f(size_t begin, size_t count, float* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [this](size_t idx) { return Get<float>(idx); });
+    }
+
+    void Gather_d(size_t begin, size_t count, double* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [this](size_t idx) { return Get<double>(idx); });
+    }
+
+    void Gather_u64(size_t begin, size_t count, uint64_t* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [this](size_t idx) { return Get<uint64_t>(idx); });
+    }
+
+    void Gather_u8(size_t begin, size_t count, unsigned char* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [this](size_t idx) { return Get<unsigned char>(idx); });
+    }
+
     ~Accessor_Impl() override = default;
 
 private:
@@ -143,6 +201,11 @@ public:
         return static_cast<R>(this->val_) / static_cast<R>(std::numeric_limits<T>::max());
     }
 
+    template<class R>
+    R Get(size_t /*idx*/) const {
+        return Get<R>();
+    }
+
     float Get_f(size_t idx) const override {
         return Get<float>();
     }
@@ -167,6 +230,22 @@ public:
         return Get<unsigned char>();
     }
 
+    void Gather_f(size_t begin, size_t count, float* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [this](size_t) { return Get<float>(); });
+    }
+
+    void Gather_d(size_t begin, size_t count, double* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [this](size_t) { return Get<double>(); });
+    }
+
+    void Gather_u64(size_t begin, size_t count, uint64_t* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [this](size_t) { return Get<uint64_t>(); });
+    }
+
+    void Gather_u8(size_t begin, size_t count, unsigned char* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [this](size_t) { return Get<unsigned char>(); });
+    }
+
     ~Accessor_Val() override = default;
 
 private:
@@ -189,6 +268,11 @@ public:
 
     Accessor_0& operator=(Accessor_0&& rhs) = default;
 
+    template<class R>
+    R Get(size_t /*idx*/) const {
+        return static_cast<R>(0);
+    }
+
     float Get_f(size_t idx) const override {
         return static_cast<float>(0);
     }
@@ -213,6 +297,22 @@ public:
         return static_cast<unsigned char>(0);
     }
 
+    void Gather_f(size_t begin, size_t count, float* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [](size_t) { return static_cast<float>(0); });
+    }
+
+    void Gather_d(size_t begin, size_t count, double* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [](size_t) { return static_cast<double>(0); });
+    }
+
+    void Gather_u64(size_t begin, size_t count, uint64_t* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [](size_t) { return static_cast<uint64_t>(0); });
+    }
+
+    void Gather_u8(size_t begin, size_t count, unsigned char* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [](size_t) { return static_cast<unsigned char>(0); });
+    }
+
     ~Accessor_0() override = default;
 
 private:
@@ -234,6 +334,11 @@ public:
 
     Accessor_Idx& operator=(Accessor_Idx&& rhs) = default;
 
+    template<class R>
+    R Get(size_t idx) const {
+        return static_cast<R>(idx);
+    }
+
     float Get_f(size_t idx) const override {
         return static_cast<float>(idx);
     }
@@ -258,6 +363,22 @@ public:
         return static_cast<unsigned char>(idx);
     }
 
+    void Gather_f(size_t begin, size_t count, float* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [](size_t idx) { return static_cast<float>(idx); });
+    }
+
+    void Gather_d(size_t begin, size_t count, double* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [](size_t idx) { return static_cast<double>(idx); });
+    }
+
+    void Gather_u64(size_t begin, size_t count, uint64_t* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [](size_t idx) { return static_cast<uint64_t>(idx); });
+    }
+
+    void Gather_u8(size_t begin, size_t count, unsigned char* out, size_t out_stride) const override {
+        gather_into(begin, count, out, out_stride, [](size_t idx) { return static_cast<unsigned char>(idx); });
+    }
+
     ~Accessor_Idx() override = default;
 
 private:
@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <vector>
+
 #include "geometry_calls/AbstractParticleDataCall.h"
 #include "geometry_calls/SimpleSphericalParticles.h"
 #include "mmcore/factories/CallAutoDescription.h"
@@ -16,6 +20,49 @@ namespace megamol::geocalls {
 template class AbstractParticleDataCall<SimpleSphericalParticles>;
 
 
+/**
+ * Affine transformation of one instance of the particle data.
+ *
+ * The matrix is stored column-major as 3x4 matrix, i.e. the three columns of the linear part followed by the
+ * translation. This matches the layout of OSPRay's affine3f.
+ */
+struct InstanceTransform {
+    std::array<float, 12> matrix = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f};
+
+    /**
+     * Creates a pure translation.
+     *
+     * @param x The translation along the x axis.
+     * @param y The translation along the y axis.
+     * @param z The translation along the z axis.
+     *
+     * @return The transformation.
+     */
+    static InstanceTransform Translation(float x, float y, float z) {
+        InstanceTransform t;
+        t.matrix[9] = x;
+        t.matrix[10] = y;
+        t.matrix[11] = z;
+        return t;
+    }
+
+    /**
+     * Transforms a position.
+     *
+     * @param in  The position to transform.
+     * @param out Receives the transformed position. May be the same as 'in'.
+     */
+    void Apply(float const* in, float* out) const {
+        auto const x = in[0];
+        auto const y = in[1];
+        auto const z = in[2];
+        out[0] = matrix[0] * x + matrix[3] * y + matrix[6] * z + matrix[9];
+        out[1] = matrix[1] * x + matrix[4] * y + matrix[7] * z + matrix[10];
+        out[2] = matrix[2] * x + matrix[5] * y + matrix[8] * z + matrix[11];
+    }
+};
+
+
 /**
  * Call for multi-stream particle data.
  */
@@ -49,6 +96,40 @@ public:
      * @return A reference to this
      */
     MultiParticleDataCall& operator=(const MultiParticleDataCall& rhs);
+
+    /**
+     * Answer the instance transformations. Every particle list is to be displayed once per transformation. If no
+     * transformations are set, the data is displayed once without transformation.
+     *
+     * Consumers that cannot handle instances can use a 'ParticleInstanceMaterializer' in front of them.
+     *
+     * @return The instance transformations or nullptr.
+     */
+    std::shared_ptr<std::vector<InstanceTransform> const> const& GetInstanceTransforms() const {
+        return this->instanceTransforms;
+    }
+
+    /**
+     * Answer the number of instances of the data.
+     *
+     * @return The number of instances, which is at least one.
+     */
+    size_t GetInstanceCount() const {
+        return this->instanceTransforms == nullptr ? 1 : this->instanceTransforms->size();
+    }
+
+    /**
+     * Sets the instance transformations.
+     *
+     * @param transforms The instance transformations or nullptr to display the data once.
+     */
+    void SetInstanceTransforms(std::shared_ptr<std::vector<InstanceTransform> const> transforms) {
+        this->instanceTransforms = std::move(transforms);
+    }
+
+private:
+    /** The instance transformations, shared with the producer */
+    std::shared_ptr<std::vector<InstanceTransform> const> instanceTransforms;
 };
 
 
@@ -254,6 +254,44 @@ public:
             return this->id_acc_;
         }
 
+        /**
+         * Writes the positions of the particles [begin, begin + count) as xyz triples to 'out'.
+         *
+         * @param out_stride Distance between two written positions in bytes, 0 for tightly packed triples.
+         */
+        void GatherPositions(size_t begin, size_t count, float* out, size_t out_stride = 0) const {
+            auto const stride = out_stride == 0 ? 3 * sizeof(float) : out_stride;
+            this->x_acc_->Gather_f(begin, count, out, stride);
+            this->y_acc_->Gather_f(begin, count, out + 1, stride);
+            this->z_acc_->Gather_f(begin, count, out + 2, stride);
+        }
+
+        /**
+         * Writes the colours of the particles [begin, begin + count) as rgba quadruples to 'out'.
+         *
+         * @param out_stride Distance between two written colours in bytes, 0 for tightly packed quadruples.
+         */
+        void GatherColours(size_t begin, size_t count, float* out, size_t out_stride = 0) const {
+            auto const stride = out_stride == 0 ? 4 * sizeof(float) : out_stride;
+            this->cr_acc_->Gather_f(begin, count, out, stride);
+            this->cg_acc_->Gather_f(begin, count, out + 1, stride);
+            this->cb_acc_->Gather_f(begin, count, out + 2, stride);
+            this->ca_acc_->Gather_f(begin, count, out + 3, stride);
+        }
+
+        /**
+         * Writes the colours of the particles [begin, begin + count) as rgba quadruples to 'out'.
+         *
+         * @param out_stride Distance between two written colours in bytes, 0 for tightly packed quadruples.
+         */
+        void GatherColours(size_t begin, size_t count, unsigned char* out, size_t out_stride = 0) const {
+            auto const stride = out_stride == 0 ? 4 * sizeof(unsigned char) : out_stride;
+            this->cr_acc_->Gather_u8(begin, count, out, stride);
+            this->cg_acc_->Gather_u8(begin, count, out + 1, stride);
+            this->cb_acc_->Gather_u8(begin, count, out + 2, stride);
+            this->ca_acc_->Gather_u8(begin, count, out + 3, stride);
+        }
+
     private:
         std::shared_ptr<Accessor> x_acc_ = std::make_shared<Accessor_0>();
         std::shared_ptr<Accessor> y_acc_ = std::make_shared<Accessor_0>();
@@ -641,6 +679,44 @@ public:
         return *this->par_store_;
     }
 
+    /**
+     * Calls 'kernel(x, y, z, r, cr, cg, cb, ca)' once with accessors of the concrete types matching the vertex and
+     * colour data of this list. All accessors provide a non-virtual 'Get<R>(idx)' with the same conversions as the
+     * getters of the particle store, so the loops of the kernel are compiled for each combination of data types and
+     * the element access is inlined.
+     *
+     * @param kernel Generic callable taking the eight accessors as const references.
+     */
+    template<class Kernel>
+    void DispatchTyped(Kernel&& kernel) const {
+        auto const p = reinterpret_cast<char const*>(this->vertPtr);
+        auto const s = this->vertStride;
+        Accessor_Val<float, false> const globRad(this->radius);
+        switch (this->vertDataType) {
+        case VERTDATA_DOUBLE_XYZ: {
+            dispatchColour(kernel, Accessor_Impl<double>(p, s), Accessor_Impl<double>(p + sizeof(double), s),
+                Accessor_Impl<double>(p + 2 * sizeof(double), s), globRad);
+        } break;
+        case VERTDATA_FLOAT_XYZ: {
+            dispatchColour(kernel, Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                Accessor_Impl<float>(p + 2 * sizeof(float), s), globRad);
+        } break;
+        case VERTDATA_FLOAT_XYZR: {
+            dispatchColour(kernel, Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                Accessor_Impl<float>(p + 2 * sizeof(float), s), Accessor_Impl<float>(p + 3 * sizeof(float), s));
+        } break;
+        case VERTDATA_SHORT_XYZ: {
+            dispatchColour(kernel, Accessor_Impl<unsigned short>(p, s),
+                Accessor_Impl<unsigned short>(p + sizeof(unsigned short), s),
+                Accessor_Impl<unsigned short>(p + 2 * sizeof(unsigned short), s), globRad);
+        } break;
+        case VERTDATA_NONE:
+        default: {
+            dispatchColour(kernel, Accessor_0(), Accessor_0(), Accessor_0(), globRad);
+        }
+        }
+    }
+
     /**
      * Disable NULL-checks in case we have an OpenGL-VAO
      * @param disable flag to disable/enable the checks
@@ -722,6 +798,51 @@ public:
     }
 
 private:
+    /**
+     * Second stage of 'DispatchTyped' resolving the colour accessors.
+     */
+    template<class Kernel, class X, class Y, class Z, class R>
+    void dispatchColour(Kernel& kernel, X const& x, Y const& y, Z const& z, R const& r) const {
+        auto const p = reinterpret_cast<char const*>(this->colPtr);
+        auto const s = this->colStride;
+        switch (this->colDataType) {
+        case COLDATA_DOUBLE_I: {
+            kernel(x, y, z, r, Accessor_Impl<double>(p, s), Accessor_0(), Accessor_0(), Accessor_0());
+        } break;
+        case COLDATA_FLOAT_I: {
+            kernel(x, y, z, r, Accessor_Impl<float>(p, s), Accessor_0(), Accessor_0(), Accessor_0());
+        } break;
+        case COLDATA_FLOAT_RGB: {
+            kernel(x, y, z, r, Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                Accessor_Impl<float>(p + 2 * sizeof(float), s), Accessor_Val<float, false>(1.0f));
+        } break;
+        case COLDATA_FLOAT_RGBA: {
+            kernel(x, y, z, r, Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                Accessor_Impl<float>(p + 2 * sizeof(float), s), Accessor_Impl<float>(p + 3 * sizeof(float), s));
+        } break;
+        case COLDATA_UINT8_RGB: {
+            kernel(x, y, z, r, Accessor_Impl<unsigned char>(p, s), Accessor_Impl<unsigned char>(p + 1, s),
+                Accessor_Impl<unsigned char>(p + 2, s), Accessor_Val<unsigned char, false>(255));
+        } break;
+        case COLDATA_UINT8_RGBA: {
+            kernel(x, y, z, r, Accessor_Impl<unsigned char>(p, s), Accessor_Impl<unsigned char>(p + 1, s),
+                Accessor_Impl<unsigned char>(p + 2, s), Accessor_Impl<unsigned char>(p + 3, s));
+        } break;
+        case COLDATA_USHORT_RGBA: {
+            kernel(x, y, z, r, Accessor_Impl<unsigned short>(p, s),
+                Accessor_Impl<unsigned short>(p + sizeof(unsigned short), s),
+                Accessor_Impl<unsigned short>(p + 2 * sizeof(unsigned short), s),
+                Accessor_Impl<unsigned short>(p + 3 * sizeof(unsigned short), s));
+        } break;
+        case COLDATA_NONE:
+        default: {
+            kernel(x, y, z, r, Accessor_Val<unsigned char, true>(this->col[0]),
+                Accessor_Val<unsigned char, true>(this->col[1]), Accessor_Val<unsigned char, true>(this->col[2]),
+                Accessor_Val<unsigned char, true>(this->col[3]));
+        }
+        }
+    }
+
     /** The global colour */
     unsigned char col[4];
 
@@ -0,0 +1,293 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <omp.h>
+
+#include "geometry_calls/VolumetricDataCall.h"
+
+
+namespace megamol::geocalls::volume_kernels {
+
+/**
+ * Layout of a uniform Cartesian volume as needed by the kernels.
+ */
+struct Grid {
+    std::array<size_t, 3> resolution = {0, 0, 0};
+    size_t components = 1;
+    std::array<float, 3> origin = {0.0f, 0.0f, 0.0f};
+    std::array<float, 3> inv_spacing = {1.0f, 1.0f, 1.0f};
+
+    /**
+     * Initialises the grid from the metadata of a volume.
+     *
+     * @return 'false' if the volume is not a uniform Cartesian grid.
+     */
+    bool Set(VolumetricMetadata_t const& md) {
+        if (md.GridType != CARTESIAN || !md.IsUniform[0] || !md.IsUniform[1] || !md.IsUniform[2]) {
+            return false;
+        }
+        for (int a = 0; a < 3; ++a) {
+            resolution[a] = md.Resolution[a];
+            origin[a] = md.Origin[a];
+            inv_spacing[a] = md.SliceDists[a][0] > 0.0f ? 1.0f / md.SliceDists[a][0] : 0.0f;
+        }
+        components = md.Components;
+        return true;
+    }
+
+    /** Answer the number of voxels */
+    size_t Voxels() const {
+        return resolution[0] * resolution[1] * resolution[2];
+    }
+};
+
+
+/**
+ * Computes the order in which query positions should be sampled, such that consecutive queries touch neighbouring
+ * voxels. The positions are sorted along the Morton (Z-order) curve of their voxel.
+ *
+ * @param positions The positions stored as triples (xyzxyz...).
+ * @param count     The number of positions.
+ * @param grid      The volume that will be sampled.
+ * @param order     Receives the indices of the positions in sampling order.
+ */
+inline void MortonOrder(float const* positions, size_t count, Grid const& grid, std::vector<uint32_t>& order) {
+    // spreads the lower 21 bits of 'v' to every third bit
+    auto const spread = [](uint64_t v) {
+        v &= 0x1fffff;
+        v = (v | (v << 32)) & 0x1f00000000ffff;
+        v = (v | (v << 16)) & 0x1f0000ff0000ff;
+        v = (v | (v << 8)) & 0x100f00f00f00f00f;
+        v = (v | (v << 4)) & 0x10c30c30c30c30c3;
+        v = (v | (v << 2)) & 0x1249249249249249;
+        return v;
+    };
+
+    std::vector<std::pair<uint64_t, uint32_t>> keys(count);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(count); ++i) {
+        uint64_t code = 0;
+        for (int a = 0; a < 3; ++a) {
+            auto const rel = (positions[i * 3 + a] - grid.origin[a]) * grid.inv_spacing[a];
+            auto const max_cell = static_cast<float>(std::max<size_t>(grid.resolution[a], 1) - 1);
+            code |= spread(static_cast<uint64_t>(std::clamp(rel, 0.0f, max_cell))) << a;
+        }
+        keys[i] = std::make_pair(code, static_cast<uint32_t>(i));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    order.resize(count);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(count); ++i) {
+        order[i] = keys[i].second;
+    }
+}
+
+
+/**
+ * Samples a scalar channel of a volume with trilinear interpolation. Positions outside the volume are clamped to the
+ * border.
+ *
+ * @param data      The voxels of the volume.
+ * @param grid      The layout of the volume.
+ * @param channel   The component to sample.
+ * @param positions The positions stored as triples (xyzxyz...).
+ * @param order     The order in which the positions are processed (see MortonOrder), or nullptr for the given order.
+ * @param count     The number of positions.
+ * @param values    Receives the sampled values, indexed like 'positions'.
+ *
+ * @return The number of positions outside the volume.
+ */
+template<class T>
+size_t SampleTrilinear(T const* data, Grid const& grid, uint32_t channel, float const* positions,
+    uint32_t const* order, size_t count, float* values) {
+    if (grid.Voxels() == 0) {
+        std::fill(values, values + count, 0.0f);
+        return count;
+    }
+    auto const comps = grid.components;
+    auto const stride_y = grid.resolution[0] * comps;
+    auto const stride_z = grid.resolution[1] * stride_y;
+    data += channel;
+
+    int64_t outside = 0;
+#pragma omp parallel for reduction(+ : outside)
+    for (int64_t k = 0; k < static_cast<int64_t>(count); ++k) {
+        auto const i = order == nullptr ? static_cast<size_t>(k) : order[k];
+        auto const p = positions + i * 3;
+
+        // cell and weights per axis; the upper neighbour is clamped, which pulls its weight to zero at the border
+        size_t lo[3], hi[3];
+        float w[3];
+        bool in_volume = true;
+        for (int a = 0; a < 3; ++a) {
+            auto const rel = (p[a] - grid.origin[a]) * grid.inv_spacing[a];
+            auto const max_cell = static_cast<float>(grid.resolution[a] - 1);
+            in_volume = in_volume && rel >= 0.0f && rel <= max_cell;
+            auto const clamped = std::clamp(rel, 0.0f, max_cell);
+            lo[a] = static_cast<size_t>(clamped);
+            hi[a] = std::min(lo[a] + 1, grid.resolution[a] - 1);
+            w[a] = clamped - static_cast<float>(lo[a]);
+        }
+        if (!in_volume) {
+            ++outside;
+        }
+
+        auto const x0 = lo[0] * comps, x1 = hi[0] * comps;
+        auto const y0 = lo[1] * stride_y, y1 = hi[1] * stride_y;
+        auto const z0 = lo[2] * stride_z, z1 = hi[2] * stride_z;
+
+        auto const c00 = (1.0f - w[0]) * static_cast<float>(data[z0 + y0 + x0]) +
+                         w[0] * static_cast<float>(data[z0 + y0 + x1]);
+        auto const c10 = (1.0f - w[0]) * static_cast<float>(data[z0 + y1 + x0]) +
+                         w[0] * static_cast<float>(data[z0 + y1 + x1]);
+        auto const c01 = (1.0f - w[0]) * static_cast<float>(data[z1 + y0 + x0]) +
+                         w[0] * static_cast<float>(data[z1 + y0 + x1]);
+        auto const c11 = (1.0f - w[0]) * static_cast<float>(data[z1 + y1 + x0]) +
+                         w[0] * static_cast<float>(data[z1 + y1 + x1]);
+        auto const c0 = (1.0f - w[1]) * c00 + w[1] * c10;
+        auto const c1 = (1.0f - w[1]) * c01 + w[1] * c11;
+        values[i] = (1.0f - w[2]) * c0 + w[2] * c1;
+    }
+    return static_cast<size_t>(outside);
+}
+
+
+/**
+ * Calls 'func(static_cast<T const*>(nullptr))' with the C++ type matching a scalar type and length.
+ *
+ * @return 'false' if the type is not supported, in which case 'func' is not called.
+ */
+template<class Func>
+bool DispatchScalarType(ScalarType_t type, size_t length, Func&& func) {
+    switch (type) {
+    case SIGNED_INTEGER:
+        switch (length) {
+        case 1:
+            func(static_cast<int8_t const*>(nullptr));
+            return true;
+        case 2:
+            func(static_cast<int16_t const*>(nullptr));
+            return true;
+        case 4:
+            func(static_cast<int32_t const*>(nullptr));
+            return true;
+        case 8:
+            func(static_cast<int64_t const*>(nullptr));
+            return true;
+        }
+        break;
+    case UNSIGNED_INTEGER:
+        switch (length) {
+        case 1:
+            func(static_cast<uint8_t const*>(nullptr));
+            return true;
+        case 2:
+            func(static_cast<uint16_t const*>(nullptr));
+            return true;
+        case 4:
+            func(static_cast<uint32_t const*>(nullptr));
+            return true;
+        case 8:
+            func(static_cast<uint64_t const*>(nullptr));
+            return true;
+        }
+        break;
+    case FLOATING_POINT:
+        switch (length) {
+        case 4:
+            func(static_cast<float const*>(nullptr));
+            return true;
+        case 8:
+            func(static_cast<double const*>(nullptr));
+            return true;
+        }
+        break;
+    default:
+        break;
+    }
+    return false;
+}
+
+
+/**
+ * Samples a channel of the volume held by 'call' with trilinear interpolation, see the typed overload.
+ *
+ * @param outside Receives the number of positions outside the volume.
+ *
+ * @return 'false' if the volume is not a uniform Cartesian grid in RAM or its scalar type is not supported.
+ */
+inline bool SampleTrilinear(VolumetricDataCall const& call, uint32_t channel, float const* positions,
+    uint32_t const* order, size_t count, float* values, size_t& outside) {
+    auto const md = call.GetMetadata();
+    Grid grid;
+    if (md == nullptr || call.GetData() == nullptr || !grid.Set(*md) || channel >= grid.components) {
+        return false;
+    }
+    return DispatchScalarType(md->ScalarType, md->ScalarLength, [&](auto type) {
+        using T = std::remove_const_t<std::remove_pointer_t<decltype(type)>>;
+        auto const data = static_cast<T const*>(call.GetData());
+        outside = SampleTrilinear(data, grid, channel, positions, order, count, values);
+    });
+}
+
+
+/**
+ * Combines two volumes voxel by voxel as 'dst[i] = op(lhs[i], rhs[i])' and determines the range of each component
+ * of the result.
+ *
+ * @param dst        Receives the result.
+ * @param lhs        The first operand.
+ * @param rhs        The second operand.
+ * @param count      The number of scalars (voxels times components).
+ * @param components The number of components per voxel.
+ * @param op         The binary operation, which must be safe to call concurrently.
+ * @param min_values Receives the minimum of each component.
+ * @param max_values Receives the maximum of each component.
+ */
+template<class D, class S, class Op>
+void Combine(D* dst, S const* lhs, S const* rhs, size_t count, size_t components, Op op, double* min_values,
+    double* max_values) {
+    auto const num_threads = omp_get_max_threads();
+    std::vector<double> thread_min(num_threads * components, (std::numeric_limits<double>::max)());
+    std::vector<double> thread_max(num_threads * components, std::numeric_limits<double>::lowest());
+    auto const voxels = static_cast<int64_t>(count / components);
+
+#pragma omp parallel for
+    for (int64_t v = 0; v < voxels; ++v) {
+        auto const t = static_cast<size_t>(omp_get_thread_num()) * components;
+        for (size_t c = 0; c < components; ++c) {
+            auto const i = static_cast<size_t>(v) * components + c;
+            auto const val = static_cast<D>(op(lhs[i], rhs[i]));
+            dst[i] = val;
+            thread_min[t + c] = (std::min)(thread_min[t + c], static_cast<double>(val));
+            thread_max[t + c] = (std::max)(thread_max[t + c], static_cast<double>(val));
+        }
+    }
+
+    for (size_t c = 0; c < components; ++c) {
+        min_values[c] = (std::numeric_limits<double>::max)();
+        max_values[c] = std::numeric_limits<double>::lowest();
+        for (int t = 0; t < num_threads; ++t) {
+            min_values[c] = (std::min)(min_values[c], thread_min[t * components + c]);
+            max_values[c] = (std::max)(max_values[c], thread_max[t * components + c]);
+        }
+    }
+}
+
+} // namespace megamol::geocalls::volume_kernels
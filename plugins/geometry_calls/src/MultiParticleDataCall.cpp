@@ -32,6 +32,7 @@ MultiParticleDataCall::~MultiParticleDataCall() {
  */
 MultiParticleDataCall& MultiParticleDataCall::operator=(const MultiParticleDataCall& rhs) {
     AbstractParticleDataCall<SimpleSphericalParticles>::operator=(rhs);
+    this->instanceTransforms = rhs.instanceTransforms;
     return *this;
 }
 } // namespace megamol::geocalls
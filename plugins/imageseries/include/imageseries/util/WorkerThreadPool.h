@@ -8,12 +8,9 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <thread>
-#include <vector>
 
 namespace megamol::ImageSeries::util {
 
@@ -66,33 +63,19 @@ private:
     friend class WorkerThreadPool;
 };
 
+/**
+ * Runs jobs on the process-wide task scheduler of the core.
+ */
 class WorkerThreadPool {
 public:
-    WorkerThreadPool();
-    ~WorkerThreadPool();
-
     static WorkerThreadPool& getSharedInstance();
 
     Job submit(Job::Func func);
 
-    void setThreadCount(std::size_t count);
     std::size_t getThreadCount() const;
 
 private:
-    void startThreads();
-    void stopThreads();
-
-    std::shared_ptr<Job::JobData> awaitWork();
-    void workerLoop();
-
-    std::deque<std::shared_ptr<Job::JobData>> jobs;
-
-    std::size_t threadCount = 12;
-    std::vector<std::thread> threads;
-    mutable std::mutex mutex;
-    mutable std::mutex controlMutex;
-    mutable std::condition_variable conditionQueue;
-    std::atomic_bool running = ATOMIC_VAR_INIT(false);
+    static void run(std::shared_ptr<Job::JobData> jobData);
 };
 
 } // namespace megamol::ImageSeries::util
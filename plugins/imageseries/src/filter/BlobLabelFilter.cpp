@@ -6,9 +6,11 @@
 
 #include "BlobLabelFilter.h"
 
+#include "../util/ConnectedComponents.h"
+
 #include "vislib/graphics/BitmapImage.h"
 
-#include <deque>
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -74,16 +76,6 @@ BlobLabelFilter::ImagePtr BlobLabelFilter::operator()() {
         }
     }
 
-    Label nextLabel = LabelFirst;
-    Label labelLimit = LabelFirst + input.blobCountLimit - 1;
-
-    std::vector<Index> pendingPixels;
-    std::vector<Index> pendingFlow;
-    std::deque<Index> queue;
-
-    // Reserve enough space to perform first pass
-    pendingPixels.reserve(input.minBlobSize + 4);
-
     auto testPixel = [&](Index index) {
         return dataOut[index] == LabelBackground && (dataIn[index] < threshold) != input.negateThreshold;
     };
@@ -91,122 +83,106 @@ BlobLabelFilter::ImagePtr BlobLabelFilter::operator()() {
     auto testPrev = [&](Index index) { return prevIn && (prevIn[index] < threshold) != input.negateThreshold; };
     auto testDiff = [&](Index index) { return diffIn && (diffIn[index] < threshold) != input.negateThreshold; };
 
-    auto markMinimal = [&](Index index) {
-        if (testPixel(index)) {
-            if (testDiff(index)) {
-                pendingFlow.push_back(index);
-            } else {
-                dataOut[index] = LabelMinimal;
-                pendingPixels.push_back(index);
+    using util::ConnectedComponents;
+    constexpr auto None = ConnectedComponents::None;
+
+    // Blobs are the 4-connected regions of active pixels that were not active in the predecessor frame. Active pixels
+    // of the predecessor frame form the flow interface and separate blobs.
+    ConnectedComponents blobs;
+    const auto blobCount = blobs.label(
+        width, height, ConnectedComponents::Connectivity::Four,
+        [&](Index index) { return testPixel(index) && !testPrev(index); }, [](Index, Index) { return true; });
+
+    // The size of a blob counts its pixels and the distinct adjacent interface pixels. If a separate difference frame
+    // is given, it determines the interface for the size test instead of the predecessor frame.
+    const bool separateDiff = diffIn != prevIn;
+    ConnectedComponents sizeRegions;
+    if (separateDiff) {
+        sizeRegions.label(
+            width, height, ConnectedComponents::Connectivity::Four,
+            [&](Index index) { return testPixel(index) && !testDiff(index); }, [](Index, Index) { return true; });
+    }
+    const auto& sizeRef = separateDiff ? sizeRegions : blobs;
+
+    // Collects the distinct components of the 4-neighborhood of a pixel
+    auto neighborComponents = [width, size](const ConnectedComponents& cc, Index index, Index (&result)[4]) {
+        int count = 0;
+        auto add = [&](Index neighbor) {
+            const auto component = cc.getComponent(neighbor);
+            if (component != None && std::find(result, result + count, component) == result + count) {
+                result[count++] = component;
             }
+        };
+        if (index % width < width - 1) {
+            add(index + 1);
         }
-    };
-
-    auto fillMinimal = [&](Index startIndex) {
-        pendingPixels.clear();
-        pendingFlow.clear();
-        markMinimal(startIndex);
-        Index queueIndex = 0;
-
-        // Try to collect at least MinBlobSize connected pixels
-        while (queueIndex < pendingPixels.size()) {
-            Index index = pendingPixels[queueIndex++];
-
-            // Pixel is not on the right boundary
-            if (index % width < width - 1) {
-                markMinimal(index + 1);
-            }
-            // Pixel is not on the left boundary
-            if (index % width > 0) {
-                markMinimal(index - 1);
-            }
-            // Pixel is not on the bottom boundary
-            if (index < size - width) {
-                markMinimal(index + width);
-            }
-            // Pixel is not on the top boundary
-            if (index >= width) {
-                markMinimal(index - width);
-            }
-
-            // Pixel threshold met
-            if ((pendingPixels.size() + pendingFlow.size()) >= input.minBlobSize) {
-                return true;
-            }
+        if (index % width > 0) {
+            add(index - 1);
         }
-
-        // Not enough pixels
-        return false;
-    };
-
-    auto mark = [&](Index index) {
-        if (testPixel(index)) {
-            if (testPrev(index)) {
-                dataOut[index] = LabelFlow;
-            } else {
-                dataOut[index] = nextLabel;
-                queue.push_back(index);
-            }
+        if (index < size - width) {
+            add(index + width);
+        }
+        if (index >= width) {
+            add(index - width);
         }
+        return count;
     };
 
-    auto fill = [&](Index startIndex) {
-        // Perform minimal first pass, checking if the blob is large enough
-        if (!fillMinimal(startIndex)) {
-            // Small blob: avoid assigning unique label ID
-            return;
+    std::vector<std::uint32_t> regionSizes(sizeRef.getComponentCount(), 0);
+#pragma omp parallel for
+    for (std::int64_t i = 0; i < static_cast<std::int64_t>(size); ++i) {
+        const auto index = static_cast<Index>(i);
+        const auto component = sizeRef.getComponent(index);
+        if (component != None) {
+#pragma omp atomic
+            ++regionSizes[component];
+        } else if (testPixel(index) && testDiff(index)) {
+            Index neighbors[4];
+            const auto count = neighborComponents(sizeRef, index, neighbors);
+            for (int n = 0; n < count; ++n) {
+#pragma omp atomic
+                ++regionSizes[neighbors[n]];
+            }
         }
+    }
 
-        queue.clear();
-
-        // Large blob: fill out all pixels with proper label ID
-        for (auto& index : pendingPixels) {
-            dataOut[index] = nextLabel;
-            queue.push_back(index);
-        }
+    // Assign label IDs in scan order; small blobs are replaced with LabelMinimal
+    Label nextLabel = LabelFirst;
+    Label labelLimit = LabelFirst + input.blobCountLimit - 1;
 
-        for (auto& index : pendingFlow) {
-            dataOut[index] = LabelFlow;
+    std::vector<Label> blobLabels(blobCount, LabelMinimal);
+    for (std::size_t blob = 0; blob < blobCount; ++blob) {
+        const auto seed = blobs.getFirstPixel(static_cast<Index>(blob));
+        const auto region = sizeRef.getComponent(seed);
+        if (region == None || regionSizes[region] < input.minBlobSize) {
+            continue;
         }
 
-        // Perform proper flood fill
-        while (!queue.empty()) {
-            auto index = queue.front();
-            queue.pop_front();
-
-            // Pixel is not on the right boundary
-            if (index % width < width - 1) {
-                mark(index + 1);
-            }
-            // Pixel is not on the left boundary
-            if (index % width > 0) {
-                mark(index - 1);
-            }
-            // Pixel is not on the bottom boundary
-            if (index < size - width) {
-                mark(index + width);
-            }
-            // Pixel is not on the top boundary
-            if (index >= width) {
-                mark(index - width);
-            }
-        }
+        blobLabels[blob] = nextLabel;
 
         // Check if label limit has been reached
-        if (nextLabel == labelLimit) {
+        if (nextLabel != labelLimit) {
             // TODO clear smallest blob
-            return;
+            nextLabel++;
         }
+    }
 
-        // Increment label index
-        nextLabel++;
-    };
-
-    // Perform flood fill
-    for (Index i = 0; i < size; ++i) {
-        // Found a possible seed point: start flood filling!
-        if (testPixel(i) && !testPrev(i)) {
-            fill(i);
+    // Write blob labels and mark the interface pixels adjacent to proper blobs
+#pragma omp parallel for
+    for (std::int64_t i = 0; i < static_cast<std::int64_t>(size); ++i) {
+        const auto index = static_cast<Index>(i);
+        const auto blob = blobs.getComponent(index);
+        if (blob != None) {
+            dataOut[index] = blobLabels[blob];
+        } else if (testPixel(index) && testPrev(index)) {
+            Index neighbors[4];
+            const auto count = neighborComponents(blobs, index, neighbors);
+            for (int n = 0; n < count; ++n) {
+                if (blobLabels[neighbors[n]] != LabelMinimal) {
+                    dataOut[index] = LabelFlow;
+                    break;
+                }
+            }
         }
     }
 
@@ -6,6 +6,7 @@
 
 #include "FlowTimeLabelFilter.h"
 
+#include "../util/ConnectedComponents.h"
 #include "../util/GraphGDFExporter.h"
 #include "../util/GraphLuaExporter.h"
 
@@ -110,7 +111,6 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
 
     // Assign unique labels to connected areas of same time
     auto nodeGraph = std::make_shared<graph::GraphData2D>();
-    std::map<Timestamp, std::vector<graph::GraphData2D::NodeID>> nodesByTime;
 
     for (Index index = 0; index < size; ++index) {
         if (dataIn[index] == 0) {
@@ -122,19 +122,50 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
         }
     }
 
-    std::vector<Index> floodQueue;
+    util::ConnectedComponents regions;
+    const auto regionCount = regions.label(
+        width, height, util::ConnectedComponents::Connectivity::Eight,
+        [&](Index index) { return dataOut[index] == LabelUnassigned; },
+        [&](Index lhs, Index rhs) { return dataIn[lhs] == dataIn[rhs]; });
 
-    auto floodFill = [&](const Index index, const Label label) {
-        floodQueue.clear();
-        floodQueue.push_back(index);
+    if (regionCount > static_cast<std::size_t>(LabelMaximum - LabelMinimum)) {
+        core::utility::log::Log::DefaultLog.WriteError(
+            "[FlowTimeLabelFilter]: Too many labels! Consider denoising the input images.");
 
-        graph::GraphData2D::Node current_region(dataIn[index], label);
-        current_region.pixels.push_back(index);
+        // return black image and empty graph
+        auto output = std::make_shared<Output>();
+        output->image =
+            std::make_shared<Image>(image->Width(), image->Height(), 1, Image::ChannelType::CHANNELTYPE_WORD);
+        output->graph = std::make_shared<graph::GraphData2D>();
+        return output;
+    }
 
-        dataOut[index] = label;
+    regions.groupPixels();
 
-        for (std::size_t queueIndex = 0; queueIndex < floodQueue.size(); ++queueIndex) {
-            const auto currentIndex = floodQueue[queueIndex];
+    // Labels follow scan order, as the components are numbered in the order of their first pixel
+    Label next_label = static_cast<Label>(LabelMinimum + regionCount);
+
+    // Collect pixels and interfaces of each region. Writing the interface images touches neighboring regions, which
+    // is only done sequentially.
+    std::vector<graph::GraphData2D::Node> regionNodes;
+    regionNodes.reserve(regionCount);
+    for (std::size_t region = 0; region < regionCount; ++region) {
+        const auto first = regions.getFirstPixel(static_cast<Index>(region));
+        regionNodes.emplace_back(dataIn[first], static_cast<Label>(LabelMinimum + region));
+    }
+
+#pragma omp parallel for schedule(dynamic) if (interface_output == interface_t::none)
+    for (std::int64_t region = 0; region < static_cast<std::int64_t>(regionCount); ++region) {
+        auto& current_region = regionNodes[region];
+        const auto label = current_region.getLabel();
+        const auto time = current_region.getFrameIndex();
+
+        const auto* begin = regions.getPixels(static_cast<Index>(region));
+        const auto* end = regions.getPixelsEnd(static_cast<Index>(region));
+        current_region.pixels.assign(begin, end);
+
+        for (const auto currentIndex : current_region.pixels) {
+            dataOut[currentIndex] = label;
 
             const auto x = currentIndex % width;
             const auto y = currentIndex / width;
@@ -143,37 +174,31 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
                 for (auto i = ((x > 0) ? -1 : 0); i <= ((x < width - 1) ? 1 : 0); ++i) {
                     const auto neighborIndex = (y + j) * width + (x + i);
 
-                    if (dataOut[neighborIndex] == LabelUnassigned && dataIn[index] == dataIn[neighborIndex]) {
-                        floodQueue.push_back(neighborIndex);
-                        dataOut[neighborIndex] = label;
-
-                        current_region.pixels.push_back(neighborIndex);
-                    } else if (dataOut[neighborIndex] == LabelSolid) {
+                    if (dataIn[neighborIndex] == 0) {
                         // Add current fluid index to interfaces, indicating a fluid-solid interface
                         current_region.interfaces[LabelSolid].insert(currentIndex);
 
                         if (interface_output == interface_t::full) {
                             interfaceSolidOut[currentIndex] = interfaceOut[currentIndex] = 0;
                         }
-                    } else if (dataIn[index] > dataIn[neighborIndex]) {
+                    } else if (time > dataIn[neighborIndex]) {
                         // Add neighboring fluid index to interfaces, indicating a past fluid-fluid interface
                         current_region.interfaces[dataIn[neighborIndex]].insert(neighborIndex);
-                    } else if (dataIn[index] < dataIn[neighborIndex]) {
+                    } else if (time < dataIn[neighborIndex]) {
                         // Add current fluid index to interfaces, indicating a current fluid-fluid interface
                         current_region.interfaces[dataIn[neighborIndex]].insert(neighborIndex);
 
                         if (interface_output == interface_t::full) {
-                            interfaceFluidOut[neighborIndex] = interfaceOut[currentIndex] =
-                                current_region.getFrameIndex();
+                            interfaceFluidOut[neighborIndex] = interfaceOut[currentIndex] = time;
                         }
                     }
 
                     if (interface_output != interface_t::none) {
                         const auto targetInterface = static_cast<Timestamp>(interface_output);
-                        if (dataIn[index] <= targetInterface && dataIn[neighborIndex] > targetInterface) {
+                        if (time <= targetInterface && dataIn[neighborIndex] > targetInterface) {
                             interfaceFluidOut[neighborIndex] = interfaceOut[currentIndex] = 0;
                         }
-                        if (dataIn[index] <= targetInterface && dataIn[neighborIndex] == LabelSolid) {
+                        if (time <= targetInterface && dataIn[neighborIndex] == LabelSolid) {
                             interfaceSolidOut[neighborIndex] = interfaceOut[currentIndex] = 0;
                         }
                     }
@@ -189,29 +214,19 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
                 current_region.interfaceFluid += fluid_interface.second.size();
             }
         }
-
-        nodesByTime[current_region.getFrameIndex()].push_back(nodeGraph->addNode(current_region));
-    };
-
-    Label next_label = LabelMinimum;
-
-    for (Index index = 0; index < size; ++index) {
-        if (dataOut[index] == LabelUnassigned && next_label <= LabelMaximum) {
-            floodFill(index, next_label++);
-        }
     }
 
-    if (next_label > LabelMaximum) {
-        core::utility::log::Log::DefaultLog.WriteError(
-            "[FlowTimeLabelFilter]: Too many labels! Consider denoising the input images.");
-
-        // return black image and empty graph
-        auto output = std::make_shared<Output>();
-        output->image =
-            std::make_shared<Image>(image->Width(), image->Height(), 1, Image::ChannelType::CHANNELTYPE_WORD);
-        output->graph = std::make_shared<graph::GraphData2D>();
-        return output;
+    // Add nodes in label order, remembering them sorted by time for edge creation
+    std::vector<std::pair<Timestamp, graph::GraphData2D::NodeID>> nodesByTime;
+    nodesByTime.reserve(regionCount);
+    for (auto& current_region : regionNodes) {
+        const auto time = current_region.getFrameIndex();
+        nodesByTime.emplace_back(time, nodeGraph->addNode(std::move(current_region)));
     }
+    regionNodes.clear();
+
+    std::stable_sort(nodesByTime.begin(), nodesByTime.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
 
     auto printNode = [&nodeGraph](graph::GraphData2D::NodeID id) {
         const auto& node = nodeGraph->getNode(id);
@@ -263,34 +278,32 @@ std::shared_ptr<FlowTimeLabelFilter::Output> FlowTimeLabelFilter::operator()() {
     }
 
     // Create edges by iterating over flow fronts with time monotonically increasing
-    for (const auto& flow_fronts : nodesByTime) {
-        for (const auto flow_front_ID : flow_fronts.second) {
-            const auto& flow_front = nodeGraph->getNode(flow_front_ID);
+    for (const auto& [time, flow_front_ID] : nodesByTime) {
+        const auto& flow_front = nodeGraph->getNode(flow_front_ID);
 
-            // Find neighboring flow fronts and add edge if the neighboring front is (1) from the past and (2) the local maximum
-            std::unordered_set<Label> past_neighboring_flow_fronts;
-            Timestamp past_time{};
+        // Find neighboring flow fronts and add edge if the neighboring front is (1) from the past and (2) the local maximum
+        std::unordered_set<Label> past_neighboring_flow_fronts;
+        Timestamp past_time{};
 
-            for (auto it = flow_front.interfaces.crbegin(); it != flow_front.interfaces.crend(); ++it) {
-                if (it->first != LabelSolid && it->first < flow_front.getFrameIndex()) {
-                    past_time = it->first;
+        for (auto it = flow_front.interfaces.crbegin(); it != flow_front.interfaces.crend(); ++it) {
+            if (it->first != LabelSolid && it->first < flow_front.getFrameIndex()) {
+                past_time = it->first;
 
-                    for (const auto index : it->second) {
-                        past_neighboring_flow_fronts.insert(dataOut[index]);
-                    }
-
-                    break;
+                for (const auto index : it->second) {
+                    past_neighboring_flow_fronts.insert(dataOut[index]);
                 }
+
+                break;
             }
+        }
 
-            for (const auto& past_flow_front : past_neighboring_flow_fronts) {
-                const auto& srcNode = nodeGraph->getNode(past_time, past_flow_front);
+        for (const auto& past_flow_front : past_neighboring_flow_fronts) {
+            const auto& srcNode = nodeGraph->getNode(past_time, past_flow_front);
 
-                graph::GraphData2D::Edge edge(
-                    srcNode.getID(), flow_front_ID, glm::distance(flow_front.centerOfMass, srcNode.centerOfMass));
+            graph::GraphData2D::Edge edge(
+                srcNode.getID(), flow_front_ID, glm::distance(flow_front.centerOfMass, srcNode.centerOfMass));
 
-                nodeGraph->addEdge(std::move(edge));
-            }
+            nodeGraph->addEdge(std::move(edge));
         }
     }
 
@@ -6,6 +6,8 @@
 
 #include "ImageLoadFilter.h"
 
+#include "../util/DecodedImageCache.h"
+
 #include "vislib/graphics/BitmapCodecCollection.h"
 
 #include <memory>
@@ -15,11 +17,12 @@ namespace megamol::ImageSeries::filter {
 
 ImageLoadFilter::ImageLoadFilter(Input input) : input(input) {}
 
-ImageLoadFilter::ImageLoadFilter(
-    std::shared_ptr<vislib::graphics::BitmapCodecCollection> codecs, std::string filename, ImageMetadata metadata) {
+ImageLoadFilter::ImageLoadFilter(std::shared_ptr<vislib::graphics::BitmapCodecCollection> codecs, std::string filename,
+    ImageMetadata metadata, std::shared_ptr<const util::DecodedImageCache> decodedCache) {
     input.codecs = codecs;
     input.filename = filename;
     input.metadata = metadata;
+    input.decodedCache = decodedCache;
 }
 
 ImageLoadFilter::ImagePtr ImageLoadFilter::operator()() {
@@ -27,10 +30,21 @@ ImageLoadFilter::ImagePtr ImageLoadFilter::operator()() {
     try {
         util::PerfTimer timer("ImageLoadFilter", input.filename);
 
+        // Skip decoding if the image has been decoded before
+        if (input.decodedCache) {
+            if (auto img = input.decodedCache->load(input.filename)) {
+                return img;
+            }
+        }
+
         auto img = std::make_shared<vislib::graphics::BitmapImage>();
         if (!input.codecs->LoadBitmapImage(*img, filename)) {
             throw vislib::Exception("No suitable codec found", __FILE__, __LINE__);
         }
+
+        if (input.decodedCache) {
+            input.decodedCache->store(input.filename, *img);
+        }
         return img;
     } catch (vislib::Exception& ex) {
         // TODO thread-safe log?
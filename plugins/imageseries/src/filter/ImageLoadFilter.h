@@ -15,6 +15,10 @@ namespace vislib::graphics {
 class BitmapCodecCollection;
 }
 
+namespace megamol::ImageSeries::util {
+class DecodedImageCache;
+}
+
 namespace megamol::ImageSeries::filter {
 
 class ImageLoadFilter {
@@ -26,11 +30,14 @@ public:
         std::shared_ptr<vislib::graphics::BitmapCodecCollection> codecs;
         std::string filename;
         ImageMetadata metadata;
+
+        /// Optional persistent cache of decoded images
+        std::shared_ptr<const util::DecodedImageCache> decodedCache;
     };
 
     ImageLoadFilter(Input input);
-    ImageLoadFilter(
-        std::shared_ptr<vislib::graphics::BitmapCodecCollection> codecs, std::string filename, ImageMetadata metadata);
+    ImageLoadFilter(std::shared_ptr<vislib::graphics::BitmapCodecCollection> codecs, std::string filename,
+        ImageMetadata metadata, std::shared_ptr<const util::DecodedImageCache> decodedCache = nullptr);
     ImagePtr operator()();
 
     ImageMetadata getMetadata() const;
@@ -13,6 +13,7 @@
 
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
 #include "mmcore/param/StringParam.h"
 
 #include "vislib/graphics/BitmapCodecCollection.h"
@@ -35,6 +36,8 @@ ImageSeriesLoader::ImageSeriesLoader()
         : getDataCallee("getData", "Returns data from the image series for the requested timestamp.")
         , pathParam("Path", "Directory from which image files should be loaded.")
         , patternParam("Filename pattern", "Regular expression to filter file names by.")
+        , prefetchParam("Prefetch", "Number of frames to load ahead of the requested frame in playback direction.")
+        , decodedCachePathParam("Decoded cache", "Directory for storing decoded images, to skip decoding on reload.")
         , imageCache([](const AsyncImageData2D<>& imageData) { return imageData.getByteSize(); }) {
 
     getDataCallee.SetCallback(ImageSeries2DCall::ClassName(),
@@ -51,6 +54,13 @@ ImageSeriesLoader::ImageSeriesLoader()
     patternParam.SetUpdateCallback(&ImageSeriesLoader::patternChangedCallback);
     MakeSlotAvailable(&patternParam);
 
+    prefetchParam << new core::param::IntParam(4, 0, 64);
+    MakeSlotAvailable(&prefetchParam);
+
+    decodedCachePathParam << new core::param::FilePathParam("", core::param::FilePathParam::Flag_Directory_ToBeCreated);
+    decodedCachePathParam.SetUpdateCallback(&ImageSeriesLoader::decodedCachePathChangedCallback);
+    MakeSlotAvailable(&decodedCachePathParam);
+
     // Set default image cache size to 512 MB
     imageCache.setMaximumSize(512 * 1024 * 1024);
 }
@@ -61,12 +71,21 @@ ImageSeriesLoader::~ImageSeriesLoader() {
 
 bool ImageSeriesLoader::create() {
     filterRunner = std::make_unique<filter::AsyncFilterRunner<>>();
+#ifdef MEGAMOL_USE_PROFILING
+    perfManager = const_cast<frontend_resources::PerformanceManager*>(
+        &frontend_resources.get<frontend_resources::PerformanceManager>());
+    imageCachePool = perfManager->add_memory_pool(this, "image cache");
+#endif
     return true;
 }
 
 void ImageSeriesLoader::release() {
     imageCache.clear();
+    decodedCache = nullptr;
     filterRunner = nullptr;
+#ifdef MEGAMOL_USE_PROFILING
+    perfManager->remove_memory_pool(imageCachePool);
+#endif
 }
 
 bool ImageSeriesLoader::getDataCallback(core::Call& caller) {
@@ -79,16 +98,12 @@ bool ImageSeriesLoader::getDataCallback(core::Call& caller) {
         output.resultTime = frameIndexToTimestamp(output.imageIndex);
 
         if (output.imageIndex < imageFilesFiltered.size()) {
-            const auto& path = imageFilesFiltered[output.imageIndex];
-            output.filename = path;
-
-            ImageMetadata meta = metadata;
-            meta.imageCount = output.imageCount;
-            meta.index = output.imageIndex;
-            meta.valid = true;
-            output.imageData = imageCache.findOrCreate(output.imageIndex, [&](std::uint32_t) {
-                return filterRunner->run<ImageSeries::filter::ImageLoadFilter>(getBitmapCodecs(), path, meta);
-            });
+            output.filename = imageFilesFiltered[output.imageIndex];
+            output.imageData = requestImage(output.imageIndex);
+            prefetchImages(output.imageIndex);
+#ifdef MEGAMOL_USE_PROFILING
+            perfManager->set_memory_usage(imageCachePool, imageCache.getTotalSize());
+#endif
         }
 
         // TODO validate that width and height match series metadata
@@ -123,6 +138,15 @@ bool ImageSeriesLoader::patternChangedCallback(core::param::ParamSlot& param) {
     return true;
 }
 
+bool ImageSeriesLoader::decodedCachePathChangedCallback(core::param::ParamSlot& param) {
+    auto path = decodedCachePathParam.Param<core::param::FilePathParam>()->Value();
+    decodedCache = path.empty() ? nullptr : std::make_shared<const util::DecodedImageCache>(path);
+
+    // Images already loaded are not affected by the decoded cache
+    imageCache.clear();
+    return true;
+}
+
 bool ImageSeriesLoader::formatChangedCallback(core::param::ParamSlot& param) {
     // TODO mutex?
     updateMetadata();
@@ -245,6 +269,45 @@ std::shared_ptr<vislib::graphics::BitmapImage> ImageSeriesLoader::loadImageFile(
     return nullptr;
 }
 
+std::shared_ptr<const AsyncImageData2D<>> ImageSeriesLoader::requestImage(std::size_t index) {
+    ImageMetadata meta = metadata;
+    meta.imageCount = outputPrototype.imageCount;
+    meta.index = index;
+    meta.valid = true;
+
+    const auto& path = imageFilesFiltered[index];
+    return imageCache.findOrCreate(index, [&](std::uint32_t) {
+        return filterRunner->run<ImageSeries::filter::ImageLoadFilter>(getBitmapCodecs(), path, meta, decodedCache);
+    });
+}
+
+void ImageSeriesLoader::prefetchImages(std::size_t index) {
+    // Keep the previous direction if the same frame is requested repeatedly
+    if (index != lastImageIndex) {
+        playbackDirection = index > lastImageIndex ? 1 : -1;
+        lastImageIndex = index;
+    }
+
+    // Limit prefetching such that the requested frame is not evicted from the cache by the prefetched frames
+    std::size_t count = prefetchParam.Param<core::param::IntParam>()->Value();
+    const auto frameSize = std::max<std::size_t>(metadata.getByteSize(), 1);
+    count = std::min(count, imageCache.getMaximumSize() / frameSize / 2);
+
+    // Images are loaded on the shared worker thread pool as soon as they are created
+    for (std::size_t offset = 1; offset <= count; ++offset) {
+        if (playbackDirection < 0 && offset > index) {
+            break;
+        }
+
+        const auto next = playbackDirection > 0 ? index + offset : index - offset;
+        if (next >= imageFilesFiltered.size()) {
+            break;
+        }
+
+        requestImage(next);
+    }
+}
+
 std::shared_ptr<vislib::graphics::BitmapCodecCollection> ImageSeriesLoader::getBitmapCodecs() const {
     // Copy bitmap codec collection (for thread-safety)
     auto bitmapCodecCollection = std::make_shared<vislib::graphics::BitmapCodecCollection>(
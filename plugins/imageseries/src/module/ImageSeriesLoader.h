@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../filter/AsyncFilterRunner.h"
+#include "../util/DecodedImageCache.h"
 #include "../util/LRUCache.h"
 
 #include "imageseries/AsyncImageData2D.h"
@@ -19,6 +20,10 @@
 
 #include "vislib/graphics/BitmapCodecCollection.h"
 
+#ifdef MEGAMOL_USE_PROFILING
+#include "PerformanceManager.h"
+#endif
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -54,6 +59,13 @@ public:
         return true;
     }
 
+#ifdef MEGAMOL_USE_PROFILING
+    static void requested_lifetime_resources(frontend_resources::ResourceRequest& req) {
+        core::Module::requested_lifetime_resources(req);
+        req.require<frontend_resources::PerformanceManager>();
+    }
+#endif
+
     ImageSeriesLoader();
 
     ~ImageSeriesLoader() override;
@@ -91,6 +103,11 @@ protected:
      */
     bool patternChangedCallback(core::param::ParamSlot& param);
 
+    /**
+     * Callback for changes to the 'decoded cache' parameter.
+     */
+    bool decodedCachePathChangedCallback(core::param::ParamSlot& param);
+
     /**
      * Callback for changes to the 'image format' parameter.
      */
@@ -106,6 +123,16 @@ private:
 
     std::shared_ptr<vislib::graphics::BitmapImage> loadImageFile(const std::string& path) const;
 
+    /**
+     * Answers the image of a frame, starting to load it in the background if it is not cached yet.
+     */
+    std::shared_ptr<const AsyncImageData2D<>> requestImage(std::size_t index);
+
+    /**
+     * Starts loading the frames following the given one in the direction of playback.
+     */
+    void prefetchImages(std::size_t index);
+
     std::unique_ptr<filter::AsyncFilterRunner<>> filterRunner;
 
     core::CalleeSlot getDataCallee;
@@ -116,15 +143,31 @@ private:
     /// Regex pattern to filter image series by
     core::param::ParamSlot patternParam;
 
+    /// Number of frames to load ahead of the requested frame
+    core::param::ParamSlot prefetchParam;
+
+    /// Directory for persisting decoded images
+    core::param::ParamSlot decodedCachePathParam;
+
     std::vector<std::string> imageFilesUnfiltered;
     std::vector<std::string> imageFilesFiltered;
 
     util::LRUCache<std::uint32_t, AsyncImageData2D<>> imageCache;
+    std::shared_ptr<const util::DecodedImageCache> decodedCache;
+
+    /// Last requested frame and direction of playback, for prefetching
+    std::size_t lastImageIndex = 0;
+    int playbackDirection = 1;
 
     ImageMetadata metadata;
     ImageSeries2DCall::Output outputPrototype;
 
     std::shared_ptr<vislib::graphics::BitmapCodecCollection> getBitmapCodecs() const;
+
+#ifdef MEGAMOL_USE_PROFILING
+    frontend_resources::PerformanceManager* perfManager = nullptr;
+    frontend_resources::PerformanceManager::pool_handle imageCachePool = 0;
+#endif
 };
 
 } // namespace megamol::ImageSeries
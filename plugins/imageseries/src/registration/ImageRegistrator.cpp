@@ -12,10 +12,63 @@
 
 #include "imageseries/util/ImageUtils.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace megamol::ImageSeries::registration {
 
+namespace {
+
+/**
+ * Halves the resolution of an image by averaging 2x2 blocks, repeating the last row and column for odd sizes.
+ */
+template<typename T>
+std::vector<T> downsample(const std::vector<T>& source, std::size_t width, std::size_t height) {
+    const std::size_t targetWidth = (width + 1) / 2;
+    const std::size_t targetHeight = (height + 1) / 2;
+    std::vector<T> target(targetWidth * targetHeight);
+
+#pragma omp parallel for
+    for (std::int64_t y = 0; y < static_cast<std::int64_t>(targetHeight); ++y) {
+        const std::size_t y0 = y * 2;
+        const std::size_t y1 = std::min<std::size_t>(y0 + 1, height - 1);
+        for (std::size_t x = 0; x < targetWidth; ++x) {
+            const std::size_t x0 = x * 2;
+            const std::size_t x1 = std::min(x0 + 1, width - 1);
+            target[y * targetWidth + x] = (source[y0 * width + x0] + source[y0 * width + x1] +
+                                              source[y1 * width + x0] + source[y1 * width + x1]) *
+                                          0.25f;
+        }
+    }
+    return target;
+}
+
+/**
+ * Bilinear lookup with clamping at the image borders.
+ */
+template<typename T>
+T lerp(const std::vector<T>& image, std::size_t width, std::size_t height, glm::vec2 point) {
+    const float fx = std::floor(point.x);
+    const float fy = std::floor(point.y);
+    const float wx = point.x - fx;
+    const float wy = point.y - fy;
+
+    const auto maxX = static_cast<int>(width) - 1;
+    const auto maxY = static_cast<int>(height) - 1;
+    const int x0 = std::clamp(static_cast<int>(fx), 0, maxX);
+    const int x1 = std::clamp(static_cast<int>(fx) + 1, 0, maxX);
+    const std::size_t row0 = std::clamp(static_cast<int>(fy), 0, maxY) * width;
+    const std::size_t row1 = std::clamp(static_cast<int>(fy) + 1, 0, maxY) * width;
+
+    return (image[row0 + x0] * (1 - wx) + image[row0 + x1] * wx) * (1 - wy) +
+           (image[row1 + x0] * (1 - wx) + image[row1 + x1] * wx) * wy;
+}
+
+} // namespace
+
 ImageRegistrator::ImageRegistrator() : transform(1, 0, 0, 1, 0, 0) {}
 
 void ImageRegistrator::setInputImage(AsyncImagePtr image) {
@@ -33,6 +86,7 @@ void ImageRegistrator::setInputImage(AsyncImagePtr image) {
         this->inputDerivative = filter::DerivativeFilter(blurredImage)();
         this->biasedAverageMeanSquareError = -1.f;
         this->stepsSinceLastImprovement = 0;
+        this->currentLevel = this->pyramidLevels - 1;
     }
 }
 
@@ -76,9 +130,27 @@ float ImageRegistrator::getMeanSquareError() const {
     return meanSquareError;
 }
 
+void ImageRegistrator::setPyramidLevels(int levels) {
+    if (this->pyramidLevels != std::max(levels, 1)) {
+        this->pyramidLevels = std::max(levels, 1);
+        this->pyramid.clear();
+        this->pyramidInput = nullptr;
+        this->currentLevel = this->pyramidLevels - 1;
+    }
+}
+
+int ImageRegistrator::getPyramidLevels() const {
+    return pyramidLevels;
+}
+
+int ImageRegistrator::getCurrentLevel() const {
+    return pyramid.empty() ? currentLevel : std::min<int>(currentLevel, pyramid.size() - 1);
+}
+
 void ImageRegistrator::reset() {
     this->biasedAverageMeanSquareError = -1.f;
     this->stepsSinceLastImprovement = 0;
+    this->currentLevel = this->pyramidLevels - 1;
     this->transform = glm::mat3x2(1, 0, 0, 1, 0, 0);
 }
 
@@ -86,6 +158,64 @@ int ImageRegistrator::getStepsSinceLastImprovement() const {
     return stepsSinceLastImprovement;
 }
 
+bool ImageRegistrator::buildPyramid(ImagePtr referenceData, ImagePtr inputData) {
+    pyramid.clear();
+    pyramidReference = referenceData;
+    pyramidInput = inputData;
+    pyramidDerivative = inputDerivative;
+
+    if (referenceData->BytesPerPixel() != 1 || inputData->BytesPerPixel() != 1 ||
+        inputDerivative->BytesPerPixel() != 2 || inputDerivative->Width() != inputData->Width() ||
+        inputDerivative->Height() != inputData->Height()) {
+        return false;
+    }
+
+    // Convert full resolution to normalized values once, instead of in every step
+    Level level;
+    level.width = inputData->Width();
+    level.height = inputData->Height();
+    level.referenceWidth = referenceData->Width();
+    level.referenceHeight = referenceData->Height();
+
+    const auto* input = inputData->PeekDataAs<std::uint8_t>();
+    const auto* reference = referenceData->PeekDataAs<std::uint8_t>();
+    const auto* derivative = inputDerivative->PeekDataAs<std::uint8_t>();
+
+    level.input.resize(level.width * level.height);
+    level.derivative.resize(level.width * level.height);
+    level.reference.resize(level.referenceWidth * level.referenceHeight);
+    for (std::size_t i = 0; i < level.input.size(); ++i) {
+        level.input[i] = input[i] / 255.f;
+        level.derivative[i] = (glm::vec2(derivative[i * 2], derivative[i * 2 + 1]) - glm::vec2(127.f, 127.f)) / 255.f;
+    }
+    for (std::size_t i = 0; i < level.reference.size(); ++i) {
+        level.reference[i] = reference[i] / 255.f;
+    }
+    pyramid.push_back(std::move(level));
+
+    // Coarser levels; derivatives are averaged, thus they remain relative to full-resolution pixels
+    while (static_cast<int>(pyramid.size()) < pyramidLevels) {
+        const auto& finer = pyramid.back();
+        if ((finer.width + 1) / 2 < MinLevelSize || (finer.height + 1) / 2 < MinLevelSize ||
+            (finer.referenceWidth + 1) / 2 < MinLevelSize || (finer.referenceHeight + 1) / 2 < MinLevelSize) {
+            break;
+        }
+
+        Level coarser;
+        coarser.width = (finer.width + 1) / 2;
+        coarser.height = (finer.height + 1) / 2;
+        coarser.referenceWidth = (finer.referenceWidth + 1) / 2;
+        coarser.referenceHeight = (finer.referenceHeight + 1) / 2;
+        coarser.scale = finer.scale * 2;
+        coarser.input = downsample(finer.input, finer.width, finer.height);
+        coarser.derivative = downsample(finer.derivative, finer.width, finer.height);
+        coarser.reference = downsample(finer.reference, finer.referenceWidth, finer.referenceHeight);
+        pyramid.push_back(std::move(coarser));
+    }
+
+    return true;
+}
+
 void ImageRegistrator::step() {
     auto referenceData = referenceImage ? referenceImage->getImageData() : nullptr;
     auto inputData = inputImage ? inputImage->getImageData() : nullptr;
@@ -94,36 +224,71 @@ void ImageRegistrator::step() {
         return;
     }
 
-    util::ImageSampler<uint8_t, 1> reference(*referenceData);
-    util::ImageSampler<uint8_t, 1> input(*inputData);
-    util::ImageSampler<uint8_t, 2> derivative(*inputDerivative);
+    if (referenceData != pyramidReference || inputData != pyramidInput || inputDerivative != pyramidDerivative) {
+        if (!buildPyramid(referenceData, inputData)) {
+            return;
+        }
+    }
+    if (pyramid.empty()) {
+        return;
+    }
+
+    currentLevel = std::clamp<int>(currentLevel, 0, pyramid.size() - 1);
+    const auto& level = pyramid[currentLevel];
+
+    // Pixel centers of the current level in full-resolution coordinates
+    const float scale = static_cast<float>(level.scale);
+    const float center = (scale - 1.f) * 0.5f;
+    const float maxX = static_cast<float>(pyramid.front().referenceWidth) - 1.f;
+    const float maxY = static_cast<float>(pyramid.front().referenceHeight) - 1.f;
+    const auto referenceMaxX = static_cast<std::int64_t>(level.referenceWidth) - 1;
+    const auto referenceMaxY = static_cast<std::int64_t>(level.referenceHeight) - 1;
 
-    glm::mat3x2 sum(0.f);
-    std::size_t sampleCount = 0;
+    // Components of the gradient, accumulated separately for the OpenMP reduction
+    double gradient0 = 0, gradient1 = 0, gradient2 = 0, gradient3 = 0, gradient4 = 0, gradient5 = 0;
+    std::int64_t sampleCount = 0;
     double squareErrorSum = 0;
 
-    for (std::size_t y = 0; y < input.getHeight(); ++y) {
-        for (std::size_t x = 0; x < input.getWidth(); ++x) {
-            auto point = glm::vec2(transform * glm::vec3(x, y, 1.f));
+#pragma omp parallel for reduction(+ : gradient0, gradient1, gradient2, gradient3, gradient4, gradient5) \
+    reduction(+ : sampleCount, squareErrorSum)
+    for (std::int64_t y = 0; y < static_cast<std::int64_t>(level.height); ++y) {
+        const float fy = y * scale + center;
+        const std::size_t referenceRow = std::min(y, referenceMaxY) * level.referenceWidth;
 
-            if (point.x < 0 || point.y < 0 || point.x > reference.getWidth() - 1 ||
-                point.y > reference.getHeight() - 1) {
+        // The transform is affine, thus the sample point advances by a constant step along the row
+        auto point = glm::vec2(transform * glm::vec3(center, fy, 1.f));
+        const auto pointStep = transform[0] * scale;
+
+        for (std::int64_t x = 0; x < static_cast<std::int64_t>(level.width); ++x, point += pointStep) {
+            if (point.x < 0 || point.y < 0 || point.x > maxX || point.y > maxY) {
                 continue;
             }
 
-            auto referenceSample = reference.get(x, y) / 255.f;
-            auto inputSample = input.lerp(point) / 255.f;
-            auto derivativeSample = (derivative.lerp(point) - glm::vec2(127.f, 127.f)) / 255.f;
-
-            auto difference = referenceSample - inputSample;
-            squareErrorSum += difference.x * difference.x;
-
-            auto offset = difference.x * 2.f * derivativeSample;
-            sum += glm::mat3x2(x * offset.x, x * offset.y, y * offset.x, y * offset.y, offset.x, offset.y);
+            const auto levelPoint = (point - center) / scale;
+            const auto referenceSample = level.reference[referenceRow + std::min(x, referenceMaxX)];
+            const auto inputSample = lerp(level.input, level.width, level.height, levelPoint);
+            const auto derivativeSample = lerp(level.derivative, level.width, level.height, levelPoint);
+
+            const auto difference = referenceSample - inputSample;
+            squareErrorSum += difference * difference;
+
+            const float fx = x * scale + center;
+            const auto offset = difference * 2.f * derivativeSample;
+            gradient0 += fx * offset.x;
+            gradient1 += fx * offset.y;
+            gradient2 += fy * offset.x;
+            gradient3 += fy * offset.y;
+            gradient4 += offset.x;
+            gradient5 += offset.y;
             sampleCount++;
         }
     }
 
+    // Each sample of a coarse level stands for scale^2 pixels of the full resolution
+    const auto weight = scale * scale;
+    glm::mat3x2 sum(gradient0 * weight, gradient1 * weight, gradient2 * weight, gradient3 * weight,
+        gradient4 * weight, gradient5 * weight);
+
     auto limitVectorLength = [](glm::vec2 vec, float maxLength) {
         float length = glm::length(vec);
         return length > maxLength ? vec / length * maxLength : vec;
@@ -142,6 +307,13 @@ void ImageRegistrator::step() {
         transform += glm::mat3x2(sum[0] * (convergenceRateLinear * biasedAverageMeanSquareError),
             sum[1] * (convergenceRateLinear * biasedAverageMeanSquareError),
             limitVectorLength(sum[2] * (convergenceRateAffine * biasedAverageMeanSquareError), 2.f));
+
+        // Refine once the current level has converged
+        if (currentLevel > 0 && stepsSinceLastImprovement >= LevelPatience) {
+            currentLevel--;
+            biasedAverageMeanSquareError = -1.f;
+            stepsSinceLastImprovement = 0;
+        }
     }
 }
 
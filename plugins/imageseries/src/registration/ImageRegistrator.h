@@ -9,11 +9,19 @@
 #include "imageseries/AsyncImageData2D.h"
 
 #include <glm/mat3x2.hpp>
+#include <glm/vec2.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace megamol::ImageSeries::registration {
 
+/**
+ * Gradient-descent registration of an input image onto a reference image.
+ *
+ * Optimization starts on a coarse level of an image pyramid and moves to the next finer level whenever the error
+ * stops improving. The transform always refers to full-resolution pixel coordinates.
+ */
 class ImageRegistrator {
 public:
     using AsyncImagePtr = std::shared_ptr<const AsyncImageData2D<>>;
@@ -41,12 +49,45 @@ public:
 
     float getMeanSquareError() const;
 
+    /**
+     * Sets the number of pyramid levels, including the full-resolution level. Levels smaller than MinLevelSize are
+     * omitted.
+     */
+    void setPyramidLevels(int levels);
+    int getPyramidLevels() const;
+
+    /**
+     * Answers the pyramid level of the next step, where 0 is the full resolution.
+     */
+    int getCurrentLevel() const;
+
     void reset();
     int getStepsSinceLastImprovement() const;
 
     void step();
 
 private:
+    /// Image data of one pyramid level, as normalized values
+    struct Level {
+        std::size_t width = 0;
+        std::size_t height = 0;
+        std::size_t referenceWidth = 0;
+        std::size_t referenceHeight = 0;
+        int scale = 1;
+
+        std::vector<float> input;
+        std::vector<float> reference;
+        std::vector<glm::vec2> derivative;
+    };
+
+    /// Smallest extent of a coarse pyramid level
+    static constexpr std::size_t MinLevelSize = 32;
+
+    /// Number of steps without improvement before moving to the next finer level
+    static constexpr int LevelPatience = 10;
+
+    bool buildPyramid(ImagePtr referenceData, ImagePtr inputData);
+
     AsyncImagePtr inputImage;
     ImagePtr inputDerivative;
     AsyncImagePtr referenceImage;
@@ -56,6 +97,13 @@ private:
     float meanSquareError = 0.f;
     float biasedAverageMeanSquareError = -1.f;
     int stepsSinceLastImprovement = 0;
+
+    std::vector<Level> pyramid;
+    ImagePtr pyramidReference;
+    ImagePtr pyramidInput;
+    ImagePtr pyramidDerivative;
+    int pyramidLevels = 3;
+    int currentLevel = 0;
 };
 
 } // namespace megamol::ImageSeries::registration
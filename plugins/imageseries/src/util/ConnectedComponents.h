@@ -0,0 +1,273 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <omp.h>
+
+namespace megamol::ImageSeries::util {
+
+/**
+ * Connected-component labelling of 2D images.
+ *
+ * The image is split into tiles that are labelled in parallel with a union-find forest. A second pass merges the
+ * components across tile borders. Every component is rooted at its first pixel in raster order, so components are
+ * numbered in the order a sequential scan would discover them.
+ */
+class ConnectedComponents {
+public:
+    using Index = std::uint32_t;
+
+    /** Component ID of pixels that are not part of any component */
+    static constexpr Index None = std::numeric_limits<Index>::max();
+
+    enum class Connectivity { Four, Eight };
+
+    /**
+     * Labels the connected components of an image.
+     *
+     * @param width        Image width.
+     * @param height       Image height.
+     * @param connectivity Pixel neighbourhood.
+     * @param active       'bool(Index pixel)': whether a pixel belongs to any component.
+     * @param connected    'bool(Index a, Index b)': whether two adjacent active pixels belong to the same component.
+     *                     Must be symmetric. Both functions are called concurrently.
+     *
+     * @return The number of components.
+     */
+    template<typename Active, typename Connected>
+    std::size_t label(Index width, Index height, Connectivity connectivity, Active active, Connected connected) {
+        this->width = width;
+        this->height = height;
+        const std::size_t size = static_cast<std::size_t>(width) * height;
+
+        parent.resize(size);
+        components.resize(size);
+        grouped = false;
+
+        const Index tilesX = (width + TileSize - 1) / TileSize;
+        const Index tilesY = (height + TileSize - 1) / TileSize;
+        const bool diagonal = connectivity == Connectivity::Eight;
+
+        // Label each tile on its own. Unions only link pixels of the same tile, so tiles do not interfere.
+#pragma omp parallel for schedule(dynamic)
+        for (std::int64_t tile = 0; tile < static_cast<std::int64_t>(tilesX) * tilesY; ++tile) {
+            const Index x0 = static_cast<Index>(tile % tilesX) * TileSize;
+            const Index y0 = static_cast<Index>(tile / tilesX) * TileSize;
+            const Index x1 = std::min(x0 + TileSize, width);
+            const Index y1 = std::min(y0 + TileSize, height);
+
+            for (Index y = y0; y < y1; ++y) {
+                for (Index x = x0; x < x1; ++x) {
+                    const Index index = y * width + x;
+                    parent[index] = active(index) ? index : None;
+                    if (parent[index] == None) {
+                        continue;
+                    }
+
+                    // Visit the already processed neighbors within the tile
+                    auto link = [&](Index neighbor) {
+                        if (parent[neighbor] != None && connected(index, neighbor)) {
+                            unite(index, neighbor);
+                        }
+                    };
+                    if (x > x0) {
+                        link(index - 1);
+                    }
+                    if (y > y0) {
+                        link(index - width);
+                        if (diagonal && x > x0) {
+                            link(index - width - 1);
+                        }
+                        if (diagonal && x + 1 < x1) {
+                            link(index - width + 1);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Merge components across tile borders. The borders are a small fraction of the image, thus this is serial.
+        auto link = [&](Index a, Index b) {
+            if (parent[a] != None && parent[b] != None && connected(a, b)) {
+                unite(a, b);
+            }
+        };
+        for (Index tx = 1; tx < tilesX; ++tx) {
+            const Index x = tx * TileSize;
+            for (Index y = 0; y < height; ++y) {
+                const Index index = y * width + x;
+                link(index, index - 1);
+                if (diagonal && y > 0) {
+                    link(index, index - width - 1);
+                }
+                if (diagonal && y + 1 < height) {
+                    link(index, index + width - 1);
+                }
+            }
+        }
+        for (Index ty = 1; ty < tilesY; ++ty) {
+            const Index y = ty * TileSize;
+            for (Index x = 0; x < width; ++x) {
+                const Index index = y * width + x;
+                link(index, index - width);
+                if (diagonal && x > 0 && x % TileSize != 0) {
+                    link(index, index - width - 1);
+                }
+                if (diagonal && x + 1 < width && (x + 1) % TileSize != 0) {
+                    link(index, index - width + 1);
+                }
+            }
+        }
+
+        // Roots are the first pixel of their component, thus numbering them in raster order yields scan order
+        std::size_t count = 0;
+        roots.clear();
+        for (std::size_t index = 0; index < size; ++index) {
+            if (parent[index] == index) {
+                components[index] = static_cast<Index>(count++);
+                roots.push_back(static_cast<Index>(index));
+            }
+        }
+#pragma omp parallel for
+        for (std::int64_t index = 0; index < static_cast<std::int64_t>(size); ++index) {
+            if (parent[index] == None) {
+                components[index] = None;
+            } else if (parent[index] != static_cast<Index>(index)) {
+                components[index] = components[root(static_cast<Index>(index))];
+            }
+        }
+
+        componentCount = count;
+        return count;
+    }
+
+    /**
+     * Answer the component of a pixel, or None.
+     */
+    Index getComponent(Index pixel) const {
+        return components[pixel];
+    }
+
+    /**
+     * Answer the component of all pixels.
+     */
+    const std::vector<Index>& getComponents() const {
+        return components;
+    }
+
+    /**
+     * Answer the first pixel of a component in raster order.
+     */
+    Index getFirstPixel(Index component) const {
+        return roots[component];
+    }
+
+    /**
+     * Answer the number of components found by the last call to label.
+     */
+    std::size_t getComponentCount() const {
+        return componentCount;
+    }
+
+    /**
+     * Sorts the pixels by component, keeping raster order within each component. Required for getPixels and getSize.
+     */
+    void groupPixels() {
+        offsets.assign(componentCount + 1, 0);
+        for (const auto component : components) {
+            if (component != None) {
+                ++offsets[component + 1];
+            }
+        }
+        for (std::size_t component = 0; component < componentCount; ++component) {
+            offsets[component + 1] += offsets[component];
+        }
+
+        pixels.resize(offsets[componentCount]);
+        std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t index = 0; index < components.size(); ++index) {
+            if (components[index] != None) {
+                pixels[fill[components[index]]++] = static_cast<Index>(index);
+            }
+        }
+        grouped = true;
+    }
+
+    /**
+     * Answer the first of the pixels of a component, in raster order. The pixels end at getPixelsEnd.
+     */
+    const Index* getPixels(Index component) const {
+        return pixels.data() + offsets[component];
+    }
+
+    const Index* getPixelsEnd(Index component) const {
+        return pixels.data() + offsets[component + 1];
+    }
+
+    /**
+     * Answer the number of pixels of a component.
+     */
+    std::size_t getSize(Index component) const {
+        return offsets[component + 1] - offsets[component];
+    }
+
+    /**
+     * Answer whether groupPixels has been called since the last labelling.
+     */
+    bool isGrouped() const {
+        return grouped;
+    }
+
+private:
+    static constexpr Index TileSize = 128;
+
+    Index root(Index index) const {
+        while (parent[index] != index) {
+            index = parent[index];
+        }
+        return index;
+    }
+
+    Index find(Index index) {
+        // Path halving
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    }
+
+    void unite(Index a, Index b) {
+        a = find(a);
+        b = find(b);
+        // The smaller index becomes the root, which keeps the first pixel of each component as its root
+        if (a < b) {
+            parent[b] = a;
+        } else if (b < a) {
+            parent[a] = b;
+        }
+    }
+
+    Index width = 0;
+    Index height = 0;
+    std::size_t componentCount = 0;
+    bool grouped = false;
+
+    std::vector<Index> parent;
+    std::vector<Index> components;
+    std::vector<Index> roots;
+    std::vector<std::size_t> offsets;
+    std::vector<Index> pixels;
+};
+
+} // namespace megamol::ImageSeries::util
@@ -0,0 +1,153 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "DecodedImageCache.h"
+
+#include "imageseries/util/ImageUtils.h"
+
+#include "vislib/graphics/BitmapImage.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace megamol::ImageSeries::util {
+
+struct DecodedImageCache::Header {
+    char magic[8] = {'M', 'M', 'I', 'S', 'R', 'A', 'W', '1'};
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceTime = 0;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t channels = 0;
+    std::uint32_t channelType = 0;
+};
+
+DecodedImageCache::DecodedImageCache(std::filesystem::path directory) : directory(std::move(directory)) {
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+}
+
+std::shared_ptr<vislib::graphics::BitmapImage> DecodedImageCache::load(const std::string& source) const {
+    using Image = vislib::graphics::BitmapImage;
+
+    Header expected;
+    if (!getSourceStamp(source, expected)) {
+        return nullptr;
+    }
+
+    std::ifstream file(getEntryPath(source), std::ios::binary);
+    Header header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return nullptr;
+    }
+
+    // Reject foreign files and entries of modified source files
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+        header.sourceSize != expected.sourceSize || header.sourceTime != expected.sourceTime ||
+        header.channels == 0 || header.channelType > Image::ChannelType::CHANNELTYPE_FLOAT) {
+        return nullptr;
+    }
+
+    std::vector<std::uint8_t> labels(header.channels);
+    if (!file.read(reinterpret_cast<char*>(labels.data()), labels.size())) {
+        return nullptr;
+    }
+
+    auto image = std::make_shared<Image>(
+        header.width, header.height, header.channels, static_cast<Image::ChannelType>(header.channelType));
+    for (std::uint32_t channel = 0; channel < header.channels; ++channel) {
+        image->SetChannelLabel(channel, static_cast<Image::ChannelLabel>(labels[channel]));
+    }
+
+    const auto byteSize = static_cast<std::streamsize>(image->Width()) * image->Height() * image->BytesPerPixel();
+    if (!file.read(image->PeekDataAs<char>(), byteSize)) {
+        return nullptr;
+    }
+
+    return image;
+}
+
+bool DecodedImageCache::store(const std::string& source, const vislib::graphics::BitmapImage& image) const {
+    Header header;
+    if (!getSourceStamp(source, header)) {
+        return false;
+    }
+
+    header.width = image.Width();
+    header.height = image.Height();
+    header.channels = image.GetChannelCount();
+    header.channelType = image.GetChannelType();
+
+    std::vector<std::uint8_t> labels(header.channels);
+    for (std::uint32_t channel = 0; channel < header.channels; ++channel) {
+        labels[channel] = static_cast<std::uint8_t>(image.GetChannelLabel(channel));
+    }
+
+    // Write to a temporary file first, such that concurrent readers never observe a partial entry
+    const auto path = getEntryPath(source);
+    std::stringstream suffix;
+    suffix << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+    auto tempPath = path;
+    tempPath += suffix.str();
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        const auto byteSize = static_cast<std::streamsize>(image.Width()) * image.Height() * image.BytesPerPixel();
+        if (!file || !file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !file.write(reinterpret_cast<const char*>(labels.data()), labels.size()) ||
+            !file.write(image.PeekDataAs<char>(), byteSize)) {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+const std::filesystem::path& DecodedImageCache::getDirectory() const {
+    return directory;
+}
+
+std::filesystem::path DecodedImageCache::getEntryPath(const std::string& source) const {
+    // Name entries by a hash of the full source path, which is stable across sessions
+    std::stringstream name;
+    name << std::hex << hashBytes(source.data(), source.size()) << ".raw";
+    return directory / name.str();
+}
+
+bool DecodedImageCache::getSourceStamp(const std::string& source, Header& header) {
+    std::error_code error;
+    const auto path = std::filesystem::u8path(source);
+    const auto size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    const auto time = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+
+    header.sourceSize = size;
+    header.sourceTime = static_cast<std::int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+} // namespace megamol::ImageSeries::util
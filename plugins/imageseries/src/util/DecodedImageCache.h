@@ -0,0 +1,60 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace vislib::graphics {
+class BitmapImage;
+}
+
+namespace megamol::ImageSeries::util {
+
+/**
+ * Persistent cache of decoded images.
+ *
+ * Each image is stored as a raw file, consisting of a small header followed by the pixel data as laid out in memory.
+ * Loading a cached image thus is a single sequential read instead of a decode. Entries are invalidated when the size
+ * or modification time of their source file changes.
+ *
+ * All methods may be called concurrently.
+ */
+class DecodedImageCache {
+public:
+    /**
+     * Creates a cache in the given directory, which is created if it does not exist yet.
+     */
+    explicit DecodedImageCache(std::filesystem::path directory);
+
+    /**
+     * Loads the decoded image of a source file.
+     *
+     * @return The image, or nullptr if there is no up-to-date entry.
+     */
+    std::shared_ptr<vislib::graphics::BitmapImage> load(const std::string& source) const;
+
+    /**
+     * Stores the decoded image of a source file, replacing any previous entry.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool store(const std::string& source, const vislib::graphics::BitmapImage& image) const;
+
+    const std::filesystem::path& getDirectory() const;
+
+private:
+    struct Header;
+
+    std::filesystem::path getEntryPath(const std::string& source) const;
+    static bool getSourceStamp(const std::string& source, Header& header);
+
+    std::filesystem::path directory;
+};
+
+} // namespace megamol::ImageSeries::util
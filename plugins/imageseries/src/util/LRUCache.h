@@ -93,6 +93,10 @@ public:
         return maximumSize;
     }
 
+    std::size_t getTotalSize() const {
+        return totalByteCount;
+    }
+
 private:
     struct Entry {
         std::shared_ptr<const Value> value;
@@ -6,11 +6,12 @@
 
 #include "imageseries/util/WorkerThreadPool.h"
 
-#include <chrono>
 #include <memory>
 #include <mutex>
 #include <utility>
 
+#include "mmcore/utility/sys/TaskScheduler.h"
+
 namespace megamol::ImageSeries::util {
 
 bool Job::JobData::isPending() const {
@@ -105,28 +106,6 @@ Job::Status Job::getStatus() const {
 }
 
 
-WorkerThreadPool::WorkerThreadPool() {
-    startThreads();
-}
-
-WorkerThreadPool::~WorkerThreadPool() {
-    std::unique_lock<std::mutex> lock(controlMutex);
-
-    // Remove all threads
-    stopThreads();
-
-    // Cancel all pending jobs
-    for (auto& job : jobs) {
-        if (job->status != Job::Status::CANCELLED) {
-            {
-                std::unique_lock<std::mutex> lock(job->mutex);
-                job->status = Job::Status::CANCELLED;
-            }
-            job->condition.notify_all();
-        }
-    }
-}
-
 WorkerThreadPool& WorkerThreadPool::getSharedInstance() {
     static WorkerThreadPool pool;
     return pool;
@@ -135,84 +114,31 @@ WorkerThreadPool& WorkerThreadPool::getSharedInstance() {
 Job WorkerThreadPool::submit(Job::Func func) {
     auto jobData = std::make_shared<Job::JobData>();
     jobData->func = std::move(func);
-
-    {
-        std::unique_lock<std::mutex> lock(mutex);
-        jobs.push_back(jobData);
-    }
-
-    conditionQueue.notify_one();
+    core::utility::sys::TaskScheduler::Instance().Enqueue([jobData] { run(jobData); });
     return Job(jobData);
 }
 
-void WorkerThreadPool::setThreadCount(std::size_t count) {
-    std::unique_lock<std::mutex> lock(controlMutex);
-    if (threadCount != count) {
-        stopThreads();
-        threadCount = count;
-        startThreads();
-    }
-}
-
 std::size_t WorkerThreadPool::getThreadCount() const {
-    return threadCount;
+    return core::utility::sys::TaskScheduler::Instance().GetThreadCount();
 }
 
-void WorkerThreadPool::startThreads() {
-    running = true;
-    for (std::size_t i = 0; i < threadCount; ++i) {
-        threads.emplace_back([this] { workerLoop(); });
-    }
-}
-
-void WorkerThreadPool::stopThreads() {
-    running = false;
-    conditionQueue.notify_all();
-    for (auto& thread : threads) {
-        thread.join();
-    }
-    threads.clear();
-}
+void WorkerThreadPool::run(std::shared_ptr<Job::JobData> jobData) {
+    {
+        std::unique_lock<std::mutex> lock(jobData->mutex);
 
-std::shared_ptr<Job::JobData> WorkerThreadPool::awaitWork() {
-    std::unique_lock<std::mutex> lock(mutex);
-    while (running) {
-        if (jobs.empty()) {
-            conditionQueue.wait_for(lock, std::chrono::seconds(1));
-        }
+        // Check/update activity status
+        int status = Job::Status::WAITING;
+        if (jobData->status.compare_exchange_strong(status, Job::Status::ACTIVE)) {
+            // Do work
+            jobData->func();
 
-        if (running && !jobs.empty()) {
-            auto jobData = jobs.front();
-            jobs.pop_front();
-            return jobData;
+            // Indicate completion status
+            jobData->status = Job::Status::DONE;
         }
     }
 
-    return nullptr;
-}
-
-void WorkerThreadPool::workerLoop() {
-    while (running) {
-        auto jobData = awaitWork();
-        if (jobData) {
-            {
-                std::unique_lock<std::mutex> lock(jobData->mutex);
-
-                // Check/update activity status
-                int status = Job::Status::WAITING;
-                if (jobData->status.compare_exchange_strong(status, Job::Status::ACTIVE)) {
-                    // Do work
-                    jobData->func();
-
-                    // Indicate completion status
-                    jobData->status = Job::Status::DONE;
-                }
-            }
-
-            // Notify anyone waiting for job completion
-            jobData->condition.notify_all();
-        }
-    }
+    // Notify anyone waiting for job completion
+    jobData->condition.notify_all();
 }
 
 
@@ -288,12 +288,17 @@ public:
     void setStructureType(structureTypeEnum strtype);
     structureTypeEnum getStructureType();
 
+    /** Optional instances of the API objects, as provided by a MultiParticleDataCall */
+    void setInstanceTransforms(std::shared_ptr<std::vector<geocalls::InstanceTransform> const> transforms);
+    std::shared_ptr<std::vector<geocalls::InstanceTransform> const> getInstanceTransforms();
+
     void resetDirty();
     void setDirty();
     bool isDirty();
 
 private:
     std::vector<void*> api_obj;
+    std::shared_ptr<std::vector<geocalls::InstanceTransform> const> instanceTransforms;
     float timeStamp;
     structureTypeEnum type;
     bool dirtyFlag;
@@ -7,6 +7,7 @@
 
 #pragma once
 #include "ParticleDataAccessCollection.h"
+#include "geometry_calls/MultiParticleDataCall.h"
 #include "mesh/MeshCalls.h"
 #include "mmcore/BoundingBoxes.h"
 #include "mmcore/Call.h"
@@ -99,6 +100,8 @@ struct OSPRayStructureContainer {
 
     std::shared_ptr<OSPRayTransformationContainer> transformationContainer = nullptr;
     bool transformationChanged = false;
+    /** Optional instances of the structure, each one applied after the transformation */
+    std::shared_ptr<std::vector<geocalls::InstanceTransform> const> instanceTransforms = nullptr;
     bool dataChanged;
     bool materialChanged;
     bool parameterChanged;
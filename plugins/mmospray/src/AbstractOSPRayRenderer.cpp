@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <stdio.h>
 
 namespace megamol::ospray {
@@ -474,6 +475,7 @@ void AbstractOSPRayRenderer::clearOSPRayStuff() {
     _groups.clear();
     _instances.clear();
     _materials.clear();
+    _rebuiltStructures.clear();
 }
 
 AbstractOSPRayRenderer::~AbstractOSPRayRenderer() {}
@@ -578,26 +580,33 @@ void AbstractOSPRayRenderer::fillMaterialContainer(
 
 void AbstractOSPRayRenderer::changeMaterial() {
 
-    for (auto entry : this->_structureMap) {
+    for (auto& entry : this->_structureMap) {
         auto const& element = entry.second;
 
+        // structures with new data already got their material in generateRepresentations
+        if (!element.materialChanged || element.dataChanged)
+            continue;
+
         // custom material settings
-        if (this->_materials[entry.first] != NULL) {
-            //ospRelease(this->_materials[entry.first]);
-            this->_materials.erase(entry.first);
-        }
+        this->_materials.erase(entry.first);
         if (element.materialContainer != NULL) {
             fillMaterialContainer(entry.first, element);
             _materials[entry.first].commit();
         }
 
-        if (this->_materials[entry.first] != NULL) {
-            if (element.type == structureTypeEnum::GEOMETRY) {
-                _geometricModels[entry.first].back().setParam(
-                    "material", ::ospray::cpp::CopiedData(_materials[entry.first]));
-                _geometricModels[entry.first].back().commit();
-                _groups[entry.first].setParam("geometry", ::ospray::cpp::CopiedData(_geometricModels[entry.first]));
-                _groups[entry.first].commit();
+        auto const mat = this->_materials.find(entry.first);
+        if (mat != this->_materials.end() && element.type == structureTypeEnum::GEOMETRY &&
+            !_geometricModels[entry.first].empty()) {
+            _geometricModels[entry.first].back().setParam("material", ::ospray::cpp::CopiedData(mat->second));
+            _geometricModels[entry.first].back().commit();
+            _groups[entry.first].setParam("geometry", ::ospray::cpp::CopiedData(_geometricModels[entry.first]));
+            _groups[entry.first].commit();
+            // the instance has to be committed again to pick up the modified group
+            auto const inst = this->_instances.find(entry.first);
+            if (inst != this->_instances.end()) {
+                for (auto& i : inst->second) {
+                    i.commit();
+                }
             }
         }
     }
@@ -605,11 +614,26 @@ void AbstractOSPRayRenderer::changeMaterial() {
 
 void AbstractOSPRayRenderer::changeTransformation() {
 
-    for (auto& entry : this->_baseStructures) {
-        if (this->_structureMap[entry.first].transformationContainer == nullptr)
+    for (auto& entry : this->_structureMap) {
+        auto const& element = entry.second;
+        if (!element.transformationChanged || element.transformationContainer == nullptr)
+            continue;
+        auto const inst = this->_instances.find(entry.first);
+        if (inst == this->_instances.end())
             continue;
-        auto trafo = this->_structureMap[entry.first].transformationContainer;
-        ::rkcommon::math::affine3f xfm;
+        auto const xfms = instanceTransformations(element);
+        for (size_t i = 0; i < inst->second.size() && i < xfms.size(); ++i) {
+            inst->second[i].setParam("xfm", xfms[i]);
+            inst->second[i].commit();
+        }
+    }
+}
+
+std::vector<::rkcommon::math::affine3f> AbstractOSPRayRenderer::instanceTransformations(
+    OSPRayStructureContainer const& element) {
+    ::rkcommon::math::affine3f xfm = ::rkcommon::math::one;
+    if (element.transformationContainer) {
+        auto trafo = element.transformationContainer;
         xfm.p.x = trafo->pos[0];
         xfm.p.y = trafo->pos[1];
         xfm.p.z = trafo->pos[2];
@@ -622,14 +646,26 @@ void AbstractOSPRayRenderer::changeTransformation() {
         xfm.l.vz.x = trafo->MX[2][0];
         xfm.l.vz.y = trafo->MX[2][1];
         xfm.l.vz.z = trafo->MX[2][2];
+    }
 
-        _instances[entry.first].setParam("xfm", xfm);
-        _instances[entry.first].commit();
+    if (element.instanceTransforms == nullptr) {
+        return {xfm};
     }
+
+    std::vector<::rkcommon::math::affine3f> xfms;
+    xfms.reserve(element.instanceTransforms->size());
+    for (auto const& t : *element.instanceTransforms) {
+        auto const& m = t.matrix;
+        ::rkcommon::math::affine3f const inst(::rkcommon::math::vec3f(m[0], m[1], m[2]),
+            ::rkcommon::math::vec3f(m[3], m[4], m[5]), ::rkcommon::math::vec3f(m[6], m[7], m[8]),
+            ::rkcommon::math::vec3f(m[9], m[10], m[11]));
+        xfms.push_back(xfm * inst);
+    }
+    return xfms;
 }
 
 
-bool AbstractOSPRayRenderer::generateRepresentations() {
+bool AbstractOSPRayRenderer::generateRepresentations(bool rebuild_all) {
 
     bool returnValue = true;
 
@@ -643,7 +679,8 @@ bool AbstractOSPRayRenderer::generateRepresentations() {
         auto const& element = entry.second;
 
         // check if structure should be released first
-        if (element.dataChanged) {
+        if (element.dataChanged || rebuild_all) {
+            _rebuiltStructures.insert(entry.first);
             //for (int i = 0; i < _baseStructures[entry.first].size(); ++i) {
             //    if (_baseStructures[entry.first].types[i] == structureTypeEnum::GEOMETRY) {
             //        ospRelease(std::get<::ospray::cpp::Geometry>(_baseStructures[entry.first].structures[i]).handle());
@@ -801,7 +838,10 @@ bool AbstractOSPRayRenderer::generateRepresentations() {
                         if (attrib.semantic == ParticleDataAccessCollection::POSITION) {
                             auto count = attrib.byte_size / attrib.stride;
 
-                            auto vertexData = ::ospray::cpp::CopiedData(attrib.data, OSP_VEC3F, count, attrib.stride);
+                            // the data source keeps the particles alive until its data changes, which triggers a
+                            // rebuild of this geometry, so the positions can be shared like radius and color
+                            auto vertexData = ::ospray::cpp::SharedData(
+                                &attrib.data[attrib.offset], OSP_VEC3F, count, attrib.stride);
                             vertexData.commit();
                             std::get<::ospray::cpp::Geometry>(_baseStructures[entry.first].structures.back())
                                 .setParam("sphere.position", vertexData);
@@ -1322,40 +1362,60 @@ bool AbstractOSPRayRenderer::generateRepresentations() {
     return returnValue;
 }
 
-void AbstractOSPRayRenderer::createInstances() {
+bool AbstractOSPRayRenderer::createInstances() {
+
+    bool instances_changed = false;
+
+    // release everything belonging to structures that disappeared from the structure map
+    for (auto it = _instances.begin(); it != _instances.end();) {
+        if (_structureMap.find(it->first) == _structureMap.end()) {
+            _baseStructures.erase(it->first);
+            _geometricModels.erase(it->first);
+            _volumetricModels.erase(it->first);
+            _clippingModels.erase(it->first);
+            _groups.erase(it->first);
+            _materials.erase(it->first);
+            it = _instances.erase(it);
+            instances_changed = true;
+        } else {
+            ++it;
+        }
+    }
 
     for (auto& entry : this->_structureMap) {
 
+        // unchanged structures keep their instance
+        if (_rebuiltStructures.find(entry.first) == _rebuiltStructures.end() &&
+            _instances.find(entry.first) != _instances.end())
+            continue;
+
         /*if (_instances[entry.first]) {
             ospRelease(_instances[entry.first].handle());
         }*/
         _instances.erase(entry.first);
+        instances_changed = true;
 
         auto const& element = entry.second;
 
-        _instances[entry.first] = ::ospray::cpp::Instance(_groups[entry.first]);
-
-        if (element.transformationContainer) {
-
-            auto trafo = element.transformationContainer;
-            ::rkcommon::math::affine3f xfm;
-            xfm.p.x = trafo->pos[0];
-            xfm.p.y = trafo->pos[1];
-            xfm.p.z = trafo->pos[2];
-            xfm.l.vx.x = trafo->MX[0][0];
-            xfm.l.vx.y = trafo->MX[0][1];
-            xfm.l.vx.z = trafo->MX[0][2];
-            xfm.l.vy.x = trafo->MX[1][0];
-            xfm.l.vy.y = trafo->MX[1][1];
-            xfm.l.vy.z = trafo->MX[1][2];
-            xfm.l.vz.x = trafo->MX[2][0];
-            xfm.l.vz.y = trafo->MX[2][1];
-            xfm.l.vz.z = trafo->MX[2][2];
-
-            _instances[entry.first].setParam("xfm", xfm);
+        // one instance of the group per instance transformation, the geometry itself is shared
+        auto& instances = _instances[entry.first];
+        for (auto const& xfm : instanceTransformations(element)) {
+            instances.emplace_back(_groups[entry.first]);
+            instances.back().setParam("xfm", xfm);
+            instances.back().commit();
         }
+    }
+    _rebuiltStructures.clear();
+
+    return instances_changed;
+}
 
-        _instances[entry.first].commit();
+void AbstractOSPRayRenderer::updateWorldInstances() {
+    std::vector<::ospray::cpp::Instance> instanceArray;
+    instanceArray.reserve(_instances.size());
+    for (auto const& entry : _instances) {
+        instanceArray.insert(instanceArray.end(), entry.second.begin(), entry.second.end());
     }
+    _world->setParam("instance", ::ospray::cpp::CopiedData(instanceArray));
 }
 } // namespace megamol::ospray
@@ -14,6 +14,7 @@
 #include "ospray/ospray_cpp.h"
 #include "ospray/ospray_cpp/ext/rkcommon.h"
 #include <map>
+#include <set>
 #include <stdint.h>
 
 namespace megamol::ospray {
@@ -141,17 +142,35 @@ protected:
 
     /**
      * Reads the structure map and uses its parameteres to
-     * create geometries and volumes.
+     * create geometries and volumes. Only structures that report changed data are rebuilt.
      *
+     * @param rebuild_all Rebuild every structure regardless of its change flag, e.g. after a new world was created.
      */
-    bool generateRepresentations();
+    bool generateRepresentations(bool rebuild_all = false);
 
-    void createInstances();
+    /**
+     * Creates instances for the structures rebuilt by the last call to generateRepresentations and releases all
+     * OSPRay objects of structures that are no longer part of the structure map.
+     *
+     * @return 'true' if the set of instances changed and the instance array of the world must be updated.
+     */
+    bool createInstances();
 
+    /** Recreates the materials of all structures that report a changed material */
     void changeMaterial();
 
+    /** Updates the instance transformation of all structures that report a changed transformation */
     void changeTransformation();
 
+    /** Sets the instance array of the world from the current instances */
+    void updateWorldInstances();
+
+    /**
+     * Answers the instance transformations of a structure, i.e. its transformation combined with each of its
+     * instance transformations.
+     */
+    static std::vector<::rkcommon::math::affine3f> instanceTransformations(OSPRayStructureContainer const& element);
+
     // Call slots
     megamol::core::CallerSlot _lightSlot;
 
@@ -200,9 +219,11 @@ protected:
     std::map<CallOSPRayStructure*, std::vector<::ospray::cpp::GeometricModel>> _clippingModels;
 
     std::map<CallOSPRayStructure*, ::ospray::cpp::Group> _groups;
-    std::map<CallOSPRayStructure*, ::ospray::cpp::Instance> _instances;
+    std::map<CallOSPRayStructure*, std::vector<::ospray::cpp::Instance>> _instances;
     std::map<CallOSPRayStructure*, ::ospray::cpp::Material> _materials;
 
+    // structures rebuilt by generateRepresentations that still need a new instance
+    std::set<CallOSPRayStructure*> _rebuiltStructures;
 
     // Structure map
     OSPRayStrcutrureMap _structureMap;
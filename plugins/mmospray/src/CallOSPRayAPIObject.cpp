@@ -48,6 +48,16 @@ structureTypeEnum megamol::ospray::CallOSPRayAPIObject::getStructureType() {
     return this->type;
 }
 
+void megamol::ospray::CallOSPRayAPIObject::setInstanceTransforms(
+    std::shared_ptr<std::vector<geocalls::InstanceTransform> const> transforms) {
+    this->instanceTransforms = std::move(transforms);
+}
+
+std::shared_ptr<std::vector<megamol::geocalls::InstanceTransform> const>
+megamol::ospray::CallOSPRayAPIObject::getInstanceTransforms() {
+    return this->instanceTransforms;
+}
+
 void megamol::ospray::CallOSPRayAPIObject::resetDirty() {
     this->dirtyFlag = false;
 }
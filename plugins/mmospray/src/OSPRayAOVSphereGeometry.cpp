@@ -360,6 +360,8 @@ bool OSPRayAOVSphereGeometry::getDataCallback(megamol::core::Call& call) {
     }
     os->setStructureType(GEOMETRY);
     os->setAPIObjects(std::move(geo_transfer));
+    // the spheres and their AO volume are uploaded once and instanced by OSPRay
+    os->setInstanceTransforms(cd->GetInstanceTransforms());
 
     return true;
 }
@@ -72,6 +72,7 @@ bool OSPRayAPIStructure::readData(megamol::core::Call& call) {
         return false;
     }
     structureContainer.structure = apis;
+    structureContainer.instanceTransforms = cd->getInstanceTransforms();
 
     return true;
 }
@@ -130,6 +130,8 @@ bool OSPRayPKDGeometry::getDataCallback(megamol::core::Call& call) {
     }
     os->setStructureType(GEOMETRY);
     os->setAPIObjects(std::move(geo_transfer));
+    // the tree is uploaded once and instanced by OSPRay
+    os->setInstanceTransforms(cd->GetInstanceTransforms());
 
     return true;
 }
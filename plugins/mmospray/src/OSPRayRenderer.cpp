@@ -7,15 +7,45 @@
 #include "OSPRayRenderer.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
 #include "mmcore/utility/log/Log.h"
 #include "ospray/ospray_cpp.h"
 #include <chrono>
 
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
 #include <sstream>
 #include <stdint.h>
 
 using namespace megamol::ospray;
 
+namespace {
+
+/** Summarizes the timings of one phase over all recorded frames */
+nlohmann::json phaseStatistics(std::vector<double> values) {
+    nlohmann::json stats;
+    if (values.empty()) {
+        return stats;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (auto const v : values) {
+        sum += v;
+    }
+    auto const mid = values.size() / 2;
+    stats["min"] = values.front();
+    stats["max"] = values.back();
+    stats["mean"] = sum / static_cast<double>(values.size());
+    stats["median"] = (values.size() % 2 == 1) ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+    stats["total"] = sum;
+    return stats;
+}
+
+} // namespace
+
 /*
 ospray::OSPRayRenderer::OSPRaySphereRenderer
 */
@@ -24,6 +54,12 @@ OSPRayRenderer::OSPRayRenderer()
         , _cam()
         , _getStructureSlot("getStructure", "Connects to an OSPRay structure")
         , _enablePickingSlot("enable picking", "")
+        , _benchFramesSlot("benchmark::frames", "Number of frames recorded for a benchmark report (0 disables it)")
+        , _benchWarmupSlot("benchmark::warmup", "Number of frames skipped before recording starts")
+        , _benchReportSlot("benchmark::report", "File the benchmark report is written to (JSON)")
+        , _benchBaselineSlot("benchmark::baseline", "Optional benchmark report the new report is compared against")
+        , _benchToleranceSlot(
+              "benchmark::tolerance", "Relative slowdown of a phase against the baseline that is reported as warning")
 
 {
     this->_getStructureSlot.SetCompatibleCall<CallOSPRayStructureDescription>();
@@ -35,12 +71,27 @@ OSPRayRenderer::OSPRayRenderer()
     _renderer = nullptr;
     _camera = nullptr;
     _world = nullptr;
+    _light_has_changed = false;
 
     _accum_time.count = 0;
     _accum_time.amount = 0;
 
     _enablePickingSlot << new core::param::BoolParam(false);
     MakeSlotAvailable(&_enablePickingSlot);
+
+    _benchFramesSlot << new core::param::IntParam(0, 0);
+    MakeSlotAvailable(&_benchFramesSlot);
+    _benchWarmupSlot << new core::param::IntParam(2, 0);
+    MakeSlotAvailable(&_benchWarmupSlot);
+    _benchReportSlot << new core::param::FilePathParam(
+        "ospray_benchmark.json", core::param::FilePathParam::Flag_File_ToBeCreatedWithRestrExts, {"json"});
+    MakeSlotAvailable(&_benchReportSlot);
+    _benchBaselineSlot << new core::param::FilePathParam(
+        "", core::param::FilePathParam::Flag_File_RestrictExtension, {"json"});
+    MakeSlotAvailable(&_benchBaselineSlot);
+    _benchToleranceSlot << new core::param::FloatParam(0.1f, 0.0f);
+    MakeSlotAvailable(&_benchToleranceSlot);
+    _bench_skipped = 0;
 }
 
 
@@ -202,42 +253,46 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
 
         auto cam_pose = _cam.get<Camera::Pose>();
         std::array<float, 3> eyeDir = {cam_pose.direction.x, cam_pose.direction.y, cam_pose.direction.z};
-        if (_data_has_changed || _frameID != static_cast<size_t>(cr.Time()) || _renderer_has_changed) {
-            // || this->InterfaceIsDirty()) {
-            if (!this->generateRepresentations())
+        // only structures with changed data, material or transformation are touched, everything else keeps its
+        // committed OSPRay objects; a new renderer comes with a new world that has to be filled from scratch
+        bool world_has_changed = false;
+        bool instances_have_changed = false;
+        FrameTimings timings;
+        auto const upload_start = std::chrono::high_resolution_clock::now();
+        if (_data_has_changed || _renderer_has_changed || _structureMap.size() != _instances.size()) {
+            if (!this->generateRepresentations(_renderer_has_changed))
                 return false;
-            this->createInstances();
-            std::vector<::ospray::cpp::Instance> instanceArray;
-            std::transform(_instances.begin(), _instances.end(), std::back_inserter(instanceArray), second(_instances));
-            _world->setParam("instance", ::ospray::cpp::CopiedData(instanceArray));
-
-            // Enable Lights
+            instances_have_changed = this->createInstances() || _renderer_has_changed;
+            world_has_changed = true;
+        }
+        if (_material_has_changed && !_renderer_has_changed) {
+            this->changeMaterial();
+            world_has_changed = true;
+        }
+        if (_transformation_has_changed) {
+            this->changeTransformation();
+            world_has_changed = true;
+        }
+        if (instances_have_changed) {
+            this->updateWorldInstances();
+        }
+        if (_light_has_changed || _renderer_has_changed) {
             this->fillLightArray(eyeDir);
             _world->setParam("light", ::ospray::cpp::CopiedData(_lightArray));
-
+            world_has_changed = true;
+        }
+        auto const upload_end = std::chrono::high_resolution_clock::now();
+        timings.upload = std::chrono::duration<double, std::milli>(upload_end - upload_start).count();
+        if (world_has_changed) {
             // Commiting world and measuring time
             auto t1 = std::chrono::high_resolution_clock::now();
             _world->commit();
             auto t2 = std::chrono::high_resolution_clock::now();
             const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+            timings.commit = std::chrono::duration<double, std::milli>(t2 - t1).count();
             megamol::core::utility::log::Log::DefaultLog.WriteInfo(
                 "[OSPRayRenderer] Commiting World took: %d microseconds", duration);
         }
-        if (_material_has_changed && !_data_has_changed) {
-            this->changeMaterial();
-        }
-        if (_transformation_has_changed || _material_has_changed && !_data_has_changed) {
-            this->changeTransformation();
-            std::vector<::ospray::cpp::Instance> instanceArray;
-            std::transform(_instances.begin(), _instances.end(), std::back_inserter(instanceArray), second(_instances));
-            _world->setParam("instance", ::ospray::cpp::CopiedData(instanceArray));
-            _world->commit();
-        }
-        if (_light_has_changed && !_data_has_changed) {
-            this->fillLightArray(eyeDir);
-            _world->setParam("light", ::ospray::cpp::CopiedData(_lightArray));
-            _world->commit();
-        }
 
 
         this->InterfaceResetDirty();
@@ -283,6 +338,7 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
 
         _framebuffer->clear(); //(OSP_FB_COLOR | OSP_FB_DEPTH | OSP_FB_ACCUM);
         _framebuffer->renderFrame(*_renderer, *_camera, *_world);
+        auto const render_end = std::chrono::high_resolution_clock::now();
 
         // get the texture from the framebuffer
         auto fb = reinterpret_cast<uint32_t*>(_framebuffer->map(OSP_FB_COLOR));
@@ -290,6 +346,9 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
 
         auto t2 = std::chrono::high_resolution_clock::now();
         const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1);
+        timings.render = std::chrono::duration<double, std::milli>(render_end - t1).count();
+        timings.readback = std::chrono::duration<double, std::milli>(t2 - render_end).count();
+        this->recordBenchmarkFrame(timings);
 
         _accum_time.amount += duration.count();
         _accum_time.count += 1;
@@ -342,6 +401,7 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
         auto t1 = std::chrono::high_resolution_clock::now();
 
         _framebuffer->renderFrame(*_renderer, *_camera, *_world);
+        auto const render_end = std::chrono::high_resolution_clock::now();
         auto fb = reinterpret_cast<uint32_t*>(_framebuffer->map(OSP_FB_COLOR));
         _fb = std::vector<uint32_t>(fb, fb + _imgSize[0] * _imgSize[1]);
 
@@ -356,6 +416,12 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
         auto t2 = std::chrono::high_resolution_clock::now();
         const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1);
 
+        // accumulation frames neither upload nor commit anything
+        FrameTimings timings;
+        timings.render = std::chrono::duration<double, std::milli>(render_end - t1).count();
+        timings.readback = std::chrono::duration<double, std::milli>(t2 - render_end).count();
+        this->recordBenchmarkFrame(timings);
+
         _accum_time.amount += duration.count();
         _accum_time.count += 1;
         if (_accum_time.amount >= static_cast<unsigned long long int>(1e6)) {
@@ -539,3 +605,116 @@ void OSPRayRenderer::getOpenGLDepthFromOSPPerspective(std::vector<float>& db) {
     // unmap OSPRay depth buffer
     _framebuffer->unmap(ospDepthBuffer);
 }
+
+void OSPRayRenderer::recordBenchmarkFrame(FrameTimings const& timings) {
+    // changing the benchmark setup restarts the recording
+    if (_benchFramesSlot.IsDirty() || _benchWarmupSlot.IsDirty()) {
+        _benchFramesSlot.ResetDirty();
+        _benchWarmupSlot.ResetDirty();
+        _bench_samples.clear();
+        _bench_skipped = 0;
+    }
+
+    auto const frames = static_cast<size_t>(_benchFramesSlot.Param<core::param::IntParam>()->Value());
+    if (frames == 0 || _bench_samples.size() >= frames) {
+        return;
+    }
+    if (_bench_skipped < _benchWarmupSlot.Param<core::param::IntParam>()->Value()) {
+        ++_bench_skipped;
+        return;
+    }
+
+    _bench_samples.push_back(timings);
+    if (_bench_samples.size() == frames) {
+        this->writeBenchmarkReport();
+    }
+}
+
+bool OSPRayRenderer::writeBenchmarkReport() {
+    using megamol::core::utility::log::Log;
+
+    std::vector<double> upload, commit, render, readback;
+    nlohmann::json samples = nlohmann::json::array();
+    for (auto const& t : _bench_samples) {
+        upload.push_back(t.upload);
+        commit.push_back(t.commit);
+        render.push_back(t.render);
+        readback.push_back(t.readback);
+        samples.push_back({{"upload", t.upload}, {"commit", t.commit}, {"render", t.render}, {"readback", t.readback}});
+    }
+
+    size_t num_geometries = 0;
+    size_t num_volumes = 0;
+    for (auto const& entry : _geometricModels) {
+        num_geometries += entry.second.size();
+    }
+    for (auto const& entry : _volumetricModels) {
+        num_volumes += entry.second.size();
+    }
+
+    nlohmann::json report;
+    report["renderer"] = _rd_type_string;
+    report["image_size"] = {_imgSize[0], _imgSize[1]};
+    report["samples_per_pixel"] = _rd_spp.Param<core::param::IntParam>()->Value();
+    report["accumulate"] = _accumulateSlot.Param<core::param::BoolParam>()->Value();
+    report["structures"] = _structureMap.size();
+    report["geometries"] = num_geometries;
+    report["volumes"] = num_volumes;
+    report["warmup"] = _bench_skipped;
+    report["frames"] = _bench_samples.size();
+    report["phases"]["upload"] = phaseStatistics(upload);
+    report["phases"]["commit"] = phaseStatistics(commit);
+    report["phases"]["render"] = phaseStatistics(render);
+    report["phases"]["readback"] = phaseStatistics(readback);
+    report["samples"] = samples;
+
+    auto const filename = _benchReportSlot.Param<core::param::FilePathParam>()->Value();
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        Log::DefaultLog.WriteError("[OSPRayRenderer] Cannot write benchmark report \"%s\"", filename.string().c_str());
+        return false;
+    }
+    file << report.dump(2);
+    file.close();
+    Log::DefaultLog.WriteInfo("[OSPRayRenderer] Benchmark of %zu frames written to \"%s\"", _bench_samples.size(),
+        filename.string().c_str());
+
+    auto const baseline_filename = _benchBaselineSlot.Param<core::param::FilePathParam>()->Value();
+    if (baseline_filename.empty()) {
+        return true;
+    }
+    nlohmann::json baseline;
+    try {
+        std::ifstream baseline_file(baseline_filename);
+        baseline_file >> baseline;
+    } catch (nlohmann::json::exception const& e) {
+        Log::DefaultLog.WriteError("[OSPRayRenderer] Cannot read benchmark baseline \"%s\": %s",
+            baseline_filename.string().c_str(), e.what());
+        return false;
+    }
+
+    // compare the mean time of each phase, phases that take almost no time are too noisy to be judged
+    auto const tolerance = _benchToleranceSlot.Param<core::param::FloatParam>()->Value();
+    for (auto const& phase : {"upload", "commit", "render", "readback"}) {
+        auto const base = baseline.value("phases", nlohmann::json::object()).value(phase, nlohmann::json::object());
+        if (!base.contains("mean")) {
+            continue;
+        }
+        auto const base_mean = base["mean"].get<double>();
+        auto const mean = report["phases"][phase]["mean"].get<double>();
+        if (base_mean < 1e-3) {
+            continue;
+        }
+        auto const ratio = mean / base_mean;
+        if (ratio > 1.0 + tolerance) {
+            Log::DefaultLog.WriteWarn(
+                "[OSPRayRenderer] Benchmark phase %s: %.3f ms vs. %.3f ms baseline (%.1f%% slower)", phase, mean,
+                base_mean, (ratio - 1.0) * 100.0);
+        } else {
+            Log::DefaultLog.WriteInfo("[OSPRayRenderer] Benchmark phase %s: %.3f ms vs. %.3f ms baseline (%.2fx)",
+                phase, mean, base_mean, ratio);
+        }
+    }
+
+    return true;
+}
@@ -86,11 +86,45 @@ private:
 
     bool OnMouseMove(double x, double y) override;
 
+    /** Wall clock times of the phases of one frame in milliseconds */
+    struct FrameTimings {
+        double upload = 0.0;
+        double commit = 0.0;
+        double render = 0.0;
+        double readback = 0.0;
+    };
+
+    /**
+     * Adds the timings of a frame to the benchmark record and writes the report once enough frames are recorded.
+     *
+     * @param timings The phase timings of the frame.
+     */
+    void recordBenchmarkFrame(FrameTimings const& timings);
+
+    /**
+     * Writes the recorded frames as JSON report and compares it against the baseline report, if one is set.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool writeBenchmarkReport();
+
     /** The call for data */
     core::CallerSlot _getStructureSlot;
 
     core::param::ParamSlot _enablePickingSlot;
 
+    /** Benchmark parameters */
+    core::param::ParamSlot _benchFramesSlot;
+    core::param::ParamSlot _benchWarmupSlot;
+    core::param::ParamSlot _benchReportSlot;
+    core::param::ParamSlot _benchBaselineSlot;
+    core::param::ParamSlot _benchToleranceSlot;
+
+    /** Timings of the recorded benchmark frames */
+    std::vector<FrameTimings> _bench_samples;
+    /** Number of warmup frames skipped so far */
+    int _bench_skipped;
+
 
     // Interface dirty flag
     bool InterfaceIsDirty();
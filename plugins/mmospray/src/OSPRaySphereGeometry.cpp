@@ -135,6 +135,9 @@ bool OSPRaySphereGeometry::readData(megamol::core::Call& call) {
 
     this->structureContainer.structure = ss;
 
+    // the spheres are uploaded once and instanced by OSPRay
+    this->structureContainer.instanceTransforms = cd->GetInstanceTransforms();
+
     return true;
 }
 
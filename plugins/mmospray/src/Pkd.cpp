@@ -4,29 +4,127 @@
  */
 
 #include "Pkd.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <stdint.h>
-#include <thread>
 
-#define POS(idx, dim) pos(idx, dim)
+#include <omp.h>
+
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/utility/log/Log.h"
 
 using namespace megamol;
 
+namespace {
+
+constexpr char pkdCacheMagic[8] = {'M', 'M', 'P', 'K', 'D', 'C', '0', '1'};
+
+/** Hash of the particle data, independent of the number of threads */
+uint64_t hashModel(const std::vector<rkcommon::math::vec4f>& position) {
+    constexpr size_t chunkSize = 1 << 20;
+    const auto data = reinterpret_cast<const uint32_t*>(position.data());
+    const size_t numWords = position.size() * 4;
+    const int64_t numChunks = static_cast<int64_t>((numWords + chunkSize - 1) / chunkSize);
+    std::vector<uint64_t> chunkHashes(numChunks);
+#pragma omp parallel for
+    for (int64_t c = 0; c < numChunks; ++c) {
+        uint64_t h = 14695981039346656037ULL;
+        const size_t end = std::min(numWords, (c + 1) * chunkSize);
+        for (size_t i = c * chunkSize; i < end; ++i) {
+            h = (h ^ data[i]) * 1099511628211ULL;
+        }
+        chunkHashes[c] = h;
+    }
+    uint64_t h = 14695981039346656037ULL ^ position.size();
+    for (const auto ch : chunkHashes) {
+        h = (h ^ ch) * 1099511628211ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+bool loadCache(const std::filesystem::path& file, uint64_t hash, std::vector<rkcommon::math::vec4f>& position) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    char magic[8];
+    uint64_t count = 0, fileHash = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    in.read(reinterpret_cast<char*>(&fileHash), sizeof(fileHash));
+    if (!in || !std::equal(magic, magic + 8, pkdCacheMagic) || count != position.size() || fileHash != hash) {
+        return false;
+    }
+    std::vector<rkcommon::math::vec4f> cached(count);
+    in.read(reinterpret_cast<char*>(cached.data()), count * sizeof(rkcommon::math::vec4f));
+    if (!in) {
+        return false;
+    }
+    position.swap(cached);
+    return true;
+}
+
+void storeCache(const std::filesystem::path& file, uint64_t hash, const std::vector<rkcommon::math::vec4f>& position) {
+    // write to a temporary file first, so an interrupted write never leaves a valid looking cache file behind
+    auto tmp = file;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        const uint64_t count = position.size();
+        out.write(pkdCacheMagic, sizeof(pkdCacheMagic));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+        out.write(reinterpret_cast<const char*>(position.data()), count * sizeof(rkcommon::math::vec4f));
+        if (!out) {
+            core::utility::log::Log::DefaultLog.WriteWarn(
+                "[PkdBuilder] Could not write cache file \"%s\"", tmp.string().c_str());
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, file, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+    }
+}
+
+} // namespace
+
 
 ospray::PkdBuilder::PkdBuilder()
         : megamol::datatools::AbstractParticleManipulator("outData", "inData")
+        , cacheDirSlot("cacheDirectory", "Directory for PKD-sorted lists, which are reused for identical input")
         , inDataHash(std::numeric_limits<size_t>::max())
         , outDataHash(0)
+        , frameID(std::numeric_limits<unsigned int>::max())
 /*, numParticles(0)
 , numInnerNodes(0)*/
 {
     //model = std::make_shared<ParticleModel>();
+    cacheDirSlot << new core::param::FilePathParam("", core::param::FilePathParam::Flag_Directory_ToBeCreated);
+    MakeSlotAvailable(&cacheDirSlot);
 }
 
 ospray::PkdBuilder::~PkdBuilder() {
     Release();
 }
 
+std::filesystem::path ospray::PkdBuilder::cacheFile(uint64_t hash) {
+    const auto dir = cacheDirSlot.Param<core::param::FilePathParam>()->Value();
+    if (dir.empty()) {
+        return {};
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    char name[32];
+    snprintf(name, sizeof(name), "pkd_%016llx.bin", static_cast<unsigned long long>(hash));
+    return dir / name;
+}
+
 bool ospray::PkdBuilder::manipulateData(
     geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
 
@@ -48,15 +146,36 @@ bool ospray::PkdBuilder::manipulateData(
             models[i].position.clear();
 
             // put data the data into the model
-            // and build the pkd tree
+            // and build the pkd tree, unless an identical list has already been built
             // this->model->fill(parts);
             models[i].fill(parts);
-            // this->build();
-            Pkd pkd;
-            pkd.model = &models[i];
-            pkd.build();
+            if (!models[i].position.empty()) {
+                const auto start = std::chrono::high_resolution_clock::now();
+                const auto hash = hashModel(models[i].position);
+                const auto file = cacheFile(hash);
+                if (file.empty() || !loadCache(file, hash, models[i].position)) {
+                    // this->build();
+                    Pkd pkd;
+                    pkd.model = &models[i];
+                    pkd.build();
+                    if (!file.empty()) {
+                        storeCache(file, hash, models[i].position);
+                    }
+                    const auto duration = std::chrono::duration<double, std::milli>(
+                        std::chrono::high_resolution_clock::now() - start);
+                    core::utility::log::Log::DefaultLog.WriteInfo("[PkdBuilder] Built PKD of list %u (%zu particles) "
+                                                                  "in %.2f ms",
+                        i, models[i].position.size(), duration.count());
+                } else {
+                    core::utility::log::Log::DefaultLog.WriteInfo(
+                        "[PkdBuilder] Loaded PKD of list %u from \"%s\"", i, file.string().c_str());
+                }
+            }
 
-            out.SetCount(parts.GetCount());
+            out.SetCount(models[i].position.size());
+            if (models[i].position.empty()) {
+                continue;
+            }
             out.SetVertexData(
                 megamol::geocalls::SimpleSphericalParticles::VERTDATA_FLOAT_XYZ, &models[i].position[0].x, 16);
             out.SetColourData(
@@ -71,11 +190,10 @@ bool ospray::PkdBuilder::manipulateData(
 }
 
 
-void ospray::Pkd::setDim(size_t ID, int dim) const {
+void ospray::Pkd::setDim(rkcommon::math::vec4f& particle, int dim) {
 #if DIM_FROM_DEPTH
     return;
 #else
-    rkcommon::math::vec3f& particle = (rkcommon::math::vec3f&)this->model->position[ID];
     int& pxAsInt = (int&)particle.x;
     pxAsInt = (pxAsInt & ~3) | dim;
 #endif
@@ -96,8 +214,15 @@ inline size_t ospray::Pkd::maxDim(const rkcommon::math::vec3f& v) const {
 }
 
 
-inline void ospray::Pkd::swap(const size_t a, const size_t b) const {
-    std::swap(model->position[a], model->position[b]);
+size_t ospray::Pkd::subtreeSize(size_t nodeID) const {
+    size_t size = 0;
+    size_t width = 1;
+    while (isValidNode(nodeID)) {
+        size += std::min(width, numParticles - nodeID);
+        nodeID = leftChildOf(nodeID);
+        width += width;
+    }
+    return size;
 }
 
 
@@ -110,15 +235,6 @@ void ospray::Pkd::build() {
     numParticles = model->position.size();
     assert(numParticles <= (1ULL << 31));
 
-#if 0
-    cout << "#osp:pkd: TEST: RANDOMIZING PARTICLES" << endl;
-    for (size_t i = numParticles - 1; i>0; --i) {
-        size_t j = size_t(drand48()*i);
-        if (i != j) swap(i, j);
-    }
-    cout << "#osp:pkd: RANDOMIZED" << endl;
-#endif
-
     numInnerNodes = numInnerNodesOf(numParticles);
 
     // determine num levels
@@ -130,123 +246,73 @@ void ospray::Pkd::build() {
     }
     // PRINT(numLevels);
 
-    const rkcommon::math::box3f& bounds = model->getBounds();
-    /*std::cout << "#osp:pkd: bounds of model " << bounds << std::endl;
-    std::cout << "#osp:pkd: number of input particles " << numParticles << std::endl;*/
-    this->buildRec(0, bounds, 0);
+    // The tree is built top-down from the particles in the model as working array. Each subtree owns a contiguous
+    // range of it, which is partitioned around its median; the median becomes the root of the subtree and is
+    // written to its heap position in 'tree'. Subtrees are independent, so the upper levels are built one level at
+    // a time with all nodes of a level in parallel, until there are enough subtrees to keep all threads busy. These
+    // are then built as independent tasks.
+    std::vector<rkcommon::math::vec4f> tree(numParticles);
+    std::vector<BuildJob> jobs = {{0, 0, model->getBounds()}};
+    const size_t minJobs = 4 * static_cast<size_t>(omp_get_max_threads());
+    while (!jobs.empty() && jobs.size() < minJobs) {
+        std::vector<BuildJob> children(2 * jobs.size());
+        std::vector<int> numChildren(jobs.size());
+#pragma omp parallel for
+        for (int64_t j = 0; j < static_cast<int64_t>(jobs.size()); ++j) {
+            numChildren[j] = buildNode(jobs[j], tree, &children[2 * j]);
+        }
+        jobs.clear();
+        for (size_t j = 0; j < numChildren.size(); ++j) {
+            jobs.insert(jobs.end(), children.begin() + 2 * j, children.begin() + 2 * j + numChildren[j]);
+        }
+    }
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t j = 0; j < static_cast<int64_t>(jobs.size()); ++j) {
+        buildRec(jobs[j], tree);
+    }
+
+    model->position.swap(tree);
 }
 
 
-void ospray::Pkd::buildRec(const size_t nodeID, const rkcommon::math::box3f& bounds, const size_t depth) const {
-    // if (depth < 4)
-    // std::cout << "#osp:pkd: building subtree " << nodeID << std::endl;
-    if (!hasLeftChild(nodeID))
+int ospray::Pkd::buildNode(const BuildJob& job, std::vector<rkcommon::math::vec4f>& tree, BuildJob* children) const {
+    auto& position = model->position;
+    const size_t n = subtreeSize(job.nodeID);
+    if (n == 1) {
         // has no children -> it's a valid kd-tree already :-)
-        return;
-
-    // we have at least one child.
-    const size_t dim = this->maxDim(bounds.size());
-    // if (depth < 4) { PRINT(bounds); printf("depth %ld-> dim %ld\n",depth,dim); }
-    const size_t N = numParticles;
-
-    if (!hasRightChild(nodeID)) {
-        // no right child, but not a leaf emtpy. must have exactly one
-        // child on the left. see if we have to swap, but otherwise
-        // nothing to do.
-        size_t lChild = leftChildOf(nodeID);
-        if (POS(lChild, dim) > POS(nodeID, dim))
-            swap(nodeID, lChild);
-        // and done
-        setDim(nodeID, dim);
-        return;
+        tree[job.nodeID] = position[job.begin];
+        return 0;
     }
 
-    {
+    // the left subtree takes the 'numLeft' smallest particles along the split dimension, so the median particle at
+    // 'begin + numLeft' separates the subtrees
+    const size_t dim = this->maxDim(job.bounds.size());
+    const size_t numLeft = subtreeSize(leftChildOf(job.nodeID));
+    const auto first = position.begin() + job.begin;
+    std::nth_element(first, first + numLeft, first + n,
+        [dim](const rkcommon::math::vec4f& a, const rkcommon::math::vec4f& b) { return a[dim] < b[dim]; });
 
-        // we have a left and a right subtree, each of at least 1 node.
-        SubtreeIterator l0(leftChildOf(nodeID));
-        SubtreeIterator r0(rightChildOf(nodeID));
-
-        SubtreeIterator l((size_t)l0); //(leftChildOf(nodeID));
-        SubtreeIterator r((size_t)r0); //(rightChildOf(nodeID));
-
-        // size_t numSwaps = 0, numComps = 0;
-        float rootPos = POS(nodeID, dim);
-        while (1) {
-
-            while (isValidNode(l, N) && (POS(l, dim) <= rootPos))
-                ++l;
-            while (isValidNode(r, N) && (POS(r, dim) >= rootPos))
-                ++r;
-
-            if (isValidNode(l, N)) {
-                if (isValidNode(r, N)) {
-                    // both mis-mathces valid, just swap them and go on
-                    swap(l, r);
-                    ++l;
-                    ++r;
-                    continue;
-                } else {
-                    // mis-match on left side, but nothing on right side to swap with: swap with root
-                    // --> can't go on on right side any more, but can still compact matches on left
-                    l0 = l;
-                    ++l;
-                    while (isValidNode(l, N)) {
-                        if (POS(l, dim) <= rootPos) {
-                            swap(l0, l);
-                            ++l0;
-                        }
-                        ++l;
-                    }
-                    swap(nodeID, l0);
-                    ++l0;
-                    rootPos = POS(nodeID, dim);
+    auto& root = tree[job.nodeID];
+    root = position[job.begin + numLeft];
+    setDim(root, dim);
 
-                    l = l0;
-                    r = r0;
-                    continue;
-                }
-            } else {
-                if (isValidNode(r, N)) {
-                    // mis-match on left side, but nothing on right side to swap with: swap with root
-                    // --> can't go on on right side any more, but can still compact matches on left
-                    r0 = r;
-                    ++r;
-                    while (isValidNode(r, N)) {
-                        if (POS(r, dim) >= rootPos) {
-                            swap(r0, r);
-                            ++r0;
-                        }
-                        ++r;
-                    }
-                    swap(nodeID, r0);
-                    ++r0;
-                    rootPos = POS(nodeID, dim);
+    rkcommon::math::box3f lBounds = job.bounds;
+    rkcommon::math::box3f rBounds = job.bounds;
+    lBounds.upper[dim] = rBounds.lower[dim] = root[dim];
 
-                    l = l0;
-                    r = r0;
-                    continue;
-                } else {
-                    // no mis-match on either side ... done.
-                    break;
-                }
-            }
-        }
+    children[0] = {leftChildOf(job.nodeID), job.begin, lBounds};
+    if (!hasRightChild(job.nodeID)) {
+        return 1;
     }
+    children[1] = {rightChildOf(job.nodeID), job.begin + numLeft + 1, rBounds};
+    return 2;
+}
 
-    rkcommon::math::box3f lBounds = bounds;
-    rkcommon::math::box3f rBounds = bounds;
-
-    setDim(nodeID, dim);
-
-    lBounds.upper[dim] = rBounds.lower[dim] = pos(nodeID, dim);
 
-    if ((numLevels - depth) > 20) {
-        std::thread lThread(&pkdBuildThread, new PKDBuildJob(this, leftChildOf(nodeID), lBounds, depth + 1));
-        buildRec(rightChildOf(nodeID), rBounds, depth + 1);
-        lThread.join();
-    } else {
-        buildRec(leftChildOf(nodeID), lBounds, depth + 1);
-        buildRec(rightChildOf(nodeID), rBounds, depth + 1);
+void ospray::Pkd::buildRec(const BuildJob& job, std::vector<rkcommon::math::vec4f>& tree) const {
+    BuildJob children[2];
+    const int numChildren = buildNode(job, tree, children);
+    for (int c = 0; c < numChildren; ++c) {
+        buildRec(children[c], tree);
     }
 }
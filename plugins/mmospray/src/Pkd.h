@@ -8,8 +8,10 @@
 #include "datatools/AbstractParticleManipulator.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CallerSlot.h"
+#include "mmcore/param/ParamSlot.h"
 #include "rkcommon/math/box.h"
 #include "rkcommon/math/vec.h"
+#include <filesystem>
 #include <map>
 
 
@@ -48,6 +50,12 @@ protected:
     bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
 
 private:
+    /** Answer the cache file of a model with the given content hash, or an empty path if caching is disabled */
+    std::filesystem::path cacheFile(uint64_t hash);
+
+    /** Directory holding the PKD-sorted lists, keyed by the hash of their input */
+    core::param::ParamSlot cacheDirSlot;
+
     size_t inDataHash;
     size_t outDataHash;
     unsigned int frameID;
@@ -89,65 +97,27 @@ struct Pkd {
         return model->position[nodeID][dim];
     }
 
-    //! helper function for building - swap two particles in the model
-    inline void swap(const size_t a, const size_t b) const;
+    //! a subtree to be built from the particles in [begin, begin + subtreeSize(nodeID)) of the working array
+    struct BuildJob {
+        size_t nodeID;
+        size_t begin;
+        rkcommon::math::box3f bounds;
+    };
 
     // save the given particle's split dimension
-    void setDim(size_t ID, int dim) const;
+    static void setDim(rkcommon::math::vec4f& particle, int dim);
     inline size_t maxDim(const rkcommon::math::vec3f& v) const;
 
+    //! number of valid nodes in the subtree below 'nodeID'
+    size_t subtreeSize(size_t nodeID) const;
+
     //! build particle tree over given model. WILL REORDER THE MODEL'S ELEMENTS
     void build();
 
-    void buildRec(const size_t nodeID, const rkcommon::math::box3f& bounds, const size_t depth) const;
-};
-
-
-struct SubtreeIterator {
-    size_t curInLevel;
-    size_t maxInLevel;
-    size_t current;
-
-    __forceinline SubtreeIterator(size_t root) : curInLevel(0), maxInLevel(1), current(root) {}
-
-    __forceinline operator size_t() const {
-        return current;
-    }
-
-    __forceinline void operator++() {
-        ++current;
-        ++curInLevel;
-        if (curInLevel == maxInLevel) {
-            current = leftChildOf(current - maxInLevel);
-            maxInLevel += maxInLevel;
-            curInLevel = 0;
-        }
-    }
-
-    __forceinline SubtreeIterator& operator=(const SubtreeIterator& other) {
-        curInLevel = other.curInLevel;
-        maxInLevel = other.maxInLevel;
-        current = other.current;
-        return *this;
-    }
-};
+    //! places the root of 'job' into 'tree' and answers the number of child jobs written to 'children'
+    int buildNode(const BuildJob& job, std::vector<rkcommon::math::vec4f>& tree, BuildJob* children) const;
 
-struct PKDBuildJob {
-    const Pkd* const pkd;
-    const size_t nodeID;
-    const rkcommon::math::box3f bounds;
-    const size_t depth;
-    __forceinline PKDBuildJob(const Pkd* pkd, size_t nodeID, rkcommon::math::box3f bounds, size_t depth)
-            : pkd(pkd)
-            , nodeID(nodeID)
-            , bounds(bounds)
-            , depth(depth){};
+    void buildRec(const BuildJob& job, std::vector<rkcommon::math::vec4f>& tree) const;
 };
 
-static void pkdBuildThread(void* arg) {
-    PKDBuildJob* job = (PKDBuildJob*)arg;
-    job->pkd->buildRec(job->nodeID, job->bounds, job->depth);
-    delete job;
-}
-
 } // namespace megamol::ospray
@@ -61,42 +61,23 @@ rkcommon::math::box3f ospray::ParticleModel::getBounds() const {
 void megamol::ospray::ParticleModel::fill(geocalls::SimpleSphericalParticles parts) {
     // Attribute rgba("rgba");
 
-    size_t vertexLength;
-    size_t colorLength;
-
-    // Vertex data type check
-    if (parts.GetVertexDataType() == geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZ) {
-        vertexLength = 3;
-    } else if (parts.GetVertexDataType() == geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZR) {
-        vertexLength = 4;
-    }
-
-    auto const& parStore = parts.GetParticleStore();
-    auto const& xAcc = parStore.GetXAcc();
-    auto const& yAcc = parStore.GetYAcc();
-    auto const& zAcc = parStore.GetZAcc();
-    auto const& rAcc = parStore.GetCRAcc();
-    auto const& gAcc = parStore.GetCGAcc();
-    auto const& bAcc = parStore.GetCBAcc();
-    auto const& aAcc = parStore.GetCAAcc();
-
-    for (size_t loop = 0; loop < parts.GetCount(); ++loop) {
-
-        rkcommon::math::vec3f pos;
-
-        pos.x = xAcc->Get_f(loop);
-        pos.y = yAcc->Get_f(loop);
-        pos.z = zAcc->Get_f(loop);
-
-        rkcommon::math::vec4uc col;
-
-        col.x = rAcc->Get_u8(loop);
-        col.y = gAcc->Get_u8(loop);
-        col.z = bAcc->Get_u8(loop);
-        col.w = aAcc->Get_u8(loop);
-
-        float const color = encodeColorToFloat(col);
-
-        this->position.emplace_back(pos, color);
-    }
+    auto const count = static_cast<int64_t>(parts.GetCount());
+    auto const offset = this->position.size();
+    this->position.resize(offset + count);
+    auto const out = this->position.data() + offset;
+
+    parts.DispatchTyped([this, out, count](auto const& xAcc, auto const& yAcc, auto const& zAcc, auto const& /*rad*/,
+                            auto const& rAcc, auto const& gAcc, auto const& bAcc, auto const& aAcc) {
+#pragma omp parallel for
+        for (int64_t loop = 0; loop < count; ++loop) {
+            rkcommon::math::vec3f const pos(
+                xAcc.template Get<float>(loop), yAcc.template Get<float>(loop), zAcc.template Get<float>(loop));
+
+            rkcommon::math::vec4uc const col(rAcc.template Get<unsigned char>(loop),
+                gAcc.template Get<unsigned char>(loop), bAcc.template Get<unsigned char>(loop),
+                aAcc.template Get<unsigned char>(loop));
+
+            out[loop] = rkcommon::math::vec4f(pos, encodeColorToFloat(col));
+        }
+    });
 }
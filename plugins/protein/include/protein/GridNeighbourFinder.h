@@ -9,161 +9,278 @@
 #pragma once
 
 #include "mmcore/utility/log/Log.h"
-#include "vislib/ArrayAllocator.h"
-#include "vislib/SmartPtr.h"
+#include "vislib/Array.h"
 #include "vislib/math/Cuboid.h"
-#include "vislib/math/ShallowPoint.h"
 #include "vislib/math/mathfunctions.h"
 #include "vislib/types.h"
-#include <ctime>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 using namespace megamol;
 
 /**
  * Simple nearest-neighbour-search implementation which uses a regular grid to speed up search queries.
+ *
+ * The grid is stored as a cell list built by a counting sort: all points are sorted by their cell index and each
+ * cell is represented by a range within the sorted point arrays. Since the cells of one grid row are consecutive
+ * in memory, the search for neighbours within a row of cells is a single linear scan over contiguous positions.
  */
 namespace megamol::protein {
 template<class T /*, unigned int Dim> als template parameter?!*/>
 class GridNeighbourFinder {
-    typedef vislib::math::Point<T, 3> Point;
-
 public:
-    GridNeighbourFinder() : elementGrid(0), elementCount(0), elementPositions(0) {}
-
-    ~GridNeighbourFinder() {
-        delete[] elementGrid;
+    GridNeighbourFinder() : elementCount(0), elementPositions(nullptr), gridSize(0) {
+        for (int i = 0; i < 3; i++) {
+            this->gridResolution[i] = 0;
+            this->gridResolutionFactors[i] = static_cast<T>(0);
+            this->cellSize[i] = static_cast<T>(0);
+            this->elementOrigin[i] = static_cast<T>(0);
+        }
     }
 
+    ~GridNeighbourFinder() = default;
+
     /**
      * Set new point data to the neighbourhood search grid.
-     * @params TODO
+     *
+     * @param pointData      The positions of the points stored as triples (xyzxyz...). The pointer must stay valid
+     *                       as long as the finder is used.
+     * @param pointCount     The number of points in 'pointData'.
+     * @param boundingBox    The bounding box of all points. Points outside are clamped to the border cells.
+     * @param searchDistance The typical search distance used to choose the cell size of the grid.
+     * @param filter         Optional per-point filter. Points with a filter value of -1 are not inserted.
      */
     void SetPointData(const T* pointData, unsigned int pointCount, vislib::math::Cuboid<T> boundingBox,
-        T searchDistance, int* filter = 0) {
+        T searchDistance, const int* filter = nullptr) {
         this->elementPositions = pointData;
         this->elementCount = pointCount;
 
-        // does the new BBox fit into the old one?
-        if (!elementGrid || !(this->elementBBox.Contains(boundingBox.GetLeftBottomBack(), -1) &&
-                                this->elementBBox.Contains(boundingBox.GetRightTopFront(), -1))) {
-            /* resize bounding-box and grid structure */
-            vislib::math::Dimension<T, 3> dim = boundingBox.GetSize();
-            for (int i = 0; i < 3; i++)
-                this->gridResolution[i] = (unsigned int)floor(dim[i] / (2 * searchDistance) + 1.0);
-            this->gridSize = this->gridResolution[0] * this->gridResolution[1] * this->gridResolution[2];
-            this->elementBBox = boundingBox;
-
-            // initialize element grid
-            if (elementGrid)
-                delete[] elementGrid;
-            this->elementGrid = new vislib::Array<const T*>[gridSize];
-            for (unsigned int i = 0; i < gridSize; i++) {
-                elementGrid[i].Resize(100);
-                elementGrid[i].SetCapacityIncrement(100);
+        this->setupGrid(boundingBox, searchDistance);
+
+        // compute the cell of each point in parallel
+        const unsigned int invalidCell = std::numeric_limits<unsigned int>::max();
+        this->pointCells.resize(this->elementCount);
+#pragma omp parallel for schedule(static)
+        for (int64_t i = 0; i < static_cast<int64_t>(this->elementCount); i++) {
+            if (filter != nullptr && filter[i] == -1) {
+                this->pointCells[i] = invalidCell;
+            } else {
+                this->pointCells[i] = this->cellIndexOf(&this->elementPositions[i * 3]);
             }
-        } else {
-            for (unsigned int i = 0; i < gridSize; i++)
-                elementGrid[i].Clear();
         }
 
-        this->elementOrigin = this->elementBBox.GetOrigin();
-
-        /** fill the internal grid structure */
-        vislib::math::Dimension<T, 3> bBoxDimension = this->elementBBox.GetSize();
-        for (int i = 0; i < 3; i++) {
-            this->gridResolutionFactors[i] = (T)this->gridResolution[i] / bBoxDimension[i];
-            this->cellSize[i] = (T)bBoxDimension[i] / this->gridResolution[i]; //(T)1.0) / gridResolutionFactors[i];
+        // counting sort of the points by cell index (stable, so each cell lists its points in ascending order)
+        this->cellStart.assign(static_cast<size_t>(this->gridSize) + 1, 0);
+        for (unsigned int i = 0; i < this->elementCount; i++) {
+            if (this->pointCells[i] != invalidCell) {
+                this->cellStart[this->pointCells[i] + 1]++;
+            }
+        }
+        for (unsigned int c = 0; c < this->gridSize; c++) {
+            this->cellStart[c + 1] += this->cellStart[c];
         }
-        // sort the element positions into the grid ...
+        const unsigned int insertedCount = this->cellStart[this->gridSize];
+        this->sortedIndices.resize(insertedCount);
+        std::vector<unsigned int> cellFill(this->cellStart.begin(), this->cellStart.end() - 1);
         for (unsigned int i = 0; i < this->elementCount; i++) {
-            // we can skip this assert becaus another ASSERT in 'insertPointIntoGrid'
-            //ASSERT( elementBBox.Contains(vislib::math::ShallowPoint<T,3>(const_cast<T*>(&elementPositions[i*3]))) );
-            if (!filter || filter[i] != -1)
-                insertPointIntoGrid(&this->elementPositions[i * 3]);
+            if (this->pointCells[i] != invalidCell) {
+                this->sortedIndices[cellFill[this->pointCells[i]]++] = i;
+            }
+        }
+
+        // copy the positions into cell order so that queries touch contiguous memory only
+        this->sortedPositions.resize(static_cast<size_t>(insertedCount) * 3);
+#pragma omp parallel for schedule(static)
+        for (int64_t i = 0; i < static_cast<int64_t>(insertedCount); i++) {
+            const T* src = &this->elementPositions[static_cast<size_t>(this->sortedIndices[i]) * 3];
+            this->sortedPositions[i * 3 + 0] = src[0];
+            this->sortedPositions[i * 3 + 1] = src[1];
+            this->sortedPositions[i * 3 + 2] = src[2];
         }
     }
 
-public:
-    //template<typename T>
+    /**
+     * Collects the indices of all points within 'distance' of 'point' (including the point itself if it is part
+     * of the grid). The indices are appended to 'resIdx'.
+     */
     void FindNeighboursInRange(const T* point, T distance, vislib::Array<unsigned int>& resIdx) const {
-        //Point relPos = sub(point, elementOrigin);
+        this->forEachNeighbour(point, distance, [&resIdx](unsigned int idx) {
+            resIdx.Add(idx);
+            return true;
+        });
+    }
+
+    /**
+     * Collects the indices of all points within 'distance' of 'point' (including the point itself if it is part
+     * of the grid). The indices are appended to 'resIdx'.
+     */
+    void FindNeighboursInRange(const T* point, T distance, std::vector<unsigned int>& resIdx) const {
+        this->forEachNeighbour(point, distance, [&resIdx](unsigned int idx) {
+            resIdx.push_back(idx);
+            return true;
+        });
+    }
+
+    /**
+     * Answers whether at least one point of the grid lies within 'distance' of 'point'.
+     */
+    bool HasNeighbourInRange(const T* point, T distance) const {
+        bool found = false;
+        this->forEachNeighbour(point, distance, [&found](unsigned int) {
+            found = true;
+            return false;
+        });
+        return found;
+    }
+
+    /**
+     * Batched, parallel neighbour search for many query points at once. The result is stored in compressed sparse
+     * row layout: the neighbours of query 'q' are 'indices[offsets[q]]' to 'indices[offsets[q + 1] - 1]'.
+     *
+     * @param queryPoints The query positions stored as triples (xyzxyz...).
+     * @param queryCount  The number of query positions.
+     * @param distance    The search radius.
+     * @param offsets     Receives 'queryCount + 1' offsets into 'indices'.
+     * @param indices     Receives the neighbour indices of all queries.
+     */
+    void FindAllNeighboursInRange(const T* queryPoints, unsigned int queryCount, T distance,
+        std::vector<unsigned int>& offsets, std::vector<unsigned int>& indices) const {
+        offsets.assign(static_cast<size_t>(queryCount) + 1, 0);
+        std::vector<std::vector<unsigned int>> threadIndices(omp_get_max_threads());
+
+#pragma omp parallel
+        {
+            // static scheduling hands out contiguous query ranges in thread order, so the per-thread results can
+            // simply be concatenated afterwards
+            auto& local = threadIndices[omp_get_thread_num()];
+#pragma omp for schedule(static)
+            for (int64_t q = 0; q < static_cast<int64_t>(queryCount); q++) {
+                const size_t before = local.size();
+                this->FindNeighboursInRange(&queryPoints[q * 3], distance, local);
+                offsets[q + 1] = static_cast<unsigned int>(local.size() - before);
+            }
+        }
+
+        for (unsigned int q = 0; q < queryCount; q++) {
+            offsets[q + 1] += offsets[q];
+        }
+        indices.resize(offsets[queryCount]);
+        size_t pos = 0;
+        for (auto& local : threadIndices) {
+            std::copy(local.begin(), local.end(), indices.begin() + pos);
+            pos += local.size();
+        }
+    }
+
+private:
+    /**
+     * Calls 'func' with the index of each point within 'distance' of 'point' until 'func' returns false.
+     */
+    template<class Func>
+    VISLIB_FORCEINLINE void forEachNeighbour(const T* point, T distance, Func func) const {
+        if (this->gridSize == 0) {
+            return;
+        }
         T relPos[3] = {point[0] - elementOrigin[0], point[1] - elementOrigin[1], point[2] - elementOrigin[2]};
+        const T distSq = distance * distance;
 
-        // calculate range in the grid ...
+        // calculate range in the grid (clamped the same way as the points, which keeps points outside the
+        // bounding box reachable) ...
         int min[3], max[3];
         for (unsigned int i = 0; i < 3; i++) {
-            min[i] = (int)floor((relPos[i] - distance) * gridResolutionFactors[i]);
-            if (min[i] < 0)
-                min[i] = 0;
-            max[i] = (int)ceil((relPos[i] + distance) * gridResolutionFactors[i]);
-            if (max[i] >= (int)gridResolution[i])
-                max[i] = (int)gridResolution[i] - 1;
+            const int last = static_cast<int>(gridResolution[i]) - 1;
+            min[i] = std::clamp(
+                static_cast<int>(std::floor((relPos[i] - distance) * gridResolutionFactors[i])), 0, last);
+            max[i] = std::clamp(
+                static_cast<int>(std::floor((relPos[i] + distance) * gridResolutionFactors[i])), 0, last);
         }
 
-        // loop over all cells inside the sphere (point, distance)
-        /*              for(float x = relPos[0]-distance; x <= relPos[0]+distance+cellSize[0]; x += cellSize[0]) {
-                                for(float y = relPos[1]-distance; y <= relPos[1]+distance+cellSize[1]; y += cellSize[1]) {
-                                        for(float z = relPos[2]-distance; z <= relPos[2]+distance+cellSize[2]; z += cellSize[2]) {
-                                                unsigned int indexX = x * gridResolutionFactors[0]; // floor()
-                                                unsigned int indexY = y * gridResolutionFactors[1];
-                                                unsigned int indexZ = z * gridResolutionFactors[2];
-                                                if (indexX > 0 && indexX < ... && ... && ... )
-                                        */
-        for (int indexX = min[0]; indexX <= max[0]; indexX++) {
+        // the cells [min[0], max[0]] of one row are consecutive, thus their points form one contiguous range
+        for (int indexZ = min[2]; indexZ <= max[2]; indexZ++) {
             for (int indexY = min[1]; indexY <= max[1]; indexY++) {
-                for (int indexZ = min[2]; indexZ <= max[2]; indexZ++) {
-                    //if ( (Point(x,y,z)-relPos).Length() < distance ) continue;
-                    findNeighboursInCell(elementGrid[cellIndex(indexX, indexY, indexZ)], point, distance, resIdx);
+                const unsigned int first = cellStart[cellIndex(min[0], indexY, indexZ)];
+                const unsigned int last = cellStart[cellIndex(max[0], indexY, indexZ) + 1];
+                for (unsigned int i = first; i < last; i++) {
+                    const T* p = &sortedPositions[static_cast<size_t>(i) * 3];
+                    const T x = p[0] - point[0];
+                    const T y = p[1] - point[1];
+                    const T z = p[2] - point[2];
+                    if (x * x + y * y + z * z <= distSq) {
+                        if (!func(sortedIndices[i])) {
+                            return;
+                        }
+                    }
                 }
             }
         }
     }
 
-private:
-    VISLIB_FORCEINLINE void insertPointIntoGrid(const T* point) {
-        //Point relPos = sub(point, elementOrigin);
-        unsigned int indexX =
-            (unsigned int)(/*relPos.X()*/ (point[0] - elementOrigin[0]) * gridResolutionFactors[0]); // floor()?
-        unsigned int indexY = (unsigned int)(/*relPos.Y()*/ (point[1] - elementOrigin[1]) * gridResolutionFactors[1]);
-        unsigned int indexZ = (unsigned int)(/*relPos.Z()*/ (point[2] - elementOrigin[2]) * gridResolutionFactors[2]);
-        ASSERT(indexX < gridResolution[0] && indexY < gridResolution[1] && indexZ < gridResolution[2]);
-        vislib::Array<const T*>& cell = elementGrid[cellIndex(indexX, indexY, indexZ)];
-        cell.Add(point);
+    /**
+     * Sets up the grid resolution for the given bounding box. The cell size equals the search distance, but the
+     * total number of cells is bounded relative to the number of points to keep the cell list compact.
+     */
+    void setupGrid(const vislib::math::Cuboid<T>& boundingBox, T searchDistance) {
+        vislib::math::Dimension<T, 3> dim = boundingBox.GetSize();
+        T size = (searchDistance > static_cast<T>(0)) ? searchDistance : static_cast<T>(1);
+        const double maxCells = std::max(64.0, 8.0 * static_cast<double>(this->elementCount));
+        while (true) {
+            double cells = 1.0;
+            for (int i = 0; i < 3; i++) {
+                cells *= std::floor(std::max(dim[i], static_cast<T>(0)) / size) + 1.0;
+            }
+            if (cells <= maxCells)
+                break;
+            size *= static_cast<T>(1.25);
+        }
+        for (int i = 0; i < 3; i++) {
+            this->gridResolution[i] =
+                static_cast<unsigned int>(std::floor(std::max(dim[i], static_cast<T>(0)) / size) + 1.0);
+            this->cellSize[i] = size;
+            this->gridResolutionFactors[i] = static_cast<T>(1) / size;
+        }
+        this->gridSize = this->gridResolution[0] * this->gridResolution[1] * this->gridResolution[2];
+        this->elementBBox = boundingBox;
+        this->elementOrigin[0] = boundingBox.GetLeft();
+        this->elementOrigin[1] = boundingBox.GetBottom();
+        this->elementOrigin[2] = boundingBox.GetBack();
     }
 
-    VISLIB_FORCEINLINE void findNeighboursInCell(
-        const vislib::Array<const T*>& cell, const T* point, T distance, vislib::Array<unsigned int>& resIdx) const {
-        for (int i = 0; i < (int)cell.Count(); i++)
-            if (dist(cell[i], point) <= distance)
-                resIdx.Add((unsigned int)((cell[i] - elementPositions) / 3)); // store atom index
+    VISLIB_FORCEINLINE unsigned int cellIndexOf(const T* point) const {
+        int idx[3];
+        for (int i = 0; i < 3; i++) {
+            idx[i] = static_cast<int>((point[i] - elementOrigin[i]) * gridResolutionFactors[i]);
+            idx[i] = std::clamp(idx[i], 0, static_cast<int>(gridResolution[i]) - 1);
+        }
+        return cellIndex(idx[0], idx[1], idx[2]);
     }
 
     inline unsigned int cellIndex(unsigned int x, unsigned int y, unsigned int z) const {
         return x + (y + z * gridResolution[1]) * gridResolution[0];
     }
 
-    inline static Point sub(const T* a, const Point& b) {
-        return Point(a[0] - b[0], a[1] - b[1], a[2] - b[2]);
-    };
-
-    inline static T dist(const T* a, const T* b) {
-        T x = a[0] - b[0];
-        T y = a[1] - b[1];
-        T z = a[2] - b[2];
-        return sqrt(x * x + y * y + z * z);
-    }
-
 private:
-    /** pointer to points/positions stored in triples (xyzxyz...) */
-    const T* elementPositions;
     /** number of points of 'elementPositions' */
     unsigned int elementCount;
-    /** array of position-pointers for each cell of the regular element grid */
-    vislib::Array<const T*>* elementGrid;
+    /** pointer to points/positions stored in triples (xyzxyz...) */
+    const T* elementPositions;
+    /** scratch buffer holding the cell index per point during construction */
+    std::vector<unsigned int> pointCells;
+    /** start offset of each cell into 'sortedIndices' (gridSize + 1 entries) */
+    std::vector<unsigned int> cellStart;
+    /** the point indices sorted by cell */
+    std::vector<unsigned int> sortedIndices;
+    /** the point positions sorted by cell (xyzxyz...) */
+    std::vector<T> sortedPositions;
     /** bounding box of all positions/points */
     vislib::math::Cuboid<T> elementBBox;
     /** origin of 'elementBBox' */
-    Point elementOrigin;
+    T elementOrigin[3];
     /** number of cells in each dimension */
     unsigned int gridResolution[3];
     /** factors to calculate cell index from a given point (inverse of 'cellSize') */
@@ -17,6 +17,10 @@
 #include "mmcore/utility/log/Log.h"
 #include "vislib/math/ShallowVector.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
 using namespace megamol;
 using namespace megamol::core;
 using namespace megamol::protein;
@@ -141,6 +145,18 @@ void HydroBondFilter::fillSecStructVector(MolecularDataCall& mdc) {
             }
         }
     }
+
+    // label contiguous runs of helix atoms, so that the same-helix test does not have to scan the atom range
+    this->helixRunPerAtom.clear();
+    this->helixRunPerAtom.resize(mdc.AtomCount(), UINT_MAX);
+    unsigned int runIdx = 0;
+    for (unsigned int atomIdx = 0; atomIdx < mdc.AtomCount(); atomIdx++) {
+        if (this->secStructPerAtom[atomIdx] == MolecularDataCall::SecStructure::ElementType::TYPE_HELIX) {
+            this->helixRunPerAtom[atomIdx] = runIdx;
+        } else if (atomIdx > 0 && this->helixRunPerAtom[atomIdx - 1] != UINT_MAX) {
+            runIdx++;
+        }
+    }
 }
 
 /*
@@ -222,19 +238,20 @@ bool HydroBondFilter::getExtent(Call& call) {
 /*
  * HydroBondFilter::isValidHBond
  */
-bool HydroBondFilter::isValidHBond(unsigned int donorIndex, unsigned int acceptorIndex, MolecularDataCall& mdc) {
+bool HydroBondFilter::isValidHBond(
+    unsigned int donorIndex, unsigned int acceptorIndex, MolecularDataCall& mdc, float maxDistance) const {
 
     if (donorIndex == acceptorIndex)
         return false;
 
-    // shallow vectors do not work because of constness
-    vislib::math::Vector<float, 3> donorPos = vislib::math::Vector<float, 3>(&mdc.AtomPositions()[donorIndex * 3]);
-    vislib::math::Vector<float, 3> acceptorPos =
-        vislib::math::Vector<float, 3>(&mdc.AtomPositions()[acceptorIndex * 3]);
-    vislib::math::Vector<float, 3> DToA(acceptorPos - donorPos);
+    const float* donorPos = &mdc.AtomPositions()[donorIndex * 3];
+    const float* acceptorPos = &mdc.AtomPositions()[acceptorIndex * 3];
+    const float dx = acceptorPos[0] - donorPos[0];
+    const float dy = acceptorPos[1] - donorPos[1];
+    const float dz = acceptorPos[2] - donorPos[2];
 
     // the distance between acceptor and donator has to be below a threshold
-    return DToA.Length() <= this->hBondDonorAcceptorDistance.Param<param::FloatParam>()->Value();
+    return dx * dx + dy * dy + dz * dz <= maxDistance * maxDistance;
 }
 
 /*
@@ -242,18 +259,22 @@ bool HydroBondFilter::isValidHBond(unsigned int donorIndex, unsigned int accepto
  */
 void HydroBondFilter::filterHBonds(MolecularDataCall& mdc) {
 
-    std::vector<bool> copyVector(mdc.HydrogenBondCount(), false);
-    unsigned int copyCount = 0;
+    const int64_t bondCount = static_cast<int64_t>(mdc.HydrogenBondCount());
+    const unsigned int* bonds = mdc.GetHydrogenBonds();
+    std::vector<unsigned char> copyVector(bondCount, 0);
+    int64_t copyCount = 0;
 
-    bool copyAlpha = this->alphaHelixHBonds.Param<param::BoolParam>()->Value();
-    bool copyBeta = this->betaSheetHBonds.Param<param::BoolParam>()->Value();
-    bool copyOther = this->otherHBonds.Param<param::BoolParam>()->Value();
-    bool fake = this->cAlphaHBonds.Param<param::BoolParam>()->Value();
+    const bool copyAlpha = this->alphaHelixHBonds.Param<param::BoolParam>()->Value();
+    const bool copyBeta = this->betaSheetHBonds.Param<param::BoolParam>()->Value();
+    const bool copyOther = this->otherHBonds.Param<param::BoolParam>()->Value();
+    const bool fake = this->cAlphaHBonds.Param<param::BoolParam>()->Value();
+    const float maxDistance = this->hBondDonorAcceptorDistance.Param<param::FloatParam>()->Value();
 
     // determine which H-Bonds have to be copied
-    for (unsigned int i = 0; i < mdc.HydrogenBondCount(); i++) {
-        unsigned int donorIdx = mdc.GetHydrogenBonds()[i * 2 + 0];
-        unsigned int acceptorIdx = mdc.GetHydrogenBonds()[i * 2 + 1];
+#pragma omp parallel for reduction(+ : copyCount)
+    for (int64_t i = 0; i < bondCount; i++) {
+        unsigned int donorIdx = bonds[i * 2 + 0];
+        unsigned int acceptorIdx = bonds[i * 2 + 1];
 
         auto secStructDonor = this->secStructPerAtom[donorIdx];
         auto secStructAcceptor = this->secStructPerAtom[acceptorIdx];
@@ -265,18 +286,9 @@ void HydroBondFilter::filterHBonds(MolecularDataCall& mdc) {
                 // beta sheets are always copied, if allowed
                 copy = copyBeta;
             } else if (secStructDonor == MolecularDataCall::SecStructure::ElementType::TYPE_HELIX) {
-                // alpha sheets are only copied if it is the same alpha sheet
-                unsigned int min = std::min(donorIdx, acceptorIdx);
-                unsigned int max = std::max(donorIdx, acceptorIdx);
-
-                bool isSame = true;
-                for (unsigned int j = min; j <= max; j++) {
-                    if (this->secStructPerAtom[j] != MolecularDataCall::SecStructure::ElementType::TYPE_HELIX) {
-                        // not the same if there happens a change in secondary structure between the two atoms
-                        isSame = false;
-                        break;
-                    }
-                }
+                // alpha sheets are only copied if it is the same alpha sheet, i.e. there is no change in secondary
+                // structure between the two atoms
+                bool isSame = this->helixRunPerAtom[donorIdx] == this->helixRunPerAtom[acceptorIdx];
 
                 if (copyAlpha && isSame) {
                     copy = true;
@@ -292,35 +304,57 @@ void HydroBondFilter::filterHBonds(MolecularDataCall& mdc) {
             copy = copyOther;
         }
 
-        if (!isValidHBond(donorIdx, acceptorIdx, mdc)) {
+        if (copy && !isValidHBond(donorIdx, acceptorIdx, mdc, maxDistance)) {
             copy = false;
         }
 
-        copyVector[i] = copy;
+        copyVector[i] = copy ? 1 : 0;
         if (copy) {
             copyCount++;
         }
     }
 
-    this->hBondStatistics.resize(mdc.AtomCount(), 0);
+    this->hBondStatistics.assign(mdc.AtomCount(), 0);
     this->hydrogenBondsFiltered.resize(copyCount * 2, 0);
 
-    // copy the H-Bond statistics and hydrogen bonds
-    unsigned int copied = 0;
-    for (unsigned int i = 0; i < mdc.HydrogenBondCount() * 2; i = i + 2) {
-        if (copyVector[i / 2]) {
-            this->hydrogenBondsFiltered[copied] = mdc.GetHydrogenBonds()[i];
-            this->hydrogenBondsFiltered[copied + 1] = mdc.GetHydrogenBonds()[i + 1];
-            copied += 2;
+    // copy the surviving hydrogen bonds in chunks, each chunk writes behind the survivors of its predecessors
+    const int64_t chunkSize = 1 << 16;
+    const int64_t chunkCount = (bondCount + chunkSize - 1) / chunkSize;
+    std::vector<int64_t> chunkOffsets(chunkCount + 1, 0);
+#pragma omp parallel for
+    for (int64_t c = 0; c < chunkCount; c++) {
+        const int64_t end = std::min(bondCount, (c + 1) * chunkSize);
+        int64_t cnt = 0;
+        for (int64_t i = c * chunkSize; i < end; i++) {
+            cnt += copyVector[i];
         }
+        chunkOffsets[c + 1] = cnt;
+    }
+    for (int64_t c = 0; c < chunkCount; c++) {
+        chunkOffsets[c + 1] += chunkOffsets[c];
     }
-    megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-        "%u hydrogen bonds out of %u survived the filtering.\n", copyCount, mdc.HydrogenBondCount());
+#pragma omp parallel for
+    for (int64_t c = 0; c < chunkCount; c++) {
+        const int64_t end = std::min(bondCount, (c + 1) * chunkSize);
+        int64_t copied = chunkOffsets[c] * 2;
+        for (int64_t i = c * chunkSize; i < end; i++) {
+            if (copyVector[i]) {
+                unsigned int donorIdx = bonds[i * 2 + 0];
+                unsigned int acceptorIdx = bonds[i * 2 + 1];
+                if (fake) {
+                    donorIdx = this->cAlphaIndicesPerAtom[donorIdx];
+                    acceptorIdx = this->cAlphaIndicesPerAtom[acceptorIdx];
+                }
+                this->hydrogenBondsFiltered[copied] = donorIdx;
+                this->hydrogenBondsFiltered[copied + 1] = acceptorIdx;
+                copied += 2;
+            }
+        }
+    }
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo("%u hydrogen bonds out of %u survived the filtering.\n",
+        static_cast<unsigned int>(copyCount), mdc.HydrogenBondCount());
 
     for (unsigned int i = 0; i < static_cast<unsigned int>(this->hydrogenBondsFiltered.size()); i++) {
-        if (fake) {
-            this->hydrogenBondsFiltered[i] = this->cAlphaIndicesPerAtom[this->hydrogenBondsFiltered[i]];
-        }
         this->hBondStatistics[this->hydrogenBondsFiltered[i]]++;
     }
 }
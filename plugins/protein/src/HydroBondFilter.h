@@ -152,8 +152,10 @@ private:
      * @param donorIndex The index of the donor of the hydrogen bond.
      * @param accptorIndex The index of the acceptor of the hydrogen bond.
      * @param mdc The MolecularDataCall containing the data.
+     * @param maxDistance The maximal distance between donor and acceptor.
      */
-    bool isValidHBond(unsigned int donorIndex, unsigned int acceptorIndex, protein_calls::MolecularDataCall& mdc);
+    bool isValidHBond(unsigned int donorIndex, unsigned int acceptorIndex, protein_calls::MolecularDataCall& mdc,
+        float maxDistance) const;
 
     /** caller slot */
     core::CallerSlot inDataSlot;
@@ -191,6 +193,12 @@ private:
     /** The secondary structure ID per atom */
     std::vector<protein_calls::MolecularDataCall::SecStructure::ElementType> secStructPerAtom;
 
+    /**
+     * The index of the contiguous run of helix atoms each atom belongs to (or UINT_MAX for non-helix atoms).
+     * Two helix atoms belong to the same helix iff their run indices are equal.
+     */
+    std::vector<unsigned int> helixRunPerAtom;
+
     /** The c alpha indices per atom */
     std::vector<unsigned int> cAlphaIndicesPerAtom;
 };
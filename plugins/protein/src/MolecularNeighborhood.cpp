@@ -142,15 +142,12 @@ bool MolecularNeighborhood::getExtent(core::Call& call) {
 void MolecularNeighborhood::findNeighborhoods(MolecularDataCall& call, float radius) {
     GridNeighbourFinder<float> finder;
     finder.SetPointData(call.AtomPositions(), call.AtomCount(), call.AccessBoundingBoxes().ObjectSpaceBBox(), radius);
-    neighborhood.clear();
-    neighborhood.resize(call.AtomCount());
-    neighborhoodSizes.clear();
+    finder.FindAllNeighboursInRange(
+        call.AtomPositions(), call.AtomCount(), radius, this->neighborhoodOffsets, this->neighborhood);
     neighborhoodSizes.resize(call.AtomCount());
-    dataPointers.clear();
     dataPointers.resize(call.AtomCount());
     for (unsigned int i = 0; i < call.AtomCount(); i++) {
-        finder.FindNeighboursInRange(&call.AtomPositions()[i * 3], radius, neighborhood[i]);
-        neighborhoodSizes[i] = static_cast<unsigned int>(neighborhood[i].Count());
-        dataPointers[i] = neighborhood[i].PeekElements();
+        neighborhoodSizes[i] = neighborhoodOffsets[i + 1] - neighborhoodOffsets[i];
+        dataPointers[i] = neighborhood.data() + neighborhoodOffsets[i];
     }
 }
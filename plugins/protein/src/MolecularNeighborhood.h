@@ -98,8 +98,11 @@ private:
     /** The last data set hash that was sent to the render */
     SIZE_T lastHashSent;
 
-    /** Vector containing the neighborhood for each atom as array of atom indices */
-    std::vector<vislib::Array<unsigned int>> neighborhood;
+    /** The neighboring atom indices of all atoms, the neighborhood of atom i starts at neighborhoodOffsets[i] */
+    std::vector<unsigned int> neighborhood;
+
+    /** Offsets into 'neighborhood' for each atom (AtomCount() + 1 entries) */
+    std::vector<unsigned int> neighborhoodOffsets;
 
     /** Vector containing the sizes of the neighborhoods */
     std::vector<unsigned int> neighborhoodSizes;
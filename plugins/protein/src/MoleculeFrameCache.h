@@ -0,0 +1,161 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "vislib/math/Cuboid.h"
+
+namespace megamol::protein {
+
+/**
+ * The per-frame data of a trajectory.
+ */
+struct MoleculeFrame {
+    /** Positions of the atoms */
+    std::vector<glm::vec3> atom_positions_;
+    /** Bounding box of the atoms including their radii */
+    vislib::math::Cuboid<float> bounding_box_;
+
+    /**
+     * Answer the memory footprint of the frame.
+     *
+     * @return The size of the frame in bytes.
+     */
+    size_t ByteSize() const {
+        return sizeof(MoleculeFrame) + atom_positions_.capacity() * sizeof(glm::vec3);
+    }
+};
+
+/**
+ * Thread-safe least-recently-used cache of trajectory frames with a byte budget.
+ *
+ * Frames are handed out as shared pointers, so evicting a frame never invalidates data still in use by a call.
+ */
+class MoleculeFrameCache {
+public:
+    using FramePtr = std::shared_ptr<const MoleculeFrame>;
+
+    /**
+     * Answer the frame with the given index and mark it as most recently used.
+     *
+     * @param idx The frame index.
+     *
+     * @return The frame or nullptr if it is not cached.
+     */
+    FramePtr Get(int64_t idx) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto const it = entries_.find(idx);
+        if (it == entries_.end()) {
+            return nullptr;
+        }
+        order_.splice(order_.begin(), order_, it->second.order_pos_);
+        return it->second.frame_;
+    }
+
+    /**
+     * Answer whether the frame with the given index is cached, without changing its recency.
+     *
+     * @param idx The frame index.
+     *
+     * @return 'true' if the frame is cached.
+     */
+    bool Contains(int64_t idx) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.find(idx) != entries_.end();
+    }
+
+    /**
+     * Inserts a frame as most recently used and evicts the least recently used frames until the cache fits into
+     * its budget again. The inserted frame itself is never evicted.
+     *
+     * @param idx   The frame index.
+     * @param frame The frame data.
+     */
+    void Put(int64_t idx, FramePtr frame) {
+        if (frame == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto const it = entries_.find(idx);
+        if (it != entries_.end()) {
+            byte_count_ -= it->second.frame_->ByteSize();
+            order_.erase(it->second.order_pos_);
+            entries_.erase(it);
+        }
+        byte_count_ += frame->ByteSize();
+        order_.push_front(idx);
+        entries_[idx] = Entry{std::move(frame), order_.begin()};
+        evict();
+    }
+
+    /**
+     * Removes all frames.
+     */
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        order_.clear();
+        byte_count_ = 0;
+    }
+
+    /**
+     * Sets the byte budget of the cache.
+     *
+     * @param max_bytes The maximum number of bytes held by the cache.
+     */
+    void SetBudget(size_t max_bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_bytes_ = max_bytes;
+        evict();
+    }
+
+    /**
+     * Answer the byte budget of the cache.
+     *
+     * @return The maximum number of bytes held by the cache.
+     */
+    size_t Budget() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return max_bytes_;
+    }
+
+private:
+    struct Entry {
+        FramePtr frame_;
+        std::list<int64_t>::iterator order_pos_;
+    };
+
+    /** Evicts the least recently used frames except for the most recent one until the budget is met */
+    void evict() {
+        while (byte_count_ > max_bytes_ && order_.size() > 1) {
+            auto const it = entries_.find(order_.back());
+            byte_count_ -= it->second.frame_->ByteSize();
+            entries_.erase(it);
+            order_.pop_back();
+        }
+    }
+
+    /** Guards all members */
+    mutable std::mutex mutex_;
+    /** The cached frames */
+    std::unordered_map<int64_t, Entry> entries_;
+    /** Frame indices from most to least recently used */
+    std::list<int64_t> order_;
+    /** Bytes currently held */
+    size_t byte_count_ = 0;
+    /** Maximum number of bytes to hold */
+    size_t max_bytes_ = 0;
+};
+
+} // namespace megamol::protein
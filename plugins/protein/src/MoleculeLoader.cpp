@@ -10,13 +10,34 @@
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
 #include "mmcore/param/StringParam.h"
 
+#include <cstring>
+#include <fstream>
 #include <iostream>
 
 using namespace megamol::core;
 using namespace megamol::protein;
 
+namespace {
+/**
+ * Header of the binary frame store. The header is followed by one record per frame, each consisting of the bounding
+ * box (left, bottom, back, right, top, front) and the atom positions (xyzxyz...) as 32 bit floats.
+ */
+struct FrameStoreHeader {
+    char magic[8];
+    uint64_t atom_count;
+    uint64_t frame_count;
+    uint64_t source_size;
+    int64_t source_time;
+};
+
+constexpr char frame_store_magic[8] = {'M', 'M', 'M', 'O', 'L', 'F', 'S', '1'};
+
+static_assert(sizeof(chemfiles::Vector3D) == 3 * sizeof(double), "chemfiles positions have to be tightly packed");
+} // namespace
+
 MoleculeLoader::MoleculeLoader()
         : core::Module()
         , data_out_slot_("dataOut", "Connects the loader with the requesting modules")
@@ -25,6 +46,11 @@ MoleculeLoader::MoleculeLoader()
         , calc_secstruct_slot_(
               "calcSecstruct", "Enables the calculation of the Secondary Structure using the STRIDE algorithm")
         , used_radius_slot_("radiusMeasure", "Selection for the radius measure used for the atoms")
+        , frame_cache_size_slot_("frameCacheSize", "Memory budget of the trajectory frame cache in MiB")
+        , prefetch_count_slot_("prefetchFrames", "Number of trajectory frames read ahead in the background")
+        , frame_store_slot_("frameStore",
+              "Optional path to a binary frame store. The trajectory is converted into it once and read from it in "
+              "later sessions")
         , structure_(nullptr)
         , time_step_count_(0) {
     // Callee slots
@@ -55,6 +81,18 @@ MoleculeLoader::MoleculeLoader()
     used_radius_slot_.SetParameter(en);
     this->MakeSlotAvailable(&used_radius_slot_);
 
+    frame_cache_size_slot_.SetParameter(new param::IntParam(1024, 0));
+    this->MakeSlotAvailable(&frame_cache_size_slot_);
+
+    prefetch_count_slot_.SetParameter(new param::IntParam(8, 0));
+    this->MakeSlotAvailable(&prefetch_count_slot_);
+
+    frame_store_slot_.SetParameter(
+        new param::FilePathParam("", param::FilePathParam::FilePathFlags_::Flag_File_ToBeCreated));
+    this->MakeSlotAvailable(&frame_store_slot_);
+
+    frame_cache_.SetBudget(static_cast<size_t>(frame_cache_size_slot_.Param<param::IntParam>()->Value()) << 20);
+
     global_bounding_box_.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
     local_bounding_box_ = global_bounding_box_;
 }
@@ -64,13 +102,25 @@ MoleculeLoader::~MoleculeLoader() {
 }
 
 bool MoleculeLoader::create() {
-    // TODO
+    keep_prefetching_ = true;
+    prefetch_thread_ = std::thread(&MoleculeLoader::prefetchLoop, this);
 
     return true;
 }
 
 void MoleculeLoader::release() {
-    // TODO
+    {
+        std::lock_guard<std::mutex> lock(prefetch_mutex_);
+        keep_prefetching_ = false;
+    }
+    prefetch_cond_.notify_one();
+    if (prefetch_thread_.joinable()) {
+        prefetch_thread_.join();
+    }
+    frame_store_.Close();
+    frame_store_valid_ = false;
+    frame_cache_.Clear();
+    current_frame_ = nullptr;
 }
 
 bool MoleculeLoader::getMDCExtent(core::Call& call) {
@@ -99,11 +149,21 @@ bool MoleculeLoader::getMDCData(core::Call& call) {
     bool const recalc = updateFiles();
     postProcessFilesMDC(*mdc, recalc);
 
+    if (structure_ != nullptr) {
+        auto const frame_idx = static_cast<int64_t>(mdc->Calltime()) % std::max(time_step_count_, int64_t(1));
+        auto frame = requestFrame(frame_idx);
+        if (frame != nullptr) {
+            current_frame_ = std::move(frame);
+            local_bounding_box_ = current_frame_->bounding_box_;
+        }
+    }
+
     auto const& s = mdc_structures_;
     auto const& f = mdc_structures_frame_;
-    mdc->SetAtoms(f.atom_positions_.size(), s.atom_types_.size(), s.atom_type_indices_.data(),
-        &f.atom_positions_.front().x, s.atom_types_.data(), s.atom_residue_indices_.data(), f.b_factors_.data(),
-        f.charges_.data(), f.occupancies_.data());
+    auto const atom_count = current_frame_ != nullptr ? current_frame_->atom_positions_.size() : 0;
+    mdc->SetAtoms(atom_count, s.atom_types_.size(), s.atom_type_indices_.data(),
+        atom_count > 0 ? &current_frame_->atom_positions_.front().x : nullptr, s.atom_types_.data(),
+        s.atom_residue_indices_.data(), f.b_factors_.data(), f.charges_.data(), f.occupancies_.data());
     mdc->SetBFactorRange(f.b_factor_bounds_.first, f.b_factor_bounds_.second);
     mdc->SetOccupancyRange(f.occupancy_bounds_.first, f.occupancy_bounds_.second);
     mdc->SetChargeRange(f.charge_bounds_.first, f.charge_bounds_.second);
@@ -154,6 +214,14 @@ bool MoleculeLoader::loadFile(
 }
 
 bool MoleculeLoader::updateFiles() {
+    if (frame_cache_size_slot_.IsDirty()) {
+        frame_cache_size_slot_.ResetDirty();
+        frame_cache_.SetBudget(static_cast<size_t>(frame_cache_size_slot_.Param<param::IntParam>()->Value()) << 20);
+    }
+    bool store_change = frame_store_slot_.IsDirty();
+    frame_store_slot_.ResetDirty();
+
+    bool updated = false;
     if (filename_slot_.IsDirty() || trajectory_filename_slot_.IsDirty()) {
         filename_slot_.ResetDirty();
         trajectory_filename_slot_.ResetDirty();
@@ -167,6 +235,7 @@ bool MoleculeLoader::updateFiles() {
             change = true;
         }
         if (change) {
+            std::lock_guard<std::mutex> lock(io_mutex_);
             bool success = false;
             if (filename == traj_filename) {
                 success = loadFile(filename);
@@ -178,11 +247,29 @@ bool MoleculeLoader::updateFiles() {
             if (success) {
                 path_to_current_structure_ = filename;
                 path_to_current_trajectory_ = traj_filename;
+
+                // the radii are needed to compute the bounding box of every frame
+                auto const first = structure_->read_step(0);
+                auto const& topology = first.topology();
+                atom_radii_.resize(topology.size());
+                for (size_t i = 0; i < topology.size(); ++i) {
+                    atom_radii_[i] = static_cast<float>(topology[i].vdw_radius().value_or(0.0));
+                }
             }
+            store_change = true;
         }
-        return true;
+        updated = true;
     }
-    return false;
+
+    if (store_change) {
+        std::lock_guard<std::mutex> lock(io_mutex_);
+        ++file_generation_;
+        frame_cache_.Clear();
+        current_frame_ = nullptr;
+        openFrameStore(frame_store_slot_.Param<param::FilePathParam>()->Value());
+    }
+
+    return updated;
 }
 
 void MoleculeLoader::postProcessFilesMDC(protein_calls::MolecularDataCall& mdc, bool recalc) {
@@ -191,7 +278,10 @@ void MoleculeLoader::postProcessFilesMDC(protein_calls::MolecularDataCall& mdc,
     }
 
     if (recalc) {
-        auto protein = structure_->read_step(static_cast<int>(mdc.Calltime()) % time_step_count_);
+        auto const frame_idx = static_cast<int64_t>(mdc.Calltime()) % time_step_count_;
+        std::unique_lock<std::mutex> lock(io_mutex_);
+        auto protein = structure_->read_step(static_cast<size_t>(frame_idx));
+        lock.unlock();
         auto const atom_count = protein.topology().size();
         auto const residue_count = protein.topology().residues().size();
         auto const connection_count = protein.topology().bonds().size();
@@ -201,31 +291,15 @@ void MoleculeLoader::postProcessFilesMDC(protein_calls::MolecularDataCall& mdc,
             mdc_structures_ = {};
             mdc_structures_frame_ = {};
 
-            // calc bounding box
-            auto const& first_atom = protein.topology()[0];
-            auto const& first_pos = protein.positions().at(0);
-            auto const first_vdw_radius = first_atom.vdw_radius().value_or(0.0f);
-            local_bounding_box_.Set(first_pos[0] - first_vdw_radius, first_pos[1] - first_vdw_radius,
-                first_pos[2] - first_vdw_radius, first_pos[0] + first_vdw_radius, first_pos[1] + first_vdw_radius,
-                first_pos[2] + first_vdw_radius);
-            for (size_t i = 0; i < atom_count; ++i) {
-                auto const& atom = protein.topology()[i];
-                auto const& atom_pos = protein.positions()[i];
-                auto const vdw_radius = atom.vdw_radius().value_or(0.0);
-                vislib::math::Cuboid<float> const atom_bbox(atom_pos[0] - vdw_radius, atom_pos[1] - vdw_radius,
-                    atom_pos[2] - vdw_radius, atom_pos[0] + vdw_radius, atom_pos[1] + vdw_radius,
-                    atom_pos[2] + vdw_radius);
-                local_bounding_box_.Union(atom_bbox);
-            }
+            // convert the positions and calc bounding box
+            auto frame = std::make_shared<MoleculeFrame>();
+            convertFrame(protein, *frame);
+            local_bounding_box_ = frame->bounding_box_;
             // TODO handle per-frame bounding boxes
             global_bounding_box_ = local_bounding_box_;
             // TODO consider bounding boxes stored by chemfiles
-
-            // copy over atom positions
-            mdc_structures_frame_.atom_positions_.resize(atom_count);
-            for (size_t i = 0; i < atom_count; ++i) {
-                mdc_structures_frame_.atom_positions_[i] = glm::make_vec3(&protein.positions().at(i)[0]);
-            }
+            frame_cache_.Put(frame_idx, frame);
+            current_frame_ = frame;
             // TODO charge, bfactor, occupancy
             mdc_structures_frame_.b_factors_.resize(atom_count, 0.0f);
             mdc_structures_frame_.occupancies_.resize(atom_count, 1.0f);
@@ -276,3 +350,195 @@ void MoleculeLoader::postProcessFilesMDC(protein_calls::MolecularDataCall& mdc,
 void MoleculeLoader::postProcessFilesMolecule() {
     // TODO
 }
+
+MoleculeFrameCache::FramePtr MoleculeLoader::requestFrame(int64_t idx) {
+    auto frame = frame_cache_.Get(idx);
+    if (frame == nullptr) {
+        std::lock_guard<std::mutex> lock(io_mutex_);
+        frame = loadFrame(idx);
+        frame_cache_.Put(idx, frame);
+    }
+
+    // read ahead the following frames, a new request replaces the pending one
+    auto const count =
+        std::min(static_cast<int64_t>(prefetch_count_slot_.Param<param::IntParam>()->Value()), time_step_count_ - 1);
+    if (count > 0) {
+        {
+            std::lock_guard<std::mutex> lock(prefetch_mutex_);
+            prefetch_first_ = (idx + 1) % time_step_count_;
+            prefetch_count_ = count;
+            prefetch_generation_ = file_generation_;
+        }
+        prefetch_cond_.notify_one();
+    }
+
+    return frame;
+}
+
+MoleculeFrameCache::FramePtr MoleculeLoader::loadFrame(int64_t idx) {
+    auto frame = std::make_shared<MoleculeFrame>();
+
+    if (frame_store_valid_) {
+        // the store holds the frames in their final layout, so a frame is read with a single bulk copy
+        using vislib::sys::File;
+        auto const atom_count = atom_radii_.size();
+        auto const record_size = static_cast<File::FileSize>((6 + 3 * atom_count) * sizeof(float));
+        float box[6];
+        frame->atom_positions_.resize(atom_count);
+        frame_store_.Seek(static_cast<File::FileOffset>(sizeof(FrameStoreHeader) + idx * record_size));
+        if (frame_store_.Read(box, sizeof(box)) != sizeof(box) ||
+            frame_store_.Read(frame->atom_positions_.data(), atom_count * sizeof(glm::vec3)) !=
+                atom_count * sizeof(glm::vec3)) {
+            utility::log::Log::DefaultLog.WriteError("Unable to read frame %lld from the frame store",
+                static_cast<long long>(idx));
+            return nullptr;
+        }
+        frame->bounding_box_.Set(box[0], box[1], box[2], box[3], box[4], box[5]);
+        return frame;
+    }
+
+    if (structure_ == nullptr) {
+        return nullptr;
+    }
+    try {
+        auto const step = structure_->read_step(static_cast<size_t>(idx));
+        convertFrame(step, *frame);
+    } catch (chemfiles::Error const& ex) {
+        utility::log::Log::DefaultLog.WriteError("Unable to read frame %lld: %s", static_cast<long long>(idx),
+            ex.what());
+        return nullptr;
+    }
+    return frame;
+}
+
+void MoleculeLoader::convertFrame(chemfiles::Frame const& frame, MoleculeFrame& out) const {
+    auto const atom_count = frame.size();
+    out.atom_positions_.resize(atom_count);
+    if (atom_count == 0) {
+        out.bounding_box_.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
+        return;
+    }
+
+    // chemfiles stores the positions as tightly packed doubles, so they are converted in one linear pass
+    auto const src = &frame.positions()[0][0];
+    auto const dst = &out.atom_positions_.front().x;
+    for (size_t i = 0; i < 3 * atom_count; ++i) {
+        dst[i] = static_cast<float>(src[i]);
+    }
+
+    glm::vec3 lower(std::numeric_limits<float>::max());
+    glm::vec3 upper(std::numeric_limits<float>::lowest());
+    bool const has_radii = atom_radii_.size() == atom_count;
+    for (size_t i = 0; i < atom_count; ++i) {
+        auto const r = has_radii ? atom_radii_[i] : 0.0f;
+        lower = glm::min(lower, out.atom_positions_[i] - r);
+        upper = glm::max(upper, out.atom_positions_[i] + r);
+    }
+    out.bounding_box_.Set(lower.x, lower.y, lower.z, upper.x, upper.y, upper.z);
+}
+
+bool MoleculeLoader::openFrameStore(std::filesystem::path const& path_to_store) {
+    frame_store_.Close();
+    frame_store_valid_ = false;
+    if (path_to_store.empty() || structure_ == nullptr || time_step_count_ <= 1) {
+        return false;
+    }
+
+    std::error_code ec;
+    FrameStoreHeader expected;
+    std::memcpy(expected.magic, frame_store_magic, sizeof(frame_store_magic));
+    expected.atom_count = atom_radii_.size();
+    expected.frame_count = static_cast<uint64_t>(time_step_count_);
+    expected.source_size = std::filesystem::file_size(path_to_current_trajectory_, ec);
+    expected.source_time = std::filesystem::last_write_time(path_to_current_trajectory_, ec).time_since_epoch().count();
+
+    // reuse an existing store if it was written for the same trajectory file
+    FrameStoreHeader existing;
+    bool matches = false;
+    {
+        std::ifstream in(path_to_store, std::ios::binary);
+        if (in.read(reinterpret_cast<char*>(&existing), sizeof(existing))) {
+            matches = std::memcmp(&existing, &expected, sizeof(FrameStoreHeader)) == 0;
+        }
+    }
+
+    if (!matches) {
+        utility::log::Log::DefaultLog.WriteInfo("Converting the trajectory %s into the frame store %s",
+            path_to_current_trajectory_.generic_u8string().c_str(), path_to_store.generic_u8string().c_str());
+        std::ofstream out(path_to_store, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<char const*>(&expected), sizeof(expected));
+        MoleculeFrame frame;
+        try {
+            for (int64_t i = 0; i < time_step_count_ && out; ++i) {
+                convertFrame(structure_->read_step(static_cast<size_t>(i)), frame);
+                auto const& box = frame.bounding_box_;
+                float const box_data[6] = {
+                    box.Left(), box.Bottom(), box.Back(), box.Right(), box.Top(), box.Front()};
+                out.write(reinterpret_cast<char const*>(box_data), sizeof(box_data));
+                out.write(reinterpret_cast<char const*>(frame.atom_positions_.data()),
+                    frame.atom_positions_.size() * sizeof(glm::vec3));
+            }
+        } catch (chemfiles::Error const& ex) {
+            utility::log::Log::DefaultLog.WriteError("Unable to convert the trajectory: %s", ex.what());
+            out.setstate(std::ios::failbit);
+        }
+        if (!out) {
+            utility::log::Log::DefaultLog.WriteError(
+                "Unable to write the frame store %s", path_to_store.generic_u8string().c_str());
+            out.close();
+            std::filesystem::remove(path_to_store, ec);
+            return false;
+        }
+    }
+
+    using vislib::sys::File;
+    if (!frame_store_.Open(path_to_store.native().c_str(), File::READ_ONLY, File::SHARE_READ, File::OPEN_ONLY)) {
+        utility::log::Log::DefaultLog.WriteError(
+            "Unable to open the frame store %s", path_to_store.generic_u8string().c_str());
+        return false;
+    }
+    frame_store_valid_ = true;
+    return true;
+}
+
+void MoleculeLoader::prefetchLoop() {
+    std::unique_lock<std::mutex> lock(prefetch_mutex_);
+    while (true) {
+        prefetch_cond_.wait(lock, [this]() { return !keep_prefetching_ || prefetch_first_ >= 0; });
+        if (!keep_prefetching_) {
+            break;
+        }
+        auto const first = prefetch_first_;
+        auto const count = prefetch_count_;
+        auto const generation = prefetch_generation_;
+        prefetch_first_ = -1;
+        lock.unlock();
+
+        // the frame count cannot change without changing the generation, which is checked under the io lock
+        int64_t frame_count = 0;
+        {
+            std::lock_guard<std::mutex> io_lock(io_mutex_);
+            frame_count = generation == file_generation_ ? time_step_count_ : 0;
+        }
+        for (int64_t i = 0; i < count && frame_count > 0; ++i) {
+            auto const idx = (first + i) % frame_count;
+            {
+                // stop as soon as the playback asks for something else
+                std::lock_guard<std::mutex> request_lock(prefetch_mutex_);
+                if (!keep_prefetching_ || prefetch_first_ >= 0) {
+                    break;
+                }
+            }
+            if (frame_cache_.Contains(idx)) {
+                continue;
+            }
+            std::lock_guard<std::mutex> io_lock(io_mutex_);
+            if (generation != file_generation_) {
+                break;
+            }
+            frame_cache_.Put(idx, loadFrame(idx));
+        }
+
+        lock.lock();
+    }
+}
@@ -5,6 +5,10 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <chemfiles.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -15,6 +19,9 @@
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
 #include "protein_calls/MolecularDataCall.h"
+#include "vislib/sys/MemmappedFile.h"
+
+#include "MoleculeFrameCache.h"
 
 namespace megamol::protein {
 class MoleculeLoader : public core::Module {
@@ -137,6 +144,45 @@ protected:
      */
     void postProcessFilesMolecule();
 
+    /**
+     * Answers the requested frame from the frame cache, loads it if necessary and schedules the prefetch of the
+     * following frames.
+     *
+     * @param idx The index of the requested frame
+     * @return The frame data or nullptr if the frame could not be loaded
+     */
+    MoleculeFrameCache::FramePtr requestFrame(int64_t idx);
+
+    /**
+     * Loads a single frame from the frame store or the trajectory. The caller has to hold 'io_mutex_'.
+     *
+     * @param idx The index of the frame to load
+     * @return The frame data or nullptr if the frame could not be loaded
+     */
+    MoleculeFrameCache::FramePtr loadFrame(int64_t idx);
+
+    /**
+     * Converts the positions of a chemfiles frame into the frame data and computes its bounding box
+     *
+     * @param frame The chemfiles frame
+     * @param out The frame data to write into
+     */
+    void convertFrame(chemfiles::Frame const& frame, MoleculeFrame& out) const;
+
+    /**
+     * Opens the binary frame store for the current trajectory and (re)creates it if it does not match the
+     * trajectory. The caller has to hold 'io_mutex_'.
+     *
+     * @param path_to_store Path to the frame store file
+     * @return True if the frame store can be used, false otherwise
+     */
+    bool openFrameStore(std::filesystem::path const& path_to_store);
+
+    /**
+     * Loop of the prefetch thread reading the frames following the last requested one into the frame cache
+     */
+    void prefetchLoop();
+
 private:
     /** Slot connecting this module to the requesting modules */
     core::CalleeSlot data_out_slot_;
@@ -152,6 +198,13 @@ private:
     /** Slot for the selection of the radius measure */
     core::param::ParamSlot used_radius_slot_;
 
+    /** Slot for the memory budget of the frame cache in MiB */
+    core::param::ParamSlot frame_cache_size_slot_;
+    /** Slot for the number of frames read ahead in the background */
+    core::param::ParamSlot prefetch_count_slot_;
+    /** Slot for the path of the binary frame store */
+    core::param::ParamSlot frame_store_slot_;
+
     /** Pointer to the structure */
     std::shared_ptr<chemfiles::Trajectory> structure_;
 
@@ -170,8 +223,6 @@ private:
     vislib::math::Cuboid<float> local_bounding_box_;
 
     struct MDCStructuresFrame {
-        /** Positions of the atoms */
-        std::vector<glm::vec3> atom_positions_;
         /** B-Factor values for each atom */
         std::vector<float> b_factors_;
         /** Charges for each atom */
@@ -220,6 +271,39 @@ private:
         // TODO
     } molecule_structures_;
 
+    /** Radius per atom used for the bounding boxes */
+    std::vector<float> atom_radii_;
+
+    /** Cache for the frames of the trajectory */
+    MoleculeFrameCache frame_cache_;
+    /** The frame currently handed out to the calls */
+    MoleculeFrameCache::FramePtr current_frame_;
+
+    /** Guards 'structure_' and 'frame_store_' which are accessed by the prefetch thread as well */
+    std::mutex io_mutex_;
+    /** Incremented whenever the files change, so the prefetch thread can drop outdated requests */
+    uint64_t file_generation_ = 0;
+
+    /** The binary frame store */
+    vislib::sys::MemmappedFile frame_store_;
+    /** Whether the frame store is open and matches the current trajectory */
+    bool frame_store_valid_ = false;
+
+    /** The prefetch thread */
+    std::thread prefetch_thread_;
+    /** Guards the prefetch request */
+    std::mutex prefetch_mutex_;
+    /** Wakes up the prefetch thread */
+    std::condition_variable prefetch_cond_;
+    /** First frame to prefetch, -1 if there is nothing to do */
+    int64_t prefetch_first_ = -1;
+    /** Number of frames to prefetch */
+    int64_t prefetch_count_ = 0;
+    /** The file generation of the prefetch request */
+    uint64_t prefetch_generation_ = 0;
+    /** Whether the prefetch thread should keep running */
+    bool keep_prefetching_ = false;
+
     /** The current data hash */
     size_t datahash_ = 0;
 };
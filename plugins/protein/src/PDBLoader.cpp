@@ -9,6 +9,7 @@
 #include "PDBLoader.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmcore/param/StringParam.h"
 #include "mmcore/utility/log/Log.h"
@@ -758,6 +759,9 @@ PDBLoader::PDBLoader()
         , calcBondsSlot("calculateBonds", "Calculate covalent bonds when loading the file")
         , recomputeStridePerFrameSlot(
               "recomputeSTRIDEeachFrame", "If STRIDE is used, should it be recomputed each frame?")
+        , strideIncrementalThresholdSlot("strideIncrementalThreshold",
+              "If STRIDE is recomputed each frame, only the hydrogen bonds of residues whose backbone moved more than "
+              "this distance are re-evaluated (0 = always recompute everything)")
         , bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , datahash(0)
         , stride(0)
@@ -799,6 +803,9 @@ PDBLoader::PDBLoader()
     this->recomputeStridePerFrameSlot << new param::BoolParam(false);
     this->MakeSlotAvailable(&this->recomputeStridePerFrameSlot);
 
+    this->strideIncrementalThresholdSlot << new param::FloatParam(0.0f, 0.0f);
+    this->MakeSlotAvailable(&this->strideIncrementalThresholdSlot);
+
     mdd = NULL; // no mdd object
 }
 
@@ -952,9 +959,14 @@ bool PDBLoader::getData(core::Call& call) {
     if ((!this->secStructAvailable || this->recomputeStridePerFrameSlot.Param<param::BoolParam>()->Value()) &&
         this->strideFlagSlot.Param<param::BoolParam>()->Value()) {
         time_t t = clock(); // DEBUG
-        if (this->stride)
-            delete this->stride;
-        this->stride = new Stride(dc);
+        if (this->stride && this->secStructAvailable) {
+            // keep the STRIDE instance to reuse the hydrogen bonds of residues that did not move
+            this->stride->Update(dc, this->strideIncrementalThresholdSlot.Param<param::FloatParam>()->Value());
+        } else {
+            if (this->stride)
+                delete this->stride;
+            this->stride = new Stride(dc);
+        }
         this->stride->WriteToInterface(dc);
         this->secStructAvailable = true;
         Log::DefaultLog.WriteInfo("Secondary Structure computed via STRIDE in %f seconds.",
@@ -675,6 +675,8 @@ private:
     core::param::ParamSlot calcBondsSlot;
     /** Determine whether to recompute STRIDE each frame */
     core::param::ParamSlot recomputeStridePerFrameSlot;
+    /** Backbone movement threshold for the incremental STRIDE update */
+    core::param::ParamSlot strideIncrementalThresholdSlot;
 
     /** The data */
     vislib::Array<Frame*> data;
@@ -8,6 +8,7 @@
 #include "SolventCounter.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/utility/log/Log.h"
+#include "protein/GridNeighbourFinder.h"
 #include "protein_calls/PerAtomFloatCall.h"
 #include "vislib/assert.h"
 #include <cfloat>
@@ -108,19 +109,15 @@ bool SolventCounter::getDataCallback(core::Call& call) {
     if (solvent.Count() != mol->AtomCount() || this->datahash != mol->DataHash()) {
         this->solvent.Clear();
         this->solvent.SetCount(mol->AtomCount());
-        vislib::math::Vector<float, 3> molAtomPos, solAtomPos;
-        for (unsigned int i = 0; i < mol->AtomCount(); i++) {
-            molAtomPos.Set(
-                mol->AtomPositions()[3 * i], mol->AtomPositions()[3 * i + 1], mol->AtomPositions()[3 * i + 2]);
-            this->solvent[i] = 0.0f;
-            for (unsigned int j = 0; j < sol->AtomCount(); j++) {
-                solAtomPos.Set(
-                    sol->AtomPositions()[3 * j], sol->AtomPositions()[3 * j + 1], sol->AtomPositions()[3 * j + 2]);
-                // increase counter if the current solvent atom is within the given radius
-                if ((molAtomPos - solAtomPos).Length() <= this->radiusParam.Param<param::FloatParam>()->Value()) {
-                    this->solvent[i] = 1.0f;
-                }
-            }
+        const float radius = this->radiusParam.Param<param::FloatParam>()->Value();
+        GridNeighbourFinder<float> solventGrid;
+        solventGrid.SetPointData(
+            sol->AtomPositions(), sol->AtomCount(), sol->AccessBoundingBoxes().ObjectSpaceBBox(), radius);
+        const float* molAtomPos = mol->AtomPositions();
+#pragma omp parallel for
+        for (int i = 0; i < static_cast<int>(mol->AtomCount()); i++) {
+            // set the counter if any solvent atom is within the given radius
+            this->solvent[i] = solventGrid.HasNeighbourInRange(&molAtomPos[3 * i], radius) ? 1.0f : 0.0f;
         }
         this->datahash = mol->DataHash();
     }
@@ -151,7 +148,8 @@ bool SolventCounter::getDataCallback(core::Call& call) {
         this->minValue = FLT_MAX;
         this->maxValue = FLT_MIN;
         // loop over all frames
-        vislib::math::Vector<float, 3> molAtomPos, solAtomPos;
+        const float radius = this->radiusParam.Param<param::FloatParam>()->Value();
+        GridNeighbourFinder<float> solventGrid;
         for (unsigned int fID = 0; fID < frameCount; fID++) {
             if (fID % 100 == 0)
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("Computing Frame %i", fID);
@@ -161,18 +159,15 @@ bool SolventCounter::getDataCallback(core::Call& call) {
             sol->SetFrameID(fID);
             if (!(*sol)(MolecularDataCall::CallForGetData))
                 return false;
-            // loop over all molecule atoms and check for neighboring solvent atoms
-            for (unsigned int i = 0; i < mol->AtomCount(); i++) {
-                molAtomPos.Set(
-                    mol->AtomPositions()[3 * i], mol->AtomPositions()[3 * i + 1], mol->AtomPositions()[3 * i + 2]);
-                for (unsigned int j = 0; j < sol->AtomCount(); j++) {
-                    solAtomPos.Set(
-                        sol->AtomPositions()[3 * j], sol->AtomPositions()[3 * j + 1], sol->AtomPositions()[3 * j + 2]);
-                    // increase counter if the current solvent atom is within the given radius
-                    if ((molAtomPos - solAtomPos).Length() <= this->radiusParam.Param<param::FloatParam>()->Value()) {
-                        this->solvent[i] += 1.0f;
-                        break;
-                    }
+            // loop over all molecule atoms and check for neighboring solvent atoms using a grid of the solvent
+            solventGrid.SetPointData(
+                sol->AtomPositions(), sol->AtomCount(), sol->AccessBoundingBoxes().ObjectSpaceBBox(), radius);
+            const float* molAtomPos = mol->AtomPositions();
+#pragma omp parallel for
+            for (int i = 0; i < static_cast<int>(mol->AtomCount()); i++) {
+                // increase counter if any solvent atom is within the given radius
+                if (solventGrid.HasNeighbourInRange(&molAtomPos[3 * i], radius)) {
+                    this->solvent[i] += 1.0f;
                 }
             }
             this->datahash = mol->DataHash();
@@ -1,5 +1,7 @@
 #include "Stride.h"
+#include "protein/GridNeighbourFinder.h"
 #include <algorithm>
+#include <cfloat>
 #include <cstdio>
 #include <iostream>
 
@@ -13,7 +15,11 @@ using namespace megamol::protein_calls;
 #undef max
 
 
-Stride::Stride(MolecularDataCall* mol) : Successful(false) {
+Stride::Stride(MolecularDataCall* mol)
+        : MovementThreshold(0.0f)
+        , CachedNAcc(0)
+        , CacheValid(false)
+        , Successful(false) {
     // set protein chain count to zero
     ProteinChainCnt = 0;
     // set hydrogen bond count to zero
@@ -40,17 +46,42 @@ Stride::Stride(MolecularDataCall* mol) : Successful(false) {
 
 Stride::~Stride() {
     // free variables
+    FreeData();
+    free(ProteinChain);
+    free(HydroBond);
+    free(StrideCmd);
+}
+
+void Stride::FreeData() {
     int i;
     for (i = 0; i < ProteinChainCnt; ++i)
         FreeChain(ProteinChain[i]);
-    free(ProteinChain);
+    ProteinChainCnt = 0;
 
     for (i = 0; i < HydroBondCnt; ++i)
         FreeHBond(HydroBond[i]);
+    HydroBondCnt = 0;
 
-    free(HydroBond);
+    for (auto d : Donors)
+        free(d);
+    Donors.clear();
+    for (auto a : Acceptors)
+        free(a);
+    Acceptors.clear();
+}
 
-    free(StrideCmd);
+bool Stride::Update(MolecularDataCall* mol, float movementThreshold) {
+    if (!mol)
+        return false;
+
+    // the chains are rebuilt from scratch, the incremental state survives
+    FreeData();
+    MovementThreshold = movementThreshold;
+
+    GetChains(mol);
+    Successful = ComputeSecondaryStructure();
+    PostProcessHBonds(mol);
+    return Successful;
 }
 
 void Stride::FreeChain(CHAIN* Chain) {
@@ -113,7 +144,8 @@ void Stride::GetChains(MolecularDataCall* mol) {
     ProteinChainCnt = std::min((unsigned int)mol->MoleculeCount(), (unsigned int)MAX_CHAIN);
     chain = 0;
 
-    // iterate over all chains
+    // iterate over all chains (the chains are independent of each other)
+#pragma omp parallel for schedule(dynamic) private(cntRes, cntAtm, idx, cnt, atomCount, firstAtom, r)
     for (cntCha = 0; cntCha < ProteinChainCnt; ++cntCha) {
         // inititalize the chain
         InitChain(&ProteinChain[cntCha]);
@@ -208,12 +240,17 @@ bool Stride::ComputeSecondaryStructure() {
     PhiPsiMapHelix = DefaultHelixMap(StrideCmd);
     PhiPsiMapSheet = DefaultSheetMap(StrideCmd);
 
+#pragma omp parallel for schedule(dynamic)
     for (Cn = 0; Cn < ProteinChainCnt; ++Cn)
         PlaceHydrogens(ProteinChain[Cn]);
 
-    if ((HydroBondCnt = FindHydrogenBonds(ProteinChain, Cn, HydroBond, StrideCmd)) == 0) {
+    FindMovedResidues(ProteinChain, ProteinChainCnt);
+
+    if ((HydroBondCnt = FindHydrogenBonds(ProteinChain, ProteinChainCnt, HydroBond, StrideCmd)) == 0) {
         //die( "No hydrogen bonds found in %s\n", StrideCmd->InputFile );
         printf("No hydrogen bonds found.\n");
+        free(PhiPsiMapHelix);
+        free(PhiPsiMapSheet);
         return false;
     }
 
@@ -227,13 +264,39 @@ bool Stride::ComputeSecondaryStructure() {
 
     DiscrPhiPsi(ProteinChain, ProteinChainCnt, StrideCmd);
 
-    // find secondary structure (helices, sheets, turns)
+    // search the strand patterns of all pairs of valid chains in parallel, the patterns only depend on the hydrogen
+    // bonds and the torsion angles, but not on the secondary structure assigned so far
+    std::vector<std::pair<int, int>> sheetPairs;
+    for (Cn = 0; Cn < ProteinChainCnt; ++Cn) {
+        for (i = 0; i < ProteinChainCnt; ++i) {
+            if (ProteinChain[Cn]->Valid && ProteinChain[i]->Valid)
+                sheetPairs.emplace_back(Cn, i);
+        }
+    }
+    std::vector<std::vector<char>> sheetAsn(sheetPairs.size());
+#pragma omp parallel for schedule(dynamic)
+    for (int p = 0; p < static_cast<int>(sheetPairs.size()); ++p) {
+        int Cn1 = sheetPairs[p].first, Cn2 = sheetPairs[p].second;
+        int NRes1 = ProteinChain[Cn1]->NRes, NRes2 = ProteinChain[Cn2]->NRes;
+        sheetAsn[p].resize(2 * (NRes1 + NRes2));
+        char* AntiPar1 = sheetAsn[p].data();
+        char* Par1 = AntiPar1 + NRes1;
+        char* AntiPar2 = Par1 + NRes1;
+        char* Par2 = AntiPar2 + NRes2;
+        SheetPatterns(ProteinChain, Cn1, Cn2, HydroBond, StrideCmd, PhiPsiMapSheet, AntiPar1, Par1, AntiPar2, Par2);
+    }
+
+    // find secondary structure (helices, sheets, turns), the assignment order matters
+    size_t p = 0;
     for (Cn = 0; Cn < ProteinChainCnt; ++Cn) {
         if (ProteinChain[Cn]->Valid) {
             Helix(ProteinChain, Cn, HydroBond, StrideCmd, PhiPsiMapHelix);
-            for (i = 0; i < ProteinChainCnt; ++i) {
-                if (ProteinChain[i]->Valid)
-                    Sheet(ProteinChain, Cn, i, HydroBond, StrideCmd, PhiPsiMapSheet);
+            for (; p < sheetPairs.size() && sheetPairs[p].first == Cn; ++p) {
+                int Cn2 = sheetPairs[p].second;
+                int NRes1 = ProteinChain[Cn]->NRes, NRes2 = ProteinChain[Cn2]->NRes;
+                const char* AntiPar1 = sheetAsn[p].data();
+                SheetAssign(ProteinChain, Cn, Cn2, AntiPar1, AntiPar1 + NRes1, AntiPar1 + 2 * NRes1,
+                    AntiPar1 + 2 * NRes1 + NRes2);
             }
             BetaTurn(ProteinChain, Cn);
             GammaTurn(ProteinChain, Cn, HydroBond);
@@ -243,6 +306,9 @@ bool Stride::ComputeSecondaryStructure() {
     // find disulfide bonds
     SSBond(ProteinChain, ProteinChainCnt);
 
+    free(PhiPsiMapHelix);
+    free(PhiPsiMapSheet);
+
     return true;
 }
 
@@ -461,6 +527,7 @@ int Stride::CheckChain(CHAIN* Chain, COMMAND* Cmd) {
 void Stride::BackboneAngles(CHAIN** Chain, int NChain) {
     int Res, Cn;
 
+#pragma omp parallel for schedule(dynamic) private(Res)
     for (Cn = 0; Cn < NChain; Cn++) {
 
         for (Res = 0; Res < Chain[Cn]->NRes; Res++) {
@@ -655,6 +722,153 @@ int Stride::PlaceHydrogens(CHAIN* Chain) {
     return (PlacedCnt);
 }
 
+void Stride::FindMovedResidues(CHAIN** Chain, int NChain) {
+    static const char* Backbone[4] = {"N", "CA", "C", "O"};
+    int Cn, Res, i, At;
+
+    // the incremental mode needs an unchanged topology and does not track side chain atoms
+    int NRes = 0;
+    std::vector<int> Offset(NChain + 1, 0);
+    for (Cn = 0; Cn < NChain; Cn++) {
+        Offset[Cn] = NRes;
+        NRes += Chain[Cn]->NRes;
+    }
+    Offset[NChain] = NRes;
+    BOOLEAN Incremental = MovementThreshold > 0.0f && !StrideCmd->SideChainHBond && Offset == ResidueOffset;
+
+    if (!Incremental) {
+        ResidueOffset = Offset;
+        BackboneReference.assign(12 * NRes, 0.0f);
+        ResidueMoved.assign(NRes, 1);
+        CacheValid = false;
+    }
+
+    const float ThresholdSq = MovementThreshold * MovementThreshold;
+#pragma omp parallel for schedule(dynamic) private(Res, i, At)
+    for (Cn = 0; Cn < NChain; Cn++) {
+        for (Res = 0; Res < Chain[Cn]->NRes; Res++) {
+            float* Ref = &BackboneReference[12 * (ResidueOffset[Cn] + Res)];
+            RESIDUE* r = Chain[Cn]->Rsd[Res];
+            BOOLEAN Moved = !Incremental;
+            for (i = 0; i < 4 && !Moved; i++) {
+                if (FindAtom(Chain[Cn], Res, Backbone[i], &At)) {
+                    float dx = r->Coord[At][0] - Ref[3 * i + 0];
+                    float dy = r->Coord[At][1] - Ref[3 * i + 1];
+                    float dz = r->Coord[At][2] - Ref[3 * i + 2];
+                    Moved = dx * dx + dy * dy + dz * dz > ThresholdSq;
+                }
+            }
+            ResidueMoved[ResidueOffset[Cn] + Res] = Moved ? 1 : 0;
+            if (Moved) {
+                // the reference is only reset on movement, so slow drifts are detected as well
+                for (i = 0; i < 4; i++) {
+                    if (FindAtom(Chain[Cn], Res, Backbone[i], &At)) {
+                        Ref[3 * i + 0] = r->Coord[At][0];
+                        Ref[3 * i + 1] = r->Coord[At][1];
+                        Ref[3 * i + 2] = r->Coord[At][2];
+                    }
+                }
+            }
+        }
+    }
+}
+
+Stride::BOOLEAN Stride::EvaluateHBond(DONOR* Dnr, ACCEPTOR* Acc, COMMAND* Cmd, HBOND* HBond) {
+    HBond->ExistHydrBondRose = STRIDE_NO;
+    HBond->ExistHydrBondBaker = STRIDE_NO;
+    HBond->ExistPolarInter = STRIDE_NO;
+
+    if ((HBond->AccDonDist = Dist(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) <= Cmd->DistCutOff) {
+
+        if (Cmd->MainChainPolarInt && Dnr->Group == Peptide && Acc->Group == Peptide && Dnr->H != ERR) {
+            GRID_Energy(Acc->Chain->Rsd[Acc->AA2_Res]->Coord[Acc->AA2_At],
+                Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At], Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H], Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At], Cmd,
+                HBond);
+
+            if (HBond->Energy < -10.0 &&
+                ((Cmd->EnergyType == 'G' && fabs(HBond->Et) > Eps && fabs(HBond->Ep) > Eps) ||
+                    Cmd->EnergyType != 'G'))
+                HBond->ExistPolarInter = STRIDE_YES;
+        }
+
+        if (Cmd->MainChainHBond &&
+            (HBond->OHDist = Dist(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+                 Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) <= 2.5 &&
+            (HBond->AngNHO = Ang(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                 Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+                 Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) >= 90.0 &&
+            HBond->AngNHO <= 180.0 &&
+            (HBond->AngCOH = Ang(Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+                 Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                 Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H])) >= 90.0 &&
+
+            HBond->AngCOH <= 180.0)
+            HBond->ExistHydrBondBaker = STRIDE_YES;
+
+        if (Cmd->MainChainHBond && HBond->AccDonDist <= Dnr->HB_Radius + Acc->HB_Radius) {
+
+            HBond->AccAng = Ang(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At]);
+
+            if (((Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                    (HBond->AccAng >= MINACCANG_SP2 && HBond->AccAng <= MAXACCANG_SP2)) ||
+                ((Acc->Hybrid == Ssp3 || Acc->Hybrid == Osp3) &&
+                    (HBond->AccAng >= MINACCANG_SP3 && HBond->AccAng <= MAXACCANG_SP3))) {
+
+                HBond->DonAng = Ang(Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                    Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                    Dnr->Chain->Rsd[Dnr->DD_Res]->Coord[Dnr->DD_At]);
+
+                if (((Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) &&
+                        (HBond->DonAng >= MINDONANG_SP2 && HBond->DonAng <= MAXDONANG_SP2)) ||
+                    ((Dnr->Hybrid == Nsp3 || Dnr->Hybrid == Osp3) &&
+                        (HBond->DonAng >= MINDONANG_SP3 && HBond->DonAng <= MAXDONANG_SP3))) {
+
+                    if (Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) {
+                        HBond->AccDonAng =
+                            fabs(Torsion(Dnr->Chain->Rsd[Dnr->DDI_Res]->Coord[Dnr->DDI_At],
+                                Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                                Dnr->Chain->Rsd[Dnr->DD_Res]->Coord[Dnr->DD_At],
+                                Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At]));
+
+                        if (HBond->AccDonAng > 90.0f && HBond->AccDonAng < 270.0f)
+                            HBond->AccDonAng = fabs(180.0f - HBond->AccDonAng);
+                    }
+
+                    if (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) {
+                        HBond->DonAccAng =
+                            fabs(Torsion(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                                Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                                Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+                                Acc->Chain->Rsd[Acc->AA2_Res]->Coord[Acc->AA2_At]));
+
+                        if (HBond->DonAccAng > 90.0f && HBond->DonAccAng < 270.0f)
+                            HBond->DonAccAng = fabs(180.0f - HBond->DonAccAng);
+                    }
+
+                    if ((Dnr->Hybrid != Nsp2 && Dnr->Hybrid != Osp2 && Acc->Hybrid != Nsp2 &&
+                            Acc->Hybrid != Osp2) ||
+                        (Acc->Hybrid != Nsp2 && Acc->Hybrid != Osp2 &&
+                            (Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) &&
+                            HBond->AccDonAng <= ACCDONANG) ||
+                        (Dnr->Hybrid != Nsp2 && Dnr->Hybrid != Osp2 &&
+                            (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                            HBond->DonAccAng <= DONACCANG) ||
+                        ((Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) &&
+                            (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                            HBond->AccDonAng <= ACCDONANG && HBond->DonAccAng <= DONACCANG))
+                        HBond->ExistHydrBondRose = STRIDE_YES;
+                }
+            }
+        }
+    }
+
+    return ((HBond->ExistPolarInter && HBond->Energy < 0.0) || HBond->ExistHydrBondRose || HBond->ExistHydrBondBaker);
+}
+
 int Stride::FindHydrogenBonds(CHAIN** Chain, int NChain, HBOND** HBond, COMMAND* Cmd) {
     DONOR** Dnr;
     ACCEPTOR** Acc;
@@ -669,181 +883,130 @@ int Stride::FindHydrogenBonds(CHAIN** Chain, int NChain, HBOND** HBond, COMMAND*
         FindAcc(Chain[cc], Acc, &NAcc, Cmd);
     }
 
-    BOOLEAN *BondedDonor, *BondedAcceptor;
-    BondedDonor = (BOOLEAN*)ckalloc(NDnr * sizeof(BOOLEAN));
-    BondedAcceptor = (BOOLEAN*)ckalloc(NAcc * sizeof(BOOLEAN));
+    // sort the acceptors into a grid, so that each donor only tests the acceptors within the distance cut off
+    std::vector<float> AccPos(3 * NAcc);
+    float BBoxMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, BBoxMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (ac = 0; ac < NAcc; ac++) {
+        for (i = 0; i < 3; i++) {
+            AccPos[3 * ac + i] = Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At][i];
+            BBoxMin[i] = std::min(BBoxMin[i], AccPos[3 * ac + i]);
+            BBoxMax[i] = std::max(BBoxMax[i], AccPos[3 * ac + i]);
+        }
+    }
+    const float SearchDist = Cmd->DistCutOff + 0.01f;
+    GridNeighbourFinder<float> AccGrid;
+    if (NAcc > 0) {
+        AccGrid.SetPointData(AccPos.data(), NAcc,
+            vislib::math::Cuboid<float>(BBoxMin[0], BBoxMin[1], BBoxMin[2], BBoxMax[0], BBoxMax[1], BBoxMax[2]),
+            SearchDist);
+    }
+
+    // without a valid cache from the last computation all donors have to be evaluated
+    BOOLEAN Incremental = MovementThreshold > 0.0f && CacheValid && (int)DonorBondCache.size() == NDnr &&
+                          CachedNAcc == NAcc && (int)ResidueMoved.size() == ResidueOffset.back();
+    if (!Incremental)
+        DonorBondCache.assign(NDnr, std::vector<CACHEDHBOND>());
+    auto Moved = [this](CHAIN* Chain, int Res) {
+        return Res >= 0 && ResidueMoved[ResidueOffset[Chain->ChainId] + Res] != 0;
+    };
+    auto AccMoved = [&Moved](ACCEPTOR* A) {
+        return Moved(A->Chain, A->A_Res) || Moved(A->Chain, A->AA_Res) || Moved(A->Chain, A->AA2_Res);
+    };
+
+    // evaluate all donor/acceptor pairs in parallel, the bonds of each donor are kept in ascending acceptor order
+#pragma omp parallel
+    {
+        std::vector<unsigned int> Candidates;
+        HBOND Bond;
+#pragma omp for schedule(dynamic, 64)
+        for (int d = 0; d < NDnr; d++) {
+            DONOR* D = Dnr[d];
+            if (D->Group != Peptide && !Cmd->SideChainHBond)
+                continue;
 
-    for (i = 0; i < NDnr; i++)
-        BondedDonor[i] = STRIDE_NO;
-    for (i = 0; i < NAcc; i++)
-        BondedAcceptor[i] = STRIDE_NO;
+            Candidates.clear();
+            AccGrid.FindNeighboursInRange(D->Chain->Rsd[D->D_Res]->Coord[D->D_At], SearchDist, Candidates);
+            std::sort(Candidates.begin(), Candidates.end());
+
+            if (Incremental) {
+                // the cached bonds stay valid if neither the donor nor any of its (old and new) partners moved
+                bool Dirty = Moved(D->Chain, D->D_Res) || Moved(D->Chain, D->DD_Res) || Moved(D->Chain, D->DDI_Res);
+                for (size_t c = 0; c < Candidates.size() && !Dirty; c++)
+                    Dirty = AccMoved(Acc[Candidates[c]]);
+                for (size_t c = 0; c < DonorBondCache[d].size() && !Dirty; c++)
+                    Dirty = AccMoved(Acc[DonorBondCache[d][c].Acc]);
+                if (!Dirty)
+                    continue;
+            }
 
-    for (dc = 0; dc < NDnr; dc++) {
+            DonorBondCache[d].clear();
+            for (size_t c = 0; c < Candidates.size(); c++) {
+                int a = static_cast<int>(Candidates[c]);
 
-        if (Dnr[dc]->Group != Peptide && !Cmd->SideChainHBond)
-            continue;
+                if (abs(Acc[a]->A_Res - D->D_Res) < 2 && Acc[a]->Chain->Id == D->Chain->Id)
+                    continue;
 
-        for (ac = 0; ac < NAcc; ac++) {
+                if (Acc[a]->Group != Peptide && !Cmd->SideChainHBond)
+                    continue;
 
-            if (abs(Acc[ac]->A_Res - Dnr[dc]->D_Res) < 2 && Acc[ac]->Chain->Id == Dnr[dc]->Chain->Id)
-                continue;
+                memset(&Bond, 0, sizeof(HBOND));
+                if (EvaluateHBond(D, Acc[a], Cmd, &Bond)) {
+                    DonorBondCache[d].push_back(CACHEDHBOND{a, Bond});
+                }
+            }
+        }
+    }
+    CachedNAcc = NAcc;
+    CacheValid = MovementThreshold > 0.0f;
 
-            if (Acc[ac]->Group != Peptide && !Cmd->SideChainHBond)
-                continue;
+    // register the bonds in the same order as the exhaustive search over all pairs would do
+    for (dc = 0; dc < NDnr; dc++) {
+        for (const auto& Cached : DonorBondCache[dc]) {
+            ac = Cached.Acc;
 
             if (hc == MAXHYDRBOND)
                 die("Number of hydrogen bonds exceeds current limit of %d in %s\n", MAXHYDRBOND, Chain[0]->File);
             HBond[hc] = (HBOND*)ckalloc(sizeof(HBOND));
-
-            HBond[hc]->ExistHydrBondRose = STRIDE_NO;
-            HBond[hc]->ExistHydrBondBaker = STRIDE_NO;
-            HBond[hc]->ExistPolarInter = STRIDE_NO;
-
-            if ((HBond[hc]->AccDonDist = Dist(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                     Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) <= Cmd->DistCutOff) {
-
-
-                if (Cmd->MainChainPolarInt && Dnr[dc]->Group == Peptide && Acc[ac]->Group == Peptide &&
-                    Dnr[dc]->H != ERR) {
-                    GRID_Energy(Acc[ac]->Chain->Rsd[Acc[ac]->AA2_Res]->Coord[Acc[ac]->AA2_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At], Cmd, HBond[hc]);
-
-                    if (HBond[hc]->Energy < -10.0 &&
-                        ((Cmd->EnergyType == 'G' && fabs(HBond[hc]->Et) > Eps && fabs(HBond[hc]->Ep) > Eps) ||
-                            Cmd->EnergyType != 'G'))
-                        HBond[hc]->ExistPolarInter = STRIDE_YES;
-                }
-
-                if (Cmd->MainChainHBond &&
-                    (HBond[hc]->OHDist = Dist(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) <= 2.5 &&
-                    (HBond[hc]->AngNHO = Ang(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                         Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) >= 90.0 &&
-                    HBond[hc]->AngNHO <= 180.0 &&
-                    (HBond[hc]->AngCOH = Ang(Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                         Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H])) >= 90.0 &&
-
-                    HBond[hc]->AngCOH <= 180.0)
-                    HBond[hc]->ExistHydrBondBaker = STRIDE_YES;
-
-                if (Cmd->MainChainHBond && HBond[hc]->AccDonDist <= Dnr[dc]->HB_Radius + Acc[ac]->HB_Radius) {
-
-                    HBond[hc]->AccAng = Ang(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At]);
-
-                    if (((Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                            (HBond[hc]->AccAng >= MINACCANG_SP2 && HBond[hc]->AccAng <= MAXACCANG_SP2)) ||
-                        ((Acc[ac]->Hybrid == Ssp3 || Acc[ac]->Hybrid == Osp3) &&
-                            (HBond[hc]->AccAng >= MINACCANG_SP3 && HBond[hc]->AccAng <= MAXACCANG_SP3))) {
-
-                        HBond[hc]->DonAng = Ang(Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                            Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                            Dnr[dc]->Chain->Rsd[Dnr[dc]->DD_Res]->Coord[Dnr[dc]->DD_At]);
-
-                        if (((Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                (HBond[hc]->DonAng >= MINDONANG_SP2 && HBond[hc]->DonAng <= MAXDONANG_SP2)) ||
-                            ((Dnr[dc]->Hybrid == Nsp3 || Dnr[dc]->Hybrid == Osp3) &&
-                                (HBond[hc]->DonAng >= MINDONANG_SP3 && HBond[hc]->DonAng <= MAXDONANG_SP3))) {
-
-                            if (Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) {
-                                HBond[hc]->AccDonAng =
-                                    fabs(Torsion(Dnr[dc]->Chain->Rsd[Dnr[dc]->DDI_Res]->Coord[Dnr[dc]->DDI_At],
-                                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                        Dnr[dc]->Chain->Rsd[Dnr[dc]->DD_Res]->Coord[Dnr[dc]->DD_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At]));
-
-                                if (HBond[hc]->AccDonAng > 90.0f && HBond[hc]->AccDonAng < 270.0f)
-                                    HBond[hc]->AccDonAng = fabs(180.0f - HBond[hc]->AccDonAng);
-                            }
-
-                            if (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) {
-                                HBond[hc]->DonAccAng =
-                                    fabs(Torsion(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->AA2_Res]->Coord[Acc[ac]->AA2_At]));
-
-                                if (HBond[hc]->DonAccAng > 90.0f && HBond[hc]->DonAccAng < 270.0f)
-                                    HBond[hc]->DonAccAng = fabs(180.0f - HBond[hc]->DonAccAng);
-                            }
-
-                            if ((Dnr[dc]->Hybrid != Nsp2 && Dnr[dc]->Hybrid != Osp2 && Acc[ac]->Hybrid != Nsp2 &&
-                                    Acc[ac]->Hybrid != Osp2) ||
-                                (Acc[ac]->Hybrid != Nsp2 && Acc[ac]->Hybrid != Osp2 &&
-                                    (Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                    HBond[hc]->AccDonAng <= ACCDONANG) ||
-                                (Dnr[dc]->Hybrid != Nsp2 && Dnr[dc]->Hybrid != Osp2 &&
-                                    (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                                    HBond[hc]->DonAccAng <= DONACCANG) ||
-                                ((Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                    (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                                    HBond[hc]->AccDonAng <= ACCDONANG && HBond[hc]->DonAccAng <= DONACCANG))
-                                HBond[hc]->ExistHydrBondRose = STRIDE_YES;
-                        }
-                    }
-                }
+            memcpy(HBond[hc], &Cached.Bond, sizeof(HBOND));
+
+            HBond[hc]->Dnr = Dnr[dc];
+            HBond[hc]->Acc = Acc[ac];
+            if ((ccd = FindChain(Chain, NChain, Dnr[dc]->Chain->Id)) != ERR) {
+                if (Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr < MAXRESDNR)
+                    Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->HBondDnr[Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr++] =
+                        hc;
+                else
+                    printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
+                        Chain[ccd]->Rsd[Dnr[dc]->D_Res]->ResType, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->PDB_ResNumb,
+                        Chain[ccd]->ChainId, MAXRESDNR, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr);
             }
-
-            if ((HBond[hc]->ExistPolarInter && HBond[hc]->Energy < 0.0) || HBond[hc]->ExistHydrBondRose ||
-                HBond[hc]->ExistHydrBondBaker) {
-                HBond[hc]->Dnr = Dnr[dc];
-                HBond[hc]->Acc = Acc[ac];
-                BondedDonor[dc] = STRIDE_YES;
-                BondedAcceptor[ac] = STRIDE_YES;
-                if ((ccd = FindChain(Chain, NChain, Dnr[dc]->Chain->Id)) != ERR) {
-                    if (Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr < MAXRESDNR)
-                        Chain[ccd]
-                            ->Rsd[Dnr[dc]->D_Res]
-                            ->Inv->HBondDnr[Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr++] = hc;
-                    else
-                        printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
-                            Chain[ccd]->Rsd[Dnr[dc]->D_Res]->ResType, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->PDB_ResNumb,
-                            Chain[ccd]->ChainId, MAXRESDNR, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr);
-                }
-                if ((cca = FindChain(Chain, NChain, Acc[ac]->Chain->Id)) != ERR) {
-                    if (Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc < MAXRESACC)
-                        Chain[cca]
-                            ->Rsd[Acc[ac]->A_Res]
-                            ->Inv->HBondAcc[Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc++] = hc;
-                    else
-                        printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
-                            Chain[cca]->Rsd[Acc[ac]->A_Res]->ResType, Chain[cca]->Rsd[Acc[ac]->A_Res]->PDB_ResNumb,
-                            Chain[cca]->ChainId, MAXRESDNR, Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc);
-                }
-                if (ccd != cca && ccd != ERR) {
-                    Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->InterchainHBonds = STRIDE_YES;
-                    Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->InterchainHBonds = STRIDE_YES;
-                    if (HBond[hc]->ExistHydrBondRose) {
-                        Chain[0]->NHydrBondInterchain++;
-                        Chain[0]->NHydrBondTotal++;
-                    }
-                } else if (ccd == cca && ccd != ERR && HBond[hc]->ExistHydrBondRose) {
-                    Chain[ccd]->NHydrBond++;
+            if ((cca = FindChain(Chain, NChain, Acc[ac]->Chain->Id)) != ERR) {
+                if (Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc < MAXRESACC)
+                    Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->HBondAcc[Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc++] =
+                        hc;
+                else
+                    printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
+                        Chain[cca]->Rsd[Acc[ac]->A_Res]->ResType, Chain[cca]->Rsd[Acc[ac]->A_Res]->PDB_ResNumb,
+                        Chain[cca]->ChainId, MAXRESDNR, Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc);
+            }
+            if (ccd != cca && ccd != ERR) {
+                Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->InterchainHBonds = STRIDE_YES;
+                Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->InterchainHBonds = STRIDE_YES;
+                if (HBond[hc]->ExistHydrBondRose) {
+                    Chain[0]->NHydrBondInterchain++;
                     Chain[0]->NHydrBondTotal++;
                 }
-                hc++;
-            } else
-                free(HBond[hc]);
+            } else if (ccd == cca && ccd != ERR && HBond[hc]->ExistHydrBondRose) {
+                Chain[ccd]->NHydrBond++;
+                Chain[0]->NHydrBondTotal++;
+            }
+            hc++;
         }
     }
 
-    for (i = 0; i < NDnr; i++)
-        if (!BondedDonor[i])
-            free(Dnr[i]);
-    for (i = 0; i < NAcc; i++)
-        if (!BondedAcceptor[i])
-            free(Acc[i]);
-
-    // if ( NDnr )
-    free(BondedDonor);
-    // if ( NAcc )
-    free(BondedAcceptor);
+    // the donors and acceptors are referenced by the bonds and freed with the chains
+    Donors.assign(Dnr, Dnr + NDnr);
+    Acceptors.assign(Acc, Acc + NAcc);
 
     free(Dnr);
     free(Acc);
@@ -875,6 +1038,7 @@ void Stride::DiscrPhiPsi(CHAIN** Chain, int NChain, COMMAND* Cmd) {
     int i, Res, Cn;
     RESIDUE* r;
 
+#pragma omp parallel for schedule(dynamic) private(i, Res, r)
     for (Cn = 0; Cn < NChain; Cn++) {
 
         for (Res = 0; Res < Chain[Cn]->NRes; Res++) {
@@ -995,20 +1159,32 @@ void Stride::Helix(CHAIN** Chain, int Cn, HBOND** HBond, COMMAND* Cmd, float** P
 }
 
 void Stride::Sheet(CHAIN** Chain, int Cn1, int Cn2, HBOND** HBond, COMMAND* Cmd, float** PhiPsiMap) {
+    char *AntiPar1, *Par1, *AntiPar2, *Par2;
+
+    AntiPar1 = (char*)ckalloc(Chain[Cn1]->NRes * sizeof(char)); /* Antiparallel strands */
+    Par1 = (char*)ckalloc(Chain[Cn1]->NRes * sizeof(char));     /* Parallel strands */
+    AntiPar2 = (char*)ckalloc(Chain[Cn2]->NRes * sizeof(char)); /* Antiparallel strands */
+    Par2 = (char*)ckalloc(Chain[Cn2]->NRes * sizeof(char));     /* Parallel strands */
+
+    SheetPatterns(Chain, Cn1, Cn2, HBond, Cmd, PhiPsiMap, AntiPar1, Par1, AntiPar2, Par2);
+    SheetAssign(Chain, Cn1, Cn2, AntiPar1, Par1, AntiPar2, Par2);
+
+    free(AntiPar1);
+    free(Par1);
+    free(AntiPar2);
+    free(Par2);
+}
+
+void Stride::SheetPatterns(CHAIN** Chain, int Cn1, int Cn2, HBOND** HBond, COMMAND* Cmd, float** PhiPsiMap,
+    char* AntiPar1, char* Par1, char* AntiPar2, char* Par2) {
     PATTERN **PatN, **PatP;
     RESIDUE *Res1, *Res3, *Res2, *Res4, *ResA, *ResB, *Res1m1, *Res3p1;
     int R1, R3, R2, R4, RA, RB, PatCntN = 0, PatCntP = 0, Beg;
-    char *AntiPar1, *Par1, *AntiPar2, *Par2;
     int i;
 
     PatN = (PATTERN**)ckalloc(MAXHYDRBOND * sizeof(PATTERN*));
     PatP = (PATTERN**)ckalloc(MAXHYDRBOND * sizeof(PATTERN*));
 
-    AntiPar1 = (char*)ckalloc(Chain[Cn1]->NRes * sizeof(char)); /* Antiparallel strands */
-    Par1 = (char*)ckalloc(Chain[Cn1]->NRes * sizeof(char));     /* Parallel strands */
-    AntiPar2 = (char*)ckalloc(Chain[Cn2]->NRes * sizeof(char)); /* Antiparallel strands */
-    Par2 = (char*)ckalloc(Chain[Cn2]->NRes * sizeof(char));     /* Parallel strands */
-
     for (i = 0; i < Chain[Cn1]->NRes; i++) {
         AntiPar1[i] = 'C';
         Par1[i] = 'C';
@@ -1115,6 +1291,20 @@ void Stride::Sheet(CHAIN** Chain, int Cn1, int Cn2, HBOND** HBond, COMMAND* Cmd,
     Bridge(AntiPar1, AntiPar2, Chain, Cn1, Cn2, PatN, PatCntN);
     Bridge(Par1, Par2, Chain, Cn1, Cn2, PatP, PatCntP);
 
+    /*
+      for( i=0; i<PatCntN; i++ )
+        free(PatN[i]);
+      for( i=0; i<PatCntP; i++ )
+        free(PatP[i]);
+    */
+    free(PatN);
+    free(PatP);
+}
+
+void Stride::SheetAssign(
+    CHAIN** Chain, int Cn1, int Cn2, const char* AntiPar1, const char* Par1, const char* AntiPar2, const char* Par2) {
+    int i;
+
     for (i = 0; i < Chain[Cn1]->NRes; i++)
         if (AntiPar1[i] == 'N' || Par1[i] == 'P')
             Chain[Cn1]->Rsd[i]->Prop->Asn = 'E';
@@ -1132,19 +1322,6 @@ void Stride::Sheet(CHAIN** Chain, int Cn1, int Cn2, HBOND** HBond, COMMAND* Cmd,
             Chain[Cn2]->Rsd[i]->Prop->Asn = 'B';
         else if (AntiPar2[i] == 'b' || Par2[i] == 'b')
             Chain[Cn2]->Rsd[i]->Prop->Asn = 'b';
-
-    /*
-      for( i=0; i<PatCntN; i++ )
-        free(PatN[i]);
-      for( i=0; i<PatCntP; i++ )
-        free(PatP[i]);
-    */
-    free(PatN);
-    free(PatP);
-    free(AntiPar1);
-    free(Par1);
-    free(AntiPar2);
-    free(Par2);
 }
 
 void Stride::BetaTurn(CHAIN** Chain, int Cn) {
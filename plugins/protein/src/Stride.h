@@ -275,6 +275,21 @@ public:
     Stride(megamol::protein_calls::MolecularDataCall* mol);
     virtual ~Stride();
 
+    /**
+     * Recomputes the secondary structure for the current atom positions of 'mol'.
+     *
+     * If 'movementThreshold' is positive and the topology did not change since the last computation, the hydrogen
+     * bond search is done incrementally: only donors whose own residue or whose potential acceptor residues had a
+     * backbone atom moving more than 'movementThreshold' since it was last evaluated are re-evaluated, the bonds of
+     * all other donors are taken over from the last computation.
+     *
+     * @param mol               The molecular data.
+     * @param movementThreshold The backbone displacement threshold in Angstrom, 0 disables the incremental mode.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool Update(megamol::protein_calls::MolecularDataCall* mol, float movementThreshold);
+
     bool WriteToInterface(megamol::protein_calls::MolecularDataCall* mol);
 
 protected:
@@ -284,6 +299,20 @@ protected:
         unsigned int acceptor;
     } OWNBOND;
 
+    typedef struct // CACHEDHBOND
+    {
+        int Acc;
+        HBOND Bond;
+    } CACHEDHBOND;
+
+    void FreeData();
+    void FindMovedResidues(CHAIN** Chain, int NChain);
+    BOOLEAN EvaluateHBond(DONOR* Dnr, ACCEPTOR* Acc, COMMAND* Cmd, HBOND* HBond);
+    void SheetPatterns(CHAIN** Chain, int Cn1, int Cn2, HBOND** HBond, COMMAND* Cmd, float** PhiPsiMap,
+        char* AntiPar1, char* Par1, char* AntiPar2, char* Par2);
+    void SheetAssign(CHAIN** Chain, int Cn1, int Cn2, const char* AntiPar1, const char* Par1, const char* AntiPar2,
+        const char* Par2);
+
     void GetChains(megamol::protein_calls::MolecularDataCall* mol);
     bool ComputeSecondaryStructure();
 
@@ -381,6 +410,19 @@ private:
     int HydroBondCnt;
     std::vector<unsigned int> ownHydroBonds;
 
+    // all donors and acceptors of the last hydrogen bond search (referenced by 'HydroBond')
+    std::vector<DONOR*> Donors;
+    std::vector<ACCEPTOR*> Acceptors;
+
+    // incremental mode: displacement threshold, reference backbone positions and the bonds found per donor
+    float MovementThreshold;
+    std::vector<int> ResidueOffset;
+    std::vector<float> BackboneReference;
+    std::vector<char> ResidueMoved;
+    std::vector<std::vector<CACHEDHBOND>> DonorBondCache;
+    int CachedNAcc;
+    bool CacheValid;
+
     // was the computation successful?
     bool Successful;
 };
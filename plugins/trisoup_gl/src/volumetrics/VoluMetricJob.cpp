@@ -12,6 +12,7 @@
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmcore/utility/log/Log.h"
+#include "mmcore/utility/sys/TaskScheduler.h"
 #include "trisoup/volumetrics/MarchingCubeTables.h"
 #include "vislib/graphics/NamedColours.h"
 #include "vislib/math/ShallowPoint.h"
@@ -20,7 +21,6 @@
 #include "vislib/sys/ConsoleProgressBar.h"
 #include "vislib/sys/SystemInformation.h"
 #include "vislib/sys/Thread.h"
-#include "vislib/sys/ThreadPool.h"
 #include "vislib/sys/sysfunctions.h"
 #include <cfloat>
 #include <climits>
@@ -164,8 +164,7 @@ DWORD VoluMetricJob::Run(void* userData) {
 
     for (unsigned int frameI = 0; frameI < frameCnt; frameI++) {
 
-        vislib::sys::ThreadPool pool;
-        //pool.SetThreadCount(static_cast<SIZE_T>(vislib::sys::SystemInformation::ProcessorCount() * 1.5));
+        core::utility::sys::TaskScheduler::TaskGroup voxelizerTasks;
 
         datacall->SetFrameID(frameI, true);
         do {
@@ -334,7 +333,7 @@ DWORD VoluMetricJob::Run(void* userData) {
                     voxelizerList.Add(v);
 
                     //if (z == 0 && y == 0) {
-                    pool.QueueUserWorkItem(v, sjd);
+                    voxelizerTasks.Run([v, sjd]() { v->Run(sjd); });
                     //}
                 }
             }
@@ -355,23 +354,29 @@ DWORD VoluMetricJob::Run(void* userData) {
         vislib::Array<trisoup::volumetrics::VoxelizerFloat> volPerID;
         vislib::Array<trisoup::volumetrics::VoxelizerFloat> voidVolPerID;
 
-        SIZE_T lastCount = pool.CountUserWorkItems();
-        while (1) {
-            if (pool.Wait(500) && pool.CountUserWorkItems() == 0) {
-                // we are done
-                break;
-            }
-            if (lastCount != pool.CountUserWorkItems()) {
+        SIZE_T lastCount = voxelizerTasks.Pending();
+        while (voxelizerTasks.Pending() > 0) {
+            vislib::sys::Thread::Sleep(500);
+            if (lastCount != voxelizerTasks.Pending()) {
                 pb.Set(
-                    static_cast<vislib::sys::ConsoleProgressBar::Size>(divX * divY * divZ - pool.CountUserWorkItems()));
+                    static_cast<vislib::sys::ConsoleProgressBar::Size>(divX * divY * divZ - voxelizerTasks.Pending()));
                 generateStatistics(uniqueIDs, countPerID, surfPerID, volPerID, voidVolPerID);
                 if (storeMesh)
                     copyMeshesToBackbuffer(uniqueIDs);
                 if (storeVolume)
                     copyVolumesToBackBuffer();
-                lastCount = pool.CountUserWorkItems();
+                lastCount = voxelizerTasks.Pending();
             }
         }
+        try {
+            voxelizerTasks.Wait();
+        } catch (std::exception const& ex) {
+            Log::DefaultLog.WriteError("Voxelizing frame %u failed: %s", frameI, ex.what());
+            return -4;
+        } catch (...) {
+            Log::DefaultLog.WriteError("Voxelizing frame %u failed with unknown exception", frameI);
+            return -4;
+        }
         generateStatistics(uniqueIDs, countPerID, surfPerID, volPerID, voidVolPerID);
         outputStatistics(frameI, uniqueIDs, countPerID, surfPerID, volPerID, voidVolPerID);
         if (storeMesh)
@@ -380,7 +385,6 @@ DWORD VoluMetricJob::Run(void* userData) {
             copyVolumesToBackBuffer();
         pb.Stop();
         Log::DefaultLog.WriteInfo("Done marching.");
-        pool.Terminate(true);
 
         while (!this->continueToNextFrameSlot.Param<megamol::core::param::BoolParam>()->Value()) {
             vislib::sys::Thread::Sleep(500);
@@ -8,8 +8,10 @@
 #include "DifferenceVolume.h"
 
 #include <limits>
+#include <type_traits>
 
 #include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 
 #include "mmcore/utility/log/Log.h"
 
@@ -24,6 +26,9 @@ megamol::volume::DifferenceVolume::DifferenceVolume()
         , hashState((std::numeric_limits<std::size_t>::max)())
         , paramIgnoreInputHash(
               "ignoreInputHash", "Instructs the module not to honour the input hash when checking for updates.")
+        , paramOperation("operation", "The voxel-wise operation applied to the current and the previous frame.")
+        , srcScalarLength(0)
+        , srcScalarType(geocalls::UNKNOWN)
         , slotIn("in", "The input slot providing the volume data.")
         , slotOut("out", "The output slot receiving the difference.") {
     using geocalls::VolumetricDataCall;
@@ -47,6 +52,14 @@ megamol::volume::DifferenceVolume::DifferenceVolume()
 
     this->paramIgnoreInputHash << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->paramIgnoreInputHash);
+
+    {
+        auto param = new core::param::EnumParam(OPERATION_DIFFERENCE);
+        param->SetTypePair(OPERATION_DIFFERENCE, "Difference");
+        param->SetTypePair(OPERATION_RATIO, "Ratio");
+        this->paramOperation << param;
+    }
+    this->MakeSlotAvailable(&this->paramOperation);
 }
 
 
@@ -96,23 +109,24 @@ megamol::geocalls::ScalarType_t megamol::volume::DifferenceVolume::getDifference
  */
 bool megamol::volume::DifferenceVolume::checkCompatibility(const geocalls::VolumetricMetadata_t& md) const {
     using megamol::core::utility::log::Log;
-    auto reqType = getDifferenceType(md);
 
-    if (getFrameSize(this->metadata) != getFrameSize(md)) {
+    const auto& ref = this->metadata;
+    if (md.Resolution[0] * md.Resolution[1] * md.Resolution[2] * md.Components !=
+        ref.Resolution[0] * ref.Resolution[1] * ref.Resolution[2] * ref.Components) {
         Log::DefaultLog.WriteError("The volume resolution must not change "
                                    "over time in order for %hs to work.",
             DifferenceVolume::ClassName());
         return false;
     }
 
-    if ((this->metadata.ScalarLength != md.ScalarLength) && (md.ScalarType == reqType)) {
+    if (this->srcScalarLength != md.ScalarLength) {
         Log::DefaultLog.WriteError("The scalar size must not change over time "
                                    "in order for %hs to work.",
             DifferenceVolume::ClassName());
         return false;
     }
 
-    if (this->metadata.ScalarType != reqType) {
+    if (this->srcScalarType != md.ScalarType) {
         Log::DefaultLog.WriteError("The scalar type must not change over time "
                                    "in order for %hs to work.",
             DifferenceVolume::ClassName());
@@ -123,6 +137,22 @@ bool megamol::volume::DifferenceVolume::checkCompatibility(const geocalls::Volum
 }
 
 
+/*
+ * megamol::volume::DifferenceVolume::setResultType
+ */
+void megamol::volume::DifferenceVolume::setResultType(geocalls::VolumetricMetadata_t& md) const {
+    if (this->paramOperation.Param<core::param::EnumParam>()->Value() == OPERATION_RATIO) {
+        md.ScalarType = geocalls::FLOATING_POINT;
+        md.ScalarLength = (md.ScalarLength == 8) ? 8 : 4;
+    } else {
+        if (md.ScalarType == geocalls::UNSIGNED_INTEGER) {
+            md.ScalarLength = (std::min)(2 * md.ScalarLength, static_cast<std::size_t>(8));
+        }
+        md.ScalarType = getDifferenceType(md);
+    }
+}
+
+
 /*
  * megamol::volume::DifferenceVolume::create
  */
@@ -141,7 +171,8 @@ bool megamol::volume::DifferenceVolume::onGetData(core::Call& call) {
 
     auto dst = dynamic_cast<VolumetricDataCall*>(&call);
     auto src = this->slotIn.CallAs<VolumetricDataCall>();
-    const auto localUpdate = this->paramIgnoreInputHash.IsDirty();
+    const auto localUpdate = this->paramIgnoreInputHash.IsDirty() || this->paramOperation.IsDirty();
+    const auto ratio = this->paramOperation.Param<core::param::EnumParam>()->Value() == OPERATION_RATIO;
     const auto ignoreHash = this->paramIgnoreInputHash.Param<BoolParam>()->Value();
 
     /* Sanity checks. */
@@ -196,15 +227,20 @@ bool megamol::volume::DifferenceVolume::onGetData(core::Call& call) {
 
         /* Everything is OK at this point, save the reference data. */
         this->metadata = *src->GetMetadata();
+        this->srcScalarType = src->GetMetadata()->ScalarType;
+        this->srcScalarLength = src->GetMetadata()->ScalarLength;
+        this->setResultType(this->metadata);
 
         /* Reset the caching state. */
         this->frameID = (std::numeric_limits<unsigned int>::max)();
         this->frameIdx = 0;
         this->hashData = src->DataHash();
+        ++this->hashState;
 
         /* Mark local state as unchanged. */
         if (localUpdate) {
             this->paramIgnoreInputHash.ResetDirty();
+            this->paramOperation.ResetDirty();
         }
     }
 
@@ -228,6 +264,7 @@ bool megamol::volume::DifferenceVolume::onGetData(core::Call& call) {
         }
 
         /* Prepare a cache location for the current frame. */
+        const auto curFrameID = src->FrameID();
         auto& cur = this->cache[this->frameIdx];
         cur.resize(src->GetFrameSize());
         ::memcpy(cur.data(), src->GetData(), src->GetFrameSize());
@@ -236,7 +273,8 @@ bool megamol::volume::DifferenceVolume::onGetData(core::Call& call) {
         auto& prev = this->cache[increment(this->frameIdx)];
 
         /* Prepare the data storage. */
-        this->data.resize(cur.size());
+        const auto cnt = cur.size() / this->srcScalarLength;
+        this->data.resize(cnt * this->metadata.ScalarLength);
 
         if (src->FrameID() < 1) {
             /* There is no predecessor, so the frame is the difference. */
@@ -270,130 +308,46 @@ bool megamol::volume::DifferenceVolume::onGetData(core::Call& call) {
             }
 
             prev.resize(src->GetFrameSize());
-            ::memcpy(cur.data(), src->GetData(), src->GetFrameSize());
+            ::memcpy(prev.data(), src->GetData(), src->GetFrameSize());
         }
         /* At this point, 'prev' contains the previous frame. */
-        assert(cur.size() == this->data.size());
-        assert(prev.size() == this->data.size());
-
-        /* Do the conversion depending on the type of the data.*/
-        switch (this->metadata.ScalarType) {
-        case geocalls::SIGNED_INTEGER:
-            switch (this->metadata.ScalarLength) {
-            case 1: {
-                auto c = reinterpret_cast<std::int8_t*>(cur.data());
-                auto p = reinterpret_cast<std::int8_t*>(prev.data());
-                auto d = reinterpret_cast<std::int8_t*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            case 2: {
-                auto c = reinterpret_cast<std::int16_t*>(cur.data());
-                auto p = reinterpret_cast<std::int16_t*>(prev.data());
-                auto d = reinterpret_cast<std::int16_t*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            case 4: {
-                auto c = reinterpret_cast<std::int32_t*>(cur.data());
-                auto p = reinterpret_cast<std::int32_t*>(prev.data());
-                auto d = reinterpret_cast<std::int32_t*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            case 8: {
-                auto c = reinterpret_cast<std::int64_t*>(cur.data());
-                auto p = reinterpret_cast<std::int64_t*>(prev.data());
-                auto d = reinterpret_cast<std::int64_t*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            default:
-                Log::DefaultLog.WriteError("%hs cannot process "
-                                           "%u-byte SIGNED_INTEGER data.",
-                    DifferenceVolume::ClassName(), this->metadata.ScalarLength);
-                return false;
-            }
-            break;
+        assert(cur.size() == cnt * this->srcScalarLength);
+        assert(prev.size() == cur.size());
 
-        case geocalls::UNSIGNED_INTEGER:
-            // HAZARD: unsigned-to-signed conversion is untested!
-            switch (this->metadata.ScalarLength) {
-            case 1: {
-                auto c = (cur.data());
-                auto p = (prev.data());
-                this->data.resize(2 * this->data.size());
-                this->metadata.ScalarLength = 2 * src->GetMetadata()->ScalarLength;
-                auto d = reinterpret_cast<std::int16_t*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            case 2: {
-                auto c = reinterpret_cast<std::uint16_t*>(cur.data());
-                auto p = reinterpret_cast<std::uint16_t*>(prev.data());
-                this->data.resize(2 * this->data.size());
-                this->metadata.ScalarLength = 2 * src->GetMetadata()->ScalarLength;
-                auto d = reinterpret_cast<std::int32_t*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            case 4: {
-                auto c = reinterpret_cast<std::uint32_t*>(cur.data());
-                auto p = reinterpret_cast<std::uint32_t*>(prev.data());
-                this->data.resize(2 * this->data.size());
-                this->metadata.ScalarLength = 2 * src->GetMetadata()->ScalarLength;
-                auto d = reinterpret_cast<std::int64_t*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            case 8: {
-                Log::DefaultLog.WriteWarn("Conversion from UINT64 "
-                                          "to INT64 in %hs might cause data truncation.",
-                    DifferenceVolume::ClassName());
-                auto c = reinterpret_cast<std::uint64_t*>(cur.data());
-                auto p = reinterpret_cast<std::uint64_t*>(prev.data());
-                auto d = reinterpret_cast<std::int64_t*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            default:
-                Log::DefaultLog.WriteError("%hs cannot process "
-                                           "%u-byte UNSIGNED_INTEGER data.",
-                    DifferenceVolume::ClassName(), this->metadata.ScalarLength);
-                return false;
-            }
-            break;
-
-        case geocalls::FLOATING_POINT:
-            switch (this->metadata.ScalarLength) {
-            case 4: {
-                auto c = reinterpret_cast<float*>(cur.data());
-                auto p = reinterpret_cast<float*>(prev.data());
-                auto d = reinterpret_cast<float*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            case 8: {
-                auto c = reinterpret_cast<double*>(cur.data());
-                auto p = reinterpret_cast<double*>(prev.data());
-                auto d = reinterpret_cast<double*>(this->data.data());
-                this->calcDifference(d, c, p, cur.size() / sizeof(*c));
-            } break;
-
-            default:
-                Log::DefaultLog.WriteError("%hs cannot process "
-                                           "%u-byte FLOATING_POINT data.",
-                    DifferenceVolume::ClassName(), this->metadata.ScalarLength);
-                return false;
-            }
-            break;
+        if (!ratio && (this->srcScalarType == geocalls::UNSIGNED_INTEGER) && (this->srcScalarLength == 8)) {
+            Log::DefaultLog.WriteWarn("Conversion from UINT64 "
+                                      "to INT64 in %hs might cause data truncation.",
+                DifferenceVolume::ClassName());
+        }
 
-        default:
-            assert(false); // This should not be reachable.
+        /* Do the conversion depending on the type of the data.*/
+        const auto isSupported = geocalls::volume_kernels::DispatchScalarType(
+            this->srcScalarType, this->srcScalarLength, [&](auto type) {
+                using S = std::remove_const_t<std::remove_pointer_t<decltype(type)>>;
+                // unsigned input is widened to the next larger signed type
+                using W = std::conditional_t<sizeof(S) == 1, std::int16_t,
+                    std::conditional_t<sizeof(S) == 2, std::int32_t, std::int64_t>>;
+                using D = std::conditional_t<std::is_unsigned_v<S>, W, S>;
+
+                auto c = reinterpret_cast<const S*>(cur.data());
+                auto p = reinterpret_cast<const S*>(prev.data());
+                if (!ratio) {
+                    this->calcDifference(reinterpret_cast<D*>(this->data.data()), c, p, cnt);
+                } else if (this->metadata.ScalarLength == 8) {
+                    this->calcRatio(reinterpret_cast<double*>(this->data.data()), c, p, cnt);
+                } else {
+                    this->calcRatio(reinterpret_cast<float*>(this->data.data()), c, p, cnt);
+                }
+            });
+        if (!isSupported) {
+            Log::DefaultLog.WriteError("%hs cannot process "
+                                       "%u-byte data of type %u.",
+                DifferenceVolume::ClassName(), static_cast<unsigned int>(this->srcScalarLength),
+                static_cast<unsigned int>(this->srcScalarType));
             return false;
         }
 
-        this->frameID = src->FrameID();
+        this->frameID = curFrameID;
         this->frameIdx = increment(this->frameIdx);
     } /* end if (this->frameID != src->FrameID()) */
 
@@ -468,6 +422,13 @@ bool megamol::volume::DifferenceVolume::onGetMetadata(core::Call& call) {
     }
     *dst = *src;
 
+    /* The result does not have the scalar type of the source. */
+    if (src->GetMetadata() != nullptr) {
+        this->metadata = *src->GetMetadata();
+        this->setResultType(this->metadata);
+        dst->SetMetadata(&this->metadata);
+    }
+
     dst->SetDataHash(this->getHash());
     return true;
 }
@@ -10,6 +10,7 @@
 #include <array>
 #include <vector>
 
+#include "geometry_calls/VolumeKernels.h"
 #include "geometry_calls/VolumetricDataCall.h"
 #include "geometry_calls/VolumetricMetadataStore.h"
 
@@ -68,6 +69,9 @@ public:
     ~DifferenceVolume() override;
 
 protected:
+    /** Possible voxel-wise operations on the current and the previous frame. */
+    enum Operation { OPERATION_DIFFERENCE = 0, OPERATION_RATIO = 1 };
+
     /**
      * Compute the size of a single frame in bytes.
      */
@@ -91,6 +95,20 @@ protected:
     template<class D, class S>
     void calcDifference(D* dst, const S* cur, const S* prev, const std::size_t cnt);
 
+    /**
+     * Compute the ratio of 'cur' to 'prev' into 'dst'. Voxels where 'prev' is
+     * zero become zero.
+     */
+    template<class D, class S>
+    void calcRatio(D* dst, const S* cur, const S* prev, const std::size_t cnt);
+
+    /**
+     * Change the scalar type in the source metadata 'md' to the one of the
+     * result of the selected operation: ratios are floating point,
+     * differences of unsigned data are signed.
+     */
+    void setResultType(geocalls::VolumetricMetadata_t& md) const;
+
     /**
      * Check whether the given metadata are compatible with the cache state
      * of the module.
@@ -161,6 +179,9 @@ private:
     std::size_t hashState;
     geocalls::VolumetricMetadataStore metadata;
     core::param::ParamSlot paramIgnoreInputHash;
+    core::param::ParamSlot paramOperation;
+    std::size_t srcScalarLength;
+    geocalls::ScalarType_t srcScalarType;
     core::CallerSlot slotIn;
     core::CalleeSlot slotOut;
 };
@@ -11,25 +11,20 @@
  */
 template<class D, class S>
 void megamol::volume::DifferenceVolume::calcDifference(D* dst, const S* cur, const S* prev, const std::size_t cnt) {
-    //#pragma omp parallel for
-    //    for (std::size_t i = 0; i < cnt; ++i) {
-    //        dst[i] = static_cast<D>(cur[i]) - static_cast<D>(prev[i]);
-    //    }
-
-    const auto components = this->metadata.Components;
+    geocalls::volume_kernels::Combine(
+        dst, cur, prev, cnt, this->metadata.Components,
+        [](const S c, const S p) { return static_cast<D>(c) - static_cast<D>(p); }, this->metadata.MinValues,
+        this->metadata.MaxValues);
+}
 
-    for (std::size_t i = 0; i < components; ++i) {
-        this->metadata.MinValues[i] = (std::numeric_limits<double>::max)();
-        this->metadata.MaxValues[i] = std::numeric_limits<double>::lowest();
-    }
 
-    for (std::size_t i = 0; i < cnt; ++i) {
-        dst[i] = static_cast<D>(cur[i]) - static_cast<D>(prev[i]);
-        if (dst[i] < this->metadata.MinValues[i % components]) {
-            this->metadata.MinValues[i % components] = dst[i];
-        }
-        if (dst[i] > this->metadata.MaxValues[i % components]) {
-            this->metadata.MaxValues[i % components] = dst[i];
-        }
-    }
+/*
+ * megamol::volume::DifferenceVolume::calcRatio
+ */
+template<class D, class S>
+void megamol::volume::DifferenceVolume::calcRatio(D* dst, const S* cur, const S* prev, const std::size_t cnt) {
+    geocalls::volume_kernels::Combine(
+        dst, cur, prev, cnt, this->metadata.Components,
+        [](const S c, const S p) { return (p != 0) ? static_cast<D>(c) / static_cast<D>(p) : static_cast<D>(0); },
+        this->metadata.MinValues, this->metadata.MaxValues);
 }
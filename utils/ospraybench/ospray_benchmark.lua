@@ -0,0 +1,101 @@
+-- Headless CPU benchmark of the OSPRay plugin.
+--
+-- Renders a synthetic scene offscreen with View3D and OSPRayRenderer and lets the renderer write a JSON report
+-- with upload, commit, render and readback timings. Configuration via environment variables:
+--   MMOSPBENCH_SCENE     spheres | pkd | animated | volume | mesh (default: spheres)
+--   MMOSPBENCH_COUNT     number of generated particles (default: 1000000)
+--   MMOSPBENCH_FRAMES    number of recorded frames (default: 50)
+--   MMOSPBENCH_WARMUP    number of frames skipped before recording (default: 2)
+--   MMOSPBENCH_SIZE      framebuffer size as WIDTHxHEIGHT (default: 1920x1080)
+--   MMOSPBENCH_RENDERER  SciVis | PathTracer (default: SciVis)
+--   MMOSPBENCH_REPORT    report file (default: ospray_benchmark_<scene>.json)
+--   MMOSPBENCH_BASELINE  optional report of an earlier run to compare against
+
+local function env(name, default)
+    local value = mmGetEnvValue(name)
+    if value == nil or value == "" then
+        return default
+    end
+    return value
+end
+
+local scene = env("MMOSPBENCH_SCENE", "spheres")
+local count = tonumber(env("MMOSPBENCH_COUNT", "1000000"))
+local frames = tonumber(env("MMOSPBENCH_FRAMES", "50"))
+local warmup = tonumber(env("MMOSPBENCH_WARMUP", "2"))
+local width, height = string.match(env("MMOSPBENCH_SIZE", "1920x1080"), "(%d+)x(%d+)")
+local report = env("MMOSPBENCH_REPORT", "ospray_benchmark_" .. scene .. ".json")
+local baseline = env("MMOSPBENCH_BASELINE", "")
+
+mmCreateView("bench", "View3D", "::view")
+mmCreateModule("OSPRayRenderer", "::renderer")
+mmCreateModule("DistantLight", "::light")
+mmCreateCall("CallRender3D", "::view::rendering", "::renderer::rendering")
+mmCreateCall("CallLight", "::renderer::lights", "::light::deployLightSlot")
+
+if scene == "spheres" or scene == "pkd" then
+    mmCreateModule("ParticleBoxGeneratorDataSource", "::data")
+    mmSetParamValue("::data::count", tostring(count))
+    mmSetParamValue("::data::store::color", "RGBA (floats)")
+    mmSetParamValue("::data::radiusScale", "0.5")
+    if scene == "spheres" then
+        mmCreateModule("OSPRaySphereGeometry", "::geometry")
+        mmCreateCall("MultiParticleDataCall", "::geometry::getdata", "::data::data")
+        mmCreateCall("CallOSPRayStructure", "::renderer::getStructure", "::geometry::deployStructureSlot")
+    else
+        mmSetParamValue("::data::store::color", "RGBA (bytes)")
+        -- OSPRayPKDGeometry expects the particles in PKD order
+        mmCreateModule("PkdBuilder", "::pkd")
+        mmCreateModule("OSPRayPKDGeometry", "::geometry")
+        mmCreateModule("OSPRayAPIStructure", "::structure")
+        mmCreateCall("MultiParticleDataCall", "::pkd::inData", "::data::data")
+        mmCreateCall("MultiParticleDataCall", "::geometry::getdata", "::pkd::outData")
+        mmCreateCall("CallOSPRayAPIObject", "::structure::getdata", "::geometry::deployStructureSlot")
+        mmCreateCall("CallOSPRayStructure", "::renderer::getStructure", "::structure::deployStructureSlot")
+    end
+elseif scene == "animated" then
+    -- new particle data every frame, which measures the per-frame upload and commit costs
+    mmCreateModule("TestSpheresDataSource", "::data")
+    mmSetParamValue("::data::numSpheres", tostring(count))
+    mmSetParamValue("::data::numFrames", tostring(frames + warmup))
+    mmCreateModule("OSPRaySphereGeometry", "::geometry")
+    mmCreateCall("MultiParticleDataCall", "::geometry::getdata", "::data::getData")
+    mmCreateCall("CallOSPRayStructure", "::renderer::getStructure", "::geometry::deployStructureSlot")
+elseif scene == "volume" then
+    mmCreateModule("BuckyBall", "::data")
+    mmCreateModule("TransferFunction", "::tf")
+    mmCreateModule("OSPRayStructuredVolume", "::geometry")
+    mmCreateCall("VolumetricDataCall", "::geometry::getdata", "::data::getData")
+    mmCreateCall("CallGetTransferFunction", "::geometry::gettransferfunction", "::tf::gettransferfunction")
+    mmCreateCall("CallOSPRayStructure", "::renderer::getStructure", "::geometry::deployStructureSlot")
+elseif scene == "mesh" then
+    mmCreateModule("BuckyBall", "::data")
+    mmCreateModule("SurfaceNets", "::surface")
+    mmCreateModule("OSPRayMeshGeometry", "::geometry")
+    mmCreateCall("VolumetricDataCall", "::surface::getData", "::data::getData")
+    mmCreateCall("CallMesh", "::geometry::getMeshData", "::surface::deployMesh")
+    mmCreateCall("CallOSPRayStructure", "::renderer::getStructure", "::geometry::deployStructureSlot")
+else
+    mmLog("unknown benchmark scene \"" .. scene .. "\"")
+    mmQuit()
+end
+
+mmSetParamValue("::renderer::Type", env("MMOSPBENCH_RENDERER", "SciVis"))
+mmSetParamValue("::renderer::accumulate", "false")
+mmSetParamValue("::renderer::benchmark::report", report)
+if baseline ~= "" then
+    mmSetParamValue("::renderer::benchmark::baseline", baseline)
+end
+mmSetParamValue("::renderer::benchmark::warmup", tostring(warmup))
+mmSetParamValue("::renderer::benchmark::frames", tostring(frames))
+mmSetViewFramebufferSize("::view", tonumber(width), tonumber(height))
+
+-- the renderer writes the report after the last recorded frame
+for frame = 0, frames + warmup do
+    if scene == "animated" then
+        mmSetParamValue("::view::anim::time", tostring(frame))
+    end
+    mmRenderNextFrame()
+end
+
+mmQuit()
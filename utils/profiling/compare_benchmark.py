@@ -0,0 +1,66 @@
+import argparse
+import json
+import sys
+
+parser = argparse.ArgumentParser(usage="%(prog)s <BASELINE> <REPORT>",
+                                 description="compare a MegaMol benchmark report (--benchmark) against a baseline "
+                                             "and flag regressions")
+parser.add_argument('baseline', help="report of the reference run")
+parser.add_argument('report', help="report of the run to check")
+parser.add_argument('-m', type=str, help="statistic to compare (min, mean, p50, p90, p95, p99)", dest='metric',
+                    default="p50")
+parser.add_argument('-t', type=float, help="relative slowdown counted as regression, in percent", dest='threshold',
+                    default=5.0)
+parser.add_argument('-a', type=float, help="ignore differences below this many milliseconds", dest='absolute',
+                    default=0.05)
+parser.add_argument('-v', action='store_true', help="show all compared values", dest='verbose')
+args = parser.parse_args()
+
+
+def load(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+def compare(name, base_stats, stats):
+    if args.metric not in base_stats or args.metric not in stats:
+        return None
+    base = base_stats[args.metric]
+    current = stats[args.metric]
+    diff = current - base
+    relative = diff / base * 100.0 if base > 0.0 else 0.0
+    regression = diff > args.absolute and relative > args.threshold
+    improvement = -diff > args.absolute and -relative > args.threshold
+    if regression or improvement or args.verbose:
+        tag = "REGRESSION " if regression else ("improvement" if improvement else "           ")
+        print(f"{tag} {name}: {base:.3f} ms -> {current:.3f} ms ({relative:+.1f}%)")
+    return regression
+
+
+baseline = load(args.baseline)
+report = load(args.report)
+
+if baseline.get("project_files") != report.get("project_files"):
+    print("warning: the reports were recorded with different project files")
+if baseline.get("camera_keyframes") != report.get("camera_keyframes"):
+    print("warning: the reports were recorded with different camera paths")
+
+regressions = 0
+for key in ["frame_wall_ms", "frame_cpu_ms"]:
+    if compare(key, baseline[key], report[key]):
+        regressions += 1
+
+base_regions = baseline.get("regions", {})
+regions = report.get("regions", {})
+for name in sorted(base_regions.keys() & regions.keys()):
+    if compare(name, base_regions[name], regions[name]):
+        regressions += 1
+
+if args.verbose:
+    for name in sorted(base_regions.keys() - regions.keys()):
+        print(f"only in baseline: {name}")
+    for name in sorted(regions.keys() - base_regions.keys()):
+        print(f"only in report: {name}")
+
+print(f"{regressions} regression(s) in {args.metric}, threshold {args.threshold}% and {args.absolute} ms")
+sys.exit(1 if regressions > 0 else 0)
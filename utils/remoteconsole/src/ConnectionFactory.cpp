@@ -29,3 +29,14 @@ std::unique_ptr<Connection> ConnectionFactory::createConnection(uint32_t timeout
         throw std::runtime_error("Error creating connection: " + std::string(ex.what()));
     }
 }
+
+std::unique_ptr<PipelinedConnection> ConnectionFactory::createPipelinedConnection(uint32_t timeout) {
+    try {
+        zmq::socket_t socket(*context_, zmq::socket_type::dealer);
+        socket.set(zmq::sockopt::linger, 0);
+        socket.connect(host_);
+        return std::make_unique<PipelinedConnection>(std::move(socket), timeout);
+    } catch (zmq::error_t const& ex) {
+        throw std::runtime_error("Error creating connection: " + std::string(ex.what()));
+    }
+}
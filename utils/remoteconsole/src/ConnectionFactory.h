@@ -13,6 +13,7 @@
 #include <zmq.hpp>
 
 #include "Connection.h"
+#include "PipelinedConnection.h"
 
 class ConnectionFactory {
 public:
@@ -25,6 +26,7 @@ public:
     ConnectionFactory& operator=(ConnectionFactory&& other) = delete;
 
     std::unique_ptr<Connection> createConnection(uint32_t timeout);
+    std::unique_ptr<PipelinedConnection> createPipelinedConnection(uint32_t timeout);
 
 private:
     std::string host_;
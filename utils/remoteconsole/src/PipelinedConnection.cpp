@@ -0,0 +1,49 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+#include "PipelinedConnection.h"
+
+#include <stdexcept>
+
+#include <zmq_addon.hpp>
+
+PipelinedConnection::PipelinedConnection(zmq::socket_t&& socket, uint32_t timeOut)
+        : socket_(std::move(socket))
+        , timeOut_(timeOut) {
+    socket_.set(zmq::sockopt::rcvtimeo, static_cast<int>(timeOut_));
+}
+
+void PipelinedConnection::sendCommand(uint64_t id, std::string const& cmd) {
+    try {
+        zmq::multipart_t msg;
+        msg.addmem(nullptr, 0); // Separator, as sent by REQ sockets
+        msg.addstr(std::to_string(id));
+        msg.addstr(cmd);
+        msg.send(socket_);
+    } catch (zmq::error_t const& ex) {
+        throw std::runtime_error("zmq send error: " + std::string(ex.what()));
+    }
+}
+
+bool PipelinedConnection::receiveReply(uint64_t& id, std::string& reply) {
+    try {
+        zmq::multipart_t msg;
+        if (!msg.recv(socket_)) {
+            return false;
+        }
+        if (msg.size() != 3) {
+            throw std::runtime_error("unexpected reply with " + std::to_string(msg.size()) + " frames");
+        }
+        id = std::stoull(msg[1].to_string());
+        reply = msg[2].to_string();
+        return true;
+    } catch (zmq::error_t const& ex) {
+        throw std::runtime_error("zmq recv error: " + std::string(ex.what()));
+    }
+}
+
+PipelinedConnection::~PipelinedConnection() {
+    socket_.close();
+}
@@ -0,0 +1,36 @@
+/**
+ * MegaMol
+ * Copyright (c) 2026, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <zmq.hpp>
+
+/**
+ * Connection that keeps several requests in flight. Every request carries an id, which MegaMol sends back with the
+ * reply.
+ */
+class PipelinedConnection {
+public:
+    PipelinedConnection(zmq::socket_t&& socket, uint32_t timeOut);
+    ~PipelinedConnection();
+
+    PipelinedConnection(PipelinedConnection const& other) = delete;
+    PipelinedConnection(PipelinedConnection&& other) = delete;
+    PipelinedConnection& operator=(PipelinedConnection const& other) = delete;
+    PipelinedConnection& operator=(PipelinedConnection&& other) = delete;
+
+    void sendCommand(uint64_t id, std::string const& cmd);
+
+    /** Waits for the next reply. Answers false on timeout. */
+    bool receiveReply(uint64_t& id, std::string& reply);
+
+private:
+    zmq::socket_t socket_;
+    uint32_t timeOut_ = 0;
+};
@@ -4,6 +4,8 @@
  * All rights reserved.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <regex>
@@ -34,6 +36,52 @@ void execCommand(std::vector<std::unique_ptr<Connection>> const& connections, st
     }
 }
 
+void measureThroughput(ConnectionFactory& factory, std::string const& cmd, uint32_t count, uint32_t window,
+    uint32_t timeout) {
+    auto connection = factory.createPipelinedConnection(timeout);
+
+    std::cout << "Sending " << count << " requests, up to " << window << " in flight: " << cmd << std::endl;
+
+    std::vector<std::chrono::steady_clock::time_point> sent(count);
+    std::vector<double> latencies;
+    latencies.reserve(count);
+
+    const auto start = std::chrono::steady_clock::now();
+    uint32_t next = 0;
+    uint32_t errors = 0;
+    while (latencies.size() < count) {
+        while (next < count && next - latencies.size() < window) {
+            sent[next] = std::chrono::steady_clock::now();
+            connection->sendCommand(next, setHammerIndex(cmd, next));
+            next++;
+        }
+
+        uint64_t id = 0;
+        std::string reply;
+        if (!connection->receiveReply(id, reply)) {
+            throw std::runtime_error("Reply timeout after " + std::to_string(latencies.size()) + " replies.");
+        }
+        if (id >= count) {
+            throw std::runtime_error("Reply to unknown request " + std::to_string(id));
+        }
+        if (!reply.empty()) {
+            if (errors == 0) {
+                std::cout << "Reply [" << id << "]: " << reply << std::endl;
+            }
+            errors++;
+        }
+        const auto latency = std::chrono::steady_clock::now() - sent[id];
+        latencies.push_back(std::chrono::duration<double, std::milli>(latency).count());
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "Replies: " << count << " (" << errors << " non-empty)" << std::endl;
+    std::cout << "Throughput: " << count / seconds << " requests/s" << std::endl;
+    std::cout << "Latency: median " << latencies[latencies.size() / 2] << " ms, max " << latencies.back() << " ms"
+              << std::endl;
+}
+
 int main(int argc, char* argv[]) {
     cxxopts::Options options("remoteconsole.exe", "MegaMol Remote Lua Console Client");
     // clang-format off
@@ -44,6 +92,8 @@ int main(int argc, char* argv[]) {
         ("scriptdelay", "Delay between lines in script (in ms).", cxxopts::value<int>())
         ("timeout", "Time to wait for a MegaMol response (in ms, default 10000)", cxxopts::value<int>())
         ("hammer", "Run with multiple connections. Replaces %%i%% with index.", cxxopts::value<int>())
+        ("throughput", "Send exec this many times, pipelined, and report the throughput. Replaces %%i%% with index.", cxxopts::value<int>())
+        ("window", "Number of requests in flight for throughput (default 64).", cxxopts::value<int>())
         ("h,help", "Print help.");
     // clang-format on
 
@@ -53,6 +103,8 @@ int main(int argc, char* argv[]) {
     uint32_t scriptDelay = 0;
     uint32_t timeout = 10000;
     uint32_t hammer = 0;
+    uint32_t throughput = 0;
+    uint32_t window = 64;
 
     try {
         auto parseResult = options.parse(argc, argv);
@@ -95,6 +147,23 @@ int main(int argc, char* argv[]) {
             }
             hammer = static_cast<uint32_t>(val);
         }
+        if (parseResult.count("throughput")) {
+            const int val = parseResult["throughput"].as<int>();
+            if (val <= 0) {
+                throw std::runtime_error("Invalid value for throughput!");
+            }
+            if (exec.empty()) {
+                throw std::runtime_error("The throughput option requires an exec command!");
+            }
+            throughput = static_cast<uint32_t>(val);
+        }
+        if (parseResult.count("window")) {
+            const int val = parseResult["window"].as<int>();
+            if (val <= 0) {
+                throw std::runtime_error("Invalid value for window!");
+            }
+            window = static_cast<uint32_t>(val);
+        }
     } catch (std::exception const& ex) {
         std::cerr << "Error parsing arguments: " << ex.what() << std::endl;
         std::cout << options.help({""}) << std::endl;
@@ -108,6 +177,12 @@ int main(int argc, char* argv[]) {
         std::cout << "MegaMol Remote Lua Console Client" << std::endl << std::endl;
 
         ConnectionFactory factory(host);
+
+        if (throughput > 0) {
+            measureThroughput(factory, exec, throughput, window, timeout);
+            return 0;
+        }
+
         std::vector<std::unique_ptr<Connection>> connections;
 
         for (uint32_t i = 0; i < std::max(hammer, 1u); i++) {